@@ -0,0 +1,192 @@
+#include "cpu_benchmark.h"
+#include "src/surface.h"
+#include "src/format.h"
+#include "src/input_layout.h"
+#include <chrono>
+#include <cstdio>
+
+namespace sf11
+{
+
+namespace
+{
+
+// keeps the results of the kernels alive so they are not optimized away
+volatile UINT Sink = 0;
+void Keep(UINT value) { Sink = Sink + value; }
+
+// runs op once untimed, then times passes more runs, work is the amount done by one run in the report unit
+template <typename F>
+void RunKernel(SfCpuBenchmarkReport& report, const char* name, UINT passes, UINT64 operationsPerPass, double workPerPass, const char* unit, F op)
+{
+	op();
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (UINT i = 0; i < passes; i++)
+		op();
+	auto end = std::chrono::high_resolution_clock::now();
+
+	SfCpuBenchmarkReport::Result result;
+	result.Name = name;
+	result.Operations = operationsPerPass * passes;
+	result.TotalMs = std::chrono::duration<double, std::milli>(end - start).count();
+	result.NsPerOp = result.Operations > 0 ? result.TotalMs * 1e6 / result.Operations : 0;
+	result.Throughput = result.TotalMs > 0 ? workPerPass * passes / (result.TotalMs / 1000) : 0;
+	result.Unit = unit;
+	report.Results.push_back(result);
+}
+
+void FillSurface(SfSurface2D& surface)
+{
+	for (UINT y = 0; y < surface.GetContentHeight(); y++)
+		for (UINT x = 0; x < surface.GetContentWidth(); x++)
+			surface.SetPixel(x, y, SfColor8((BYTE)x, (BYTE)y, (BYTE)(x ^ y), 255));
+}
+
+}
+
+SfCpuBenchmarkReport RunCpuBenchmark(const CpuBenchmarkParams& params)
+{
+	SfCpuBenchmarkReport report;
+
+	const UINT size = params.SurfaceSize;
+	const UINT64 pixels = (UINT64)size * size;
+	const double mpixels = pixels / 1e6;
+
+	if (!params.PngPath.empty())
+	{
+		SfSurface2D probe;
+		probe.LoadPNG(params.PngPath);
+		const UINT64 pngPixels = (UINT64)probe.GetContentWidth() * probe.GetContentHeight();
+
+		RunKernel(report, "LoadPNG", params.Passes, 1, pngPixels / 1e6, "Mpixel/s", [&]()
+		{
+			SfSurface2D surface;
+			surface.LoadPNG(params.PngPath);
+			Keep(surface.GetPixel(0, 0).Color);
+		});
+
+		RunKernel(report, "LoadPNG padded", params.Passes, 1, pngPixels / 1e6, "Mpixel/s", [&]()
+		{
+			SfSurface2D surface;
+			surface.LoadPNG(params.PngPath, ESurfacePadMethod::Repeat);
+			Keep(surface.GetPixel(0, 0).Color);
+		});
+	}
+
+	SfSurface2D unpadded(size, size);
+	SfSurface2D clamped(size, size, ESurfacePadMethod::Clamp);
+	SfSurface2D repeated(size, size, ESurfacePadMethod::Repeat);
+
+	RunKernel(report, "SetPixel", params.Passes, pixels, mpixels, "Mpixel/s", [&]() { FillSurface(unpadded); });
+	RunKernel(report, "SetPixel clamp", params.Passes, pixels, mpixels, "Mpixel/s", [&]() { FillSurface(clamped); });
+	RunKernel(report, "SetPixel repeat", params.Passes, pixels, mpixels, "Mpixel/s", [&]() { FillSurface(repeated); });
+
+	const double surfaceMB = (double)unpadded.GetPaddedWidth() * unpadded.GetPaddedHeight() * sizeof(SfColor8) / 1e6;
+	RunKernel(report, "CopySurface", params.Passes, 1, surfaceMB, "MB/s", [&]()
+	{
+		std::unique_ptr<SfSurface2D> copy = unpadded.CopySurface();
+		Keep(copy->GetPixel(size - 1, size - 1).Color);
+	});
+
+	{
+		const SfColor8* from = unpadded.GetData();
+		const SfColor8* to = clamped.GetData();
+		std::vector<SfColor8> out(pixels);
+
+		RunKernel(report, "SfColor8::Lerp", params.Passes, pixels, mpixels, "Mpixel/s", [&]()
+		{
+			for (UINT64 i = 0; i < pixels; i++)
+				out[i] = from[i].Lerp(to[i], (i & 255) / 255.0f);
+			Keep(out[pixels / 2].Color);
+		});
+	}
+
+	{
+		const SfFormat formats[] =
+		{
+			{ SfFormat::Float, 1 }, { SfFormat::Float, 2 }, { SfFormat::Float, 3 }, { SfFormat::Float, 4 },
+			{ SfFormat::HalfFloat, 4 }, { SfFormat::UNorm8, 4 }, { SfFormat::UNorm8BGRA, 4 },
+			{ SfFormat::UInt32, 1 }, { SfFormat::Int16, 2 }, { SfFormat::SNorm8, 4 }, { SfFormat::Float11, 3 },
+		};
+		const UINT numFormats = sizeof(formats) / sizeof(formats[0]);
+		const UINT lookups = params.FormatLookups;
+
+		RunKernel(report, "SfFormat::GetFormat", params.Passes, lookups, lookups / 1e6, "Mcall/s", [&]()
+		{
+			UINT sum = 0;
+			for (UINT i = 0; i < lookups; i++)
+				sum += formats[i % numFormats].GetFormat();
+			Keep(sum);
+		});
+
+		RunKernel(report, "SfFormat::GetTypeSize", params.Passes, lookups, lookups / 1e6, "Mcall/s", [&]()
+		{
+			UINT sum = 0;
+			for (UINT i = 0; i < lookups; i++)
+				sum += formats[i % numFormats].GetTypeSize();
+			Keep(sum);
+		});
+	}
+
+	if (params.VertexShader)
+	{
+		// a typical instanced mesh, the matrix expands to four elements
+		SfInputLayout layout =
+		{
+			{ "POSITION", { SfFormat::Float, 3 } },
+			{ "NORMAL", { SfFormat::Float, 3 } },
+			{ "TEXCOORD", { SfFormat::Float, 2 } },
+			{ "COLOR", { SfFormat::UNorm8, 4 } },
+			{ "WORLD", SfFormat::Mat4x4, EInputSlotType::PerInstance },
+			{ "INSTCOLOR", { SfFormat::Float, 4 }, EInputSlotType::PerInstance },
+		};
+		const UINT links = params.LayoutLinks;
+
+		RunKernel(report, "SfInputLayout::LinkWithVertexShader", params.Passes, links, links / 1e6, "Mcall/s", [&]()
+		{
+			for (UINT i = 0; i < links; i++)
+				layout.LinkWithVertexShader(params.VertexShader);
+			Keep(params.VertexShader.GetInputLayout() != nullptr);
+		});
+	}
+
+	return report;
+}
+
+std::string SfCpuBenchmarkReport::ToString() const
+{
+	char line[160];
+	std::string out;
+
+	snprintf(line, sizeof(line), "%-36s %12s %10s %10s %14s\n", "kernel", "ops", "total ms", "ns/op", "throughput");
+	out += line;
+	for (const Result& result : Results)
+	{
+		snprintf(line, sizeof(line), "%-36s %12llu %10.2f %10.2f %10.1f %s\n",
+			result.Name.c_str(), (unsigned long long)result.Operations, result.TotalMs, result.NsPerOp, result.Throughput, result.Unit);
+		out += line;
+	}
+	return out;
+}
+
+std::string SfCpuBenchmarkReport::ToJson() const
+{
+	char line[256];
+	std::string out = "{\n\t\"results\": [\n";
+
+	for (size_t i = 0; i < Results.size(); i++)
+	{
+		const Result& result = Results[i];
+		snprintf(line, sizeof(line),
+			"\t\t{ \"name\": \"%s\", \"operations\": %llu, \"total_ms\": %.3f, \"ns_per_op\": %.3f, \"throughput\": %.3f, \"unit\": \"%s\" }%s\n",
+			result.Name.c_str(), (unsigned long long)result.Operations, result.TotalMs, result.NsPerOp, result.Throughput, result.Unit,
+			i + 1 < Results.size() ? "," : "");
+		out += line;
+	}
+
+	out += "\t]\n}\n";
+	return out;
+}
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "src/d3d11_include.h"
+#include "src/shader.h"
+#include <vector>
+#include <string>
+
+namespace sf11
+{
+
+struct CpuBenchmarkParams
+{
+	// width and height of the surfaces used by the surface and color kernels
+	UINT SurfaceSize = 1024;
+
+	// passes over each surface, the first pass of every kernel is a warm up and is not timed
+	UINT Passes = 10;
+
+	UINT FormatLookups = 1000000;
+	UINT LayoutLinks = 10000;
+
+	// png loaded by the LoadPNG kernel, skipped when empty
+	std::string PngPath;
+
+	// shader the input layout kernel links against, skipped when null
+	// links replace the input layout of the shader
+	SfShader_Vertex VertexShader;
+};
+
+// throughput of the cpu side of sf11, see RunCpuBenchmark
+struct SfCpuBenchmarkReport
+{
+	struct Result
+	{
+		std::string Name;
+		UINT64 Operations = 0;
+		double TotalMs = 0;
+		double NsPerOp = 0;
+
+		// work per second in Unit, pixels for surface and color kernels, bytes for copies, calls otherwise
+		double Throughput = 0;
+		const char* Unit = "";
+	};
+
+	std::vector<Result> Results;
+
+	std::string ToString() const;
+
+	// one object per result, keys and order are stable so reports from different builds can be diffed
+	std::string ToJson() const;
+};
+
+// times the cpu kernels asset loading goes through
+// surfaces, colors and formats need no device, the input layout kernel creates input layouts on the shader's device
+SfCpuBenchmarkReport RunCpuBenchmark(const CpuBenchmarkParams& params = CpuBenchmarkParams());
+
+}
@@ -0,0 +1,117 @@
+#include "recorder_benchmark.h"
+#include "src/instance.h"
+#include "src/context.h"
+#include "src/texture.h"
+#include "src/buffer.h"
+#include "src/parallel_recorder.h"
+#include <cstdio>
+
+namespace sf11
+{
+
+namespace
+{
+
+constexpr UINT NumTextures = 32;
+constexpr UINT NumConstantBuffers = 16;
+constexpr UINT ConstantBufferSize = 256;
+
+}
+
+SfRecorderReport RunRecorderBenchmark(SfInstance& instance, const RecorderBenchmarkParams& params)
+{
+	SfRecorderReport report;
+
+	// shared by every job, created up front so the sweep only times recording
+	TextureParams2D texParams;
+	texParams.Width = 4;
+	texParams.Height = 4;
+	std::vector<SfTexture2D> textures;
+	const SfResource* srvs[NumTextures];
+	for (UINT i = 0; i < NumTextures; i++)
+		textures.push_back(instance.CreateTexture2D(texParams));
+	for (UINT i = 0; i < NumTextures; i++)
+		srvs[i] = &textures[i];
+
+	std::vector<SfBuffer_Constant> constantBuffers;
+	for (UINT i = 0; i < NumConstantBuffers; i++)
+		constantBuffers.push_back(instance.CreateConstantBuffer(ConstantBufferSize, SfUsage::Static));
+
+	SfBuffer_Vertex vertexBuffers[2];
+	for (SfBuffer_Vertex& vb : vertexBuffers)
+	{
+		vb = instance.CreateVertexBuffer(32, 4);
+		vb.LinkIndexBuffer(instance.CreateIndexBuffer(sizeof(USHORT), 6));
+	}
+
+	// the same object loop as the submission benchmark draw loop, minus the dynamic update every job would contend on
+	const UINT drawsPerJob = params.DrawsPerJob;
+	auto job = [&](SfContext& context, UINT index) -> UINT
+	{
+		for (UINT i = 0; i < drawsPerJob; i++)
+		{
+			const UINT object = index * drawsPerJob + i;
+			context.BindConstantBuffers(&constantBuffers[object % NumConstantBuffers], 1, 0, EShaderStage::Vertex | EShaderStage::Pixel);
+			context.BindShaderResources(&srvs[(object % 16) * 2], 2, 0, EShaderStage::Pixel);
+			context.BindVertexBuffer(vertexBuffers[(object / 4) & 1]);
+			context.DrawIndexed(6, 0, 0);
+		}
+		return drawsPerJob;
+	};
+
+	SfParallelRecorder recorder(instance);
+	const UINT available = instance.GetJobSystem().GetNumThreads();
+	const UINT maxThreads = params.MaxThreads == 0 || params.MaxThreads > available ? available : params.MaxThreads;
+
+	for (UINT threads = 1; threads <= maxThreads; threads++)
+	{
+		recorder.SetNumThreads(threads);
+
+		SfRecorderReport::Result result;
+		result.NumThreads = threads;
+		for (UINT rep = 0; rep <= params.Repetitions; rep++)
+		{
+			for (UINT j = 0; j < params.NumJobs; j++)
+				recorder.AddJob(job);
+			recorder.Execute();
+
+			// the first execute also creates the deferred contexts, it is not counted
+			if (rep == 0) continue;
+			const SfRecorderStats& stats = recorder.GetStats();
+			result.Draws += stats.DrawCalls;
+			result.RecordMs += stats.RecordTime;
+			result.ExecuteMs += stats.ExecuteTime;
+		}
+
+		if (params.Repetitions > 0)
+		{
+			result.DrawsPerSecond = result.RecordMs > 0 ? result.Draws / (result.RecordMs / 1000.0) : 0;
+			result.Draws /= params.Repetitions;
+			result.RecordMs /= params.Repetitions;
+			result.ExecuteMs /= params.Repetitions;
+		}
+		result.Scaling = !report.Results.empty() && report.Results[0].DrawsPerSecond > 0 ? result.DrawsPerSecond / report.Results[0].DrawsPerSecond : 1;
+		report.Results.push_back(result);
+	}
+
+	instance.GetImmediateContext().ClearState();
+	return report;
+}
+
+std::string SfRecorderReport::ToString() const
+{
+	char line[160];
+	std::string out;
+
+	snprintf(line, sizeof(line), "%-10s %10s %10s %10s %14s %8s\n", "threads", "draws", "record ms", "execute ms", "draws/s", "scaling");
+	out += line;
+	for (const Result& result : Results)
+	{
+		snprintf(line, sizeof(line), "%-10u %10llu %10.2f %10.2f %14.0f %7.2fx\n",
+			result.NumThreads, (unsigned long long)result.Draws, result.RecordMs, result.ExecuteMs, result.DrawsPerSecond, result.Scaling);
+		out += line;
+	}
+	return out;
+}
+
+}
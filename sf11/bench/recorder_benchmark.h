@@ -0,0 +1,50 @@
+#pragma once
+
+#include "src/d3d11_include.h"
+#include <vector>
+#include <string>
+
+namespace sf11
+{
+
+struct RecorderBenchmarkParams
+{
+	// the fixed job set every thread count records, so only the number of threads changes between runs
+	UINT NumJobs = 64;
+	UINT DrawsPerJob = 2000;
+
+	// timed executes per thread count, a warm up execute runs first
+	UINT Repetitions = 5;
+
+	// highest thread count of the sweep, 0 sweeps up to every thread of the job system
+	UINT MaxThreads = 0;
+};
+
+// draw recording throughput of SfParallelRecorder per thread count, see RunRecorderBenchmark
+struct SfRecorderReport
+{
+	struct Result
+	{
+		UINT NumThreads = 0;
+		UINT64 Draws = 0;
+
+		// averages over the repetitions
+		double RecordMs = 0;
+		double ExecuteMs = 0;
+		double DrawsPerSecond = 0;
+
+		// draws per second relative to the single thread run
+		double Scaling = 0;
+	};
+
+	std::vector<Result> Results;
+
+	std::string ToString() const;
+};
+
+// records the same set of draw jobs with SfParallelRecorder at 1 to N threads and reports draws per second for each
+// intended for instances created with EDeviceType::Null, which runs on machines without a gpu
+// leaves the immediate context cleared
+SfRecorderReport RunRecorderBenchmark(class SfInstance& instance, const RecorderBenchmarkParams& params = RecorderBenchmarkParams());
+
+}
@@ -0,0 +1,30 @@
+#include "sf11.h"
+#include <cstdio>
+
+// replays a trace written by SfFrameCapture::Save on a null device and prints the timing report
+// usage: replay_trace <file>
+
+using namespace sf11;
+
+int main(int argc, char** argv)
+{
+	if (argc != 2)
+	{
+		fprintf(stderr, "usage: replay_trace <file>\n");
+		return 1;
+	}
+
+	InstanceCreationParams params;
+	params.DeviceType = EDeviceType::Null;
+	SfInstance instance(params);
+
+	SfTraceReplayer replayer = instance.LoadTrace(argv[1]);
+	if (!replayer)
+	{
+		fprintf(stderr, "could not load trace %s\n", argv[1]);
+		return 1;
+	}
+
+	printf("%s", replayer.Replay(instance.GetImmediateContext()).ToString().c_str());
+	return 0;
+}
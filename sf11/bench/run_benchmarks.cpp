@@ -0,0 +1,43 @@
+#include "sf11.h"
+#include "submission_benchmark.h"
+#include "cpu_benchmark.h"
+#include "recorder_benchmark.h"
+#include <cstdio>
+#include <cstring>
+
+// runs the benchmark suites on a null device and prints their reports
+// the recorder sweep records the same draw jobs on 1 to hardware_concurrency threads
+// --no-state-cache measures the submission paths with the state cache off
+// --json prints the cpu kernel report as json, for diffing between builds, the other reports go to stderr
+
+using namespace sf11;
+
+int main(int argc, char** argv)
+{
+	SubmissionBenchmarkParams submission;
+	bool json = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "--no-state-cache")) submission.DisableStateCache = true;
+		else if (!strcmp(argv[i], "--json")) json = true;
+		else
+		{
+			fprintf(stderr, "unknown argument %s\n", argv[i]);
+			return 1;
+		}
+	}
+
+	InstanceCreationParams params;
+	params.DeviceType = EDeviceType::Null;
+	SfInstance instance(params);
+
+	// stdout only carries the json in json mode, the tables still go to stderr for whoever is watching
+	FILE* tables = json ? stderr : stdout;
+	fprintf(tables, "%s\n", RunSubmissionBenchmark(instance, submission).ToString().c_str());
+	fprintf(tables, "%s\n", RunRecorderBenchmark(instance).ToString().c_str());
+
+	// the png and input layout kernels need a png and a compiled shader, which a null device build has neither of
+	const SfCpuBenchmarkReport cpu = RunCpuBenchmark();
+	printf("%s\n", json ? cpu.ToJson().c_str() : cpu.ToString().c_str());
+	return 0;
+}
@@ -0,0 +1,185 @@
+#include "submission_benchmark.h"
+#include "src/instance.h"
+#include "src/context.h"
+#include "src/texture.h"
+#include "src/buffer.h"
+#include <chrono>
+#include <cstdio>
+
+namespace sf11
+{
+
+namespace
+{
+
+constexpr UINT NumTextures = 32;
+constexpr UINT NumConstantBuffers = 16;
+constexpr UINT ConstantBufferSize = 256;
+
+// clears the context, warms the path up, then times op over the given number of operations
+template <typename F>
+void RunScenario(SfContext& context, SfSubmissionReport& report, const char* name, UINT operations, UINT warmup, F op)
+{
+	context.ClearState();
+	for (UINT i = 0; i < warmup; i++)
+		op(i);
+
+	SfContextStats before = context.GetStats();
+	auto start = std::chrono::high_resolution_clock::now();
+
+	for (UINT i = 0; i < operations; i++)
+		op(i);
+
+	auto end = std::chrono::high_resolution_clock::now();
+	SfContextStats delta = context.GetStats() - before;
+
+	SfSubmissionReport::Result result;
+	result.Name = name;
+	result.Operations = operations;
+	result.TotalMs = std::chrono::duration<double, std::milli>(end - start).count();
+	result.NsPerOp = operations > 0 ? result.TotalMs * 1e6 / operations : 0;
+	result.DriverCallsPerOp = operations > 0 ? (double)delta.GetTotalCalls() / operations : 0;
+	report.Results.push_back(result);
+}
+
+const char* StageName(EShaderStage stage)
+{
+	switch (stage.Index)
+	{
+		case EShaderStage::Pixel: return "ps";
+		case EShaderStage::Vertex | EShaderStage::Pixel: return "vs+ps";
+		case EShaderStage::All: return "all";
+		default: return "?";
+	}
+}
+
+}
+
+SfSubmissionReport RunSubmissionBenchmark(SfInstance& instance, const SubmissionBenchmarkParams& params)
+{
+	SfSubmissionReport report;
+	SfContext& context = instance.GetImmediateContext();
+
+	bool cacheWasEnabled = context.IsStateCacheEnabled();
+	context.SetStateCacheEnabled(!params.DisableStateCache);
+
+	const UINT iterations = params.Iterations;
+	const UINT warmup = iterations / 10;
+
+	// two sets of 16 so consecutive binds differ and are not dropped by the cache
+	TextureParams2D texParams;
+	texParams.Width = 4;
+	texParams.Height = 4;
+	std::vector<SfTexture2D> textures;
+	const SfResource* srvs[NumTextures];
+	for (UINT i = 0; i < NumTextures; i++)
+		textures.push_back(instance.CreateTexture2D(texParams));
+	for (UINT i = 0; i < NumTextures; i++)
+		srvs[i] = &textures[i];
+
+	std::vector<SfBuffer_Constant> constantBuffers;
+	for (UINT i = 0; i < NumConstantBuffers; i++)
+		constantBuffers.push_back(instance.CreateConstantBuffer(ConstantBufferSize, SfUsage::Static));
+
+	SfBuffer_Constant staticBuffer = instance.CreateConstantBuffer(ConstantBufferSize, SfUsage::Static);
+	SfBuffer_Constant dynamicBuffer = instance.CreateConstantBuffer(ConstantBufferSize, SfUsage::Dynamic);
+	BYTE constants[ConstantBufferSize] = {};
+
+	SfBuffer_Vertex vertexBuffers[2];
+	for (SfBuffer_Vertex& vb : vertexBuffers)
+	{
+		vb = instance.CreateVertexBuffer(32, 4);
+		vb.LinkIndexBuffer(instance.CreateIndexBuffer(sizeof(USHORT), 6));
+	}
+
+	char name[64];
+
+	const EShaderStage stages[] = { EShaderStage::Pixel, EShaderStage::Vertex | EShaderStage::Pixel, EShaderStage::All };
+	for (EShaderStage stage : stages)
+	{
+		for (UINT count = 1; count <= 16; count *= 2)
+		{
+			snprintf(name, sizeof(name), "srv x%u %s", count, StageName(stage));
+			RunScenario(context, report, name, iterations, warmup, [&](UINT i)
+			{
+				context.BindShaderResources(&srvs[(i & 1) * 16], count, 0, stage);
+			});
+		}
+	}
+
+	// the same views every time, measures what the cache costs when it has nothing to drop
+	RunScenario(context, report, "srv x8 ps redundant", iterations, warmup, [&](UINT)
+	{
+		context.BindShaderResources(srvs, 8, 0, EShaderStage::Pixel);
+	});
+
+	for (UINT count = 1; count <= 8; count *= 2)
+	{
+		snprintf(name, sizeof(name), "cbuffer x%u vs+ps", count);
+		RunScenario(context, report, name, iterations, warmup, [&](UINT i)
+		{
+			context.BindConstantBuffers(&constantBuffers[(i & 1) * 8], count, 0, EShaderStage::Vertex | EShaderStage::Pixel);
+		});
+	}
+
+	RunScenario(context, report, "vertex buffer + linked index", iterations, warmup, [&](UINT i)
+	{
+		context.BindVertexBuffer(vertexBuffers[i & 1]);
+	});
+
+	RunScenario(context, report, "cull and fill mode", iterations, warmup, [&](UINT i)
+	{
+		context.SetCullAndFillMode((ECullMode)(i % 3), (EFillMode)((i / 3) % 2));
+	});
+
+	RunScenario(context, report, "update cbuffer static", iterations, warmup, [&](UINT i)
+	{
+		constants[0] = (BYTE)i;
+		context.UpdateConstantBuffer(staticBuffer, constants);
+	});
+
+	RunScenario(context, report, "update cbuffer dynamic", iterations, warmup, [&](UINT i)
+	{
+		constants[0] = (BYTE)i;
+		context.UpdateConstantBuffer(dynamicBuffer, constants);
+	});
+
+	// what a typical object costs, per draw constants, two material textures and its mesh
+	for (UINT draws : params.DrawLoopSizes)
+	{
+		snprintf(name, sizeof(name), "draw loop %u", draws);
+		RunScenario(context, report, name, draws, draws / 10, [&](UINT i)
+		{
+			constants[0] = (BYTE)i;
+			context.UpdateConstantBuffer(dynamicBuffer, constants);
+			context.BindConstantBuffers(&dynamicBuffer, 1, 0, EShaderStage::Vertex | EShaderStage::Pixel);
+			context.BindShaderResources(&srvs[(i % 16) * 2], 2, 0, EShaderStage::Pixel);
+			context.BindVertexBuffer(vertexBuffers[(i / 4) & 1]);
+			context.DrawIndexed(6, 0, 0);
+		});
+	}
+
+	context.ClearState();
+	context.ResetStats();
+	context.SetStateCacheEnabled(cacheWasEnabled);
+
+	return report;
+}
+
+std::string SfSubmissionReport::ToString() const
+{
+	char line[160];
+	std::string out;
+
+	snprintf(line, sizeof(line), "%-30s %10s %10s %10s %12s\n", "scenario", "ops", "total ms", "ns/op", "d3d calls/op");
+	out += line;
+	for (const Result& result : Results)
+	{
+		snprintf(line, sizeof(line), "%-30s %10llu %10.2f %10.1f %12.2f\n",
+			result.Name.c_str(), (unsigned long long)result.Operations, result.TotalMs, result.NsPerOp, result.DriverCallsPerOp);
+		out += line;
+	}
+	return out;
+}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "src/d3d11_include.h"
+#include <vector>
+#include <string>
+
+namespace sf11
+{
+
+struct SubmissionBenchmarkParams
+{
+	// repetitions of each bind and update scenario, a warm up pass of a tenth of this runs first
+	UINT Iterations = 100000;
+
+	// number of draws in each full draw loop
+	std::vector<UINT> DrawLoopSizes = { 10000, 100000 };
+
+	// measures the calls with the state cache off, so the cost of the cache itself can be compared
+	bool DisableStateCache = false;
+};
+
+// cpu cost of the sf11 submission paths, see RunSubmissionBenchmark
+struct SfSubmissionReport
+{
+	struct Result
+	{
+		std::string Name;
+		UINT64 Operations = 0;
+		double TotalMs = 0;
+		double NsPerOp = 0;
+
+		// calls that reached d3d after the state cache, per operation, draw loops count one operation per draw
+		double DriverCallsPerOp = 0;
+	};
+
+	std::vector<Result> Results;
+
+	std::string ToString() const;
+};
+
+// times the bind, update and draw paths of the immediate context, ns per operation and driver calls per operation
+// the calls do not form a valid pipeline, nothing is meant to be rendered
+// intended for instances created with EDeviceType::Null, which runs on machines without a gpu
+// leaves the immediate context cleared and its stats reset
+SfSubmissionReport RunSubmissionBenchmark(class SfInstance& instance, const SubmissionBenchmarkParams& params = SubmissionBenchmarkParams());
+
+}
@@ -8,6 +8,20 @@
 #include "src/rasterizer.h"
 #include "src/texture.h"
 #include "src/color.h"
+#include "src/render_queue.h"
+#include "src/parallel_recorder.h"
+#include "src/pipeline_state.h"
+#include "src/state_object_cache.h"
+#include "src/constant_ring.h"
+#include "src/geometry_ring.h"
+#include "src/readback.h"
+#include "src/gpu_profiler.h"
+#include "src/command_buffer.h"
+#include "src/frame_capture.h"
+#include "src/null_device.h"
+#include "src/frame_arena.h"
+#include "src/job_system.h"
+#include "src/async.h"
 #include <memory>
 
 // TODO 
@@ -20,6 +34,6 @@ namespace sf11
 // creates an instance which provides the initial d3d11 interface
 std::unique_ptr<SfInstance> CreateInstance(const InstanceCreationParams& params);
 
-// returns a vector containing info for each graphics devices in this machine
+// returns a vector containing info for each graphics devices in this machine, empty without windows
 std::vector<SfAdapter> EnumerateAdapters();
 }
\ No newline at end of file
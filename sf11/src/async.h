@@ -0,0 +1,137 @@
+#pragma once
+
+#include "d3d11_include.h"
+#include "sfassert.h"
+#include "job_system.h"
+#include <coroutine>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sf11
+{
+
+// coroutines that await sf11 async creation can be resumed on a chosen thread through one of these
+// the chosen thread calls Pump, usually once per frame, and the coroutines continue inside that call
+class SfResumeQueue
+{
+	std::mutex Mutex;
+	std::vector<std::coroutine_handle<>> Ready;
+
+	// swapped with Ready in Pump so coroutines can queue more while the others run
+	std::vector<std::coroutine_handle<>> Resuming;
+
+public:
+
+	SfResumeQueue() = default;
+	SfResumeQueue(const SfResumeQueue&) = delete;
+	SfResumeQueue& operator=(const SfResumeQueue&) = delete;
+
+	void Push(std::coroutine_handle<> handle)
+	{
+		std::lock_guard<std::mutex> lock(Mutex);
+		Ready.push_back(handle);
+	}
+
+	// resumes every coroutine whose object became ready since the last call, returns how many
+	UINT Pump()
+	{
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			Resuming.swap(Ready);
+		}
+
+		const UINT count = (UINT)Resuming.size();
+		for (std::coroutine_handle<> handle : Resuming)
+			handle.resume();
+		Resuming.clear();
+		return count;
+	}
+};
+
+// an object being created on the job system, returned by the SfInstance ...Async functions
+// co_await it to get the object, or call Wait from code that is not a coroutine
+// only one coroutine can await each handle
+template <typename T>
+class SfAsync
+{
+	friend class SfInstance;
+
+	struct AsyncData
+	{
+		SfJobSystem* Jobs = nullptr;
+		SfResumeQueue* ResumeOn = nullptr;
+		SfTaskGroup Group;
+
+		std::mutex Mutex;
+		bool Ready = false;
+		std::coroutine_handle<> Waiter;
+
+		T Value;
+
+		// called by the creating task once Value is filled
+		void Complete()
+		{
+			std::coroutine_handle<> waiter;
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				Ready = true;
+				waiter = Waiter;
+			}
+
+			if (!waiter) return;
+			if (ResumeOn) ResumeOn->Push(waiter);
+			else waiter.resume();
+		}
+	};
+
+	std::shared_ptr<AsyncData> Data;
+
+public:
+
+	bool IsReady() const
+	{
+		std::lock_guard<std::mutex> lock(Data->Mutex);
+		return Data->Ready;
+	}
+
+	// runs other tasks on the calling thread until the object is ready, then returns it
+	// must not be called from a coroutine that could be resumed by one of those tasks
+	T& Wait()
+	{
+		Data->Jobs->Wait(Data->Group);
+		return Data->Value;
+	}
+
+	bool await_ready() const { return IsReady(); }
+
+	bool await_suspend(std::coroutine_handle<> handle)
+	{
+		std::lock_guard<std::mutex> lock(Data->Mutex);
+		sfAssert(!Data->Waiter, "only one coroutine can await an async object");
+
+		// finished between await_ready and here, carry on without suspending
+		if (Data->Ready) return false;
+
+		Data->Waiter = handle;
+		return true;
+	}
+
+	T await_resume() const { return Data->Value; }
+};
+
+// return type for coroutines that await SfAsync objects
+// starts running when called and frees itself when it returns, the caller does not wait for it
+struct SfCoroutine
+{
+	struct promise_type
+	{
+		SfCoroutine get_return_object() { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { sfAssert(false, "unhandled exception in coroutine"); }
+	};
+};
+
+}
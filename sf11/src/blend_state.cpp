@@ -1,11 +1,9 @@
 #include "blend_state.h"
-#include "instance.h"
 
 namespace sf11
 {
 
-SfBlendState::SfBlendState(SfInstance* instance, const SfBlendData& data)
-	: Data(std::make_shared<BlendStateData>(instance))
+D3D11_BLEND_DESC SfBlendState::MakeDesc(const SfBlendData& data)
 {
 	D3D11_BLEND_DESC bd;
 	ZeroMemory(&bd, sizeof(bd));
@@ -27,11 +25,10 @@ SfBlendState::SfBlendState(SfInstance* instance, const SfBlendData& data)
 	for (int i = 0; i < 8; i++)
 		bd.RenderTarget[i] = rtbd;
 
-	Data->Instance->GetDevice()->CreateBlendState(&bd, &Data->State);
+	return bd;
 }
 
-SfBlendState::SfBlendState(SfInstance* instance, SfBlendData* data, UINT count)
-	: Data(std::make_shared<BlendStateData>(instance))
+D3D11_BLEND_DESC SfBlendState::MakeDesc(const SfBlendData* data, UINT count)
 {
 	D3D11_BLEND_DESC bd;
 	ZeroMemory(&bd, sizeof(bd));
@@ -54,7 +51,7 @@ SfBlendState::SfBlendState(SfInstance* instance, SfBlendData* data, UINT count)
 		bd.RenderTarget[i] = rtbd;
 	}
 
-	Data->Instance->GetDevice()->CreateBlendState(&bd, &Data->State);
+	return bd;
 }
 
 }
\ No newline at end of file
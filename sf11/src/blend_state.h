@@ -50,6 +50,9 @@ class SfBlendState
 {
 	friend class SfInstance;
 	friend class SfContext;
+	friend class SfRenderQueue;
+	friend class SfPipelineState;
+	friend class SfCommandBuffer;
 
 	struct BlendStateData
 	{
@@ -60,8 +63,9 @@ class SfBlendState
 
 	std::shared_ptr<BlendStateData> Data;
 
-	explicit SfBlendState(SfInstance* instance, const SfBlendData& data);
-	explicit SfBlendState(SfInstance* instance, SfBlendData* data, UINT count);
+	// single description is used for every render target, arrays fill one render target per entry
+	static D3D11_BLEND_DESC MakeDesc(const SfBlendData& data);
+	static D3D11_BLEND_DESC MakeDesc(const SfBlendData* data, UINT count);
 public:
 	SF_DEF_OPERATORS_AND_DEFAULT(SfBlendState)
 };
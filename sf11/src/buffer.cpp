@@ -10,7 +10,7 @@ SfBuffer::SfBuffer(class SfInstance* instance, UINT bindFlags, UINT miscFlags, U
 	//Data(std::make_shared<BufferData>(instance, typeSize, numElements, defaultSlot, stage, dynamic))
 	SfResource(instance, usage, defaultSlot, stage)
 {
-	Data->Buffer = ResourceData::BufferData(typeSize, numElements, defaultSlot, stage);
+	Data->Buffer = std::make_unique<BufferData>(typeSize, numElements);
 
 	DXGI_FORMAT dxFormat = format.Type == SfFormat::NullFormat ? DXGI_FORMAT_UNKNOWN : format.GetFormat();
 
@@ -42,45 +42,52 @@ SfBuffer::SfBuffer(class SfInstance* instance, UINT bindFlags, UINT miscFlags, U
 	uav.Buffer.Flags = (miscFlags & D3D11_RESOURCE_MISC_BUFFER_STRUCTURED) ? 0 : D3D11_BUFFER_UAV_FLAG_RAW;
 	uav.Buffer.NumElements = numElements;
 	
-	Data->Buffer.BufferDesc = desc;
-	Data->SrvDesc = srv;
-	Data->UavDesc = uav;
+	Data->Buffer->BufferDesc = desc;
+	Data->Buffer->SrvDesc = srv;
+	Data->Buffer->UavDesc = uav;
 
 	Reallocate(typeSize, numElements, usage, initialData);
 }
 
 void SfBuffer::Reallocate(UINT typeSize, UINT numElements, SfUsage usage, void* data /*= nullptr*/)
 {
-	if (Data->Buffer.BufferDesc.BindFlags == D3D11_BIND_CONSTANT_BUFFER)
+	if (Data->Buffer->BufferDesc.BindFlags == D3D11_BIND_CONSTANT_BUFFER)
 		sfAssert(numElements == 1, "cannot reallocate constant buffer with anything other than 1 element");
 
-	Data->Buffer.BufferDesc.ByteWidth = typeSize * numElements;
-	Data->Buffer.BufferDesc.StructureByteStride = typeSize;
-	Data->Buffer.BufferDesc.CPUAccessFlags = usage.Value == SfUsage::Dynamic ? D3D11_CPU_ACCESS_WRITE : 0;
-	Data->Buffer.BufferDesc.Usage = usage.Value == SfUsage::Dynamic ? D3D11_USAGE_DYNAMIC : D3D11_USAGE_DEFAULT;
+	Data->Buffer->BufferDesc.ByteWidth = typeSize * numElements;
+	Data->Buffer->BufferDesc.StructureByteStride = typeSize;
+	Data->Buffer->BufferDesc.CPUAccessFlags = usage.Value == SfUsage::Dynamic ? D3D11_CPU_ACCESS_WRITE : 0;
+	Data->Buffer->BufferDesc.Usage = usage.Value == SfUsage::Dynamic ? D3D11_USAGE_DYNAMIC : D3D11_USAGE_DEFAULT;
 
 	D3D11_SUBRESOURCE_DATA sd = {};
 	sd.pSysMem = data;
 
-	sfAssertHR(Data->Instance->GetDevice()->CreateBuffer(&Data->Buffer.BufferDesc, data ? &sd : NULL, &Data->Buffer.Buffer), 
+	sfAssertHR(Data->Instance->GetDevice()->CreateBuffer(&Data->Buffer->BufferDesc, data ? &sd : NULL, &Data->Buffer->Buffer), 
 		"could not create buffer");
 
-	Data->Resource = Data->Buffer.Buffer.Get();
+	Data->Resource = Data->Buffer->Buffer.Get();
 
-	if (Data->Buffer.BufferDesc.BindFlags & D3D11_BIND_SHADER_RESOURCE && usage.Value != SfUsage::Staging)
+	Data->Buffer->Shadow.reset();
+	if (Data->Buffer->BufferDesc.BindFlags == D3D11_BIND_CONSTANT_BUFFER && usage.Value == SfUsage::Static && Data->Instance->NeedsWholeConstantUpdates())
 	{
-		Data->SrvDesc.Buffer.NumElements = numElements;
-		sfAssertHR(Data->Instance->GetDevice()->CreateShaderResourceView(Data->Buffer.Buffer.Get(), &Data->SrvDesc, &Data->Buffer.ShaderResourceView), 
+		Data->Buffer->Shadow = std::make_unique<BYTE[]>(Data->Buffer->BufferDesc.ByteWidth);
+		if (data) memcpy(Data->Buffer->Shadow.get(), data, Data->Buffer->BufferDesc.ByteWidth);
+	}
+
+	if (Data->Buffer->BufferDesc.BindFlags & D3D11_BIND_SHADER_RESOURCE && usage.Value != SfUsage::Staging)
+	{
+		Data->Buffer->SrvDesc.Buffer.NumElements = numElements;
+		sfAssertHR(Data->Instance->GetDevice()->CreateShaderResourceView(Data->Buffer->Buffer.Get(), &Data->Buffer->SrvDesc, &Data->Buffer->ShaderResourceView), 
 			"could not create SRV for buffer");
-		Data->ShaderResource = Data->Buffer.ShaderResourceView.Get();
+		Data->ShaderResource = Data->Buffer->ShaderResourceView.Get();
 	}
 
-	if (Data->Buffer.BufferDesc.BindFlags & D3D11_BIND_UNORDERED_ACCESS)
+	if (Data->Buffer->BufferDesc.BindFlags & D3D11_BIND_UNORDERED_ACCESS)
 	{
-		Data->UavDesc.Buffer.NumElements = numElements;
-		sfAssertHR(Data->Instance->GetDevice()->CreateUnorderedAccessView(Data->Buffer.Buffer.Get(), &Data->UavDesc, &Data->Buffer.UnorderedAccessView), 
+		Data->Buffer->UavDesc.Buffer.NumElements = numElements;
+		sfAssertHR(Data->Instance->GetDevice()->CreateUnorderedAccessView(Data->Buffer->Buffer.Get(), &Data->Buffer->UavDesc, &Data->Buffer->UnorderedAccessView), 
 			"could not create UAV for buffer");
-		Data->UnorderedAccess = Data->Buffer.UnorderedAccessView.Get();
+		Data->UnorderedAccess = Data->Buffer->UnorderedAccessView.Get();
 	}
 }
 
@@ -158,23 +165,23 @@ SfBuffer_Index::SfBuffer_Index(SfInstance* instance, UINT indexSize,
 		usage,
 		initialData)
 {
-	Data->Buffer.IndexFormat = indexSize == 1 ? DXGI_FORMAT_R8_UINT : indexSize == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+	Data->Buffer->IndexFormat = indexSize == 1 ? DXGI_FORMAT_R8_UINT : indexSize == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
 }
 
 
 void SfBuffer_Vertex::LinkIndexBuffer(const class SfBuffer_Index& buffer)
 {
-	Data->Buffer.LinkedBuffer = buffer.Data;
+	Data->Buffer->LinkedBuffer = buffer.Data;
 }
 
 SfBuffer_Index SfBuffer_Vertex::GetLinkedIndexBuffer() const
 {
-	return { Data->Buffer.LinkedBuffer.lock() };
+	return { Data->Buffer->LinkedBuffer.lock() };
 }
 
 void SfBuffer_Vertex::ClearIndexBuffer()
 {
-	Data->Buffer.LinkedBuffer.reset();
+	Data->Buffer->LinkedBuffer.reset();
 }
 
 SfBuffer_Raw::SfBuffer_Raw(SfInstance* instance, SfFormat format, UINT numElements, 
@@ -23,10 +23,10 @@ public:
 
 	// returns the number of elements (of TypeSize) that this buffer is allocated to hold
 	// does not apply to constant buffers
-	UINT GetNumElements() const { return Data->Buffer.NumElements; }
+	UINT GetNumElements() const { return Data->Buffer->NumElements; }
 
 	// returns the size of the data type this buffer is intended to contain
-	UINT GetTypeSize() const { return Data->Buffer.TypeSize; }
+	UINT GetTypeSize() const { return Data->Buffer->TypeSize; }
 
 	// reallocate this buffer with new parameters
 	// optionally initialize it with data
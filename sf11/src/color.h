@@ -11,6 +11,7 @@ struct SfColor8
 
 	SfColor8() : Color() {}
 	SfColor8(const SfColor8& col) : Color(col.Color) {}
+	SfColor8& operator=(const SfColor8& col) = default;
 	SfColor8(unsigned int col) : Color(col) {}
 	SfColor8(BYTE r, BYTE g, BYTE b, BYTE a) : Color((a << 24u) | (r << 16u) | (g << 8u) | b) {}
 	SfColor8(BYTE r, BYTE g, BYTE b) : Color((r << 16u) | (g << 8u) | b) {}
@@ -0,0 +1,842 @@
+#include "command_buffer.h"
+#include "context.h"
+#include "instance.h"
+#include "shader_program.h"
+#include "render_target.h"
+#include "texture.h"
+#include "sampler.h"
+#include "blend_state.h"
+#include "sfassert.h"
+#include <chrono>
+
+namespace sf11
+{
+
+namespace
+{
+
+// SlotsCommand is 12 bytes, the pointer array after it starts on the next 8 byte boundary
+constexpr UINT SlotArrayOffset = 16;
+
+// payloads as they are laid out after each command header, arrays follow the struct they belong to
+
+struct SlotsCommand
+{
+	UINT Stages;
+	UINT StartSlot;
+	UINT Count;
+};
+
+struct ShaderCommand
+{
+	ID3D11DeviceChild* Shader;
+	UINT Stage;
+};
+
+struct RenderTargetsCommand
+{
+	ID3D11DepthStencilView* Depth;
+	UINT Count;
+};
+
+struct VertexBuffersCommand
+{
+	ID3D11Buffer* Buffers[2];
+	UINT Strides[2];
+	UINT Offsets[2];
+	UINT Count;
+};
+
+struct IndexBufferCommand
+{
+	ID3D11Buffer* Buffer;
+	DXGI_FORMAT Format;
+	UINT Offset;
+};
+
+struct DepthStencilCommand
+{
+	ID3D11DepthStencilState* State;
+	UINT StencilRef;
+};
+
+struct BlendCommand
+{
+	ID3D11BlendState* State;
+	FLOAT Factor[4];
+	UINT SampleMask;
+};
+
+struct ClearRenderTargetCommand
+{
+	ID3D11RenderTargetView* View;
+	FLOAT Color[4];
+};
+
+struct ClearDepthCommand
+{
+	ID3D11DepthStencilView* View;
+	float Depth;
+	UINT8 Stencil;
+};
+
+struct UpdateCommand
+{
+	void* Resource;
+	UINT Offset;
+	UINT Size;
+	EUpdateMode Mode;
+};
+
+struct CopyCommand
+{
+	void* Dst;
+	void* Src;
+};
+
+struct WriteBufferCommand
+{
+	ID3D11Buffer* Buffer;
+	UINT Offset;
+	UINT Size;
+	UINT Discard;
+};
+
+struct DrawCommand
+{
+	UINT Count;
+	UINT InstanceCount;
+	UINT Start;
+	int BaseVertex;
+	UINT StartInstance;
+};
+
+const char* CommandNames[] =
+{
+	"PipelineState",
+	"Shader",
+	"InputLayout",
+	"ShaderResources",
+	"Samplers",
+	"ConstantBuffers",
+	"ComputeUAVs",
+	"RenderTargets",
+	"VertexBuffers",
+	"IndexBuffer",
+	"Rasterizer",
+	"DepthStencil",
+	"Blend",
+	"Topology",
+	"Viewport",
+	"Scissor",
+	"ClearRenderTarget",
+	"ClearDepth",
+	"Update",
+	"Copy",
+	"WriteBuffer",
+	"Draw",
+	"DrawIndexed",
+	"DrawInstanced",
+	"DrawIndexedInstanced",
+	"Dispatch",
+	"FrameEnd",
+};
+static_assert(sizeof(CommandNames) / sizeof(CommandNames[0]) == SF_NUM_COMMAND_TYPES, "command name missing");
+
+}
+
+BYTE* SfCommandBuffer::Push(ECommand type, UINT payloadSize)
+{
+	const UINT size = (UINT)(sizeof(CommandHeader) + payloadSize + 7) & ~7u;
+	const size_t offset = Stream.size();
+	Stream.resize(offset + size);
+
+	CommandHeader* header = (CommandHeader*)(Stream.data() + offset);
+	header->Type = type;
+	header->Size = size;
+	LastCommand = offset;
+	NumCommands++;
+	return (BYTE*)(header + 1);
+}
+
+const char* SfCommandBuffer::GetCommandName(UINT type)
+{
+	static_assert((UINT)ECommand::FrameEnd + 1 == SF_NUM_COMMAND_TYPES, "SF_NUM_COMMAND_TYPES is out of date");
+	return type < SF_NUM_COMMAND_TYPES ? CommandNames[type] : "Unknown";
+}
+
+SfCommandBuffer::SfCommandBuffer(SfInstance& instance)
+	: Instance(&instance)
+{}
+
+void SfCommandBuffer::CheckInstance(SfInstance* instance)
+{
+	SF_VALIDATE(Instance == instance, "cannot record objects from another instance");
+}
+
+void SfCommandBuffer::Reset()
+{
+	Stream.clear();
+	NumCommands = 0;
+	LastCommand = 0;
+}
+
+BYTE* SfCommandBuffer::PushSlots(ECommand type, EShaderStage stages, UINT startSlot, UINT count, UINT arraySize)
+{
+	BYTE* payload = Push(type, SlotArrayOffset + arraySize);
+	*(SlotsCommand*)payload = { stages.Index, startSlot, count };
+	return payload + SlotArrayOffset;
+}
+
+void SfCommandBuffer::PushDraw(ECommand type, UINT count, UINT instanceCount, UINT start, int baseVertex, UINT startInstance)
+{
+	*(DrawCommand*)Push(type, sizeof(DrawCommand)) = { count, instanceCount, start, baseVertex, startInstance };
+}
+
+void SfCommandBuffer::RecordShaderResources(EShaderStage stages, UINT startSlot, UINT count, ID3D11ShaderResourceView* const* views)
+{
+	memcpy(PushSlots(ECommand::ShaderResources, stages, startSlot, count, sizeof(*views) * count), views, sizeof(*views) * count);
+}
+
+void SfCommandBuffer::RecordSamplers(EShaderStage stages, UINT startSlot, UINT count, ID3D11SamplerState* const* samplers)
+{
+	memcpy(PushSlots(ECommand::Samplers, stages, startSlot, count, sizeof(*samplers) * count), samplers, sizeof(*samplers) * count);
+}
+
+void SfCommandBuffer::RecordConstantBuffers(EShaderStage stages, UINT startSlot, UINT count, ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants)
+{
+	// the buffers are followed by their first constants and constant counts, both stay 0 for whole buffers
+	BYTE* slots = PushSlots(ECommand::ConstantBuffers, stages, startSlot, count, (sizeof(ID3D11Buffer*) + sizeof(UINT) * 2) * count);
+	memcpy(slots, buffers, sizeof(*buffers) * count);
+	if (firstConstants)
+	{
+		UINT* windows = (UINT*)(slots + sizeof(ID3D11Buffer*) * count);
+		memcpy(windows, firstConstants, sizeof(UINT) * count);
+		memcpy(windows + count, numConstants, sizeof(UINT) * count);
+	}
+}
+
+void SfCommandBuffer::RecordComputeUAVs(UINT startSlot, UINT count, ID3D11UnorderedAccessView* const* views)
+{
+	memcpy(PushSlots(ECommand::ComputeUAVs, EShaderStage::Compute, startSlot, count, sizeof(*views) * count), views, sizeof(*views) * count);
+}
+
+void SfCommandBuffer::RecordRenderTargets(UINT count, ID3D11RenderTargetView* const* views, ID3D11DepthStencilView* depth)
+{
+	BYTE* payload = Push(ECommand::RenderTargets, sizeof(RenderTargetsCommand) + sizeof(ID3D11RenderTargetView*) * count);
+	*(RenderTargetsCommand*)payload = { depth, count };
+	if (count > 0) memcpy(payload + sizeof(RenderTargetsCommand), views, sizeof(*views) * count);
+}
+
+void SfCommandBuffer::RecordVertexBuffers(UINT count, ID3D11Buffer* const* buffers, const UINT* strides, const UINT* offsets)
+{
+	SF_CHECK(count <= 2, "command buffers only record a vertex and an instance buffer");
+
+	VertexBuffersCommand* cmd = (VertexBuffersCommand*)Push(ECommand::VertexBuffers, sizeof(VertexBuffersCommand));
+	cmd->Count = count;
+	for (UINT i = 0; i < count; i++)
+	{
+		cmd->Buffers[i] = buffers[i];
+		cmd->Strides[i] = strides[i];
+		cmd->Offsets[i] = offsets[i];
+	}
+}
+
+void SfCommandBuffer::RecordIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, UINT offset)
+{
+	*(IndexBufferCommand*)Push(ECommand::IndexBuffer, sizeof(IndexBufferCommand)) = { buffer, format, offset };
+}
+
+void SfCommandBuffer::RecordShader(UINT stage, ID3D11DeviceChild* shader)
+{
+	*(ShaderCommand*)Push(ECommand::Shader, sizeof(ShaderCommand)) = { shader, stage };
+}
+
+void SfCommandBuffer::RecordInputLayout(ID3D11InputLayout* layout)
+{
+	*(ID3D11InputLayout**)Push(ECommand::InputLayout, sizeof(ID3D11InputLayout*)) = layout;
+}
+
+void SfCommandBuffer::RecordRasterizer(ID3D11RasterizerState* state)
+{
+	*(ID3D11RasterizerState**)Push(ECommand::Rasterizer, sizeof(ID3D11RasterizerState*)) = state;
+}
+
+void SfCommandBuffer::RecordDepthStencil(ID3D11DepthStencilState* state, UINT stencilRef)
+{
+	*(DepthStencilCommand*)Push(ECommand::DepthStencil, sizeof(DepthStencilCommand)) = { state, stencilRef };
+}
+
+void SfCommandBuffer::RecordBlend(ID3D11BlendState* state, const FLOAT factor[4], UINT sampleMask)
+{
+	*(BlendCommand*)Push(ECommand::Blend, sizeof(BlendCommand)) = { state, { factor[0], factor[1], factor[2], factor[3] }, sampleMask };
+}
+
+void SfCommandBuffer::RecordClearRenderTarget(ID3D11RenderTargetView* view, const FLOAT color[4])
+{
+	*(ClearRenderTargetCommand*)Push(ECommand::ClearRenderTarget, sizeof(ClearRenderTargetCommand)) =
+		{ view, { color[0], color[1], color[2], color[3] } };
+}
+
+void SfCommandBuffer::RecordClearDepth(ID3D11DepthStencilView* view, float depthClear, UINT8 stencilClear)
+{
+	*(ClearDepthCommand*)Push(ECommand::ClearDepth, sizeof(ClearDepthCommand)) = { view, depthClear, stencilClear };
+}
+
+void SfCommandBuffer::RecordUpdate(SfResource::ResourceData* resource, const void* data, UINT dataSize, UINT bufferOffset, EUpdateMode mode)
+{
+	BYTE* payload = Push(ECommand::Update, sizeof(UpdateCommand) + dataSize);
+	*(UpdateCommand*)payload = { resource, bufferOffset, dataSize, mode };
+	memcpy(payload + sizeof(UpdateCommand), data, dataSize);
+}
+
+void SfCommandBuffer::RecordCopy(SfResource::ResourceData* dst, SfResource::ResourceData* src)
+{
+	*(CopyCommand*)Push(ECommand::Copy, sizeof(CopyCommand)) = { dst, src };
+}
+
+void SfCommandBuffer::RecordWriteBuffer(ID3D11Buffer* buffer, UINT offset, const void* data, UINT dataSize, bool discard)
+{
+	BYTE* payload = Push(ECommand::WriteBuffer, sizeof(WriteBufferCommand) + dataSize);
+	*(WriteBufferCommand*)payload = { buffer, offset, dataSize, discard ? 1u : 0u };
+	memcpy(payload + sizeof(WriteBufferCommand), data, dataSize);
+}
+
+void SfCommandBuffer::VisitObjects(ECommand type, BYTE* payload, const std::function<void(void*& object, EObjectKind kind, UINT stage)>& visit)
+{
+	auto visitArray = [&](void** objects, UINT count, EObjectKind kind)
+	{
+		for (UINT i = 0; i < count; i++)
+			visit(objects[i], kind, 0);
+	};
+
+	switch (type)
+	{
+		case ECommand::PipelineState:
+		{
+			SfPipelineState::PipelineKey& key = *(SfPipelineState::PipelineKey*)payload;
+			visit((void*&)key.VertexShader, EObjectKind::Shader, 0);
+			visit((void*&)key.PixelShader, EObjectKind::Shader, 1);
+			visit((void*&)key.HullShader, EObjectKind::Shader, 2);
+			visit((void*&)key.DomainShader, EObjectKind::Shader, 3);
+			visit((void*&)key.GeometryShader, EObjectKind::Shader, 4);
+			visit((void*&)key.InputLayout, EObjectKind::InputLayout, 0);
+			visit((void*&)key.BlendState, EObjectKind::BlendState, 0);
+			visit((void*&)key.DepthStencilState, EObjectKind::DepthStencilState, 0);
+			visit((void*&)key.RasterizerState, EObjectKind::Rasterizer, 0);
+			break;
+		}
+		case ECommand::Shader:
+		{
+			ShaderCommand& cmd = *(ShaderCommand*)payload;
+			visit((void*&)cmd.Shader, EObjectKind::Shader, cmd.Stage);
+			break;
+		}
+		case ECommand::InputLayout: visit(*(void**)payload, EObjectKind::InputLayout, 0); break;
+		case ECommand::Rasterizer: visit(*(void**)payload, EObjectKind::Rasterizer, 0); break;
+		case ECommand::ShaderResources:
+			visitArray((void**)(payload + SlotArrayOffset), ((SlotsCommand*)payload)->Count, EObjectKind::ShaderResourceView);
+			break;
+		case ECommand::Samplers:
+			visitArray((void**)(payload + SlotArrayOffset), ((SlotsCommand*)payload)->Count, EObjectKind::Sampler);
+			break;
+		case ECommand::ConstantBuffers:
+			visitArray((void**)(payload + SlotArrayOffset), ((SlotsCommand*)payload)->Count, EObjectKind::Buffer);
+			break;
+		case ECommand::ComputeUAVs:
+			visitArray((void**)(payload + SlotArrayOffset), ((SlotsCommand*)payload)->Count, EObjectKind::UnorderedAccessView);
+			break;
+		case ECommand::RenderTargets:
+		{
+			RenderTargetsCommand& cmd = *(RenderTargetsCommand*)payload;
+			visit((void*&)cmd.Depth, EObjectKind::DepthStencilView, 0);
+			visitArray((void**)(payload + sizeof(RenderTargetsCommand)), cmd.Count, EObjectKind::RenderTargetView);
+			break;
+		}
+		case ECommand::VertexBuffers:
+			visitArray((void**)((VertexBuffersCommand*)payload)->Buffers, 2, EObjectKind::Buffer);
+			break;
+		case ECommand::IndexBuffer: visit((void*&)((IndexBufferCommand*)payload)->Buffer, EObjectKind::Buffer, 0); break;
+		case ECommand::DepthStencil: visit((void*&)((DepthStencilCommand*)payload)->State, EObjectKind::DepthStencilState, 0); break;
+		case ECommand::Blend: visit((void*&)((BlendCommand*)payload)->State, EObjectKind::BlendState, 0); break;
+		case ECommand::ClearRenderTarget: visit((void*&)((ClearRenderTargetCommand*)payload)->View, EObjectKind::RenderTargetView, 0); break;
+		case ECommand::ClearDepth: visit((void*&)((ClearDepthCommand*)payload)->View, EObjectKind::DepthStencilView, 0); break;
+		case ECommand::Update: visit(((UpdateCommand*)payload)->Resource, EObjectKind::Resource, 0); break;
+		case ECommand::Copy:
+		{
+			CopyCommand& cmd = *(CopyCommand*)payload;
+			visit(cmd.Dst, EObjectKind::Resource, 0);
+			visit(cmd.Src, EObjectKind::Resource, 0);
+			break;
+		}
+		case ECommand::WriteBuffer: visit((void*&)((WriteBufferCommand*)payload)->Buffer, EObjectKind::Buffer, 0); break;
+		default:
+			break;
+	}
+}
+
+void SfCommandBuffer::BindPipelineState(const SfPipelineState& state)
+{
+	SF_CHECK(state, "cannot record a null pipeline state");
+	CheckInstance(state.Data->Instance);
+	memcpy(Push(ECommand::PipelineState, sizeof(SfPipelineState::PipelineKey)), &state.Data->Key, sizeof(SfPipelineState::PipelineKey));
+}
+
+void SfCommandBuffer::BindShaderProgram(const SfShaderProgram& program)
+{
+	const EShaderStage shaders = program.GetActiveShaders();
+	const SfShader_Vertex& vertex = program.GetVertexShader();
+	CheckInstance(vertex.GetInstance());
+
+	RecordShader(0, vertex.GetShader());
+	if (vertex.GetInputLayout()) RecordInputLayout(vertex.GetInputLayout());
+	if (shaders.Index & EShaderStage::Hull) RecordShader(2, program.GetHullShader().GetShader());
+	if (shaders.Index & EShaderStage::Domain) RecordShader(3, program.GetDomainShader().GetShader());
+	if (shaders.Index & EShaderStage::Geometry) RecordShader(4, program.GetGeometryShader().GetShader());
+	RecordShader(1, program.GetPixelShader().GetShader());
+}
+
+void SfCommandBuffer::BindComputeShader(const SfShader_Compute& shader)
+{
+	CheckInstance(shader.GetInstance());
+	RecordShader(5, shader.GetShader());
+}
+
+void SfCommandBuffer::BindSampler(const SfSamplerState& sampler, UINT slot, EShaderStage shaderStages)
+{
+	BindSamplers(&sampler, slot, shaderStages, 1);
+}
+
+void SfCommandBuffer::BindSamplers(const SfSamplerState* samplers, UINT startSlot, EShaderStage shaderStages, UINT count /*= 1*/)
+{
+	SF_CHECK(startSlot + count <= D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT, "cannot bind samplers over slot 16");
+
+	ID3D11SamplerState** states = (ID3D11SamplerState**)PushSlots(ECommand::Samplers, shaderStages, startSlot, count, sizeof(ID3D11SamplerState*) * count);
+	for (UINT i = 0; i < count; i++)
+		states[i] = samplers[i].Data->State.Get();
+}
+
+void SfCommandBuffer::BindTexture(const SfTexture* tex, UINT slot, EShaderStage stage /*= EShaderStage::Pixel*/)
+{
+	const SfResource* resource = tex && tex->Data ? tex : nullptr;
+	BindShaderResources(&resource, 1, slot, stage);
+}
+
+void SfCommandBuffer::BindShaderResource(const SfResource* resource, UINT slot /*= -1*/, EShaderStage stage /*= EShaderStage::None*/)
+{
+	if (resource)
+	{
+		if (slot == -1) slot = resource->GetDefaultSlot();
+		if (stage == EShaderStage::None) stage = resource->GetDefaultStage();
+	}
+	else
+	{
+		SF_CHECK(slot != -1 && (stage & EShaderStage::All),
+			"cannot use default slot or shader stage when binding a null shader resource");
+	}
+	BindShaderResources(&resource, 1, slot, stage);
+}
+
+void SfCommandBuffer::BindShaderResources(const SfResource** resources, UINT count, UINT startSlot, EShaderStage stage)
+{
+	SF_CHECK(startSlot + count <= D3D11_COMMONSHADER_INPUT_RESOURCE_REGISTER_COUNT, "cannot bind shader resources over slot 128");
+
+	ID3D11ShaderResourceView** views = (ID3D11ShaderResourceView**)PushSlots(ECommand::ShaderResources, stage, startSlot, count, sizeof(ID3D11ShaderResourceView*) * count);
+	for (UINT i = 0; i < count; i++)
+		views[i] = resources[i] ? resources[i]->Data->ShaderResource : nullptr;
+}
+
+void SfCommandBuffer::BindConstantBuffer(const SfBuffer_Constant& buffer, UINT slot /*= -1*/, EShaderStage stage /*= EShaderStage::None*/)
+{
+	if (buffer)
+	{
+		if (slot == -1) slot = buffer.GetDefaultSlot();
+		if (stage == EShaderStage::None) stage = buffer.GetDefaultStage();
+	}
+	else
+	{
+		SF_CHECK(slot != -1 && (stage & EShaderStage::All),
+			"cannot use default slot or shader stage when binding a null constant buffer");
+	}
+	SF_CHECK(slot < D3D11_COMMONSHADER_CONSTANT_BUFFER_HW_SLOT_COUNT, "constant buffer slot out of range");
+
+	ID3D11Buffer* d3dBuffer = buffer ? buffer.Data->Buffer->Buffer.Get() : nullptr;
+	RecordConstantBuffers(stage, slot, 1, &d3dBuffer, nullptr, nullptr);
+}
+
+void SfCommandBuffer::BindConstantAllocation(const SfConstantAllocation& alloc, UINT slot, EShaderStage stage)
+{
+	SF_CHECK(alloc, "cannot bind an empty constant allocation");
+	SF_CHECK(slot < D3D11_COMMONSHADER_CONSTANT_BUFFER_HW_SLOT_COUNT, "constant buffer slot out of range");
+
+	RecordConstantBuffers(stage, slot, 1, &alloc.Buffer, &alloc.FirstConstant, &alloc.NumConstants);
+}
+
+void SfCommandBuffer::SetUAVsForCS(const SfResource** views, UINT count, UINT startSlot)
+{
+	SF_CHECK(startSlot + count <= D3D11_PS_CS_UAV_REGISTER_COUNT, "too many compute unordered access views");
+
+	ID3D11UnorderedAccessView** uavs = (ID3D11UnorderedAccessView**)PushSlots(ECommand::ComputeUAVs, EShaderStage::Compute, startSlot, count, sizeof(ID3D11UnorderedAccessView*) * count);
+	for (UINT i = 0; i < count; i++)
+		uavs[i] = views[i] ? views[i]->Data->UnorderedAccess : nullptr;
+}
+
+void SfCommandBuffer::BindRenderTarget(const SfRenderTarget& target, const SfDepthBuffer& depth /*= SF_NULL*/)
+{
+	BindRenderTargets(&target, 1, depth);
+}
+
+void SfCommandBuffer::BindRenderTargets(const SfRenderTarget* targets, UINT count, const SfDepthBuffer& depth /*= SF_NULL*/)
+{
+	SF_CHECK(count <= 8, "cannot bind more than 8 render targets");
+
+	BYTE* payload = Push(ECommand::RenderTargets, sizeof(RenderTargetsCommand) + sizeof(ID3D11RenderTargetView*) * count);
+	RenderTargetsCommand* cmd = (RenderTargetsCommand*)payload;
+	cmd->Depth = depth ? depth.Data->Texture->DepthStencilView.Get() : nullptr;
+	cmd->Count = count;
+
+	ID3D11RenderTargetView** views = (ID3D11RenderTargetView**)(payload + sizeof(RenderTargetsCommand));
+	for (UINT i = 0; i < count; i++)
+		views[i] = targets[i] ? targets[i].Data->Texture->RenderTargetView.Get() : nullptr;
+}
+
+void SfCommandBuffer::BindVertexBuffer(const SfBuffer_Vertex& buffer, const SfBuffer_Instance& instanceBuffer /*= SF_NULL*/)
+{
+	VertexBuffersCommand* cmd = (VertexBuffersCommand*)Push(ECommand::VertexBuffers, sizeof(VertexBuffersCommand));
+	if (!buffer) return;
+
+	if (buffer.GetNumElements() > 0)
+	{
+		cmd->Buffers[0] = buffer.Data->Buffer->Buffer.Get();
+		cmd->Strides[0] = buffer.GetTypeSize();
+		cmd->Count = 1;
+		if (instanceBuffer)
+		{
+			cmd->Buffers[1] = instanceBuffer.Data->Buffer->Buffer.Get();
+			cmd->Strides[1] = instanceBuffer.GetTypeSize();
+			cmd->Count = 2;
+		}
+	}
+
+	SfBuffer_Index ib = buffer.GetLinkedIndexBuffer();
+	if (ib && ib.GetNumElements() > 0)
+		BindIndexBuffer(ib);
+}
+
+void SfCommandBuffer::BindIndexBuffer(const SfBuffer_Index& buffer)
+{
+	IndexBufferCommand* cmd = (IndexBufferCommand*)Push(ECommand::IndexBuffer, sizeof(IndexBufferCommand));
+	if (buffer)
+	{
+		cmd->Buffer = buffer.Data->Buffer->Buffer.Get();
+		cmd->Format = buffer.Data->Buffer->IndexFormat;
+	}
+}
+
+void SfCommandBuffer::BindTransientGeometry(const SfTransientGeometry& geometry)
+{
+	SF_CHECK(geometry, "cannot bind empty transient geometry");
+
+	VertexBuffersCommand* vb = (VertexBuffersCommand*)Push(ECommand::VertexBuffers, sizeof(VertexBuffersCommand));
+	vb->Buffers[0] = geometry.VertexBuffer;
+	vb->Strides[0] = geometry.VertexStride;
+	vb->Count = 1;
+
+	if (geometry.IndexBuffer)
+	{
+		IndexBufferCommand* ib = (IndexBufferCommand*)Push(ECommand::IndexBuffer, sizeof(IndexBufferCommand));
+		ib->Buffer = geometry.IndexBuffer;
+		ib->Format = geometry.IndexFormat;
+	}
+}
+
+void SfCommandBuffer::SetCullAndFillMode(ECullMode cull, EFillMode fill)
+{
+	RecordRasterizer(Instance->GetRasterizer(cull, fill).GetState());
+}
+
+void SfCommandBuffer::BindRasterizer(const SfRasterizer& rasterizer)
+{
+	RecordRasterizer(rasterizer.GetState());
+}
+
+void SfCommandBuffer::SetDepthBufferState(EDepthState state)
+{
+	RecordDepthStencil(Instance->GetDepthState(state), 0);
+}
+
+void SfCommandBuffer::SetDepthStencilState(const SfDepthStencilState& state, UINT stencilRef /*= 0*/)
+{
+	CheckInstance(state.Data->Instance);
+	RecordDepthStencil(state.Data->State.Get(), stencilRef);
+}
+
+void SfCommandBuffer::BindBlendState(const SfBlendState& state, float factorR, float factorG, float factorB, float factorA, UINT sampleMask /*= 0xFFFFFFFF*/)
+{
+	const FLOAT factor[] = { factorR, factorG, factorB, factorA };
+	RecordBlend(state.Data->State.Get(), factor, sampleMask);
+}
+
+void SfCommandBuffer::ClearBlendState()
+{
+	const FLOAT factor[] = { 1, 1, 1, 1 };
+	RecordBlend(nullptr, factor, 0xFFFFFFFF);
+}
+
+void SfCommandBuffer::SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology)
+{
+	*(D3D11_PRIMITIVE_TOPOLOGY*)Push(ECommand::Topology, sizeof(D3D11_PRIMITIVE_TOPOLOGY)) = topology;
+}
+
+void SfCommandBuffer::SetViewport(float width, float height, float topLeftX /*= 0*/, float topLeftY /*= 0*/, float minDepth /*= 0*/, float maxDepth /*= 1*/)
+{
+	*(D3D11_VIEWPORT*)Push(ECommand::Viewport, sizeof(D3D11_VIEWPORT)) = { topLeftX, topLeftY, width, height, minDepth, maxDepth };
+}
+
+void SfCommandBuffer::SetScissorRect(LONG left, LONG top, LONG right, LONG bottom)
+{
+	*(D3D11_RECT*)Push(ECommand::Scissor, sizeof(D3D11_RECT)) = { left, top, right, bottom };
+}
+
+void SfCommandBuffer::ClearRenderTarget(const SfRenderTarget& target, float r, float g, float b, float a)
+{
+	const FLOAT color[] = { r, g, b, a };
+	RecordClearRenderTarget(target.Data->Texture->RenderTargetView.Get(), color);
+}
+
+void SfCommandBuffer::ClearDepthBuffer(const SfDepthBuffer& buffer, float depthClear /*= 1*/, UINT8 stencilClear /*= 0*/)
+{
+	RecordClearDepth(buffer.Data->Texture->DepthStencilView.Get(), depthClear, stencilClear);
+}
+
+void SfCommandBuffer::UpdateResource(const SfResource* buffer, const void* data, UINT dataSize, UINT bufferOffset, EUpdateMode mode /*= EUpdateMode::Discard*/)
+{
+	SF_CHECK(buffer, "cannot update null resource");
+	SF_CHECK(data && dataSize > 0, "cannot update resource with empty data");
+	CheckInstance(buffer->Data->Instance);
+
+	RecordUpdate(buffer->Data.get(), data, dataSize, bufferOffset, mode);
+}
+
+void SfCommandBuffer::UpdateConstantBuffer(const SfBuffer_Constant& buffer, const void* data, UINT bufferOffset /*= 0*/, UINT dataSize /*= 0*/, EUpdateMode mode /*= EUpdateMode::Discard*/)
+{
+	if (dataSize == 0) dataSize = buffer.GetTypeSize() - bufferOffset;
+	UpdateResource(&buffer, data, dataSize, bufferOffset, mode);
+}
+
+void SfCommandBuffer::CopyResource(const SfResource& dst, const SfResource& src)
+{
+	CheckInstance(dst.Data->Instance);
+	RecordCopy(dst.Data.get(), src.Data.get());
+}
+
+void SfCommandBuffer::Draw(UINT vertexCount, UINT vertexStart)
+{
+	PushDraw(ECommand::Draw, vertexCount, 1, vertexStart, 0, 0);
+}
+
+void SfCommandBuffer::DrawIndexed(UINT indexCount, UINT indexStart, int baseVertexLocation)
+{
+	PushDraw(ECommand::DrawIndexed, indexCount, 1, indexStart, baseVertexLocation, 0);
+}
+
+void SfCommandBuffer::DrawInstanced(UINT vertexCountPerInstance, UINT instanceCount, UINT startVertex, UINT startInstance)
+{
+	PushDraw(ECommand::DrawInstanced, vertexCountPerInstance, instanceCount, startVertex, 0, startInstance);
+}
+
+void SfCommandBuffer::DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndex, int baseVertex, UINT startInstance)
+{
+	PushDraw(ECommand::DrawIndexedInstanced, indexCountPerInstance, instanceCount, startIndex, baseVertex, startInstance);
+}
+
+void SfCommandBuffer::Dispatch(UINT countX, UINT countY, UINT countZ)
+{
+	UINT* counts = (UINT*)Push(ECommand::Dispatch, sizeof(UINT) * 3);
+	counts[0] = countX;
+	counts[1] = countY;
+	counts[2] = countZ;
+}
+
+void SfCommandBuffer::Replay(SfContext& context, SfCommandTimings* timings /*= nullptr*/) const
+{
+	sfAssert(Instance == context.GetInstance(), "cannot replay a command buffer on a context from another instance");
+
+	std::chrono::high_resolution_clock::time_point commandStart;
+	const BYTE* cursor = Stream.data();
+	const BYTE* end = cursor + Stream.size();
+	while (cursor < end)
+	{
+		const CommandHeader& header = *(const CommandHeader*)cursor;
+		const BYTE* payload = cursor + sizeof(CommandHeader);
+		cursor += header.Size;
+
+		if (timings) commandStart = std::chrono::high_resolution_clock::now();
+
+		switch (header.Type)
+		{
+			case ECommand::PipelineState:
+			{
+				// recorded pipelines are applied by value, the context no longer knows the pipeline object
+				context.ForgetPipelineState();
+				context.ApplyPipelineKey(*(const SfPipelineState::PipelineKey*)payload);
+				break;
+			}
+			case ECommand::Shader:
+			{
+				const ShaderCommand& cmd = *(const ShaderCommand*)payload;
+				if (cmd.Stage != 5) context.ForgetPipelineState();
+				context.SetShaderRaw(cmd.Stage, cmd.Shader);
+				break;
+			}
+			case ECommand::InputLayout:
+				context.ForgetPipelineState();
+				context.SetInputLayoutRaw(*(ID3D11InputLayout* const*)payload);
+				break;
+			case ECommand::ShaderResources:
+			{
+				const SlotsCommand& cmd = *(const SlotsCommand*)payload;
+				context.SetShaderResourcesForStages(EShaderStage((BYTE)cmd.Stages), cmd.StartSlot, cmd.Count, (ID3D11ShaderResourceView* const*)(payload + SlotArrayOffset));
+				break;
+			}
+			case ECommand::Samplers:
+			{
+				const SlotsCommand& cmd = *(const SlotsCommand*)payload;
+				context.SetSamplersForStages(EShaderStage((BYTE)cmd.Stages), cmd.StartSlot, cmd.Count, (ID3D11SamplerState* const*)(payload + SlotArrayOffset));
+				break;
+			}
+			case ECommand::ConstantBuffers:
+			{
+				const SlotsCommand& cmd = *(const SlotsCommand*)payload;
+				const UINT* windows = (const UINT*)(payload + SlotArrayOffset + sizeof(ID3D11Buffer*) * cmd.Count);
+				context.SetConstantBuffersForStages(EShaderStage((BYTE)cmd.Stages), cmd.StartSlot, cmd.Count, (ID3D11Buffer* const*)(payload + SlotArrayOffset), windows, windows + cmd.Count);
+				break;
+			}
+			case ECommand::ComputeUAVs:
+			{
+				const SlotsCommand& cmd = *(const SlotsCommand*)payload;
+				context.SetComputeUnorderedAccessViews(cmd.StartSlot, cmd.Count, (ID3D11UnorderedAccessView* const*)(payload + SlotArrayOffset));
+				break;
+			}
+			case ECommand::RenderTargets:
+			{
+				const RenderTargetsCommand& cmd = *(const RenderTargetsCommand*)payload;
+				context.SetRenderTargetViews(cmd.Count, (ID3D11RenderTargetView* const*)(payload + sizeof(RenderTargetsCommand)), cmd.Depth);
+				break;
+			}
+			case ECommand::VertexBuffers:
+			{
+				const VertexBuffersCommand& cmd = *(const VertexBuffersCommand*)payload;
+				context.SetVertexBuffers(cmd.Count, cmd.Buffers, cmd.Strides, cmd.Offsets);
+				break;
+			}
+			case ECommand::IndexBuffer:
+			{
+				const IndexBufferCommand& cmd = *(const IndexBufferCommand*)payload;
+				context.SetIndexBuffer(cmd.Buffer, cmd.Format, cmd.Offset);
+				break;
+			}
+			case ECommand::Rasterizer:
+				context.SetRasterizerState(*(ID3D11RasterizerState* const*)payload);
+				break;
+			case ECommand::DepthStencil:
+			{
+				const DepthStencilCommand& cmd = *(const DepthStencilCommand*)payload;
+				context.SetDepthStencilStateRaw(cmd.State, cmd.StencilRef);
+				break;
+			}
+			case ECommand::Blend:
+			{
+				const BlendCommand& cmd = *(const BlendCommand*)payload;
+				context.SetBlendStateRaw(cmd.State, cmd.Factor, cmd.SampleMask);
+				break;
+			}
+			case ECommand::Topology:
+				context.SetPrimitiveTopology(*(const D3D11_PRIMITIVE_TOPOLOGY*)payload);
+				break;
+			case ECommand::Viewport:
+			{
+				const D3D11_VIEWPORT& view = *(const D3D11_VIEWPORT*)payload;
+				context.SetViewport(view.Width, view.Height, view.TopLeftX, view.TopLeftY, view.MinDepth, view.MaxDepth);
+				break;
+			}
+			case ECommand::Scissor:
+			{
+				const D3D11_RECT& rect = *(const D3D11_RECT*)payload;
+				context.SetScissorRect(rect.left, rect.top, rect.right, rect.bottom);
+				break;
+			}
+			case ECommand::ClearRenderTarget:
+			{
+				const ClearRenderTargetCommand& cmd = *(const ClearRenderTargetCommand*)payload;
+				context.ClearRenderTargetRaw(cmd.View, cmd.Color);
+				break;
+			}
+			case ECommand::ClearDepth:
+			{
+				const ClearDepthCommand& cmd = *(const ClearDepthCommand*)payload;
+				context.ClearDepthStencilRaw(cmd.View, cmd.Depth, cmd.Stencil);
+				break;
+			}
+			case ECommand::Update:
+			{
+				const UpdateCommand& cmd = *(const UpdateCommand*)payload;
+				context.UpdateResourceData(*(SfResource::ResourceData*)cmd.Resource, payload + sizeof(UpdateCommand), cmd.Size, cmd.Offset, cmd.Mode);
+				break;
+			}
+			case ECommand::Copy:
+			{
+				const CopyCommand& cmd = *(const CopyCommand*)payload;
+				context.CopyResourceData(*(SfResource::ResourceData*)cmd.Dst, *(SfResource::ResourceData*)cmd.Src);
+				break;
+			}
+			case ECommand::WriteBuffer:
+			{
+				const WriteBufferCommand& cmd = *(const WriteBufferCommand*)payload;
+				context.WriteBufferRaw(cmd.Buffer, cmd.Offset, payload + sizeof(WriteBufferCommand), cmd.Size, cmd.Discard != 0);
+				break;
+			}
+			case ECommand::Draw:
+			{
+				const DrawCommand& cmd = *(const DrawCommand*)payload;
+				context.Draw(cmd.Count, cmd.Start);
+				break;
+			}
+			case ECommand::DrawIndexed:
+			{
+				const DrawCommand& cmd = *(const DrawCommand*)payload;
+				context.DrawIndexed(cmd.Count, cmd.Start, cmd.BaseVertex);
+				break;
+			}
+			case ECommand::DrawInstanced:
+			{
+				const DrawCommand& cmd = *(const DrawCommand*)payload;
+				context.DrawInstanced(cmd.Count, cmd.InstanceCount, cmd.Start, cmd.StartInstance);
+				break;
+			}
+			case ECommand::DrawIndexedInstanced:
+			{
+				const DrawCommand& cmd = *(const DrawCommand*)payload;
+				context.DrawIndexedInstanced(cmd.Count, cmd.InstanceCount, cmd.Start, cmd.BaseVertex, cmd.StartInstance);
+				break;
+			}
+			case ECommand::Dispatch:
+			{
+				const UINT* counts = (const UINT*)payload;
+				context.Dispatch(counts[0], counts[1], counts[2]);
+				break;
+			}
+			case ECommand::FrameEnd:
+				break;
+		}
+
+		if (timings)
+		{
+			const UINT type = (UINT)header.Type;
+			timings->Count[type]++;
+			timings->Microseconds[type] += std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - commandStart).count();
+		}
+	}
+}
+
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "d3d11_include.h"
+#include "rasterizer.h"
+#include "depth_buffer.h"
+#include "buffer.h"
+#include "usage.h"
+#include "pipeline_state.h"
+#include "constant_ring.h"
+#include "geometry_ring.h"
+#include <vector>
+#include <functional>
+
+namespace sf11
+{
+
+constexpr UINT SF_NUM_COMMAND_TYPES = 27;
+
+// time spent in the sf11 layer per command type while replaying, see SfCommandBuffer::Replay
+struct SfCommandTimings
+{
+	UINT64 Count[SF_NUM_COMMAND_TYPES] = {};
+	double Microseconds[SF_NUM_COMMAND_TYPES] = {};
+};
+
+// a list of context calls recorded into one block of memory and replayed later on any context of the same instance
+// recording only copies raw d3d pointers and never touches d3d, so any number of threads can record their own buffers
+// replay sends every command through the regular context paths, so the state cache and commit at draw still apply
+// unlike SfContext_Deferred this does not depend on driver command list support
+// resources are referenced rather than held, they must stay alive while the buffer can still be replayed
+// a buffer can be replayed any number of times, Reset keeps its memory for the next recording
+class SfCommandBuffer
+{
+	enum class ECommand : UINT
+	{
+		PipelineState,
+		Shader,
+		InputLayout,
+		ShaderResources,
+		Samplers,
+		ConstantBuffers,
+		ComputeUAVs,
+		RenderTargets,
+		VertexBuffers,
+		IndexBuffer,
+		Rasterizer,
+		DepthStencil,
+		Blend,
+		Topology,
+		Viewport,
+		Scissor,
+		ClearRenderTarget,
+		ClearDepth,
+		Update,
+		Copy,
+
+		// raw writes into a dynamic buffer, frame captures use these for constant and geometry rings
+		WriteBuffer,
+		Draw,
+		DrawIndexed,
+		DrawInstanced,
+		DrawIndexedInstanced,
+		Dispatch,
+
+		// only written by frame captures, replays as nothing
+		FrameEnd
+	};
+
+	// what a pointer inside a command refers to, stage is only set for shaders
+	enum class EObjectKind : UINT
+	{
+		ShaderResourceView,
+		UnorderedAccessView,
+		RenderTargetView,
+		DepthStencilView,
+		Buffer,
+		Sampler,
+		BlendState,
+		DepthStencilState,
+		Rasterizer,
+		Shader,
+		InputLayout,
+
+		// an SfResource::ResourceData, used by updates and copies
+		Resource,
+
+		// the d3d texture behind a view, never stored in a command
+		Texture
+	};
+
+	// Size covers the header, the payload and any trailing arrays, always a multiple of 8
+	struct CommandHeader
+	{
+		ECommand Type;
+		UINT Size;
+	};
+
+	std::vector<BYTE> Stream;
+	UINT NumCommands = 0;
+	size_t LastCommand = 0;
+	class SfInstance* Instance = nullptr;
+
+	// appends a command and returns its zeroed payload
+	BYTE* Push(ECommand type, UINT payloadSize);
+	void CheckInstance(class SfInstance* instance);
+
+	// returns the array that follows the slot range
+	BYTE* PushSlots(ECommand type, EShaderStage stages, UINT startSlot, UINT count, UINT arraySize);
+	void PushDraw(ECommand type, UINT count, UINT instanceCount, UINT start, int baseVertex, UINT startInstance);
+
+	// raw forms of the calls, shared by the public functions and SfFrameCapture
+	void RecordShaderResources(EShaderStage stages, UINT startSlot, UINT count, ID3D11ShaderResourceView* const* views);
+	void RecordSamplers(EShaderStage stages, UINT startSlot, UINT count, ID3D11SamplerState* const* samplers);
+	void RecordConstantBuffers(EShaderStage stages, UINT startSlot, UINT count, ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants);
+	void RecordComputeUAVs(UINT startSlot, UINT count, ID3D11UnorderedAccessView* const* views);
+	void RecordRenderTargets(UINT count, ID3D11RenderTargetView* const* views, ID3D11DepthStencilView* depth);
+	void RecordVertexBuffers(UINT count, ID3D11Buffer* const* buffers, const UINT* strides, const UINT* offsets);
+	void RecordIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, UINT offset);
+	void RecordShader(UINT stage, ID3D11DeviceChild* shader);
+	void RecordInputLayout(ID3D11InputLayout* layout);
+	void RecordRasterizer(ID3D11RasterizerState* state);
+	void RecordDepthStencil(ID3D11DepthStencilState* state, UINT stencilRef);
+	void RecordBlend(ID3D11BlendState* state, const FLOAT factor[4], UINT sampleMask);
+	void RecordClearRenderTarget(ID3D11RenderTargetView* view, const FLOAT color[4]);
+	void RecordClearDepth(ID3D11DepthStencilView* view, float depthClear, UINT8 stencilClear);
+	void RecordUpdate(SfResource::ResourceData* resource, const void* data, UINT dataSize, UINT bufferOffset, EUpdateMode mode);
+	void RecordCopy(SfResource::ResourceData* dst, SfResource::ResourceData* src);
+	void RecordWriteBuffer(ID3D11Buffer* buffer, UINT offset, const void* data, UINT dataSize, bool discard);
+	void RecordFrameEnd() { Push(ECommand::FrameEnd, 0); }
+
+	BYTE* GetLastCommand() { return Stream.data() + LastCommand; }
+
+	// calls visit with every object pointer stored in the command, the pointer can be replaced in place
+	static void VisitObjects(ECommand type, BYTE* payload, const std::function<void(void*& object, EObjectKind kind, UINT stage)>& visit);
+
+	friend class SfContext;
+	friend class SfConstantRing;
+	friend class SfGeometryRing;
+	friend class SfFrameCapture;
+	friend class SfTraceReplayer;
+
+public:
+
+	SfCommandBuffer(class SfInstance& instance);
+
+	// drops every recorded command, the memory is kept for the next recording
+	void Reset();
+
+	// preallocate room for the expected number of bytes per recording
+	void Reserve(UINT bytes) { Stream.reserve(bytes); }
+
+	UINT GetNumCommands() const { return NumCommands; }
+	UINT GetSize() const { return (UINT)Stream.size(); }
+	bool IsEmpty() const { return NumCommands == 0; }
+
+	// sends every recorded command to the context in order
+	// with timings set every command is timed and counted, which costs two clock reads per command
+	void Replay(class SfContext& context, SfCommandTimings* timings = nullptr) const;
+
+	static const char* GetCommandName(UINT type);
+
+	// same meaning as the SfContext functions of the same name
+
+	void BindPipelineState(const SfPipelineState& state);
+	void BindShaderProgram(const class SfShaderProgram& program);
+	void BindComputeShader(const struct SfShader_Compute& shader);
+
+	void BindSampler(const class SfSamplerState& sampler, UINT slot, EShaderStage shaderStages);
+	void BindSamplers(const class SfSamplerState* samplers, UINT startSlot, EShaderStage shaderStages, UINT count = 1);
+
+	void BindTexture(const class SfTexture* tex, UINT slot, EShaderStage stage = EShaderStage::Pixel);
+	void BindShaderResource(const class SfResource* resource, UINT slot = -1, EShaderStage stage = EShaderStage::None);
+	void BindShaderResources(const class SfResource** resources, UINT count, UINT startSlot, EShaderStage stage);
+
+	void BindConstantBuffer(const SfBuffer_Constant& buffer, UINT slot = -1, EShaderStage stage = EShaderStage::None);
+	void BindConstantAllocation(const SfConstantAllocation& alloc, UINT slot, EShaderStage stage);
+
+	void SetUAVsForCS(const class SfResource** views, UINT count, UINT startSlot);
+
+	void BindRenderTarget(const class SfRenderTarget& target, const SfDepthBuffer& depth = SF_NULL);
+	void BindRenderTargets(const class SfRenderTarget* targets, UINT count, const SfDepthBuffer& depth = SF_NULL);
+
+	void BindVertexBuffer(const SfBuffer_Vertex& buffer, const SfBuffer_Instance& instanceBuffer = SF_NULL);
+	void BindIndexBuffer(const SfBuffer_Index& buffer);
+	void BindTransientGeometry(const SfTransientGeometry& geometry);
+
+	void SetCullAndFillMode(ECullMode cull, EFillMode fill);
+	void BindRasterizer(const SfRasterizer& rasterizer);
+	void SetDepthBufferState(EDepthState state);
+	void SetDepthStencilState(const SfDepthStencilState& state, UINT stencilRef = 0);
+	void BindBlendState(const class SfBlendState& state, float factorR = 1, float factorG = 1, float factorB = 1, float factorA = 1, UINT sampleMask = 0xFFFFFFFF);
+	void ClearBlendState();
+	void SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology);
+	void SetViewport(float width, float height, float topLeftX = 0, float topLeftY = 0, float minDepth = 0, float maxDepth = 1);
+	void SetScissorRect(LONG left, LONG top, LONG right, LONG bottom);
+
+	void ClearRenderTarget(const class SfRenderTarget& target, float r, float g, float b, float a);
+	void ClearDepthBuffer(const SfDepthBuffer& buffer, float depthClear = 1, UINT8 stencilClear = 0);
+
+	// the data is copied into the command buffer, the source can be freed right after recording
+	void UpdateResource(const class SfResource* buffer, const void* data, UINT dataSize, UINT bufferOffset, EUpdateMode mode = EUpdateMode::Discard);
+	void UpdateConstantBuffer(const SfBuffer_Constant& buffer, const void* data, UINT bufferOffset = 0, UINT dataSize = 0, EUpdateMode mode = EUpdateMode::Discard);
+	void CopyResource(const class SfResource& dst, const class SfResource& src);
+
+	void Draw(UINT vertexCount, UINT vertexStart);
+	void DrawIndexed(UINT indexCount, UINT indexStart, int baseVertexLocation);
+	void DrawInstanced(UINT vertexCountPerInstance, UINT instanceCount, UINT startVertex, UINT startInstance);
+	void DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndex, int baseVertex, UINT startInstance);
+	void Dispatch(UINT countX, UINT countY, UINT countZ);
+};
+
+}
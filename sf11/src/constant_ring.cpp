@@ -0,0 +1,112 @@
+#include "constant_ring.h"
+#include "instance.h"
+#include "context.h"
+#include "sfassert.h"
+
+namespace sf11
+{
+
+SfConstantRing::SfConstantRing(SfInstance* instance, UINT size)
+	: Data(std::make_shared<ConstantRingData>())
+{
+	const D3D11_FEATURE_DATA_D3D11_OPTIONS& options = instance->GetOptions();
+	sfAssert(options.ConstantBufferOffsetting, "constant ring requires d3d 11.1 constant buffer offsetting");
+	sfAssert(options.MapNoOverwriteOnDynamicConstantBuffer, "constant ring requires no overwrite maps on constant buffers");
+
+	size = (size + SF_CONSTANT_RING_ALIGNMENT - 1) & ~(SF_CONSTANT_RING_ALIGNMENT - 1);
+
+	Data->Instance = instance;
+	Data->Size = size;
+
+	D3D11_BUFFER_DESC desc;
+	ZeroMemory(&desc, sizeof(D3D11_BUFFER_DESC));
+	desc.ByteWidth = size;
+	desc.Usage = D3D11_USAGE_DYNAMIC;
+	desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+	sfAssertHR(instance->GetDevice()->CreateBuffer(&desc, NULL, &Data->Buffer), "could not create constant ring");
+}
+
+void SfConstantRing::Map(SfContext& context)
+{
+	SF_VALIDATE(!Data->Mapped, "constant ring is already mapped");
+	SF_VALIDATE(context.GetInstance() == Data->Instance, "cannot map constant ring on a context from another instance");
+
+	D3D11_MAP type = D3D11_MAP_WRITE_NO_OVERWRITE;
+	if (Data->WrapPending)
+	{
+		type = D3D11_MAP_WRITE_DISCARD;
+		Data->Head = 0;
+		Data->FrameStart = 0;
+		Data->WrapPending = false;
+	}
+
+	D3D11_MAPPED_SUBRESOURCE mapped;
+	context.Data->Stats.Maps++;
+	sfAssertHR(context.Data->Context->Map(Data->Buffer.Get(), 0, type, 0, &mapped), "could not map constant ring");
+
+	Data->Mapped = (BYTE*)mapped.pData;
+	Data->MappedContext = context.Data->Context.Get();
+	Data->MapStart = Data->Head;
+	Data->MapDiscard = type == D3D11_MAP_WRITE_DISCARD;
+	Data->Stats.Maps++;
+}
+
+void SfConstantRing::Unmap(SfContext& context)
+{
+	SF_VALIDATE(Data->Mapped, "constant ring is not mapped");
+	SF_VALIDATE(Data->MappedContext == context.Data->Context.Get(), "constant ring must be unmapped on the context that mapped it");
+
+	if (Data->Head > Data->MapStart)
+	{
+		context.CaptureCall([&](SfCommandBuffer& capture)
+		{
+			capture.RecordWriteBuffer(Data->Buffer.Get(), Data->MapStart, Data->Mapped + Data->MapStart, Data->Head - Data->MapStart, Data->MapDiscard);
+		});
+	}
+
+	context.Data->Stats.Unmaps++;
+	context.Data->Context->Unmap(Data->Buffer.Get(), 0);
+	Data->Mapped = nullptr;
+	Data->MappedContext = nullptr;
+}
+
+SfConstantAllocation SfConstantRing::Allocate(UINT size)
+{
+	SF_VALIDATE(Data->Mapped, "constant ring must be mapped before allocating");
+	SF_CHECK(size > 0 && size <= D3D11_REQ_CONSTANT_BUFFER_ELEMENT_COUNT * 16, "constant allocation must be between 1 and 65536 bytes");
+
+	const UINT aligned = (size + SF_CONSTANT_RING_ALIGNMENT - 1) & ~(SF_CONSTANT_RING_ALIGNMENT - 1);
+
+	// wrapping here would hand out memory still referenced by draws recorded earlier this frame
+	sfAssert(Data->Head + aligned <= Data->Size, "constant ring is too small for one frame of constants");
+
+	SfConstantAllocation alloc;
+	alloc.Data = Data->Mapped + Data->Head;
+	alloc.Buffer = Data->Buffer.Get();
+	alloc.FirstConstant = Data->Head / 16;
+	alloc.NumConstants = aligned / 16;
+
+	Data->Head += aligned;
+	Data->Stats.Allocations++;
+	return alloc;
+}
+
+void SfConstantRing::NextFrame()
+{
+	SF_VALIDATE(!Data->Mapped, "constant ring must be unmapped before the frame ends");
+
+	Data->LastFrameSize = Data->Head - Data->FrameStart;
+	Data->Stats.BytesThisFrame = Data->LastFrameSize;
+	Data->FrameStart = Data->Head;
+
+	// assume the next frame needs as much as this one, start over before running out
+	if (Data->Head + Data->LastFrameSize > Data->Size)
+	{
+		Data->WrapPending = true;
+		Data->Stats.Wraps++;
+	}
+}
+
+}
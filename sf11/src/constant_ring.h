@@ -0,0 +1,102 @@
+#pragma once
+
+#include "d3d11_include.h"
+
+namespace sf11
+{
+
+// constant buffer windows are placed on 256 byte (16 constant) boundaries
+constexpr UINT SF_CONSTANT_RING_ALIGNMENT = 256;
+
+// a window into a constant ring, bind it with SfContext::BindConstantAllocation
+struct SfConstantAllocation
+{
+	// write the constants here, only valid until the ring is unmapped
+	void* Data = nullptr;
+
+	ID3D11Buffer* Buffer = nullptr;
+	UINT FirstConstant = 0;
+	UINT NumConstants = 0;
+
+	operator bool() const { return Buffer != nullptr; }
+};
+
+struct SfConstantRingStats
+{
+	UINT64 Maps = 0;
+	UINT64 Allocations = 0;
+	UINT64 Wraps = 0;
+	UINT BytesThisFrame = 0;
+};
+
+// one large dynamic constant buffer that per draw constants are suballocated from
+// usage per frame:
+//   ring.Map(context)
+//   allocate and fill every window needed for the frame
+//   ring.Unmap(context)
+//   draw, binding each window with SfContext::BindConstantAllocation
+//   ring.NextFrame()
+// windows are written with MAP_WRITE_NO_OVERWRITE and never reused within a frame
+// the ring only wraps at NextFrame, the wrapping map uses MAP_WRITE_DISCARD so the gpu keeps the old contents
+// requires d3d 11.1 constant buffer offsetting, the size should cover a few frames worth of constants
+class SfConstantRing
+{
+	friend class SfInstance;
+	friend class SfContext;
+
+	struct ConstantRingData
+	{
+		class SfInstance* Instance = nullptr;
+		ComPtr<ID3D11Buffer> Buffer;
+		UINT Size = 0;
+
+		// next free byte and where the current frame started
+		UINT Head = 0;
+		UINT FrameStart = 0;
+		UINT LastFrameSize = 0;
+
+		// the next map starts over at the front of the buffer
+		bool WrapPending = true;
+
+		BYTE* Mapped = nullptr;
+		ID3D11DeviceContext* MappedContext = nullptr;
+
+		// where the current map started and how, frame captures record the written range at unmap
+		UINT MapStart = 0;
+		bool MapDiscard = false;
+
+		SfConstantRingStats Stats;
+	};
+
+	std::shared_ptr<ConstantRingData> Data;
+
+	SfConstantRing(class SfInstance* instance, UINT size);
+
+public:
+
+	// maps the ring on the given context, every allocation must happen while mapped
+	void Map(class SfContext& context);
+	void Unmap(class SfContext& context);
+
+	// returns a 256 byte aligned window of at least size bytes
+	SfConstantAllocation Allocate(UINT size);
+
+	// allocates a window and copies the value into it
+	template <typename T>
+	SfConstantAllocation Push(const T& value)
+	{
+		SfConstantAllocation alloc = Allocate(sizeof(T));
+		memcpy(alloc.Data, &value, sizeof(T));
+		return alloc;
+	}
+
+	// marks the end of a frame, the space used by older frames becomes reusable once the ring wraps
+	void NextFrame();
+
+	UINT GetSize() const { return Data->Size; }
+	const SfConstantRingStats& GetStats() const { return Data->Stats; }
+
+	SF_DEF_OPERATORS_AND_DEFAULT(SfConstantRing)
+};
+
+}
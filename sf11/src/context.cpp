@@ -4,80 +4,527 @@
 #include "depth_buffer.h"
 #include "render_target.h"
 #include "buffer.h"
+#include "frame_arena.h"
 
 namespace sf11
 {
 
+// assigns the value to the cached slot, returns true if it was different
+template <typename T>
+static bool UpdateCached(T& cached, const T& value)
+{
+	if (cached == value) return false;
+	cached = value;
+	return true;
+}
+
+// compares [startSlot, startSlot + count) against the cache and copies the new values in
+// first and num receive the smallest sub range that actually changed
+template <typename T>
+static bool UpdateCachedRange(T** cached, T* const* values, UINT startSlot, UINT count, UINT& first, UINT& num)
+{
+	first = count;
+	UINT last = 0;
+	for (UINT i = 0; i < count; i++)
+	{
+		if (cached[startSlot + i] != values[i])
+		{
+			cached[startSlot + i] = values[i];
+			if (first == count) first = i;
+			last = i;
+		}
+	}
+
+	if (first == count)
+	{
+		// nothing changed, report the full range in case the cache is disabled
+		first = 0;
+		num = count;
+		return false;
+	}
+
+	num = last - first + 1;
+	return true;
+}
+
+UINT64 SfContext::GetResourceBytes(const SfResource::ResourceData& res)
+{
+	if (res.Buffer) return res.Buffer->BufferDesc.ByteWidth;
+
+	const TextureParams1D& params = res.Texture->Params;
+
+	// packed formats already report the size of a whole texel
+	const SfFormat& format = params.TextureFormat;
+	const bool packed = format.Type == SfFormat::UNorm8BGRA || format.Type == SfFormat::Float11;
+	const UINT64 texelSize = format.GetTypeSize() * (packed || format.Channels == 0 ? 1 : format.Channels);
+
+	const UINT64 height = res.Texture->Height ? res.Texture->Height : 1;
+	const UINT64 depth = res.Texture->Depth ? res.Texture->Depth : 1;
+	return texelSize * res.Texture->Width * height * depth;
+}
+
+static void StageSetShaderResources(ID3D11DeviceContext* context, UINT stage, UINT startSlot, UINT count, ID3D11ShaderResourceView* const* views)
+{
+	switch (stage)
+	{
+		case 0: context->VSSetShaderResources(startSlot, count, views); break;
+		case 1: context->PSSetShaderResources(startSlot, count, views); break;
+		case 2: context->HSSetShaderResources(startSlot, count, views); break;
+		case 3: context->DSSetShaderResources(startSlot, count, views); break;
+		case 4: context->GSSetShaderResources(startSlot, count, views); break;
+		case 5: context->CSSetShaderResources(startSlot, count, views); break;
+	}
+}
+
+static void StageSetSamplers(ID3D11DeviceContext* context, UINT stage, UINT startSlot, UINT count, ID3D11SamplerState* const* samplers)
+{
+	switch (stage)
+	{
+		case 0: context->VSSetSamplers(startSlot, count, samplers); break;
+		case 1: context->PSSetSamplers(startSlot, count, samplers); break;
+		case 2: context->HSSetSamplers(startSlot, count, samplers); break;
+		case 3: context->DSSetSamplers(startSlot, count, samplers); break;
+		case 4: context->GSSetSamplers(startSlot, count, samplers); break;
+		case 5: context->CSSetSamplers(startSlot, count, samplers); break;
+	}
+}
+
+static void StageSetConstantBuffers(ID3D11DeviceContext* context, UINT stage, UINT startSlot, UINT count, ID3D11Buffer* const* buffers)
+{
+	switch (stage)
+	{
+		case 0: context->VSSetConstantBuffers(startSlot, count, buffers); break;
+		case 1: context->PSSetConstantBuffers(startSlot, count, buffers); break;
+		case 2: context->HSSetConstantBuffers(startSlot, count, buffers); break;
+		case 3: context->DSSetConstantBuffers(startSlot, count, buffers); break;
+		case 4: context->GSSetConstantBuffers(startSlot, count, buffers); break;
+		case 5: context->CSSetConstantBuffers(startSlot, count, buffers); break;
+	}
+}
+
+static void StageSetConstantBuffers1(ID3D11DeviceContext1* context, UINT stage, UINT startSlot, UINT count, 
+	ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants)
+{
+	switch (stage)
+	{
+		case 0: context->VSSetConstantBuffers1(startSlot, count, buffers, firstConstants, numConstants); break;
+		case 1: context->PSSetConstantBuffers1(startSlot, count, buffers, firstConstants, numConstants); break;
+		case 2: context->HSSetConstantBuffers1(startSlot, count, buffers, firstConstants, numConstants); break;
+		case 3: context->DSSetConstantBuffers1(startSlot, count, buffers, firstConstants, numConstants); break;
+		case 4: context->GSSetConstantBuffers1(startSlot, count, buffers, firstConstants, numConstants); break;
+		case 5: context->CSSetConstantBuffers1(startSlot, count, buffers, firstConstants, numConstants); break;
+	}
+}
+
+bool SfContext::ShouldIssue(bool changed)
+{
+	if (changed || !Data->CacheEnabled)
+	{
+		Data->CacheStats.CallsIssued++;
+		return true;
+	}
+
+	Data->CacheStats.CallsSkipped++;
+	return false;
+}
+
+void SfContext::IssueShaderResources(UINT stage, UINT startSlot, UINT count, ID3D11ShaderResourceView* const* views)
+{
+	UINT first, num;
+	if (!ShouldIssue(UpdateCachedRange(Data->Cache.SRVs[stage], views, startSlot, count, first, num))) return;
+	Data->Stats.ShaderResourceBinds[stage]++;
+	StageSetShaderResources(Data->Context.Get(), stage, startSlot + first, num, views + first);
+}
+
+void SfContext::IssueSamplers(UINT stage, UINT startSlot, UINT count, ID3D11SamplerState* const* samplers)
+{
+	UINT first, num;
+	if (!ShouldIssue(UpdateCachedRange(Data->Cache.Samplers[stage], samplers, startSlot, count, first, num))) return;
+	Data->Stats.SamplerBinds[stage]++;
+	StageSetSamplers(Data->Context.Get(), stage, startSlot + first, num, samplers + first);
+}
+
+void SfContext::IssueConstantBuffers(UINT stage, UINT startSlot, UINT count, ID3D11Buffer* const* buffers, 
+	const UINT* firstConstants, const UINT* numConstants)
+{
+	// same as UpdateCachedRange but a slot also changes when its window moves inside the same buffer
+	SfStateCache& cache = Data->Cache;
+	UINT first = count;
+	UINT last = 0;
+	for (UINT i = 0; i < count; i++)
+	{
+		const UINT slot = startSlot + i;
+		if (cache.CBs[stage][slot] != buffers[i] ||
+			cache.CBFirstConstants[stage][slot] != firstConstants[i] ||
+			cache.CBNumConstants[stage][slot] != numConstants[i])
+		{
+			cache.CBs[stage][slot] = buffers[i];
+			cache.CBFirstConstants[stage][slot] = firstConstants[i];
+			cache.CBNumConstants[stage][slot] = numConstants[i];
+			if (first == count) first = i;
+			last = i;
+		}
+	}
+
+	const bool changed = first != count;
+	if (!changed)
+	{
+		first = 0;
+		last = count - 1;
+	}
+
+	if (!ShouldIssue(changed)) return;
+	Data->Stats.ConstantBufferBinds[stage]++;
+
+	const UINT num = last - first + 1;
+	bool windowed = false;
+	for (UINT i = first; i <= last; i++)
+		windowed |= numConstants[i] != 0;
+
+	if (!windowed)
+	{
+		StageSetConstantBuffers(Data->Context.Get(), stage, startSlot + first, num, buffers + first);
+		return;
+	}
+
+	sfAssert(Data->Context1, "constant buffer offsets require a d3d 11.1 context");
+
+	// whole buffer slots that share the call with windowed ones get the largest window
+	UINT counts[D3D11_COMMONSHADER_CONSTANT_BUFFER_HW_SLOT_COUNT];
+	for (UINT i = 0; i < num; i++)
+		counts[i] = numConstants[first + i] ? numConstants[first + i] : D3D11_REQ_CONSTANT_BUFFER_ELEMENT_COUNT;
+
+	StageSetConstantBuffers1(Data->Context1.Get(), stage, startSlot + first, num, buffers + first, firstConstants + first, counts);
+}
+
+void SfContext::SetShaderResourcesForStages(EShaderStage stages, UINT startSlot, UINT count, ID3D11ShaderResourceView* const* views)
+{
+	if (count == 0) return;
+	CaptureCall([&](SfCommandBuffer& capture) { capture.RecordShaderResources(stages, startSlot, count, views); });
+
+	SfPendingBinds& pending = Data->Pending;
+	for (UINT stage = 0; stage < SF_NUM_SHADER_STAGES; stage++)
+	{
+		if (!(stages.Index & (1 << stage))) continue;
+
+		memcpy(pending.SRVs[stage] + startSlot, views, sizeof(*views) * count);
+		if (Data->CommitAtDraw)
+		{
+			pending.SRVRange[stage].Add(startSlot, count);
+			pending.AnyDirty = true;
+		}
+		else
+		{
+			IssueShaderResources(stage, startSlot, count, views);
+		}
+	}
+}
+
+void SfContext::SetSamplersForStages(EShaderStage stages, UINT startSlot, UINT count, ID3D11SamplerState* const* samplers)
+{
+	if (count == 0) return;
+	CaptureCall([&](SfCommandBuffer& capture) { capture.RecordSamplers(stages, startSlot, count, samplers); });
+
+	SfPendingBinds& pending = Data->Pending;
+	for (UINT stage = 0; stage < SF_NUM_SHADER_STAGES; stage++)
+	{
+		if (!(stages.Index & (1 << stage))) continue;
+
+		memcpy(pending.Samplers[stage] + startSlot, samplers, sizeof(*samplers) * count);
+		if (Data->CommitAtDraw)
+		{
+			pending.SamplerRange[stage].Add(startSlot, count);
+			pending.AnyDirty = true;
+		}
+		else
+		{
+			IssueSamplers(stage, startSlot, count, samplers);
+		}
+	}
+}
+
+void SfContext::SetConstantBuffersForStages(EShaderStage stages, UINT startSlot, UINT count, ID3D11Buffer* const* buffers,
+	const UINT* firstConstants /*= nullptr*/, const UINT* numConstants /*= nullptr*/)
+{
+	if (count == 0) return;
+	CaptureCall([&](SfCommandBuffer& capture) { capture.RecordConstantBuffers(stages, startSlot, count, buffers, firstConstants, numConstants); });
+
+	SfPendingBinds& pending = Data->Pending;
+	for (UINT stage = 0; stage < SF_NUM_SHADER_STAGES; stage++)
+	{
+		if (!(stages.Index & (1 << stage))) continue;
+
+		memcpy(pending.CBs[stage] + startSlot, buffers, sizeof(*buffers) * count);
+		if (firstConstants)
+		{
+			memcpy(pending.CBFirstConstants[stage] + startSlot, firstConstants, sizeof(UINT) * count);
+			memcpy(pending.CBNumConstants[stage] + startSlot, numConstants, sizeof(UINT) * count);
+		}
+		else
+		{
+			memset(pending.CBFirstConstants[stage] + startSlot, 0, sizeof(UINT) * count);
+			memset(pending.CBNumConstants[stage] + startSlot, 0, sizeof(UINT) * count);
+		}
+
+		if (Data->CommitAtDraw)
+		{
+			pending.CBRange[stage].Add(startSlot, count);
+			pending.AnyDirty = true;
+		}
+		else
+		{
+			IssueConstantBuffers(stage, startSlot, count, buffers,
+				pending.CBFirstConstants[stage] + startSlot, pending.CBNumConstants[stage] + startSlot);
+		}
+	}
+}
+
+void SfContext::SetCommitAtDraw(bool enabled)
+{
+	// anything staged so far still has to reach d3d
+	if (!enabled) CommitBinds();
+	Data->CommitAtDraw = enabled;
+}
+
+void SfContext::CommitBinds()
+{
+	SfPendingBinds& pending = Data->Pending;
+	if (!pending.AnyDirty) return;
+
+	for (UINT stage = 0; stage < SF_NUM_SHADER_STAGES; stage++)
+	{
+		SfPendingBinds::SlotRange& srvs = pending.SRVRange[stage];
+		if (srvs.IsDirty())
+		{
+			IssueShaderResources(stage, srvs.Min, srvs.Max - srvs.Min + 1, pending.SRVs[stage] + srvs.Min);
+			srvs.Reset();
+		}
+
+		SfPendingBinds::SlotRange& samplers = pending.SamplerRange[stage];
+		if (samplers.IsDirty())
+		{
+			IssueSamplers(stage, samplers.Min, samplers.Max - samplers.Min + 1, pending.Samplers[stage] + samplers.Min);
+			samplers.Reset();
+		}
+
+		SfPendingBinds::SlotRange& cbs = pending.CBRange[stage];
+		if (cbs.IsDirty())
+		{
+			IssueConstantBuffers(stage, cbs.Min, cbs.Max - cbs.Min + 1, pending.CBs[stage] + cbs.Min,
+				pending.CBFirstConstants[stage] + cbs.Min, pending.CBNumConstants[stage] + cbs.Min);
+			cbs.Reset();
+		}
+	}
+
+	pending.AnyDirty = false;
+}
+
+void SfContext::SetComputeUnorderedAccessViews(UINT startSlot, UINT count, ID3D11UnorderedAccessView* const* views)
+{
+	CaptureCall([&](SfCommandBuffer& capture) { capture.RecordComputeUAVs(startSlot, count, views); });
+
+	UINT first, num;
+	if (!ShouldIssue(UpdateCachedRange(Data->Cache.ComputeUAVs, views, startSlot, count, first, num)))
+		return;
+
+	// UAVs evict the resource from every input and render target slot
+	ID3D11UnorderedAccessView* uavs[D3D11_PS_CS_UAV_REGISTER_COUNT];
+	memcpy(uavs, Data->Cache.ComputeUAVs, sizeof(uavs));
+	Data->Cache.InvalidateInputs();
+	Data->Cache.InvalidateOutputs();
+	memcpy(Data->Cache.ComputeUAVs, uavs, sizeof(uavs));
+
+	Data->Stats.UnorderedAccessBinds++;
+	Data->Context->CSSetUnorderedAccessViews(startSlot + first, num, views + first, nullptr);
+}
+
+void SfContext::SetRenderTargetViews(UINT count, ID3D11RenderTargetView* const* views, ID3D11DepthStencilView* depth)
+{
+	CaptureCall([&](SfCommandBuffer& capture) { capture.RecordRenderTargets(count, views, depth); });
+
+	// d3d unbinds every slot past count
+	bool changed = Data->Cache.DSV != depth;
+	for (UINT i = 0; i < D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT; i++)
+		changed |= Data->Cache.RTVs[i] != (i < count ? views[i] : nullptr);
+
+	if (!ShouldIssue(changed)) return;
+
+	Data->Cache.InvalidateInputs();
+	Data->Cache.InvalidateOutputs();
+	for (UINT i = 0; i < D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT; i++)
+		Data->Cache.RTVs[i] = i < count ? views[i] : nullptr;
+	Data->Cache.DSV = depth;
+
+	Data->Stats.RenderTargetBinds++;
+	Data->Context->OMSetRenderTargets(count, views, depth);
+}
+
+void SfContext::SetVertexBuffers(UINT count, ID3D11Buffer* const* buffers, const UINT* strides, const UINT* offsets)
+{
+	CaptureCall([&](SfCommandBuffer& capture) { capture.RecordVertexBuffers(count, buffers, strides, offsets); });
+
+	bool changed = false;
+	for (UINT i = 0; i < count; i++)
+	{
+		changed |= UpdateCached(Data->Cache.VertexBuffers[i], buffers[i]);
+		changed |= UpdateCached(Data->Cache.VertexStrides[i], strides[i]);
+		changed |= UpdateCached(Data->Cache.VertexOffsets[i], offsets[i]);
+	}
+
+	if (count > 0 && ShouldIssue(changed))
+	{
+		Data->Stats.VertexBufferBinds++;
+		Data->Context->IASetVertexBuffers(0, count, buffers, strides, offsets);
+	}
+}
+
+void SfContext::SetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, UINT offset)
+{
+	CaptureCall([&](SfCommandBuffer& capture) { capture.RecordIndexBuffer(buffer, format, offset); });
+
+	bool changed = UpdateCached(Data->Cache.IndexBuffer, buffer);
+	changed |= UpdateCached(Data->Cache.IndexFormat, format);
+	changed |= UpdateCached(Data->Cache.IndexOffset, offset);
+
+	if (ShouldIssue(changed))
+	{
+		Data->Stats.IndexBufferBinds++;
+		Data->Context->IASetIndexBuffer(buffer, format, offset);
+	}
+}
+
+void SfContext::SetRasterizerState(ID3D11RasterizerState* state)
+{
+	ForgetPipelineState();
+	CaptureCall([&](SfCommandBuffer& capture) { capture.RecordRasterizer(state); });
+	if (ShouldIssue(UpdateCached(Data->Cache.RasterizerState, state)))
+	{
+		Data->Stats.StateChanges++;
+		Data->Context->RSSetState(state);
+	}
+}
+
+void SfContext::SetDepthStencilStateRaw(ID3D11DepthStencilState* state, UINT stencilRef)
+{
+	ForgetPipelineState();
+	CaptureCall([&](SfCommandBuffer& capture) { capture.RecordDepthStencil(state, stencilRef); });
+	bool changed = UpdateCached(Data->Cache.DepthStencilState, state);
+	changed |= UpdateCached(Data->Cache.StencilRef, stencilRef);
+
+	if (ShouldIssue(changed))
+	{
+		Data->Stats.StateChanges++;
+		Data->Context->OMSetDepthStencilState(state, stencilRef);
+	}
+}
+
+void SfContext::SetBlendStateRaw(ID3D11BlendState* state, const FLOAT factor[4], UINT sampleMask)
+{
+	ForgetPipelineState();
+	CaptureCall([&](SfCommandBuffer& capture) { capture.RecordBlend(state, factor, sampleMask); });
+	bool changed = UpdateCached(Data->Cache.BlendState, state);
+	changed |= UpdateCached(Data->Cache.SampleMask, sampleMask);
+	if (memcmp(Data->Cache.BlendFactor, factor, sizeof(Data->Cache.BlendFactor)) != 0)
+	{
+		memcpy(Data->Cache.BlendFactor, factor, sizeof(Data->Cache.BlendFactor));
+		changed = true;
+	}
+
+	if (ShouldIssue(changed))
+	{
+		Data->Stats.StateChanges++;
+		Data->Context->OMSetBlendState(state, factor, sampleMask);
+	}
+}
+
 void SfContext::ClearState()
 {
 	Data->Context->ClearState();
+	Data->Cache.Invalidate();
+	ForgetPipelineState();
+	Data->Pending.Reset();
+}
+
+void SfContext::SetStateCacheEnabled(bool enabled)
+{
+	Data->CacheEnabled = enabled;
+	Data->Cache.Invalidate();
+	ForgetPipelineState();
 }
 
 void SfContext::ExecuteDeferredCommands(class SfContext_Deferred* context, bool clearState /*= true*/)
 {
 	sfAssert(*this == Data->Instance->GetImmediateContext(), "deferred commands must be executed by the immediate context");
 	Data->Context->ExecuteCommandList(context->CommandList.Get(), !clearState);
+
+	// the command list leaves the context either cleared or restored, neither is tracked
+	Data->Cache.Invalidate();
+	ForgetPipelineState();
+
+	// staged binds survive a restore, a cleared context has nothing bound
+	if (clearState) Data->Pending.Reset();
 }
 
 void SfContext::SetCullAndFillMode(ECullMode cull, EFillMode fill)
 {
-	switch (fill)
+	SetRasterizerState(Data->Instance->GetRasterizer(cull, fill).GetState());
+}
+
+void SfContext::BindRasterizer(const SfRasterizer& rasterizer)
+{
+	SetRasterizerState(rasterizer.GetState());
+}
+
+void SfContext::SetScissorRect(LONG left, LONG top, LONG right, LONG bottom)
+{
+	CaptureCall([&](SfCommandBuffer& capture) { capture.SetScissorRect(left, top, right, bottom); });
+
+	D3D11_RECT rect = { left, top, right, bottom };
+	if (ShouldIssue(memcmp(&Data->Cache.ScissorRect, &rect, sizeof(rect)) != 0))
 	{
-		case EFillMode::Solid:
-		{
-			switch (cull)
-			{
-				case ECullMode::CullBack:
-					Data->Context->RSSetState(Data->Instance->RasterSolidCullBack.Data->State.Get());
-					return;
-				case ECullMode::CullFront:
-					Data->Context->RSSetState(Data->Instance->RasterSolidCullFront.Data->State.Get());
-					return;
-				case ECullMode::CullNone:
-					Data->Context->RSSetState(Data->Instance->RasterSolidCullNone.Data->State.Get());
-					return;
-			}
-		}
-		case EFillMode::Wireframe:
-		{
-			switch (cull)
-			{
-				case ECullMode::CullBack:
-					Data->Context->RSSetState(Data->Instance->RasterWireCullBack.Data->State.Get());
-					return;
-				case ECullMode::CullFront:
-					Data->Context->RSSetState(Data->Instance->RasterWireCullFront.Data->State.Get());
-					return;
-				case ECullMode::CullNone:
-					Data->Context->RSSetState(Data->Instance->RasterWireCullNone.Data->State.Get());
-					return;
-			}
-		}
+		Data->Cache.ScissorRect = rect;
+		Data->Stats.StateChanges++;
+		Data->Context->RSSetScissorRects(1, &rect);
 	}
 }
 
 void SfContext::Draw(UINT vertexCount, UINT vertexStart)
 {
+	CaptureCall([&](SfCommandBuffer& capture) { capture.Draw(vertexCount, vertexStart); });
+	if (Data->Pending.AnyDirty) CommitBinds();
+	Data->Stats.Draws++;
 	Data->Context->Draw(vertexCount, vertexStart);
 }
 
 void SfContext::DrawIndexed(UINT indexCount, UINT indexStart, int baseVertexLocation)
 {
+	CaptureCall([&](SfCommandBuffer& capture) { capture.DrawIndexed(indexCount, indexStart, baseVertexLocation); });
+	if (Data->Pending.AnyDirty) CommitBinds();
+	Data->Stats.Draws++;
 	Data->Context->DrawIndexed(indexCount, indexStart, baseVertexLocation);
 }
 
 void SfContext::DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndex, int baseVertex, UINT startInstance)
 {
+	CaptureCall([&](SfCommandBuffer& capture) { capture.DrawIndexedInstanced(indexCountPerInstance, instanceCount, startIndex, baseVertex, startInstance); });
+	if (Data->Pending.AnyDirty) CommitBinds();
+	Data->Stats.Draws++;
 	Data->Context->DrawIndexedInstanced(indexCountPerInstance, instanceCount, startIndex, baseVertex, startInstance);
 }
 
 void SfContext::DrawInstanced(UINT vertexCountPerInstance, UINT instanceCount, UINT startVertex, UINT startInstance)
 {
+	CaptureCall([&](SfCommandBuffer& capture) { capture.DrawInstanced(vertexCountPerInstance, instanceCount, startVertex, startInstance); });
+	if (Data->Pending.AnyDirty) CommitBinds();
+	Data->Stats.Draws++;
 	Data->Context->DrawInstanced(vertexCountPerInstance, instanceCount, startVertex, startInstance);
 }
 
 void SfContext::Dispatch(UINT countX, UINT countY, UINT countZ)
 {
+	CaptureCall([&](SfCommandBuffer& capture) { capture.Dispatch(countX, countY, countZ); });
+	if (Data->Pending.AnyDirty) CommitBinds();
+	Data->Stats.Dispatches++;
 	Data->Context->Dispatch(countX, countY, countZ);
 }
 
@@ -91,45 +538,105 @@ void SfContext::SetUAVsForCS(const SfResource** views, UINT count, UINT startSlo
 	for (UINT i = 0; i < count; i++)
 		Data->ComputeUAVsToBind[i] = views[i] ? views[i]->Data->UnorderedAccess : nullptr;
 
-	Data->Context->CSSetUnorderedAccessViews(startSlot, count, Data->ComputeUAVsToBind, nullptr);
+	SetComputeUnorderedAccessViews(startSlot, count, Data->ComputeUAVsToBind);
+}
+
+void SfContext::SetShaderRaw(UINT stage, ID3D11DeviceChild* shader)
+{
+	CaptureCall([&](SfCommandBuffer& capture) { capture.RecordShader(stage, shader); });
+
+	SfStateCache& cache = Data->Cache;
+	ID3D11DeviceContext* context = Data->Context.Get();
+	switch (stage)
+	{
+		case 0:
+			if (!ShouldIssue(UpdateCached(cache.VertexShader, (ID3D11VertexShader*)shader))) return;
+			context->VSSetShader((ID3D11VertexShader*)shader, nullptr, 0);
+			break;
+		case 1:
+			if (!ShouldIssue(UpdateCached(cache.PixelShader, (ID3D11PixelShader*)shader))) return;
+			context->PSSetShader((ID3D11PixelShader*)shader, nullptr, 0);
+			break;
+		case 2:
+			if (!ShouldIssue(UpdateCached(cache.HullShader, (ID3D11HullShader*)shader))) return;
+			context->HSSetShader((ID3D11HullShader*)shader, nullptr, 0);
+			break;
+		case 3:
+			if (!ShouldIssue(UpdateCached(cache.DomainShader, (ID3D11DomainShader*)shader))) return;
+			context->DSSetShader((ID3D11DomainShader*)shader, nullptr, 0);
+			break;
+		case 4:
+			if (!ShouldIssue(UpdateCached(cache.GeometryShader, (ID3D11GeometryShader*)shader))) return;
+			context->GSSetShader((ID3D11GeometryShader*)shader, nullptr, 0);
+			break;
+		case 5:
+			if (!ShouldIssue(UpdateCached(cache.ComputeShader, (ID3D11ComputeShader*)shader))) return;
+			context->CSSetShader((ID3D11ComputeShader*)shader, nullptr, 0);
+			break;
+	}
+	Data->Stats.ShaderBinds[stage]++;
+}
+
+void SfContext::SetInputLayoutRaw(ID3D11InputLayout* layout)
+{
+	CaptureCall([&](SfCommandBuffer& capture) { capture.RecordInputLayout(layout); });
+	if (ShouldIssue(UpdateCached(Data->Cache.InputLayout, layout)))
+	{
+		Data->Stats.InputLayoutBinds++;
+		Data->Context->IASetInputLayout(layout);
+	}
+}
+
+void SfContext::SetTopologyRaw(D3D11_PRIMITIVE_TOPOLOGY topology)
+{
+	CaptureCall([&](SfCommandBuffer& capture) { capture.SetPrimitiveTopology(topology); });
+	if (ShouldIssue(UpdateCached(Data->Cache.Topology, topology)))
+	{
+		Data->Stats.StateChanges++;
+		Data->Context->IASetPrimitiveTopology(topology);
+	}
 }
 
 void SfContext::BindVertexShader(const struct SfShader_Vertex& shader)
 {
-	sfAssert(shader.GetInstance() == Data->Instance, "cannot bind shader belonging to another instance");
-	Data->Context->VSSetShader(shader.GetShader(), nullptr, 0);
-	if (shader.GetInputLayout())
-		Data->Context->IASetInputLayout(shader.GetInputLayout());
+	ForgetPipelineState();
+	SF_VALIDATE(shader.GetInstance() == Data->Instance, "cannot bind shader belonging to another instance");
+	SetShaderRaw(0, shader.GetShader());
+	if (shader.GetInputLayout()) SetInputLayoutRaw(shader.GetInputLayout());
 }
 
 void SfContext::BindHullShader(const struct SfShader_Hull& shader)
 {
-	sfAssert(shader.GetInstance() == Data->Instance, "cannot bind shader belonging to another instance");
-	Data->Context->HSSetShader(shader.GetShader(), nullptr, 0);
+	ForgetPipelineState();
+	SF_VALIDATE(shader.GetInstance() == Data->Instance, "cannot bind shader belonging to another instance");
+	SetShaderRaw(2, shader.GetShader());
 }
 
 void SfContext::BindDomainShader(const struct SfShader_Domain& shader)
 {
-	sfAssert(shader.GetInstance() == Data->Instance, "cannot bind shader belonging to another instance");
-	Data->Context->DSSetShader(shader.GetShader(), nullptr, 0);
+	ForgetPipelineState();
+	SF_VALIDATE(shader.GetInstance() == Data->Instance, "cannot bind shader belonging to another instance");
+	SetShaderRaw(3, shader.GetShader());
 }
 
 void SfContext::BindGeometryShader(const struct SfShader_Geometry& shader)
 {
-	sfAssert(shader.GetInstance() == Data->Instance, "cannot bind shader belonging to another instance");
-	Data->Context->GSSetShader(shader.GetShader(), nullptr, 0);
+	ForgetPipelineState();
+	SF_VALIDATE(shader.GetInstance() == Data->Instance, "cannot bind shader belonging to another instance");
+	SetShaderRaw(4, shader.GetShader());
 }
 
 void SfContext::BindPixelShader(const struct SfShader_Pixel& shader)
 {
-	sfAssert(shader.GetInstance() == Data->Instance, "cannot bind shader belonging to another instance");
-	Data->Context->PSSetShader(shader.GetShader(), nullptr, 0);
+	ForgetPipelineState();
+	SF_VALIDATE(shader.GetInstance() == Data->Instance, "cannot bind shader belonging to another instance");
+	SetShaderRaw(1, shader.GetShader());
 }
 
 void SfContext::BindComputeShader(const SfShader_Compute& shader)
 {
-	sfAssert(shader.GetInstance() == Data->Instance, "cannot bind shader belonging to another instance");
-	Data->Context->CSSetShader(shader.GetShader(), nullptr, 0);
+	SF_VALIDATE(shader.GetInstance() == Data->Instance, "cannot bind shader belonging to another instance");
+	SetShaderRaw(5, shader.GetShader());
 }
 
 void SfContext::BindShaderProgram(const class SfShaderProgram& program)
@@ -146,6 +653,40 @@ void SfContext::BindShaderProgram(const class SfShaderProgram& program)
 	BindPixelShader(program.GetPixelShader());
 }
 
+void SfContext::ApplyPipelineKey(const SfPipelineState::PipelineKey& key)
+{
+	// sub-states are still checked against the state cache since piecemeal binds may have run before this
+	SetShaderRaw(0, key.VertexShader);
+	if (key.InputLayout) SetInputLayoutRaw(key.InputLayout);
+	SetShaderRaw(2, key.HullShader);
+	SetShaderRaw(3, key.DomainShader);
+	SetShaderRaw(4, key.GeometryShader);
+	SetShaderRaw(1, key.PixelShader);
+	SetBlendStateRaw(key.BlendState, key.BlendFactor, key.SampleMask);
+	SetDepthStencilStateRaw(key.DepthStencilState, key.StencilRef);
+	SetRasterizerState(key.RasterizerState);
+	SetTopologyRaw(key.Topology);
+}
+
+void SfContext::BindPipelineState(const SfPipelineState& state)
+{
+	SF_VALIDATE(state.Data->Instance == Data->Instance, "cannot bind pipeline state belonging to another instance");
+
+	// fast path, the same object is still bound
+	if (Data->CacheEnabled && Data->BoundPipeline.Data == state.Data)
+		return;
+
+	// a separately created pipeline with identical contents needs no d3d calls either
+	if (Data->CacheEnabled && Data->BoundPipeline && Data->BoundPipeline.IsEquivalent(state))
+	{
+		Data->BoundPipeline = state;
+		return;
+	}
+
+	ApplyPipelineKey(state.Data->Key);
+	Data->BoundPipeline = state;
+}
+
 void SfContext::BindSampler(const SfSamplerState& sampler, UINT slot, EShaderStage shaderStages)
 {
 	BindSamplers(&sampler, slot, shaderStages, 1);
@@ -153,22 +694,11 @@ void SfContext::BindSampler(const SfSamplerState& sampler, UINT slot, EShaderSta
 
 void SfContext::BindSamplers(const SfSamplerState* samplers, UINT startSlot, EShaderStage shaderStages, UINT count /*= 1*/)
 {
-	sfAssert(startSlot + count <= D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT , "cannot bind samplers over slot 16");
+	SF_CHECK(startSlot + count <= D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT , "cannot bind samplers over slot 16");
 	for (UINT i = 0; i < count; i++)
 		Data->SamplersToBind[i] = samplers[i].Data->State.Get();
 
-	if (shaderStages & EShaderStage::Vertex)
-		Data->Context->VSSetSamplers(startSlot, count, Data->SamplersToBind);
-	if (shaderStages & EShaderStage::Pixel)
-		Data->Context->PSSetSamplers(startSlot, count, Data->SamplersToBind);
-	if (shaderStages & EShaderStage::Hull)
-		Data->Context->HSSetSamplers(startSlot, count, Data->SamplersToBind);
-	if (shaderStages & EShaderStage::Domain)
-		Data->Context->DSSetSamplers(startSlot, count, Data->SamplersToBind);
-	if (shaderStages & EShaderStage::Geometry)
-		Data->Context->GSSetSamplers(startSlot, count, Data->SamplersToBind);
-	if (shaderStages & EShaderStage::Compute)
-		Data->Context->CSSetSamplers(startSlot, count, Data->SamplersToBind);
+	SetSamplersForStages(shaderStages, startSlot, count, Data->SamplersToBind);
 }
 
 void SfContext::BindSamplers(std::vector<class SfSamplerState>& samplers, UINT startSlot, EShaderStage shaderStages)
@@ -180,11 +710,12 @@ void SfContext::BindBackBuffer(const SfDepthBuffer& depthBuffer /*= SF_NULL*/, c
 {
 	const SfWindow& win = window ? window : Data->Instance->Window;
 
+	sfAssert(win, "there is no back buffer without a window, null devices render into render targets only");
 	sfAssert(win.Data->Instance == Data->Instance, 
 		"cannot draw to window that does not belong to this instance");
 
-	Data->Context->OMSetRenderTargets(1, win.Data->BackBuffer.Data->Texture.RenderTargetView.GetAddressOf(), 
-		depthBuffer ? depthBuffer.Data->Texture.DepthStencilView.Get() : nullptr);
+	SetRenderTargetViews(1, win.Data->BackBuffer.Data->Texture->RenderTargetView.GetAddressOf(), 
+		depthBuffer ? depthBuffer.Data->Texture->DepthStencilView.Get() : nullptr);
 }
 
 void SfContext::BindTexture1D(const SfTexture1D& tex, UINT slot, EShaderStage stage /*= EShaderStage::Pixel*/)
@@ -205,37 +736,37 @@ void SfContext::BindTexture3D(const SfTexture3D& tex, UINT slot, EShaderStage st
 void SfContext::ClearRenderTarget(const SfRenderTarget& target, float r, float g, float b, float a)
 {
 	float c[] = { r, g, b, a };
-	Data->Context->ClearRenderTargetView(target.Data->Texture.RenderTargetView.Get(), c);
+	ClearRenderTargetRaw(target.Data->Texture->RenderTargetView.Get(), c);
+}
+
+void SfContext::ClearRenderTargetRaw(ID3D11RenderTargetView* view, const FLOAT color[4])
+{
+	CaptureCall([&](SfCommandBuffer& capture) { capture.RecordClearRenderTarget(view, color); });
+	Data->Stats.Clears++;
+	Data->Context->ClearRenderTargetView(view, color);
 }
 
 void SfContext::SetDepthBufferState(EDepthState state)
 {
-	switch (state)
-	{
-		case EDepthState::ReadWrite:
-			Data->Context->OMSetDepthStencilState(Data->Instance->DepthReadWrite.Get(), 0);
-			break;
-		case EDepthState::ReadOnly:
-			Data->Context->OMSetDepthStencilState(Data->Instance->DepthReadOnly.Get(), 0);
-			break;
-		case EDepthState::WriteOnly:
-			Data->Context->OMSetDepthStencilState(Data->Instance->DepthWriteOnly.Get(), 0);
-			break;
-		case EDepthState::Disabled:
-			Data->Context->OMSetDepthStencilState(Data->Instance->DepthDisabled.Get(), 0);
-			break;	
-	}
+	SetDepthStencilStateRaw(Data->Instance->GetDepthState(state), 0);
 }
 
 void SfContext::SetDepthStencilState(const SfDepthStencilState& state, UINT stencilRef /*= 0*/)
 {
-	sfAssert(state.Data->Instance == Data->Instance, "cannot use depth stencil state from another instance");
-	Data->Context->OMSetDepthStencilState(state.Data->State.Get(), stencilRef);
+	SF_VALIDATE(state.Data->Instance == Data->Instance, "cannot use depth stencil state from another instance");
+	SetDepthStencilStateRaw(state.Data->State.Get(), stencilRef);
 }
 
 void SfContext::ClearDepthBuffer(const SfDepthBuffer& buffer, float depthClear, UINT8 stencilClear)
 {
-	Data->Context->ClearDepthStencilView(buffer.Data->Texture.DepthStencilView.Get(), 
+	ClearDepthStencilRaw(buffer.Data->Texture->DepthStencilView.Get(), depthClear, stencilClear);
+}
+
+void SfContext::ClearDepthStencilRaw(ID3D11DepthStencilView* view, float depthClear, UINT8 stencilClear)
+{
+	CaptureCall([&](SfCommandBuffer& capture) { capture.RecordClearDepth(view, depthClear, stencilClear); });
+	Data->Stats.Clears++;
+	Data->Context->ClearDepthStencilView(view, 
 		D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 
 		depthClear, 
 		stencilClear);
@@ -243,18 +774,21 @@ void SfContext::ClearDepthBuffer(const SfDepthBuffer& buffer, float depthClear,
 
 void SfContext::SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology)
 {
-	Data->Context->IASetPrimitiveTopology(topology);
+	ForgetPipelineState();
+	SetTopologyRaw(topology);
 }
 
 void SfContext::BindBlendState(const SfBlendState& state, float factorR, float factorG, float factorB, float factorA, UINT sampleMask /*= 0xFFFFFFFF*/)
 {
 	float factor[] = { factorR, factorG, factorB, factorA };
-	Data->Context->OMSetBlendState(state.Data->State.Get(), factor, sampleMask);
+	SetBlendStateRaw(state.Data->State.Get(), factor, sampleMask);
 }
 
 void SfContext::ClearBlendState()
 {
-	Data->Context->OMSetBlendState(0, 0, 0xFFFFFFFF);
+	// a null blend factor is treated as all ones by d3d
+	const FLOAT factor[] = { 1, 1, 1, 1 };
+	SetBlendStateRaw(nullptr, factor, 0xFFFFFFFF);
 }
 
 void SfContext::SetViewport(float width, float height, float topLeftX /*= 0*/, float topLeftY /*= 0*/, float minDepth /*= 0*/, float maxDepth /*= 1*/)
@@ -268,7 +802,14 @@ void SfContext::SetViewport(float width, float height, float topLeftX /*= 0*/, f
 		.MinDepth = minDepth,
 		.MaxDepth = maxDepth,
 	};
-	Data->Context->RSSetViewports(1, &view);
+	CaptureCall([&](SfCommandBuffer& capture) { capture.SetViewport(width, height, topLeftX, topLeftY, minDepth, maxDepth); });
+
+	if (ShouldIssue(memcmp(&Data->Cache.Viewport, &view, sizeof(view)) != 0))
+	{
+		Data->Cache.Viewport = view;
+		Data->Stats.StateChanges++;
+		Data->Context->RSSetViewports(1, &view);
+	}
 }
 
 void SfContext::BindVertexBuffer(const SfBuffer_Vertex& buffer, const SfBuffer_Instance& instanceBuffer /*= SF_NULL*/)
@@ -283,23 +824,23 @@ void SfContext::BindVertexBuffer(const SfBuffer_Vertex& buffer, const SfBuffer_I
 				UINT stride[] = { buffer.GetTypeSize(), instanceBuffer.GetTypeSize() };
 				ID3D11Buffer* buffs[] = 
 				{ 
-					buffer.Data->Buffer.Buffer.Get(),
-					instanceBuffer.Data->Buffer.Buffer.Get() 
+					buffer.Data->Buffer->Buffer.Get(),
+					instanceBuffer.Data->Buffer->Buffer.Get() 
 				};
-				Data->Context->IASetVertexBuffers(0, 2, buffs, stride, offset);
+				SetVertexBuffers(2, buffs, stride, offset);
 			}
 			else
 			{
 				UINT offset = 0;
 				UINT stride = buffer.GetTypeSize();
-				Data->Context->IASetVertexBuffers(0, 1, (ID3D11Buffer* const*)buffer.Data->Buffer.Buffer.GetAddressOf(), &stride, &offset);
+				SetVertexBuffers(1, (ID3D11Buffer* const*)buffer.Data->Buffer->Buffer.GetAddressOf(), &stride, &offset);
 			}
 		}
 
 		SfBuffer_Index ib = buffer.GetLinkedIndexBuffer();
 		if (ib && ib.GetNumElements() > 0)
 		{
-			Data->Context->IASetIndexBuffer(ib.Data->Buffer.Buffer.Get(), ib.Data->Buffer.IndexFormat, 0);
+			SetIndexBuffer(ib.Data->Buffer->Buffer.Get(), ib.Data->Buffer->IndexFormat, 0);
 		}
 
 		return;
@@ -313,10 +854,20 @@ void SfContext::BindIndexBuffer(const class SfBuffer_Index& buffer)
 {
 	if (buffer)
 	{
-		Data->Context->IASetIndexBuffer(buffer.Data->Buffer.Buffer.Get(), buffer.Data->Buffer.IndexFormat, 0);
+		SetIndexBuffer(buffer.Data->Buffer->Buffer.Get(), buffer.Data->Buffer->IndexFormat, 0);
 		return;
 	}
-	Data->Context->IASetIndexBuffer(nullptr, (DXGI_FORMAT)0, 0);
+	SetIndexBuffer(nullptr, (DXGI_FORMAT)0, 0);
+}
+
+void SfContext::BindTransientGeometry(const SfTransientGeometry& geometry)
+{
+	SF_CHECK(geometry, "cannot bind empty transient geometry");
+
+	const UINT offset = 0;
+	SetVertexBuffers(1, &geometry.VertexBuffer, &geometry.VertexStride, &offset);
+	if (geometry.IndexBuffer)
+		SetIndexBuffer(geometry.IndexBuffer, geometry.IndexFormat, 0);
 }
 
 void SfContext::BindStructuredBuffer(const SfBuffer_Structured& buffer, UINT slot /*= -1*/, EShaderStage stage /*= EShaderStage::None*/)
@@ -338,7 +889,7 @@ void SfContext::BindConstantBuffer(const SfBuffer_Constant& buffer, UINT slot /*
 	}
 	else
 	{
-		sfAssert(slot != -1 && (stage & EShaderStage::All), 
+		SF_CHECK(slot != -1 && (stage & EShaderStage::All), 
 			"cannot use default slot or shader stage when binding a null constant buffer");
 	}
 	BindConstantBuffers(&buffer, 1, slot, stage);
@@ -346,22 +897,18 @@ void SfContext::BindConstantBuffer(const SfBuffer_Constant& buffer, UINT slot /*
 
 void SfContext::BindConstantBuffers(const SfBuffer_Constant* buffers, UINT numBuffers, UINT startSlot, EShaderStage stage)
 {
-	sfAssert(startSlot + numBuffers <= D3D11_COMMONSHADER_CONSTANT_BUFFER_HW_SLOT_COUNT , "cannot bind constant buffers over slot 15");
+	SF_CHECK(startSlot + numBuffers <= D3D11_COMMONSHADER_CONSTANT_BUFFER_HW_SLOT_COUNT , "cannot bind constant buffers over slot 15");
 	for (UINT i = 0; i < numBuffers; i++)
-		Data->CBsToBind[i] = (buffers + i) ? buffers[i].Data->Buffer.Buffer.Get() : nullptr;
-
-	if (stage & EShaderStage::Pixel) 
-		Data->Context->PSSetConstantBuffers(startSlot, numBuffers, Data->CBsToBind);
-	if (stage & EShaderStage::Vertex) 
-		Data->Context->VSSetConstantBuffers(startSlot, numBuffers, Data->CBsToBind);
-	if (stage & EShaderStage::Hull) 
-		Data->Context->HSSetConstantBuffers(startSlot, numBuffers, Data->CBsToBind);
-	if (stage & EShaderStage::Domain) 
-		Data->Context->DSSetConstantBuffers(startSlot, numBuffers, Data->CBsToBind);
-	if (stage & EShaderStage::Geometry) 
-		Data->Context->GSSetConstantBuffers(startSlot, numBuffers, Data->CBsToBind);
-	if (stage & EShaderStage::Compute) 
-		Data->Context->CSSetConstantBuffers(startSlot, numBuffers, Data->CBsToBind);	
+		Data->CBsToBind[i] = buffers && buffers[i] ? buffers[i].Data->Buffer->Buffer.Get() : nullptr;
+
+	SetConstantBuffersForStages(stage, startSlot, numBuffers, Data->CBsToBind);
+}
+
+void SfContext::BindConstantAllocation(const SfConstantAllocation& alloc, UINT slot, EShaderStage stage)
+{
+	SF_CHECK(alloc, "cannot bind an empty constant allocation");
+	SF_CHECK(slot < D3D11_COMMONSHADER_CONSTANT_BUFFER_HW_SLOT_COUNT, "constant buffer slot out of range");
+	SetConstantBuffersForStages(stage, slot, 1, &alloc.Buffer, &alloc.FirstConstant, &alloc.NumConstants);
 }
 
 void SfContext::BindRawBuffer(const class SfBuffer_Raw& buffer, UINT slot /*= -1*/, EShaderStage stage /*= EShaderStage::None*/)
@@ -383,7 +930,7 @@ void SfContext::BindShaderResource(const class SfResource* resource, UINT slot /
 	}
 	else
 	{
-		sfAssert(slot != -1 && (stage & EShaderStage::All), 
+		SF_CHECK(slot != -1 && (stage & EShaderStage::All), 
 			"cannot use default slot or shader stage when binding a null structured buffer");
 	}
 	BindShaderResources(&resource, 1, slot, stage);
@@ -391,108 +938,438 @@ void SfContext::BindShaderResource(const class SfResource* resource, UINT slot /
 
 void SfContext::BindShaderResources(const class SfResource** resources, UINT numBuffers, UINT startSlot, EShaderStage stage)
 {
-	sfAssert(startSlot + numBuffers <= D3D11_COMMONSHADER_INPUT_RESOURCE_REGISTER_COUNT, "cannot bind structured buffers over slot 128");
+	SF_CHECK(startSlot + numBuffers <= D3D11_COMMONSHADER_INPUT_RESOURCE_REGISTER_COUNT, "cannot bind structured buffers over slot 128");
 	for (UINT i = 0; i < numBuffers; i++)
 		Data->SRVsToBind[i] = resources[i] ? resources[i]->Data->ShaderResource : nullptr;
 
-	if (stage & EShaderStage::Pixel) 
-		Data->Context->PSSetShaderResources(startSlot, numBuffers, Data->SRVsToBind);
-	if (stage & EShaderStage::Vertex) 
-		Data->Context->VSSetShaderResources(startSlot, numBuffers, Data->SRVsToBind);
-	if (stage & EShaderStage::Hull) 
-		Data->Context->HSSetShaderResources(startSlot, numBuffers, Data->SRVsToBind);
-	if (stage & EShaderStage::Domain) 
-		Data->Context->DSSetShaderResources(startSlot, numBuffers, Data->SRVsToBind);
-	if (stage & EShaderStage::Geometry) 
-		Data->Context->GSSetShaderResources(startSlot, numBuffers, Data->SRVsToBind);
-	if (stage & EShaderStage::Compute) 
-		Data->Context->CSSetShaderResources(startSlot, numBuffers, Data->SRVsToBind);
+	SetShaderResourcesForStages(stage, startSlot, numBuffers, Data->SRVsToBind);
 }
 
-void SfContext::UpdateResource(const class SfResource* buffer, void* data, UINT dataSize, UINT bufferOffset)
+void SfContext::BindShaderResources(const SfResourceHandle* handles, UINT numBuffers, UINT startSlot, EShaderStage stage)
 {
-	sfAssert(buffer, "cannot update null resource");
-	sfAssert(data && dataSize > 0, "cannot update resource with empty data");
-	sfAssert(buffer->Data->Usage.Value != SfUsage::Immutable, "cannot update immutable resource");
+	SF_CHECK(startSlot + numBuffers <= D3D11_COMMONSHADER_INPUT_RESOURCE_REGISTER_COUNT, "cannot bind structured buffers over slot 128");
 
-	if (buffer->Data->Usage.Value == SfUsage::Static)
+	// the views are raw pointers until d3d holds them, with CommitAtDraw that is the next draw
+	// so the resources have to stay alive until then, only handles already stale when this is called bind null
+	for (UINT i = 0; i < numBuffers; i++)
 	{
-		// TODO allow offset
-		sfAssert(bufferOffset == 0, "cannot update offset of static resource");
+		const SfResource::ResourceData* res = SfResource::Resolve(handles[i]);
+		Data->SRVsToBind[i] = res ? res->ShaderResource : nullptr;
+	}
 
-		Data->Context->UpdateSubresource(buffer->Data->Resource, 0, NULL, data, 0, 0);
+	SetShaderResourcesForStages(stage, startSlot, numBuffers, Data->SRVsToBind);
+}
+
+void SfContext::UpdateResource(const class SfResource* buffer, void* data, UINT dataSize, UINT bufferOffset, EUpdateMode mode /*= EUpdateMode::Discard*/)
+{
+	SF_CHECK(buffer, "cannot update null resource");
+	UpdateResourceData(*buffer->Data, data, dataSize, bufferOffset, mode);
+}
+
+void SfContext::UpdateResourceData(SfResource::ResourceData& res, const void* data, UINT dataSize, UINT bufferOffset, EUpdateMode mode)
+{
+	SF_CHECK(data && dataSize > 0, "cannot update resource with empty data");
+	SF_VALIDATE(res.Usage.Value != SfUsage::Immutable, "cannot update immutable resource");
+	CaptureCall([&](SfCommandBuffer& capture) { capture.RecordUpdate(&res, data, dataSize, bufferOffset, mode); });
+
+	const bool isBuffer = res.Buffer != nullptr;
+	if (isBuffer)
+		SF_CHECK(bufferOffset + dataSize <= res.Buffer->BufferDesc.ByteWidth, "update runs past the end of the buffer");
+
+	if (res.Usage.Value == SfUsage::Static)
+	{
+		if (!isBuffer)
+		{
+			SF_CHECK(bufferOffset == 0, "cannot update offset of static texture");
+			CountUpdate(dataSize);
+			Data->Context->UpdateSubresource(res.Resource, 0, NULL, data, 0, 0);
+			return;
+		}
+
+		const bool whole = bufferOffset == 0 && dataSize == res.Buffer->BufferDesc.ByteWidth;
+		CountUpdate(dataSize);
+
+		// the cpu copy is written at record time, so only the immediate context may keep it in step with the gpu
+		if (res.Buffer->Shadow)
+		{
+			SF_CHECK(!Data->Deferred, "constant buffers with a cpu copy can only be updated on the immediate context");
+			memcpy(res.Buffer->Shadow.get() + bufferOffset, data, dataSize);
+		}
+		if (whole)
+		{
+			Data->Context->UpdateSubresource(res.Resource, 0, NULL, data, 0, 0);
+			return;
+		}
+
+		D3D11_BOX box = {};
+		box.left = bufferOffset;
+		box.right = bufferOffset + dataSize;
+		box.top = 0;
+		box.bottom = 1;
+		box.front = 0;
+		box.back = 1;
+
+		if (res.Buffer->BufferDesc.BindFlags & D3D11_BIND_CONSTANT_BUFFER)
+		{
+			// d3d 11.0 only updates constant buffers whole, 11.1 accepts a box through UpdateSubresource1 if the driver supports it
+			SF_CHECK(bufferOffset % 16 == 0 && dataSize % 16 == 0, "partial constant buffer updates must cover whole 16 byte constants");
+			const D3D11_FEATURE_DATA_D3D11_OPTIONS& options = Data->Instance->GetOptions();
+			if (Data->Context1 && options.ConstantBufferPartialUpdate && !Data->EmulatedCommandList)
+			{
+				Data->Context1->UpdateSubresource1(res.Resource, 0, &box, data, 0, 0, 0);
+				return;
+			}
+
+			// everywhere else the buffer is uploaded whole from its cpu copy
+			SF_CHECK(res.Buffer->Shadow != nullptr, "partial constant buffer update needs the cpu copy of the buffer");
+			Data->Context->UpdateSubresource(res.Resource, 0, NULL, res.Buffer->Shadow.get(), 0, 0);
+			return;
+		}
+
+		// emulated command lists apply the box to the source as well, so the source is moved back by the same amount
+		const BYTE* source = (const BYTE*)data;
+		if (Data->EmulatedCommandList) source -= bufferOffset;
+		Data->Context->UpdateSubresource(res.Resource, 0, &box, source, 0, 0);
 	}
 	else
 	{
-		D3D11_MAPPED_SUBRESOURCE mapped = MapResource(*buffer);
+		// a whole constant buffer leaves nothing to keep, so it can discard on drivers that cannot map it without overwriting
+		if (mode == EUpdateMode::NoOverwrite && isBuffer && (res.Buffer->BufferDesc.BindFlags & D3D11_BIND_CONSTANT_BUFFER) &&
+			!Data->Instance->GetOptions().MapNoOverwriteOnDynamicConstantBuffer)
+		{
+			SF_CHECK(bufferOffset == 0 && dataSize == res.Buffer->BufferDesc.ByteWidth, "driver cannot update part of a dynamic constant buffer without overwriting the rest");
+			mode = EUpdateMode::Discard;
+		}
+
+		D3D11_MAPPED_SUBRESOURCE mapped = MapResourceData(res, mode);
 		memcpy((char*)(mapped.pData) + bufferOffset, data, dataSize);
-		UnmapResource(*buffer);
+		UnmapResourceData(res);
 	}
 }
 
-void SfContext::UpdateVertexBuffer(const SfBuffer_Vertex& buffer, void* data, UINT numVertices /*= 0*/, UINT vertexOffset /*= 0*/)
+void SfContext::UpdateVertexBuffer(const SfBuffer_Vertex& buffer, void* data, UINT numVertices /*= 0*/, UINT vertexOffset /*= 0*/, EUpdateMode mode /*= EUpdateMode::Discard*/)
 {
-	if (numVertices == 0) numVertices = buffer.GetNumElements();
-	UpdateResource(&buffer, data, buffer.GetTypeSize() * numVertices, vertexOffset * buffer.GetTypeSize());
+	if (numVertices == 0) numVertices = buffer.GetNumElements() - vertexOffset;
+	UpdateResource(&buffer, data, buffer.GetTypeSize() * numVertices, vertexOffset * buffer.GetTypeSize(), mode);
 }
 
-void SfContext::UpdateIndexBuffer(const SfBuffer_Index& buffer, void* data, UINT numIndices /*= 0*/, UINT indexOffset /*= 0*/)
+void SfContext::UpdateIndexBuffer(const SfBuffer_Index& buffer, void* data, UINT numIndices /*= 0*/, UINT indexOffset /*= 0*/, EUpdateMode mode /*= EUpdateMode::Discard*/)
 {
-	if (numIndices == 0) numIndices = buffer.GetNumElements();
-	UpdateResource(&buffer, data, buffer.GetTypeSize() * numIndices, indexOffset * buffer.GetTypeSize());
+	if (numIndices == 0) numIndices = buffer.GetNumElements() - indexOffset;
+	UpdateResource(&buffer, data, buffer.GetTypeSize() * numIndices, indexOffset * buffer.GetTypeSize(), mode);
 }
 
-void SfContext::UpdateConstantBuffer(const SfBuffer_Constant& buffer, void* data, UINT bufferOffset /*= 0*/, UINT dataSize /*= 0*/)
+void SfContext::UpdateConstantBuffer(const SfBuffer_Constant& buffer, void* data, UINT bufferOffset /*= 0*/, UINT dataSize /*= 0*/, EUpdateMode mode /*= EUpdateMode::Discard*/)
 {
-	if (dataSize == 0) dataSize = buffer.GetTypeSize();
-	UpdateResource(&buffer, data, dataSize, bufferOffset);
+	if (dataSize == 0) dataSize = buffer.GetTypeSize() - bufferOffset;
+	UpdateResource(&buffer, data, dataSize, bufferOffset, mode);
 }
 
-void SfContext::UpdateStructuredBuffer(const SfBuffer_Structured& buffer, void* data, UINT numElements /*= 0*/, UINT startIndexOffset /*= 0*/)
+void SfContext::UpdateStructuredBuffer(const SfBuffer_Structured& buffer, void* data, UINT numElements /*= 0*/, UINT startIndexOffset /*= 0*/, EUpdateMode mode /*= EUpdateMode::Discard*/)
 {	
-	if (numElements == 0) numElements = buffer.GetNumElements();
+	if (numElements == 0) numElements = buffer.GetNumElements() - startIndexOffset;
 	UINT dataSize = numElements * buffer.GetTypeSize();
-	UpdateResource(&buffer, data, dataSize, startIndexOffset * buffer.GetTypeSize());
+	UpdateResource(&buffer, data, dataSize, startIndexOffset * buffer.GetTypeSize(), mode);
 }
 
-void SfContext::UpdateInstanceBuffer(const SfBuffer_Instance& buffer, void* data, UINT numInstances /*= 0*/, UINT instanceOffset /*= 0*/)
+void SfContext::UpdateInstanceBuffer(const SfBuffer_Instance& buffer, void* data, UINT numInstances /*= 0*/, UINT instanceOffset /*= 0*/, EUpdateMode mode /*= EUpdateMode::Discard*/)
 {
-	if (numInstances == 0) numInstances = buffer.GetNumElements();
+	if (numInstances == 0) numInstances = buffer.GetNumElements() - instanceOffset;
 	UINT dataSize = numInstances * buffer.GetTypeSize();
-	UpdateResource(&buffer, data, dataSize, instanceOffset * buffer.GetTypeSize());
+	UpdateResource(&buffer, data, dataSize, instanceOffset * buffer.GetTypeSize(), mode);
 }
 
-void SfContext::UpdateRawBuffer(const class SfBuffer_Raw& buffer, void* data, UINT numElements /*= 0*/, UINT startIndexOffset /*= 0*/)
+void SfContext::UpdateRawBuffer(const class SfBuffer_Raw& buffer, void* data, UINT numElements /*= 0*/, UINT startIndexOffset /*= 0*/, EUpdateMode mode /*= EUpdateMode::Discard*/)
 {
-	if (numElements == 0) numElements = buffer.GetNumElements();
+	if (numElements == 0) numElements = buffer.GetNumElements() - startIndexOffset;
 	UINT dataSize = numElements * buffer.GetTypeSize();
-	UpdateResource(&buffer, data, dataSize, startIndexOffset * buffer.GetTypeSize());
+	UpdateResource(&buffer, data, dataSize, startIndexOffset * buffer.GetTypeSize(), mode);
 }
 
 void SfContext::CopyResource(const SfResource& dst, const SfResource& src)
 {
-	Data->Context->CopyResource(dst.Data->Resource, src.Data->Resource);
+	CopyResourceData(*dst.Data, *src.Data);
+}
+
+void SfContext::CopyResourceData(SfResource::ResourceData& dst, SfResource::ResourceData& src)
+{
+	CaptureCall([&](SfCommandBuffer& capture) { capture.RecordCopy(&dst, &src); });
+	CountCopy(GetResourceBytes(src));
+	Data->Context->CopyResource(dst.Resource, src.Resource);
+}
+
+SfReadback SfContext::ReadbackResource(const SfResource& resource)
+{
+	sfAssert(resource.Data.get(), "cannot read back null resource");
+
+	SfInstance* instance = Data->Instance;
+	SfReadback readback;
+	readback.Data = std::make_shared<SfReadback::ReadbackData>();
+	readback.Data->Pool = instance->StagingPool.GetCore();
+	readback.Data->Instance = instance;
+
+	SfResource::ResourceData& res = *resource.Data;
+	if (res.Buffer)
+	{
+		readback.Data->Size = res.Buffer->BufferDesc.ByteWidth;
+		readback.Data->Staging = instance->StagingPool.AcquireBuffer(instance->GetDevice(), readback.Data->Size, readback.Data->PoolDesc);
+	}
+	else
+	{
+		const void* desc =
+			res.Texture->Dimensions == 1 ? (const void*)&res.Texture->TextureDesc1D :
+			res.Texture->Dimensions == 2 ? (const void*)&res.Texture->TextureDesc2D :
+			(const void*)&res.Texture->TextureDesc3D;
+		readback.Data->Staging = instance->StagingPool.AcquireTexture(instance->GetDevice(), res.Texture->Dimensions, desc, readback.Data->PoolDesc);
+	}
+
+	CountCopy(GetResourceBytes(res));
+	Data->Context->CopyResource(readback.Data->Staging.Get(), res.Resource);
+
+	readback.Data->Fence = instance->StagingPool.AcquireQuery(instance->GetDevice());
+	Data->Context->End(readback.Data->Fence.Get());
+	return readback;
+}
+
+SfReadback SfContext::ReadbackBufferRange(const SfResource& buffer, UINT offset, UINT size)
+{
+	sfAssert(buffer.Data.get() && buffer.Data->Buffer && buffer.Data->Buffer->Buffer, "can only read back a range of a buffer");
+	sfAssert(size > 0 && offset + size <= buffer.Data->Buffer->BufferDesc.ByteWidth, "readback range runs past the end of the buffer");
+
+	SfInstance* instance = Data->Instance;
+	SfReadback readback;
+	readback.Data = std::make_shared<SfReadback::ReadbackData>();
+	readback.Data->Pool = instance->StagingPool.GetCore();
+	readback.Data->Instance = instance;
+	readback.Data->Size = size;
+	readback.Data->Staging = instance->StagingPool.AcquireBuffer(instance->GetDevice(), size, readback.Data->PoolDesc);
+
+	D3D11_BOX box = {};
+	box.left = offset;
+	box.right = offset + size;
+	box.bottom = 1;
+	box.back = 1;
+	CountCopy(size);
+	Data->Context->CopySubresourceRegion(readback.Data->Staging.Get(), 0, 0, 0, 0, buffer.Data->Resource, 0, &box);
+
+	readback.Data->Fence = instance->StagingPool.AcquireQuery(instance->GetDevice());
+	Data->Context->End(readback.Data->Fence.Get());
+	return readback;
 }
 
-D3D11_MAPPED_SUBRESOURCE SfContext::MapResource(const SfResource& res)
+bool SfContext::IsReadbackReady(SfReadback& readback)
 {
-	sfAssert(res.Data.get(), "cannot map null resource");
-	sfAssert(!res.Data->IsMapped, "cannot map a resource that is already mapped");
+	sfAssert(readback, "cannot poll null readback");
+	sfAssert(*this == Data->Instance->GetImmediateContext(), "readbacks must be polled on the immediate context");
+
+	if (!readback.Data->Signaled)
+		readback.Data->Signaled = Data->Context->GetData(readback.Data->Fence.Get(), nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK;
+
+	return readback.Data->Signaled;
+}
+
+bool SfContext::TryMapReadback(SfReadback& readback, D3D11_MAPPED_SUBRESOURCE& mapped, UINT subresource /*= 0*/)
+{
+	if (!IsReadbackReady(readback)) return false;
+	sfAssert(!readback.Data->IsMapped, "readback is already mapped");
+
+	HRESULT hr = Data->Context->Map(readback.Data->Staging.Get(), subresource, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+	if (hr == DXGI_ERROR_WAS_STILL_DRAWING) return false;
+	sfAssertHR(hr, "could not map readback");
+
+	Data->Stats.Maps++;
+	readback.Data->IsMapped = true;
+	return true;
+}
+
+void SfContext::UnmapReadback(SfReadback& readback, UINT subresource /*= 0*/)
+{
+	sfAssert(readback.Data->IsMapped, "readback is not mapped");
+	Data->Stats.Unmaps++;
+	Data->Context->Unmap(readback.Data->Staging.Get(), subresource);
+	readback.Data->IsMapped = false;
+}
+
+bool SfContext::TryReadReadback(SfReadback& readback, void* dst, UINT dstSize)
+{
+	sfAssert(readback.Data->Size > 0, "only buffer readbacks can be read directly, map texture readbacks instead");
+	sfAssert(dstSize >= readback.Data->Size, "readback destination is too small");
 
-	res.Data->IsMapped = true;
-	D3D11_MAP type = res.IsDynamic() ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_READ_WRITE;
 	D3D11_MAPPED_SUBRESOURCE mapped;
-	Data->Context->Map(res.Data->Resource, 0, type, 0, &mapped);
-	return mapped;
+	if (!TryMapReadback(readback, mapped)) return false;
+
+	memcpy(dst, mapped.pData, readback.Data->Size);
+	UnmapReadback(readback);
+	return true;
+}
+
+void SfContext::BeginFrame()
+{
+	Data->FrameStart = Data->Stats;
+}
+
+SfContextStats SfContext::EndFrame()
+{
+	if (Data->Capture && !Data->Capture.EndFrame())
+		Data->Capture = SF_NULL;
+
+	SfContextStats frame = Data->Stats - Data->FrameStart;
+	Data->FrameStart = Data->Stats;
+
+	if (*this == Data->Instance->GetImmediateContext())
+		SfFrameArena::Get().Reset();
+
+	return frame;
+}
+
+void SfContext::SetFrameCapture(const SfFrameCapture& capture, UINT numFrames /*= 1*/)
+{
+	sfAssert(!capture || capture.Data->Instance == Data->Instance, "cannot capture into a frame capture from another instance");
+
+	Data->Capture = capture;
+	if (!capture) return;
+
+	capture.Data->FramesLeft = numFrames;
+	CaptureCurrentState();
+}
+
+void SfContext::CaptureCurrentState()
+{
+	// entries the cache does not know are skipped, slot binds come from the pending mirror which is always valid
+	const SfStateCache& cache = Data->Cache;
+	const SfPendingBinds& pending = Data->Pending;
+	auto known = [](const void* value) { return value != (const void*)~(size_t)0; };
+
+	ID3D11DeviceChild* shaders[] = { cache.VertexShader, cache.PixelShader, cache.HullShader, cache.DomainShader, cache.GeometryShader, cache.ComputeShader };
+	for (UINT stage = 0; stage < SF_NUM_SHADER_STAGES; stage++)
+	{
+		if (known(shaders[stage]))
+			CaptureCall([&](SfCommandBuffer& capture) { capture.RecordShader(stage, shaders[stage]); });
+	}
+	if (known(cache.InputLayout))
+		CaptureCall([&](SfCommandBuffer& capture) { capture.RecordInputLayout(cache.InputLayout); });
+
+	// binds slot 0 up to the last non null slot of each stage
+	auto usedSlots = [](void* const* slots, UINT count)
+	{
+		while (count > 0 && !slots[count - 1]) count--;
+		return count;
+	};
+	for (UINT stage = 0; stage < SF_NUM_SHADER_STAGES; stage++)
+	{
+		const EShaderStage stageBit = EShaderStage((BYTE)(1 << stage));
+		if (UINT count = usedSlots((void* const*)pending.SRVs[stage], D3D11_COMMONSHADER_INPUT_RESOURCE_REGISTER_COUNT))
+			CaptureCall([&](SfCommandBuffer& capture) { capture.RecordShaderResources(stageBit, 0, count, pending.SRVs[stage]); });
+		if (UINT count = usedSlots((void* const*)pending.Samplers[stage], D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT))
+			CaptureCall([&](SfCommandBuffer& capture) { capture.RecordSamplers(stageBit, 0, count, pending.Samplers[stage]); });
+		if (UINT count = usedSlots((void* const*)pending.CBs[stage], D3D11_COMMONSHADER_CONSTANT_BUFFER_HW_SLOT_COUNT))
+			CaptureCall([&](SfCommandBuffer& capture) { capture.RecordConstantBuffers(stageBit, 0, count, pending.CBs[stage], pending.CBFirstConstants[stage], pending.CBNumConstants[stage]); });
+	}
+
+	if (known(cache.VertexBuffers[0]) && cache.VertexBuffers[0])
+	{
+		const UINT count = known(cache.VertexBuffers[1]) && cache.VertexBuffers[1] ? 2 : 1;
+		CaptureCall([&](SfCommandBuffer& capture) { capture.RecordVertexBuffers(count, cache.VertexBuffers, cache.VertexStrides, cache.VertexOffsets); });
+	}
+	if (known(cache.IndexBuffer))
+		CaptureCall([&](SfCommandBuffer& capture) { capture.RecordIndexBuffer(cache.IndexBuffer, cache.IndexFormat, cache.IndexOffset); });
+
+	// outputs are always invalidated together, a known depth view means the render targets are known too
+	if (known(cache.DSV))
+	{
+		const UINT count = usedSlots((void* const*)cache.RTVs, D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT);
+		CaptureCall([&](SfCommandBuffer& capture) { capture.RecordRenderTargets(count, cache.RTVs, cache.DSV); });
+	}
+	bool uavsKnown = true;
+	for (ID3D11UnorderedAccessView* uav : cache.ComputeUAVs) uavsKnown &= known(uav);
+	if (uavsKnown)
+	{
+		if (UINT count = usedSlots((void* const*)cache.ComputeUAVs, D3D11_PS_CS_UAV_REGISTER_COUNT))
+			CaptureCall([&](SfCommandBuffer& capture) { capture.RecordComputeUAVs(0, count, cache.ComputeUAVs); });
+	}
+
+	if (known(cache.RasterizerState))
+		CaptureCall([&](SfCommandBuffer& capture) { capture.RecordRasterizer(cache.RasterizerState); });
+	if (known(cache.DepthStencilState))
+		CaptureCall([&](SfCommandBuffer& capture) { capture.RecordDepthStencil(cache.DepthStencilState, cache.StencilRef); });
+	if (known(cache.BlendState))
+		CaptureCall([&](SfCommandBuffer& capture) { capture.RecordBlend(cache.BlendState, cache.BlendFactor, cache.SampleMask); });
+	if ((UINT)cache.Topology != ~0u)
+		CaptureCall([&](SfCommandBuffer& capture) { capture.SetPrimitiveTopology(cache.Topology); });
+
+	// an unknown viewport has every bit set, which reads as NaN
+	const D3D11_VIEWPORT& view = cache.Viewport;
+	if (view.Width == view.Width)
+		CaptureCall([&](SfCommandBuffer& capture) { capture.SetViewport(view.Width, view.Height, view.TopLeftX, view.TopLeftY, view.MinDepth, view.MaxDepth); });
+	if (cache.ScissorRect.left != -1)
+		CaptureCall([&](SfCommandBuffer& capture) { capture.SetScissorRect(cache.ScissorRect.left, cache.ScissorRect.top, cache.ScissorRect.right, cache.ScissorRect.bottom); });
+}
+
+void SfContext::WriteBufferRaw(ID3D11Buffer* buffer, UINT offset, const void* data, UINT dataSize, bool discard)
+{
+	D3D11_MAPPED_SUBRESOURCE mapped;
+	Data->Stats.Maps++;
+	sfAssertHR(Data->Context->Map(buffer, 0, discard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mapped), "could not map buffer for writing");
+	memcpy((BYTE*)mapped.pData + offset, data, dataSize);
+	Data->Stats.Unmaps++;
+	Data->Context->Unmap(buffer, 0);
+}
+
+void SfContext::SetGpuProfiler(const SfGpuProfiler& profiler)
+{
+	sfAssert(!profiler || *this == Data->Instance->GetImmediateContext(), "gpu profiling is only supported on the immediate context");
+	Data->GpuProfiler = profiler;
+}
+
+void SfContext::BeginGpuMarker(const char* name)
+{
+	if (Data->GpuProfiler) Data->GpuProfiler.BeginMarker(Data->Context.Get(), name);
+}
+
+void SfContext::EndGpuMarker()
+{
+	if (Data->GpuProfiler) Data->GpuProfiler.EndMarker(Data->Context.Get());
+}
+
+D3D11_MAPPED_SUBRESOURCE SfContext::MapResource(const SfResource& res, EUpdateMode mode /*= EUpdateMode::Discard*/)
+{
+	SF_CHECK(res.Data.get(), "cannot map null resource");
+	return MapResourceData(*res.Data, mode);
 }
 
 void SfContext::UnmapResource(const SfResource& res)
 {
-	sfAssert(res.Data.get(), "cannot unmap null resource");
-	sfAssert(res.Data->IsMapped, "cannot unmap a resource that isn't already mapped");
+	SF_CHECK(res.Data.get(), "cannot unmap null resource");
+	UnmapResourceData(*res.Data);
+}
 
-	Data->Context->Unmap(res.Data->Resource, 0);
-	res.Data->IsMapped = false;
+D3D11_MAPPED_SUBRESOURCE SfContext::MapResourceData(SfResource::ResourceData& res, EUpdateMode mode)
+{
+	SF_VALIDATE(!res.IsMapped, "cannot map a resource that is already mapped");
+
+	// no overwrite maps of constant buffers need driver support, discarding instead would leave the rest undefined
+	SF_CHECK(mode != EUpdateMode::NoOverwrite || !res.Buffer || !(res.Buffer->BufferDesc.BindFlags & D3D11_BIND_CONSTANT_BUFFER) ||
+		Data->Instance->GetOptions().MapNoOverwriteOnDynamicConstantBuffer, "driver cannot map constant buffers without overwriting them");
+	const bool noOverwrite = mode == EUpdateMode::NoOverwrite;
+
+	res.IsMapped = true;
+	D3D11_MAP type = 
+		res.Usage.Value != SfUsage::Dynamic ? D3D11_MAP_READ_WRITE :
+		noOverwrite ? D3D11_MAP_WRITE_NO_OVERWRITE :
+		D3D11_MAP_WRITE_DISCARD;
+	D3D11_MAPPED_SUBRESOURCE mapped;
+	Data->Stats.Maps++;
+	Data->Context->Map(res.Resource, 0, type, 0, &mapped);
+	return mapped;
+}
+
+void SfContext::UnmapResourceData(SfResource::ResourceData& res)
+{
+	SF_VALIDATE(res.IsMapped, "cannot unmap a resource that isn't already mapped");
+
+	Data->Stats.Unmaps++;
+	Data->Context->Unmap(res.Resource, 0);
+	res.IsMapped = false;
 }
 
 void SfContext::BindTexture(const SfTexture* tex, UINT slot, EShaderStage stage /*= EShaderStage::Pixel*/)
@@ -512,18 +1389,18 @@ void SfContext::BindRenderTarget(const SfRenderTarget& target, const SfDepthBuff
 
 void SfContext::BindRenderTargets(const SfRenderTarget* targets, UINT count, const SfDepthBuffer& depth /*= SF_NULL*/)
 {
-	sfAssert(count <= 8, "cannot bind more than 8 render targets");
+	SF_CHECK(count <= 8, "cannot bind more than 8 render targets");
 	
 	for (UINT i = 0; i < count; i++)
-		Data->RTsToBind[i] = targets[i] ? targets[i].Data->Texture.RenderTargetView.Get() : nullptr;
+		Data->RTsToBind[i] = targets[i] ? targets[i].Data->Texture->RenderTargetView.Get() : nullptr;
 		
-	Data->Context->OMSetRenderTargets(count, Data->RTsToBind, depth ? depth.Data->Texture.DepthStencilView.Get() : nullptr);
+	SetRenderTargetViews(count, Data->RTsToBind, depth ? depth.Data->Texture->DepthStencilView.Get() : nullptr);
 }
 
 void SfContext::UnbindAllRenderTargets()
 {
 	memset(Data->RTsToBind, 0, sizeof(size_t) * D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT);
-	Data->Context->OMSetRenderTargets(8, Data->RTsToBind, nullptr);
+	SetRenderTargetViews(8, Data->RTsToBind, nullptr);
 }
 
 void SfContext::BindRenderTargetsAndUnorderedAccessViews(
@@ -534,19 +1411,29 @@ void SfContext::BindRenderTargetsAndUnorderedAccessViews(
 	uavStartSlot, 
 	const SfDepthBuffer& depth)
 {
-	sfAssert(rtCount <= 8, "cannot bind more than 8 render targets");
-	sfAssert(uavCount <= 8, "cannot bind more than 8 unordered access views");
+	SF_CHECK(rtCount <= 8, "cannot bind more than 8 render targets");
+	SF_CHECK(uavCount <= 8, "cannot bind more than 8 unordered access views");
 
 	for (UINT i = 0; i < rtCount; i++)
-		Data->RTsToBind[i] = targets[i].Data->Texture.RenderTargetView.Get();
+		Data->RTsToBind[i] = targets[i].Data->Texture->RenderTargetView.Get();
 
 	for (UINT i = 0; i < uavCount; i++)
 		Data->PipelineUAVsToBind[i] = UAVs[i].Data->UnorderedAccess;
 
+	// pipeline UAVs are not cached, this call always reaches the driver
+	ShouldIssue(true);
+	Data->Cache.InvalidateInputs();
+	Data->Cache.InvalidateOutputs();
+	for (UINT i = 0; i < D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT; i++)
+		Data->Cache.RTVs[i] = i < rtCount ? Data->RTsToBind[i] : nullptr;
+	Data->Cache.DSV = depth ? depth.Data->Texture->DepthStencilView.Get() : nullptr;
+
+	Data->Stats.RenderTargetBinds++;
+	Data->Stats.UnorderedAccessBinds++;
 	Data->Context->OMSetRenderTargetsAndUnorderedAccessViews(
 		rtCount,
 		(ID3D11RenderTargetView* const*)(&Data->RTsToBind),
-		depth ? depth.Data->Texture.DepthStencilView.Get() : nullptr,
+		depth ? depth.Data->Texture->DepthStencilView.Get() : nullptr,
 		uavStartSlot,
 		uavCount,
 		(ID3D11UnorderedAccessView* const*)(&Data->PipelineUAVsToBind),
@@ -556,6 +1443,9 @@ void SfContext::BindRenderTargetsAndUnorderedAccessViews(
 void SfContext_Deferred::FinishCommandList(bool clearState)
 {
 	Data->Context->FinishCommandList(!clearState, &CommandList);
+	Data->Cache.Invalidate();
+	ForgetPipelineState();
+	if (clearState) Data->Pending.Reset();
 }
 
 }
@@ -6,6 +6,14 @@
 #include "depth_buffer.h"
 #include "buffer.h"
 #include "window.h"
+#include "state_cache.h"
+#include "context_stats.h"
+#include "pipeline_state.h"
+#include "constant_ring.h"
+#include "geometry_ring.h"
+#include "readback.h"
+#include "gpu_profiler.h"
+#include "frame_capture.h"
 
 namespace sf11
 {
@@ -13,6 +21,11 @@ namespace sf11
 class SfContext
 {
 	friend class SfInstance;
+	friend class SfConstantRing;
+	friend class SfGeometryRing;
+	friend class SfGpuProfiler;
+	friend class SfCommandBuffer;
+	friend class SfFrameCapture;
 protected:
 
 	struct ContextData
@@ -20,6 +33,15 @@ protected:
 		class SfInstance* Instance = nullptr;
 		ComPtr<ID3D11DeviceContext> Context;
 
+		// null when the runtime does not support d3d 11.1, only needed for constant buffer offsets
+		ComPtr<ID3D11DeviceContext1> Context1;
+
+		// deferred context whose command lists the runtime emulates, boxed updates on these need their source adjusted
+		bool EmulatedCommandList = false;
+
+		// set on contexts made by CreateDeferredContext, these never touch the cpu copies of constant buffers
+		bool Deferred = false;
+
 		// allocate arrays for multi bind here so we dont have to do it every time a bind call is made
 		ID3D11ShaderResourceView* SRVsToBind[D3D11_COMMONSHADER_INPUT_RESOURCE_REGISTER_COUNT];
 		ID3D11SamplerState* SamplersToBind[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];
@@ -27,10 +49,85 @@ protected:
 		ID3D11Buffer* CBsToBind[D3D11_COMMONSHADER_CONSTANT_BUFFER_HW_SLOT_COUNT];
 		ID3D11UnorderedAccessView* ComputeUAVsToBind[D3D11_PS_CS_UAV_REGISTER_COUNT];
 		ID3D11UnorderedAccessView* PipelineUAVsToBind[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT];
+
+		// shadow of the d3d state, used to drop binds that would not change anything
+		SfStateCache Cache;
+		SfStateCacheStats CacheStats;
+		bool CacheEnabled = true;
+
+		// plain counters, each context only ever touches its own
+		SfContextStats Stats;
+		SfContextStats FrameStart;
+
+		// slot binds waiting for the next draw when CommitAtDraw is set
+		SfPendingBinds Pending;
+		bool CommitAtDraw = false;
+
+		// last pipeline bound with BindPipelineState, cleared by any piecemeal change to the state it covers
+		SfPipelineState BoundPipeline;
+
+		// receives SF_GPU_SCOPE markers, null when not profiling
+		SfGpuProfiler GpuProfiler;
+
+		// records every call before the state cache sees it, null when not capturing
+		SfFrameCapture Capture;
 	};
 
 	std::shared_ptr<ContextData> Data;
 
+	// slot binds go through these, they are either staged for the next draw or issued right away
+	void SetShaderResourcesForStages(EShaderStage stages, UINT startSlot, UINT count, ID3D11ShaderResourceView* const* views);
+	void SetSamplersForStages(EShaderStage stages, UINT startSlot, UINT count, ID3D11SamplerState* const* samplers);
+	void SetConstantBuffersForStages(EShaderStage stages, UINT startSlot, UINT count, ID3D11Buffer* const* buffers,
+		const UINT* firstConstants = nullptr, const UINT* numConstants = nullptr);
+
+	// every state change goes through these so redundant calls can be filtered against the cache
+	void IssueShaderResources(UINT stage, UINT startSlot, UINT count, ID3D11ShaderResourceView* const* views);
+	void IssueSamplers(UINT stage, UINT startSlot, UINT count, ID3D11SamplerState* const* samplers);
+	void IssueConstantBuffers(UINT stage, UINT startSlot, UINT count, ID3D11Buffer* const* buffers, const UINT* firstConstants, const UINT* numConstants);
+	void SetComputeUnorderedAccessViews(UINT startSlot, UINT count, ID3D11UnorderedAccessView* const* views);
+	void SetRenderTargetViews(UINT count, ID3D11RenderTargetView* const* views, ID3D11DepthStencilView* depth);
+	void SetVertexBuffers(UINT count, ID3D11Buffer* const* buffers, const UINT* strides, const UINT* offsets);
+	void SetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, UINT offset);
+	void SetRasterizerState(ID3D11RasterizerState* state);
+	void SetDepthStencilStateRaw(ID3D11DepthStencilState* state, UINT stencilRef);
+	void SetBlendStateRaw(ID3D11BlendState* state, const FLOAT factor[4], UINT sampleMask);
+
+	// stage is the bit position in EShaderStage, the shader must match the stage
+	void SetShaderRaw(UINT stage, ID3D11DeviceChild* shader);
+	void SetInputLayoutRaw(ID3D11InputLayout* layout);
+	void SetTopologyRaw(D3D11_PRIMITIVE_TOPOLOGY topology);
+	void ApplyPipelineKey(const SfPipelineState::PipelineKey& key);
+
+	void ClearRenderTargetRaw(ID3D11RenderTargetView* view, const FLOAT color[4]);
+	void ClearDepthStencilRaw(ID3D11DepthStencilView* view, float depthClear, UINT8 stencilClear);
+
+	// handle free versions of the resource functions, shared with SfCommandBuffer replay
+	void UpdateResourceData(SfResource::ResourceData& res, const void* data, UINT dataSize, UINT bufferOffset, EUpdateMode mode);
+	void CopyResourceData(SfResource::ResourceData& dst, SfResource::ResourceData& src);
+	D3D11_MAPPED_SUBRESOURCE MapResourceData(SfResource::ResourceData& res, EUpdateMode mode);
+	void UnmapResourceData(SfResource::ResourceData& res);
+
+	// writes straight into a dynamic buffer, used to replay ring writes
+	void WriteBufferRaw(ID3D11Buffer* buffer, UINT offset, const void* data, UINT dataSize, bool discard);
+
+	// returns true if the call has to reach the driver and updates the stats accordingly
+	bool ShouldIssue(bool changed);
+
+	// hands the call to the frame capture, done before the state cache so captures do not depend on what was bound earlier
+	template <typename F>
+	void CaptureCall(F record) { if (Data->Capture) Data->Capture.Record(*this, record); }
+
+	// records what is already bound so a capture started mid-stream replays with the same state
+	void CaptureCurrentState();
+
+	void ForgetPipelineState() { if (Data->BoundPipeline) Data->BoundPipeline = SF_NULL; }
+
+	void CountUpdate(UINT64 bytes) { Data->Stats.UpdateSubresourceCalls++; Data->Stats.UpdateSubresourceBytes += bytes; }
+	// byte size for the copy counters, textures only count their top mip
+	static UINT64 GetResourceBytes(const SfResource::ResourceData& res);
+	void CountCopy(UINT64 bytes) { Data->Stats.CopyCalls++; Data->Stats.CopyBytes += bytes; }
+
 public:
 
 	SF_DEF_OPERATORS_AND_DEFAULT(SfContext)
@@ -39,6 +136,38 @@ public:
 	// resets all state associated with this context
 	void ClearState();
 
+	// binds that match the state already set on this context are dropped before reaching d3d
+	// enabled by default, disabling it sends every call straight to the driver
+	void SetStateCacheEnabled(bool enabled);
+	bool IsStateCacheEnabled() const { return Data->CacheEnabled; }
+
+	// number of state calls sent to d3d versus dropped as redundant since the last reset
+	SfStateCacheStats GetStateCacheStats() const { return Data->CacheStats; }
+	void ResetStateCacheStats() { Data->CacheStats = SfStateCacheStats(); }
+
+	// totals of every call this context sent to d3d since creation or the last ResetStats
+	const SfContextStats& GetStats() const { return Data->Stats; }
+	void ResetStats() { Data->Stats = SfContextStats(); Data->FrameStart = SfContextStats(); }
+
+	// EndFrame returns what was sent since the last BeginFrame or EndFrame
+	// deferred contexts count what they record, not what the immediate context executes
+	// EndFrame on the immediate context also resets the frame arena of the calling thread, see SfFrameArena
+	void BeginFrame();
+	SfContextStats EndFrame();
+
+	// forget the cached state so the next bind of every slot reaches the driver
+	// only needed if the underlying d3d context was modified outside of sf11
+	void InvalidateStateCache() { Data->Cache.Invalidate(); ForgetPipelineState(); }
+
+	// when enabled, shader resource, sampler and constant buffer binds only mark their slots dirty
+	// the next draw or dispatch sends one call per stage and bind type covering the dirty slot range
+	// slots inside that range that were not rebound are sent again with their last bound value
+	void SetCommitAtDraw(bool enabled);
+	bool IsCommitAtDraw() const { return Data->CommitAtDraw; }
+
+	// sends any binds staged by commit at draw mode to d3d, called automatically by draws and dispatches
+	void CommitBinds();
+
 	// takes a deferred context and executes its command list
 	// option to keep the leftover state from the command list in the immediate context state
 	void ExecuteDeferredCommands(class SfContext_Deferred* context, bool clearState = true);
@@ -46,6 +175,12 @@ public:
 	// change the cull mode (clockwise = front) and fill mode
 	void SetCullAndFillMode(ECullMode cull, EFillMode fill);
 
+	// binds a rasterizer created with SfInstance::CreateRasterizer
+	void BindRasterizer(const SfRasterizer& rasterizer);
+
+	// only used while the bound rasterizer has ScissorEnable set
+	void SetScissorRect(LONG left, LONG top, LONG right, LONG bottom);
+
 	// draw raw vertices
 	void Draw(UINT vertexCount, UINT vertexStart);
 
@@ -76,6 +211,10 @@ public:
 
 	// binds a full shader program consisting of at least a vertex and pixel shader
 	void BindShaderProgram(const class SfShaderProgram& program);
+
+	// binds shaders, input layout, blend, rasterizer, depth stencil and topology from one pipeline state
+	// rebinding the current pipeline is a single pointer compare, switching only sends the parts that differ
+	void BindPipelineState(const class SfPipelineState& state);
 	
 	// binds a sampler to a given slot for the given shader stages
 	void BindSampler(const class SfSamplerState& sampler, UINT slot, EShaderStage shaderStages);
@@ -149,6 +288,9 @@ public:
 
 	// binds an index buffer
 	void BindIndexBuffer(const class SfBuffer_Index& buffer);
+
+	// binds the ring buffers behind a transient allocation, offsets are handled by its base vertex and start index
+	void BindTransientGeometry(const SfTransientGeometry& geometry);
 	
 	// binds one or more structured buffers to the specified texture slot for the specified shader stages
 	void BindStructuredBuffer(const class SfBuffer_Structured& buffer, UINT slot = -1, EShaderStage stage = EShaderStage::None);
@@ -158,6 +300,9 @@ public:
 	void BindConstantBuffer(const class SfBuffer_Constant& buffer, UINT slot = -1, EShaderStage stage = EShaderStage::None);
 	void BindConstantBuffers(const class SfBuffer_Constant* buffers, UINT numBuffers, UINT startSlot, EShaderStage stage);
 
+	// binds a window of a constant ring, the shader sees the window as the start of the buffer
+	void BindConstantAllocation(const SfConstantAllocation& alloc, UINT slot, EShaderStage stage);
+
 	void BindRawBuffer(const class SfBuffer_Raw& buffer, UINT slot = -1, EShaderStage stage = EShaderStage::None);
 	void BindRawBuffers(const class SfBuffer_Raw* buffers, UINT numBuffers, UINT startSlot, EShaderStage stage);
 
@@ -165,32 +310,74 @@ public:
 	void BindShaderResource(const class SfResource* resource, UINT slot = -1, EShaderStage stage = EShaderStage::None);
 	void BindShaderResources(const class SfResource** resources, UINT numBuffers, UINT startSlot, EShaderStage stage);
 
+	// same as above from SfResource::GetHandle, stale handles bind null
+	// handles do not keep their resources alive, they have to outlive the bind, which with CommitAtDraw is the next draw
+	void BindShaderResources(const SfResourceHandle* handles, UINT numBuffers, UINT startSlot, EShaderStage stage);
+
 	//void UpdateTexture(const class SfTexture* texture, void* data, UINT dataSize, UINT bufferOffset);
 
 	// generic resource update function, use this if sub-element updates are needed
-	void UpdateResource(const class SfResource* buffer, void* data, UINT dataSize, UINT bufferOffset);
+	// static buffers only upload the given byte range, textures are always updated whole
+	// dynamic resources map with discard or no overwrite depending on mode
+	void UpdateResource(const class SfResource* buffer, void* data, UINT dataSize, UINT bufferOffset, EUpdateMode mode = EUpdateMode::Discard);
+
+	// for the functions below a count of 0 updates everything from the offset to the end of the buffer
 
 	// updates the specified number of vertices with the given data
-	void UpdateVertexBuffer(const class SfBuffer_Vertex& buffer, void* data, UINT numVertices = 0, UINT vertexOffset = 0);
+	void UpdateVertexBuffer(const class SfBuffer_Vertex& buffer, void* data, UINT numVertices = 0, UINT vertexOffset = 0, EUpdateMode mode = EUpdateMode::Discard);
 
 	// updates the specified number of indices with the given data
-	void UpdateIndexBuffer(const class SfBuffer_Index& buffer, void* data, UINT numIndices = 0, UINT indexOffset = 0);
+	void UpdateIndexBuffer(const class SfBuffer_Index& buffer, void* data, UINT numIndices = 0, UINT indexOffset = 0, EUpdateMode mode = EUpdateMode::Discard);
 
 	// updates a constant buffer with new data
-	void UpdateConstantBuffer(const class SfBuffer_Constant& buffer, void* data, UINT bufferOffset = 0, UINT dataSize = 0);
+	// static constant buffers can only be updated whole unless the runtime supports partial constant buffer updates
+	void UpdateConstantBuffer(const class SfBuffer_Constant& buffer, void* data, UINT bufferOffset = 0, UINT dataSize = 0, EUpdateMode mode = EUpdateMode::Discard);
 
 	// updates the specified number of elements with the given data
-	void UpdateStructuredBuffer(const class SfBuffer_Structured& buffer, void* data, UINT numElements = 0, UINT startIndexOffset = 0);
+	void UpdateStructuredBuffer(const class SfBuffer_Structured& buffer, void* data, UINT numElements = 0, UINT startIndexOffset = 0, EUpdateMode mode = EUpdateMode::Discard);
 
 	// updates the specified number of instances with the given data
-	void UpdateInstanceBuffer(const class SfBuffer_Instance& buffer, void* data, UINT numInstances = 0, UINT instanceOffset = 0);
+	void UpdateInstanceBuffer(const class SfBuffer_Instance& buffer, void* data, UINT numInstances = 0, UINT instanceOffset = 0, EUpdateMode mode = EUpdateMode::Discard);
 
 	// updates the specified number of raw buffer elements with the given data
 	// size of each element is according to the buffer format
-	void UpdateRawBuffer(const class SfBuffer_Raw& buffer, void* data, UINT numElements = 0, UINT startIndexOffset = 0);
+	void UpdateRawBuffer(const class SfBuffer_Raw& buffer, void* data, UINT numElements = 0, UINT startIndexOffset = 0, EUpdateMode mode = EUpdateMode::Discard);
 
 	void CopyResource(const SfResource& dst, const SfResource& src);
-	D3D11_MAPPED_SUBRESOURCE MapResource(const SfResource& res);
+
+	// copies the resource into a pooled staging resource and places an event fence after the copy
+	// the data can be read a few frames later without stalling, works on deferred contexts too
+	SfReadback ReadbackResource(const SfResource& resource);
+
+	// same as ReadbackResource but only copies a byte range of a buffer
+	SfReadback ReadbackBufferRange(const SfResource& buffer, UINT offset, UINT size);
+
+	// polls the fence without waiting or flushing, immediate context only
+	bool IsReadbackReady(SfReadback& readback);
+
+	// maps the staging copy if the gpu is done with it, returns false instead of waiting
+	// immediate context only, call UnmapReadback when done reading
+	bool TryMapReadback(SfReadback& readback, D3D11_MAPPED_SUBRESOURCE& mapped, UINT subresource = 0);
+	void UnmapReadback(SfReadback& readback, UINT subresource = 0);
+
+	// copies a buffer readback into dst if it is ready, dstSize must be at least the readback size
+	bool TryReadReadback(SfReadback& readback, void* dst, UINT dstSize);
+
+	// markers are only recorded while a profiler is set, immediate context only
+	// pass SF_NULL to stop profiling
+	void SetGpuProfiler(const SfGpuProfiler& profiler);
+	const SfGpuProfiler& GetGpuProfiler() const { return Data->GpuProfiler; }
+
+	// prefer SF_GPU_SCOPE, which compiles away when SF_GPU_PROFILING is 0
+	void BeginGpuMarker(const char* name);
+	void EndGpuMarker();
+
+	// records the calls of the next numFrames frames, each EndFrame closes one, 0 records until SF_NULL is set
+	// the capture is detached by the EndFrame of its last frame, save it with SfFrameCapture::Save
+	void SetFrameCapture(const SfFrameCapture& capture, UINT numFrames = 1);
+	const SfFrameCapture& GetFrameCapture() const { return Data->Capture; }
+
+	D3D11_MAPPED_SUBRESOURCE MapResource(const SfResource& res, EUpdateMode mode = EUpdateMode::Discard);
 	void UnmapResource(const SfResource& res);
 };
 
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "d3d11_include.h"
+#include "state_cache.h"
+
+namespace sf11
+{
+
+// calls a context has sent to d3d, binds dropped by the state cache are not counted
+// per stage arrays are indexed by the bit position of the stage in EShaderStage
+// every field is a UINT64 counter so snapshots can be subtracted field by field
+struct SfContextStats
+{
+	UINT64 Draws = 0;
+	UINT64 Dispatches = 0;
+
+	UINT64 ShaderBinds[SF_NUM_SHADER_STAGES] = {};
+	UINT64 ShaderResourceBinds[SF_NUM_SHADER_STAGES] = {};
+	UINT64 SamplerBinds[SF_NUM_SHADER_STAGES] = {};
+	UINT64 ConstantBufferBinds[SF_NUM_SHADER_STAGES] = {};
+	UINT64 InputLayoutBinds = 0;
+	UINT64 VertexBufferBinds = 0;
+	UINT64 IndexBufferBinds = 0;
+	UINT64 RenderTargetBinds = 0;
+	UINT64 UnorderedAccessBinds = 0;
+
+	// blend, depth stencil, rasterizer, topology, viewport and scissor changes
+	UINT64 StateChanges = 0;
+
+	UINT64 Clears = 0;
+	UINT64 Maps = 0;
+	UINT64 Unmaps = 0;
+	UINT64 UpdateSubresourceCalls = 0;
+	UINT64 UpdateSubresourceBytes = 0;
+
+	// textures count the size of their top mip
+	UINT64 CopyCalls = 0;
+	UINT64 CopyBytes = 0;
+
+	UINT64 GetTotalBinds() const
+	{
+		UINT64 total = InputLayoutBinds + VertexBufferBinds + IndexBufferBinds + RenderTargetBinds + UnorderedAccessBinds;
+		for (UINT i = 0; i < SF_NUM_SHADER_STAGES; i++)
+			total += ShaderBinds[i] + ShaderResourceBinds[i] + SamplerBinds[i] + ConstantBufferBinds[i];
+		return total;
+	}
+
+	// every call counted above, as seen by the driver
+	UINT64 GetTotalCalls() const
+	{
+		return GetTotalBinds() + StateChanges + Draws + Dispatches + Clears + Maps + Unmaps + UpdateSubresourceCalls + CopyCalls;
+	}
+
+	SfContextStats operator-(const SfContextStats& other) const
+	{
+		SfContextStats out;
+		const UINT64* a = (const UINT64*)this;
+		const UINT64* b = (const UINT64*)&other;
+		UINT64* o = (UINT64*)&out;
+		for (size_t i = 0; i < sizeof(SfContextStats) / sizeof(UINT64); i++)
+			o[i] = a[i] - b[i];
+		return out;
+	}
+
+	SfContextStats& operator+=(const SfContextStats& other)
+	{
+		UINT64* a = (UINT64*)this;
+		const UINT64* b = (const UINT64*)&other;
+		for (size_t i = 0; i < sizeof(SfContextStats) / sizeof(UINT64); i++)
+			a[i] += b[i];
+		return *this;
+	}
+};
+
+static_assert(sizeof(SfContextStats) % sizeof(UINT64) == 0, "context stats may only hold UINT64 counters");
+
+}
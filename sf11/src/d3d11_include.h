@@ -1,11 +1,13 @@
 #pragma once
 
+#ifdef _WIN32
+
 #include <d3d11.h>
+#include <d3d11_1.h>
 #include <dxgi1_2.h>
 #include <DirectXMath.h>
 #include <wrl/internal.h>
 #include <wrl/client.h>
-#include <memory>
 
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "dxgi.lib")
@@ -15,9 +17,19 @@
 #pragma comment(lib, "d2d1.lib")
 #pragma comment(lib, "dxguid.lib")
 
-using Microsoft::WRL::ComPtr;
 using namespace DirectX;
 
+#else
+
+// no windows sdk, only the null device is available
+#include "d3d11_portable.h"
+
+#endif
+
+#include <memory>
+
+using Microsoft::WRL::ComPtr;
+
 #define SF_NULL {}
 
 #define SF_DEF_OPERATORS_AND_DEFAULT(className) \
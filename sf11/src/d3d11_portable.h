@@ -0,0 +1,1542 @@
+#pragma once
+
+// declarations of the windows, com, dxgi and d3d11 types sf11 uses, for platforms without the windows sdk
+// only included by d3d11_include.h when _WIN32 is not defined
+// there is no d3d runtime behind them, CreateNullDevice is the only device available
+// values and interface ids match the sdk headers, interfaces only declare the methods sf11 calls or implements
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <type_traits>
+
+// base types, sized as on windows
+typedef uint8_t BYTE;
+typedef uint8_t UINT8;
+typedef uint16_t UINT16;
+typedef uint16_t WORD;
+typedef uint16_t USHORT;
+typedef int16_t SHORT;
+typedef int32_t INT;
+typedef uint32_t UINT;
+typedef int32_t LONG;
+typedef uint32_t ULONG;
+typedef uint32_t DWORD;
+typedef int32_t BOOL;
+typedef float FLOAT;
+typedef int64_t INT64;
+typedef uint64_t UINT64;
+typedef int64_t LONGLONG;
+typedef uint64_t ULONGLONG;
+typedef size_t SIZE_T;
+typedef intptr_t INT_PTR;
+typedef uintptr_t UINT_PTR;
+typedef intptr_t LONG_PTR;
+typedef uintptr_t ULONG_PTR;
+typedef char CHAR;
+typedef char* LPSTR;
+typedef const char* LPCSTR;
+typedef void* LPVOID;
+typedef int32_t HRESULT;
+
+// 4 bytes here rather than 2, nothing sf11 reads from a WCHAR crosses a platform boundary
+typedef wchar_t WCHAR;
+
+typedef void* HANDLE;
+typedef struct HINSTANCE__* HMODULE;
+typedef struct HWND__* HWND;
+typedef UINT_PTR WPARAM;
+typedef LONG_PTR LPARAM;
+typedef LONG_PTR LRESULT;
+
+#define TRUE 1
+#define FALSE 0
+#define CALLBACK
+#define WINAPI
+#define STDMETHODCALLTYPE
+
+struct RECT { LONG left, top, right, bottom; };
+struct POINT { LONG x, y; };
+struct LUID { DWORD LowPart; LONG HighPart; };
+
+#define ZeroMemory(dest, size) memset((dest), 0, (size))
+
+// result codes
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
+
+#define S_OK ((HRESULT)0)
+#define S_FALSE ((HRESULT)1)
+#define E_NOTIMPL ((HRESULT)0x80004001)
+#define E_NOINTERFACE ((HRESULT)0x80004002)
+#define E_POINTER ((HRESULT)0x80004003)
+#define E_FAIL ((HRESULT)0x80004005)
+#define E_OUTOFMEMORY ((HRESULT)0x8007000E)
+#define E_INVALIDARG ((HRESULT)0x80070057)
+
+#define DXGI_ERROR_INVALID_CALL ((HRESULT)0x887A0001)
+#define DXGI_ERROR_NOT_FOUND ((HRESULT)0x887A0002)
+#define DXGI_ERROR_MORE_DATA ((HRESULT)0x887A0003)
+#define DXGI_ERROR_UNSUPPORTED ((HRESULT)0x887A0004)
+#define DXGI_ERROR_DEVICE_REMOVED ((HRESULT)0x887A0005)
+#define DXGI_ERROR_DEVICE_HUNG ((HRESULT)0x887A0006)
+#define DXGI_ERROR_DEVICE_RESET ((HRESULT)0x887A0007)
+#define DXGI_ERROR_WAS_STILL_DRAWING ((HRESULT)0x887A000A)
+#define DXGI_ERROR_DRIVER_INTERNAL_ERROR ((HRESULT)0x887A0020)
+#define DXGI_ERROR_SDK_COMPONENT_MISSING ((HRESULT)0x887A002D)
+
+#define D3D11_ERROR_TOO_MANY_UNIQUE_STATE_OBJECTS ((HRESULT)0x887C0001)
+#define D3D11_ERROR_FILE_NOT_FOUND ((HRESULT)0x887C0002)
+#define D3D11_ERROR_TOO_MANY_UNIQUE_VIEW_OBJECTS ((HRESULT)0x887C0003)
+#define D3D11_ERROR_DEFERRED_CONTEXT_MAP_WITHOUT_INITIAL_DISCARD ((HRESULT)0x887C0004)
+
+// com
+
+struct GUID
+{
+	uint32_t Data1;
+	uint16_t Data2;
+	uint16_t Data3;
+	uint8_t Data4[8];
+};
+
+typedef GUID IID;
+typedef const GUID& REFGUID;
+typedef const IID& REFIID;
+
+inline bool operator==(REFGUID a, REFGUID b) { return memcmp(&a, &b, sizeof(GUID)) == 0; }
+inline bool operator!=(REFGUID a, REFGUID b) { return !(a == b); }
+
+// __uuidof is a compiler extension on windows, here every interface specializes this with its sdk id
+template <typename T>
+struct SfPortableUuid;
+
+#define SF_PORTABLE_UUID(type, l, w1, w2, b1, b2, b3, b4, b5, b6, b7, b8) \
+	struct type; \
+	template <> struct SfPortableUuid<type> { static constexpr GUID Value = { l, w1, w2, { b1, b2, b3, b4, b5, b6, b7, b8 } }; };
+
+#define __uuidof(type) (SfPortableUuid<std::remove_cv_t<type>>::Value)
+
+SF_PORTABLE_UUID(IUnknown, 0x00000000, 0x0000, 0x0000, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46)
+SF_PORTABLE_UUID(ID3D10Blob, 0x8ba5fb08, 0x5195, 0x40e2, 0xac, 0x58, 0x0d, 0x98, 0x9c, 0x3a, 0x01, 0x02)
+
+SF_PORTABLE_UUID(IDXGIObject, 0xaec22fb8, 0x76f3, 0x4639, 0x9b, 0xe0, 0x28, 0xeb, 0x43, 0xa6, 0x7a, 0x2e)
+SF_PORTABLE_UUID(IDXGIAdapter, 0x2411e7e1, 0x12ac, 0x4ccf, 0xbd, 0x14, 0x97, 0x98, 0xe8, 0x53, 0x4d, 0xc0)
+SF_PORTABLE_UUID(IDXGIDevice, 0x54ec77fa, 0x1377, 0x44e6, 0x8c, 0x32, 0x88, 0xfd, 0x5f, 0x44, 0xc8, 0x4c)
+SF_PORTABLE_UUID(IDXGIFactory, 0x7b7166ec, 0x21c7, 0x44ae, 0xb2, 0x1a, 0xc9, 0xae, 0x32, 0x1a, 0xe3, 0x69)
+SF_PORTABLE_UUID(IDXGISwapChain, 0x310d36a0, 0xd2e7, 0x4c0a, 0xaa, 0x04, 0x6a, 0x9d, 0x23, 0xb8, 0x88, 0x6a)
+
+SF_PORTABLE_UUID(ID3D11DeviceChild, 0x1841e5c8, 0x16b0, 0x489b, 0xbc, 0xc8, 0x44, 0xcf, 0xb0, 0xd5, 0xde, 0xae)
+SF_PORTABLE_UUID(ID3D11Resource, 0xdc8e63f3, 0xd12b, 0x4952, 0xb4, 0x7b, 0x5e, 0x45, 0x02, 0x6a, 0x86, 0x2d)
+SF_PORTABLE_UUID(ID3D11Buffer, 0x48570b85, 0xd1ee, 0x4fcd, 0xa2, 0x50, 0xeb, 0x35, 0x07, 0x22, 0xb0, 0x37)
+SF_PORTABLE_UUID(ID3D11Texture1D, 0xf8fb5c27, 0xc6b3, 0x4f75, 0xa4, 0xc8, 0x43, 0x9a, 0xf2, 0xef, 0x56, 0x4c)
+SF_PORTABLE_UUID(ID3D11Texture2D, 0x6f15aaf2, 0xd208, 0x4e89, 0x9a, 0xb4, 0x48, 0x95, 0x35, 0xd3, 0x4f, 0x9c)
+SF_PORTABLE_UUID(ID3D11Texture3D, 0x037e866e, 0xf56d, 0x4357, 0xa8, 0xaf, 0x9d, 0xab, 0xbe, 0x6e, 0x25, 0x0e)
+SF_PORTABLE_UUID(ID3D11View, 0x839d1216, 0xbb2e, 0x412b, 0xb7, 0xf4, 0xa9, 0xdb, 0xeb, 0xe0, 0x8e, 0xd1)
+SF_PORTABLE_UUID(ID3D11ShaderResourceView, 0xb0e06fe0, 0x8192, 0x4e1a, 0xb1, 0xca, 0x36, 0xd7, 0x41, 0x47, 0x10, 0xb2)
+SF_PORTABLE_UUID(ID3D11UnorderedAccessView, 0x28acf509, 0x7f5c, 0x48f6, 0x86, 0x11, 0xf3, 0x16, 0x01, 0x0a, 0x63, 0x80)
+SF_PORTABLE_UUID(ID3D11RenderTargetView, 0xdfdba067, 0x0b8d, 0x4865, 0x87, 0x5b, 0xd7, 0xb4, 0x51, 0x6c, 0xc1, 0x64)
+SF_PORTABLE_UUID(ID3D11DepthStencilView, 0x9fdac92a, 0x1876, 0x48c3, 0xaf, 0xad, 0x25, 0xb9, 0x4f, 0x84, 0xa9, 0xb6)
+SF_PORTABLE_UUID(ID3D11VertexShader, 0x3b301d64, 0xd678, 0x4289, 0x88, 0x97, 0x22, 0xf8, 0x92, 0x8b, 0x72, 0xf3)
+SF_PORTABLE_UUID(ID3D11HullShader, 0x8e5c6061, 0x628a, 0x4c8e, 0x82, 0x64, 0xbb, 0xe4, 0x5c, 0xb3, 0xd5, 0xdd)
+SF_PORTABLE_UUID(ID3D11DomainShader, 0xf582c508, 0x0f36, 0x490c, 0x99, 0x77, 0x31, 0xee, 0xce, 0x26, 0x8c, 0xfa)
+SF_PORTABLE_UUID(ID3D11GeometryShader, 0x38325b96, 0xeffb, 0x4022, 0xba, 0x02, 0x2e, 0x79, 0x5b, 0x70, 0x27, 0x5c)
+SF_PORTABLE_UUID(ID3D11PixelShader, 0xea82e40d, 0x51dc, 0x4f33, 0x93, 0xd4, 0xdb, 0x7c, 0x91, 0x25, 0xae, 0x8c)
+SF_PORTABLE_UUID(ID3D11ComputeShader, 0x4f5b196e, 0xc2bd, 0x495e, 0xbd, 0x01, 0x1f, 0xde, 0xd3, 0x8e, 0x49, 0x69)
+SF_PORTABLE_UUID(ID3D11InputLayout, 0xe4819ddc, 0x4cf0, 0x4025, 0xbd, 0x26, 0x5d, 0xe8, 0x2a, 0x3e, 0x07, 0xb7)
+SF_PORTABLE_UUID(ID3D11SamplerState, 0xda6fea51, 0x564c, 0x4487, 0x98, 0x10, 0xf0, 0xd0, 0xf9, 0xb4, 0xe3, 0xa5)
+SF_PORTABLE_UUID(ID3D11BlendState, 0x75b68faa, 0x347d, 0x4159, 0x8f, 0x45, 0xa0, 0x64, 0x0f, 0x01, 0xcd, 0x9a)
+SF_PORTABLE_UUID(ID3D11DepthStencilState, 0x03823efb, 0x8d8f, 0x4e1c, 0x9a, 0xa2, 0xf6, 0x4b, 0xb2, 0xcb, 0xfd, 0xf1)
+SF_PORTABLE_UUID(ID3D11RasterizerState, 0x9bb4ab81, 0xab1a, 0x4d8f, 0xb5, 0x06, 0xfc, 0x04, 0x20, 0x0b, 0x6e, 0xe7)
+SF_PORTABLE_UUID(ID3D11Asynchronous, 0x4b35d0cd, 0x1e15, 0x4258, 0x9c, 0x98, 0x1b, 0x13, 0x33, 0xf6, 0xdd, 0x3b)
+SF_PORTABLE_UUID(ID3D11Query, 0xd6c00747, 0x87b7, 0x425e, 0xb8, 0x4d, 0x44, 0xd1, 0x08, 0x56, 0x0a, 0xfd)
+SF_PORTABLE_UUID(ID3D11Predicate, 0x9eb576dd, 0x9f77, 0x4d86, 0x81, 0xaa, 0x8b, 0xab, 0x5f, 0xe4, 0x90, 0xe2)
+SF_PORTABLE_UUID(ID3D11Counter, 0x6e8c49fb, 0xa371, 0x4770, 0xb4, 0x40, 0x29, 0x08, 0x60, 0x22, 0xb7, 0x41)
+SF_PORTABLE_UUID(ID3D11ClassInstance, 0xa6cd7faa, 0xb0b7, 0x4a2f, 0x94, 0x36, 0x86, 0x62, 0xa6, 0x57, 0x97, 0xcb)
+SF_PORTABLE_UUID(ID3D11ClassLinkage, 0xddf57cba, 0x9543, 0x46e4, 0xa1, 0x2b, 0xf2, 0x07, 0xa0, 0xfe, 0x7f, 0xed)
+SF_PORTABLE_UUID(ID3D11CommandList, 0xa24bc4d1, 0x769e, 0x43f7, 0x80, 0x13, 0x98, 0xff, 0x56, 0x6c, 0x18, 0xe2)
+SF_PORTABLE_UUID(ID3D11DeviceContext, 0xc0bfa96c, 0xe089, 0x44fb, 0x8e, 0xaf, 0x26, 0xf8, 0x79, 0x61, 0x90, 0xda)
+SF_PORTABLE_UUID(ID3D11DeviceContext1, 0xbb2c6faa, 0xb5fb, 0x4082, 0x8e, 0x6b, 0x38, 0x8b, 0x8c, 0xfa, 0x90, 0xe1)
+SF_PORTABLE_UUID(ID3D11Device, 0xdb6f6ddb, 0xac77, 0x4e88, 0x82, 0x53, 0x81, 0x9d, 0xf9, 0xbb, 0xf1, 0x40)
+SF_PORTABLE_UUID(ID3DDeviceContextState, 0x5c1e0d8a, 0x7c23, 0x48f9, 0x8c, 0x59, 0xa9, 0x29, 0x58, 0xce, 0xff, 0x11)
+
+struct IUnknown
+{
+	virtual HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) = 0;
+	virtual ULONG STDMETHODCALLTYPE AddRef() = 0;
+	virtual ULONG STDMETHODCALLTYPE Release() = 0;
+
+	template <typename Q>
+	HRESULT QueryInterface(Q** object) { return QueryInterface(__uuidof(Q), (void**)object); }
+};
+
+struct ID3D10Blob : public IUnknown
+{
+	virtual LPVOID STDMETHODCALLTYPE GetBufferPointer() = 0;
+	virtual SIZE_T STDMETHODCALLTYPE GetBufferSize() = 0;
+};
+typedef ID3D10Blob ID3DBlob;
+
+// the parts of Microsoft::WRL::ComPtr sf11 uses, with the same semantics
+namespace Microsoft { namespace WRL {
+
+template <typename T>
+class ComPtr;
+
+namespace Details {
+
+// what &ptr returns, releases the held pointer before handing out its address
+template <typename T>
+class ComPtrRef
+{
+	T* Ptr;
+
+public:
+
+	typedef typename T::InterfaceType InterfaceType;
+
+	explicit ComPtrRef(T* ptr) : Ptr(ptr) {}
+
+	operator InterfaceType**() { return Ptr->ReleaseAndGetAddressOf(); }
+	operator void**() const { return (void**)Ptr->ReleaseAndGetAddressOf(); }
+	operator T*() { return Ptr; }
+	InterfaceType* const* GetAddressOf() const { return Ptr->GetAddressOf(); }
+	InterfaceType** ReleaseAndGetAddressOf() { return Ptr->ReleaseAndGetAddressOf(); }
+};
+
+}
+
+template <typename T>
+class ComPtr
+{
+	template <typename U> friend class ComPtr;
+
+	T* Ptr = nullptr;
+
+	void InternalAddRef() const { if (Ptr) Ptr->AddRef(); }
+
+public:
+
+	typedef T InterfaceType;
+
+	ComPtr() = default;
+	ComPtr(decltype(nullptr)) {}
+	template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+	ComPtr(U* other) : Ptr(other) { InternalAddRef(); }
+	ComPtr(const ComPtr& other) : Ptr(other.Ptr) { InternalAddRef(); }
+	template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+	ComPtr(const ComPtr<U>& other) : Ptr(other.Ptr) { InternalAddRef(); }
+	ComPtr(ComPtr&& other) noexcept : Ptr(other.Ptr) { other.Ptr = nullptr; }
+	template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+	ComPtr(ComPtr<U>&& other) noexcept : Ptr(other.Ptr) { other.Ptr = nullptr; }
+	~ComPtr() { Reset(); }
+
+	ComPtr& operator=(decltype(nullptr)) { Reset(); return *this; }
+	ComPtr& operator=(T* other) { ComPtr(other).Swap(*this); return *this; }
+	ComPtr& operator=(const ComPtr& other) { ComPtr(other).Swap(*this); return *this; }
+	ComPtr& operator=(ComPtr&& other) noexcept { ComPtr(static_cast<ComPtr&&>(other)).Swap(*this); return *this; }
+	template <typename U>
+	ComPtr& operator=(const ComPtr<U>& other) { ComPtr(other).Swap(*this); return *this; }
+
+	void Swap(ComPtr& other) { T* ptr = Ptr; Ptr = other.Ptr; other.Ptr = ptr; }
+
+	T* Get() const { return Ptr; }
+	T* operator->() const { return Ptr; }
+	// converts like the sdk version, to bool but not to integers
+	typedef T* ComPtr::*BoolType;
+	operator BoolType() const { return Ptr ? &ComPtr::Ptr : nullptr; }
+	Details::ComPtrRef<ComPtr> operator&() { return Details::ComPtrRef<ComPtr>(this); }
+
+	T* const* GetAddressOf() const { return &Ptr; }
+	T** GetAddressOf() { return &Ptr; }
+	T** ReleaseAndGetAddressOf() { Reset(); return &Ptr; }
+
+	T* Detach() { T* ptr = Ptr; Ptr = nullptr; return ptr; }
+	void Attach(T* other) { if (Ptr != other) { Reset(); Ptr = other; } }
+
+	ULONG Reset()
+	{
+		T* ptr = Ptr;
+		if (!ptr) return 0;
+		Ptr = nullptr;
+		return ptr->Release();
+	}
+
+	HRESULT CopyTo(T** out) const { InternalAddRef(); *out = Ptr; return S_OK; }
+	HRESULT CopyTo(REFIID riid, void** out) const { return Ptr->QueryInterface(riid, out); }
+	template <typename U>
+	HRESULT CopyTo(U** out) const { return Ptr->QueryInterface(__uuidof(U), (void**)out); }
+
+	template <typename U>
+	HRESULT As(ComPtr<U>* out) const { return Ptr->QueryInterface(__uuidof(U), (void**)out->ReleaseAndGetAddressOf()); }
+	template <typename U>
+	HRESULT As(Details::ComPtrRef<ComPtr<U>> out) const { return As((ComPtr<U>*)out); }
+	HRESULT AsIID(REFIID riid, ComPtr<IUnknown>* out) const { return Ptr->QueryInterface(riid, (void**)out->ReleaseAndGetAddressOf()); }
+};
+
+template <typename T, typename U>
+bool operator==(const ComPtr<T>& a, const ComPtr<U>& b) { return a.Get() == b.Get(); }
+template <typename T, typename U>
+bool operator!=(const ComPtr<T>& a, const ComPtr<U>& b) { return a.Get() != b.Get(); }
+template <typename T>
+bool operator==(const ComPtr<T>& a, decltype(nullptr)) { return a.Get() == nullptr; }
+template <typename T>
+bool operator!=(const ComPtr<T>& a, decltype(nullptr)) { return a.Get() != nullptr; }
+
+} }
+
+// dxgi
+
+// enums are int sized like msvc makes them, sf11 marks invalidated state cache entries with all bits set
+enum DXGI_FORMAT : int
+{
+	DXGI_FORMAT_UNKNOWN = 0,
+	DXGI_FORMAT_R32G32B32A32_TYPELESS = 1,
+	DXGI_FORMAT_R32G32B32A32_FLOAT = 2,
+	DXGI_FORMAT_R32G32B32A32_UINT = 3,
+	DXGI_FORMAT_R32G32B32A32_SINT = 4,
+	DXGI_FORMAT_R32G32B32_TYPELESS = 5,
+	DXGI_FORMAT_R32G32B32_FLOAT = 6,
+	DXGI_FORMAT_R32G32B32_UINT = 7,
+	DXGI_FORMAT_R32G32B32_SINT = 8,
+	DXGI_FORMAT_R16G16B16A16_TYPELESS = 9,
+	DXGI_FORMAT_R16G16B16A16_FLOAT = 10,
+	DXGI_FORMAT_R16G16B16A16_UNORM = 11,
+	DXGI_FORMAT_R16G16B16A16_UINT = 12,
+	DXGI_FORMAT_R16G16B16A16_SNORM = 13,
+	DXGI_FORMAT_R16G16B16A16_SINT = 14,
+	DXGI_FORMAT_R32G32_TYPELESS = 15,
+	DXGI_FORMAT_R32G32_FLOAT = 16,
+	DXGI_FORMAT_R32G32_UINT = 17,
+	DXGI_FORMAT_R32G32_SINT = 18,
+	DXGI_FORMAT_R32G8X24_TYPELESS = 19,
+	DXGI_FORMAT_D32_FLOAT_S8X24_UINT = 20,
+	DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS = 21,
+	DXGI_FORMAT_X32_TYPELESS_G8X24_UINT = 22,
+	DXGI_FORMAT_R10G10B10A2_TYPELESS = 23,
+	DXGI_FORMAT_R10G10B10A2_UNORM = 24,
+	DXGI_FORMAT_R10G10B10A2_UINT = 25,
+	DXGI_FORMAT_R11G11B10_FLOAT = 26,
+	DXGI_FORMAT_R8G8B8A8_TYPELESS = 27,
+	DXGI_FORMAT_R8G8B8A8_UNORM = 28,
+	DXGI_FORMAT_R8G8B8A8_UNORM_SRGB = 29,
+	DXGI_FORMAT_R8G8B8A8_UINT = 30,
+	DXGI_FORMAT_R8G8B8A8_SNORM = 31,
+	DXGI_FORMAT_R8G8B8A8_SINT = 32,
+	DXGI_FORMAT_R16G16_TYPELESS = 33,
+	DXGI_FORMAT_R16G16_FLOAT = 34,
+	DXGI_FORMAT_R16G16_UNORM = 35,
+	DXGI_FORMAT_R16G16_UINT = 36,
+	DXGI_FORMAT_R16G16_SNORM = 37,
+	DXGI_FORMAT_R16G16_SINT = 38,
+	DXGI_FORMAT_R32_TYPELESS = 39,
+	DXGI_FORMAT_D32_FLOAT = 40,
+	DXGI_FORMAT_R32_FLOAT = 41,
+	DXGI_FORMAT_R32_UINT = 42,
+	DXGI_FORMAT_R32_SINT = 43,
+	DXGI_FORMAT_R24G8_TYPELESS = 44,
+	DXGI_FORMAT_D24_UNORM_S8_UINT = 45,
+	DXGI_FORMAT_R24_UNORM_X8_TYPELESS = 46,
+	DXGI_FORMAT_X24_TYPELESS_G8_UINT = 47,
+	DXGI_FORMAT_R8G8_TYPELESS = 48,
+	DXGI_FORMAT_R8G8_UNORM = 49,
+	DXGI_FORMAT_R8G8_UINT = 50,
+	DXGI_FORMAT_R8G8_SNORM = 51,
+	DXGI_FORMAT_R8G8_SINT = 52,
+	DXGI_FORMAT_R16_TYPELESS = 53,
+	DXGI_FORMAT_R16_FLOAT = 54,
+	DXGI_FORMAT_D16_UNORM = 55,
+	DXGI_FORMAT_R16_UNORM = 56,
+	DXGI_FORMAT_R16_UINT = 57,
+	DXGI_FORMAT_R16_SNORM = 58,
+	DXGI_FORMAT_R16_SINT = 59,
+	DXGI_FORMAT_R8_TYPELESS = 60,
+	DXGI_FORMAT_R8_UNORM = 61,
+	DXGI_FORMAT_R8_UINT = 62,
+	DXGI_FORMAT_R8_SNORM = 63,
+	DXGI_FORMAT_R8_SINT = 64,
+	DXGI_FORMAT_A8_UNORM = 65,
+	DXGI_FORMAT_R1_UNORM = 66,
+	DXGI_FORMAT_R9G9B9E5_SHAREDEXP = 67,
+	DXGI_FORMAT_R8G8_B8G8_UNORM = 68,
+	DXGI_FORMAT_G8R8_G8B8_UNORM = 69,
+	DXGI_FORMAT_BC1_TYPELESS = 70,
+	DXGI_FORMAT_BC1_UNORM = 71,
+	DXGI_FORMAT_BC1_UNORM_SRGB = 72,
+	DXGI_FORMAT_BC2_TYPELESS = 73,
+	DXGI_FORMAT_BC2_UNORM = 74,
+	DXGI_FORMAT_BC2_UNORM_SRGB = 75,
+	DXGI_FORMAT_BC3_TYPELESS = 76,
+	DXGI_FORMAT_BC3_UNORM = 77,
+	DXGI_FORMAT_BC3_UNORM_SRGB = 78,
+	DXGI_FORMAT_BC4_TYPELESS = 79,
+	DXGI_FORMAT_BC4_UNORM = 80,
+	DXGI_FORMAT_BC4_SNORM = 81,
+	DXGI_FORMAT_BC5_TYPELESS = 82,
+	DXGI_FORMAT_BC5_UNORM = 83,
+	DXGI_FORMAT_BC5_SNORM = 84,
+	DXGI_FORMAT_B5G6R5_UNORM = 85,
+	DXGI_FORMAT_B5G5R5A1_UNORM = 86,
+	DXGI_FORMAT_B8G8R8A8_UNORM = 87,
+	DXGI_FORMAT_B8G8R8X8_UNORM = 88,
+	DXGI_FORMAT_R10G10B10_XR_BIAS_A2_UNORM = 89,
+	DXGI_FORMAT_B8G8R8A8_TYPELESS = 90,
+	DXGI_FORMAT_B8G8R8A8_UNORM_SRGB = 91,
+	DXGI_FORMAT_B8G8R8X8_TYPELESS = 92,
+	DXGI_FORMAT_B8G8R8X8_UNORM_SRGB = 93,
+	DXGI_FORMAT_BC6H_TYPELESS = 94,
+	DXGI_FORMAT_BC6H_UF16 = 95,
+	DXGI_FORMAT_BC6H_SF16 = 96,
+	DXGI_FORMAT_BC7_TYPELESS = 97,
+	DXGI_FORMAT_BC7_UNORM = 98,
+	DXGI_FORMAT_BC7_UNORM_SRGB = 99,
+	DXGI_FORMAT_AYUV = 100,
+	DXGI_FORMAT_Y410 = 101,
+	DXGI_FORMAT_Y416 = 102,
+	DXGI_FORMAT_NV12 = 103,
+	DXGI_FORMAT_P010 = 104,
+	DXGI_FORMAT_P016 = 105,
+	DXGI_FORMAT_420_OPAQUE = 106,
+	DXGI_FORMAT_YUY2 = 107,
+	DXGI_FORMAT_Y210 = 108,
+	DXGI_FORMAT_Y216 = 109,
+	DXGI_FORMAT_NV11 = 110,
+	DXGI_FORMAT_AI44 = 111,
+	DXGI_FORMAT_IA44 = 112,
+	DXGI_FORMAT_P8 = 113,
+	DXGI_FORMAT_A8P8 = 114,
+	DXGI_FORMAT_B4G4R4A4_UNORM = 115
+};
+
+#define DXGI_USAGE_SHADER_INPUT 0x00000010UL
+#define DXGI_USAGE_RENDER_TARGET_OUTPUT 0x00000020UL
+typedef UINT DXGI_USAGE;
+
+enum DXGI_MODE_SCANLINE_ORDER : int
+{
+	DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED = 0,
+	DXGI_MODE_SCANLINE_ORDER_PROGRESSIVE = 1,
+	DXGI_MODE_SCANLINE_ORDER_UPPER_FIELD_FIRST = 2,
+	DXGI_MODE_SCANLINE_ORDER_LOWER_FIELD_FIRST = 3
+};
+
+enum DXGI_MODE_SCALING : int
+{
+	DXGI_MODE_SCALING_UNSPECIFIED = 0,
+	DXGI_MODE_SCALING_CENTERED = 1,
+	DXGI_MODE_SCALING_STRETCHED = 2
+};
+
+enum DXGI_SWAP_EFFECT : int
+{
+	DXGI_SWAP_EFFECT_DISCARD = 0,
+	DXGI_SWAP_EFFECT_SEQUENTIAL = 1,
+	DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL = 3,
+	DXGI_SWAP_EFFECT_FLIP_DISCARD = 4
+};
+
+enum DXGI_SWAP_CHAIN_FLAG : int
+{
+	DXGI_SWAP_CHAIN_FLAG_NONPREROTATED = 1,
+	DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH = 2,
+	DXGI_SWAP_CHAIN_FLAG_GDI_COMPATIBLE = 4
+};
+
+struct DXGI_RATIONAL
+{
+	UINT Numerator;
+	UINT Denominator;
+};
+
+struct DXGI_SAMPLE_DESC
+{
+	UINT Count;
+	UINT Quality;
+};
+
+struct DXGI_MODE_DESC
+{
+	UINT Width;
+	UINT Height;
+	DXGI_RATIONAL RefreshRate;
+	DXGI_FORMAT Format;
+	DXGI_MODE_SCANLINE_ORDER ScanlineOrdering;
+	DXGI_MODE_SCALING Scaling;
+};
+
+struct DXGI_SWAP_CHAIN_DESC
+{
+	DXGI_MODE_DESC BufferDesc;
+	DXGI_SAMPLE_DESC SampleDesc;
+	DXGI_USAGE BufferUsage;
+	UINT BufferCount;
+	HWND OutputWindow;
+	BOOL Windowed;
+	DXGI_SWAP_EFFECT SwapEffect;
+	UINT Flags;
+};
+
+struct DXGI_ADAPTER_DESC
+{
+	WCHAR Description[128];
+	UINT VendorId;
+	UINT DeviceId;
+	UINT SubSysId;
+	UINT Revision;
+	SIZE_T DedicatedVideoMemory;
+	SIZE_T DedicatedSystemMemory;
+	SIZE_T SharedSystemMemory;
+	LUID AdapterLuid;
+};
+
+// nothing implements these off windows, they are declared so adapters and windows still compile
+struct IDXGIObject : public IUnknown
+{
+	virtual HRESULT STDMETHODCALLTYPE GetParent(REFIID riid, void** parent) = 0;
+};
+
+struct IDXGIAdapter : public IDXGIObject
+{
+	virtual HRESULT STDMETHODCALLTYPE GetDesc(DXGI_ADAPTER_DESC* desc) = 0;
+};
+
+struct IDXGIDevice : public IDXGIObject
+{
+	virtual HRESULT STDMETHODCALLTYPE GetAdapter(IDXGIAdapter** adapter) = 0;
+};
+
+struct IDXGISwapChain : public IDXGIObject
+{
+	virtual HRESULT STDMETHODCALLTYPE Present(UINT syncInterval, UINT flags) = 0;
+	virtual HRESULT STDMETHODCALLTYPE GetBuffer(UINT buffer, REFIID riid, void** surface) = 0;
+	virtual HRESULT STDMETHODCALLTYPE ResizeBuffers(UINT bufferCount, UINT width, UINT height, DXGI_FORMAT format, UINT flags) = 0;
+};
+
+struct IDXGIFactory : public IDXGIObject
+{
+	virtual HRESULT STDMETHODCALLTYPE EnumAdapters(UINT adapter, IDXGIAdapter** out) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateSwapChain(IUnknown* device, DXGI_SWAP_CHAIN_DESC* desc, IDXGISwapChain** swapChain) = 0;
+};
+
+// d3d common
+
+enum D3D_DRIVER_TYPE : int
+{
+	D3D_DRIVER_TYPE_UNKNOWN = 0,
+	D3D_DRIVER_TYPE_HARDWARE = 1,
+	D3D_DRIVER_TYPE_REFERENCE = 2,
+	D3D_DRIVER_TYPE_NULL = 3,
+	D3D_DRIVER_TYPE_SOFTWARE = 4,
+	D3D_DRIVER_TYPE_WARP = 5
+};
+
+enum D3D_FEATURE_LEVEL : int
+{
+	D3D_FEATURE_LEVEL_9_1 = 0x9100,
+	D3D_FEATURE_LEVEL_9_2 = 0x9200,
+	D3D_FEATURE_LEVEL_9_3 = 0x9300,
+	D3D_FEATURE_LEVEL_10_0 = 0xa000,
+	D3D_FEATURE_LEVEL_10_1 = 0xa100,
+	D3D_FEATURE_LEVEL_11_0 = 0xb000,
+	D3D_FEATURE_LEVEL_11_1 = 0xb100
+};
+
+enum D3D_PRIMITIVE_TOPOLOGY : int
+{
+	D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED = 0,
+	D3D11_PRIMITIVE_TOPOLOGY_POINTLIST = 1,
+	D3D11_PRIMITIVE_TOPOLOGY_LINELIST = 2,
+	D3D11_PRIMITIVE_TOPOLOGY_LINESTRIP = 3,
+	D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST = 4,
+	D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP = 5,
+	D3D11_PRIMITIVE_TOPOLOGY_LINELIST_ADJ = 10,
+	D3D11_PRIMITIVE_TOPOLOGY_LINESTRIP_ADJ = 11,
+	D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST_ADJ = 12,
+	D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP_ADJ = 13,
+	D3D11_PRIMITIVE_TOPOLOGY_3_CONTROL_POINT_PATCHLIST = 35,
+	D3D11_PRIMITIVE_TOPOLOGY_4_CONTROL_POINT_PATCHLIST = 36
+};
+typedef D3D_PRIMITIVE_TOPOLOGY D3D11_PRIMITIVE_TOPOLOGY;
+
+enum D3D_SRV_DIMENSION : int
+{
+	D3D11_SRV_DIMENSION_UNKNOWN = 0,
+	D3D11_SRV_DIMENSION_BUFFER = 1,
+	D3D11_SRV_DIMENSION_TEXTURE1D = 2,
+	D3D11_SRV_DIMENSION_TEXTURE1DARRAY = 3,
+	D3D11_SRV_DIMENSION_TEXTURE2D = 4,
+	D3D11_SRV_DIMENSION_TEXTURE2DARRAY = 5,
+	D3D11_SRV_DIMENSION_TEXTURE2DMS = 6,
+	D3D11_SRV_DIMENSION_TEXTURE2DMSARRAY = 7,
+	D3D11_SRV_DIMENSION_TEXTURE3D = 8,
+	D3D11_SRV_DIMENSION_TEXTURECUBE = 9,
+	D3D11_SRV_DIMENSION_TEXTURECUBEARRAY = 10,
+	D3D11_SRV_DIMENSION_BUFFEREX = 11
+};
+typedef D3D_SRV_DIMENSION D3D11_SRV_DIMENSION;
+
+// d3d11
+
+#define D3D11_SDK_VERSION 7
+
+#define D3D11_APPEND_ALIGNED_ELEMENT 0xffffffff
+#define D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT 14
+#define D3D11_COMMONSHADER_CONSTANT_BUFFER_HW_SLOT_COUNT 15
+#define D3D11_COMMONSHADER_INPUT_RESOURCE_REGISTER_COUNT 128
+#define D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT 16
+#define D3D11_DEFAULT_STENCIL_READ_MASK 0xff
+#define D3D11_DEFAULT_STENCIL_WRITE_MASK 0xff
+#define D3D11_FLOAT32_MAX 3.402823466e+38f
+#define D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT 32
+#define D3D11_KEEP_RENDER_TARGETS_AND_DEPTH_STENCIL 0xffffffff
+#define D3D11_KEEP_UNORDERED_ACCESS_VIEWS 0xffffffff
+#define D3D11_PS_CS_UAV_REGISTER_COUNT 8
+#define D3D11_1_UAV_SLOT_COUNT 64
+#define D3D11_REQ_CONSTANT_BUFFER_ELEMENT_COUNT 4096
+#define D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT 8
+#define D3D11_SO_BUFFER_SLOT_COUNT 4
+#define D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE 16
+#define D3D10_COLOR_WRITE_ENABLE_ALL 15
+
+enum D3D11_USAGE : int
+{
+	D3D11_USAGE_DEFAULT = 0,
+	D3D11_USAGE_IMMUTABLE = 1,
+	D3D11_USAGE_DYNAMIC = 2,
+	D3D11_USAGE_STAGING = 3
+};
+
+enum D3D11_BIND_FLAG : int
+{
+	D3D11_BIND_VERTEX_BUFFER = 0x1,
+	D3D11_BIND_INDEX_BUFFER = 0x2,
+	D3D11_BIND_CONSTANT_BUFFER = 0x4,
+	D3D11_BIND_SHADER_RESOURCE = 0x8,
+	D3D11_BIND_STREAM_OUTPUT = 0x10,
+	D3D11_BIND_RENDER_TARGET = 0x20,
+	D3D11_BIND_DEPTH_STENCIL = 0x40,
+	D3D11_BIND_UNORDERED_ACCESS = 0x80
+};
+
+enum D3D11_CPU_ACCESS_FLAG : int
+{
+	D3D11_CPU_ACCESS_WRITE = 0x10000,
+	D3D11_CPU_ACCESS_READ = 0x20000
+};
+
+enum D3D11_RESOURCE_MISC_FLAG : int
+{
+	D3D11_RESOURCE_MISC_GENERATE_MIPS = 0x1,
+	D3D11_RESOURCE_MISC_SHARED = 0x2,
+	D3D11_RESOURCE_MISC_TEXTURECUBE = 0x4,
+	D3D11_RESOURCE_MISC_DRAWINDIRECT_ARGS = 0x10,
+	D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS = 0x20,
+	D3D11_RESOURCE_MISC_BUFFER_STRUCTURED = 0x40
+};
+
+enum D3D11_MAP : int
+{
+	D3D11_MAP_READ = 1,
+	D3D11_MAP_WRITE = 2,
+	D3D11_MAP_READ_WRITE = 3,
+	D3D11_MAP_WRITE_DISCARD = 4,
+	D3D11_MAP_WRITE_NO_OVERWRITE = 5
+};
+
+enum D3D11_MAP_FLAG : int
+{
+	D3D11_MAP_FLAG_DO_NOT_WAIT = 0x100000
+};
+
+enum D3D11_ASYNC_GETDATA_FLAG : int
+{
+	D3D11_ASYNC_GETDATA_DONOTFLUSH = 0x1
+};
+
+enum D3D11_CLEAR_FLAG : int
+{
+	D3D11_CLEAR_DEPTH = 0x1,
+	D3D11_CLEAR_STENCIL = 0x2
+};
+
+enum D3D11_CREATE_DEVICE_FLAG : int
+{
+	D3D11_CREATE_DEVICE_SINGLETHREADED = 0x1,
+	D3D11_CREATE_DEVICE_DEBUG = 0x2,
+	D3D11_CREATE_DEVICE_BGRA_SUPPORT = 0x20
+};
+
+enum D3D11_COMPARISON_FUNC : int
+{
+	D3D11_COMPARISON_NEVER = 1,
+	D3D11_COMPARISON_LESS = 2,
+	D3D11_COMPARISON_EQUAL = 3,
+	D3D11_COMPARISON_LESS_EQUAL = 4,
+	D3D11_COMPARISON_GREATER = 5,
+	D3D11_COMPARISON_NOT_EQUAL = 6,
+	D3D11_COMPARISON_GREATER_EQUAL = 7,
+	D3D11_COMPARISON_ALWAYS = 8
+};
+
+enum D3D11_DEPTH_WRITE_MASK : int
+{
+	D3D11_DEPTH_WRITE_MASK_ZERO = 0,
+	D3D11_DEPTH_WRITE_MASK_ALL = 1
+};
+
+enum D3D11_STENCIL_OP : int
+{
+	D3D11_STENCIL_OP_KEEP = 1,
+	D3D11_STENCIL_OP_ZERO = 2,
+	D3D11_STENCIL_OP_REPLACE = 3,
+	D3D11_STENCIL_OP_INCR_SAT = 4,
+	D3D11_STENCIL_OP_DECR_SAT = 5,
+	D3D11_STENCIL_OP_INVERT = 6,
+	D3D11_STENCIL_OP_INCR = 7,
+	D3D11_STENCIL_OP_DECR = 8
+};
+
+enum D3D11_FILL_MODE : int
+{
+	D3D11_FILL_WIREFRAME = 2,
+	D3D11_FILL_SOLID = 3
+};
+
+enum D3D11_CULL_MODE : int
+{
+	D3D11_CULL_NONE = 1,
+	D3D11_CULL_FRONT = 2,
+	D3D11_CULL_BACK = 3
+};
+
+enum D3D11_FILTER : int
+{
+	D3D11_FILTER_MIN_MAG_MIP_POINT = 0,
+	D3D11_FILTER_MIN_MAG_POINT_MIP_LINEAR = 0x1,
+	D3D11_FILTER_MIN_POINT_MAG_LINEAR_MIP_POINT = 0x4,
+	D3D11_FILTER_MIN_POINT_MAG_MIP_LINEAR = 0x5,
+	D3D11_FILTER_MIN_LINEAR_MAG_MIP_POINT = 0x10,
+	D3D11_FILTER_MIN_LINEAR_MAG_POINT_MIP_LINEAR = 0x11,
+	D3D11_FILTER_MIN_MAG_LINEAR_MIP_POINT = 0x14,
+	D3D11_FILTER_MIN_MAG_MIP_LINEAR = 0x15,
+	D3D11_FILTER_ANISOTROPIC = 0x55,
+	D3D11_FILTER_COMPARISON_MIN_MAG_MIP_POINT = 0x80,
+	D3D11_FILTER_COMPARISON_MIN_MAG_MIP_LINEAR = 0x95,
+	D3D11_FILTER_COMPARISON_ANISOTROPIC = 0xd5
+};
+
+enum D3D11_TEXTURE_ADDRESS_MODE : int
+{
+	D3D11_TEXTURE_ADDRESS_WRAP = 1,
+	D3D11_TEXTURE_ADDRESS_MIRROR = 2,
+	D3D11_TEXTURE_ADDRESS_CLAMP = 3,
+	D3D11_TEXTURE_ADDRESS_BORDER = 4,
+	D3D11_TEXTURE_ADDRESS_MIRROR_ONCE = 5
+};
+
+enum D3D11_BLEND : int
+{
+	D3D11_BLEND_ZERO = 1,
+	D3D11_BLEND_ONE = 2,
+	D3D11_BLEND_SRC_COLOR = 3,
+	D3D11_BLEND_INV_SRC_COLOR = 4,
+	D3D11_BLEND_SRC_ALPHA = 5,
+	D3D11_BLEND_INV_SRC_ALPHA = 6,
+	D3D11_BLEND_DEST_ALPHA = 7,
+	D3D11_BLEND_INV_DEST_ALPHA = 8,
+	D3D11_BLEND_DEST_COLOR = 9,
+	D3D11_BLEND_INV_DEST_COLOR = 10,
+	D3D11_BLEND_SRC_ALPHA_SAT = 11,
+	D3D11_BLEND_BLEND_FACTOR = 14,
+	D3D11_BLEND_INV_BLEND_FACTOR = 15,
+	D3D11_BLEND_SRC1_COLOR = 16,
+	D3D11_BLEND_INV_SRC1_COLOR = 17,
+	D3D11_BLEND_SRC1_ALPHA = 18,
+	D3D11_BLEND_INV_SRC1_ALPHA = 19
+};
+
+enum D3D11_BLEND_OP : int
+{
+	D3D11_BLEND_OP_ADD = 1,
+	D3D11_BLEND_OP_SUBTRACT = 2,
+	D3D11_BLEND_OP_REV_SUBTRACT = 3,
+	D3D11_BLEND_OP_MIN = 4,
+	D3D11_BLEND_OP_MAX = 5
+};
+
+enum D3D11_COLOR_WRITE_ENABLE : int
+{
+	D3D11_COLOR_WRITE_ENABLE_RED = 1,
+	D3D11_COLOR_WRITE_ENABLE_GREEN = 2,
+	D3D11_COLOR_WRITE_ENABLE_BLUE = 4,
+	D3D11_COLOR_WRITE_ENABLE_ALPHA = 8,
+	D3D11_COLOR_WRITE_ENABLE_ALL = 15
+};
+
+enum D3D11_INPUT_CLASSIFICATION : int
+{
+	D3D11_INPUT_PER_VERTEX_DATA = 0,
+	D3D11_INPUT_PER_INSTANCE_DATA = 1
+};
+
+enum D3D11_BUFFER_UAV_FLAG : int
+{
+	D3D11_BUFFER_UAV_FLAG_RAW = 0x1,
+	D3D11_BUFFER_UAV_FLAG_APPEND = 0x2,
+	D3D11_BUFFER_UAV_FLAG_COUNTER = 0x4
+};
+
+enum D3D11_UAV_DIMENSION : int
+{
+	D3D11_UAV_DIMENSION_UNKNOWN = 0,
+	D3D11_UAV_DIMENSION_BUFFER = 1,
+	D3D11_UAV_DIMENSION_TEXTURE1D = 2,
+	D3D11_UAV_DIMENSION_TEXTURE1DARRAY = 3,
+	D3D11_UAV_DIMENSION_TEXTURE2D = 4,
+	D3D11_UAV_DIMENSION_TEXTURE2DARRAY = 5,
+	D3D11_UAV_DIMENSION_TEXTURE3D = 8
+};
+
+enum D3D11_RTV_DIMENSION : int
+{
+	D3D11_RTV_DIMENSION_UNKNOWN = 0,
+	D3D11_RTV_DIMENSION_BUFFER = 1,
+	D3D11_RTV_DIMENSION_TEXTURE1D = 2,
+	D3D11_RTV_DIMENSION_TEXTURE1DARRAY = 3,
+	D3D11_RTV_DIMENSION_TEXTURE2D = 4,
+	D3D11_RTV_DIMENSION_TEXTURE2DARRAY = 5,
+	D3D11_RTV_DIMENSION_TEXTURE2DMS = 6,
+	D3D11_RTV_DIMENSION_TEXTURE2DMSARRAY = 7,
+	D3D11_RTV_DIMENSION_TEXTURE3D = 8
+};
+
+enum D3D11_DSV_DIMENSION : int
+{
+	D3D11_DSV_DIMENSION_UNKNOWN = 0,
+	D3D11_DSV_DIMENSION_TEXTURE1D = 1,
+	D3D11_DSV_DIMENSION_TEXTURE1DARRAY = 2,
+	D3D11_DSV_DIMENSION_TEXTURE2D = 3,
+	D3D11_DSV_DIMENSION_TEXTURE2DARRAY = 4,
+	D3D11_DSV_DIMENSION_TEXTURE2DMS = 5,
+	D3D11_DSV_DIMENSION_TEXTURE2DMSARRAY = 6
+};
+
+enum D3D11_RESOURCE_DIMENSION : int
+{
+	D3D11_RESOURCE_DIMENSION_UNKNOWN = 0,
+	D3D11_RESOURCE_DIMENSION_BUFFER = 1,
+	D3D11_RESOURCE_DIMENSION_TEXTURE1D = 2,
+	D3D11_RESOURCE_DIMENSION_TEXTURE2D = 3,
+	D3D11_RESOURCE_DIMENSION_TEXTURE3D = 4
+};
+
+enum D3D11_QUERY : int
+{
+	D3D11_QUERY_EVENT = 0,
+	D3D11_QUERY_OCCLUSION,
+	D3D11_QUERY_TIMESTAMP,
+	D3D11_QUERY_TIMESTAMP_DISJOINT,
+	D3D11_QUERY_PIPELINE_STATISTICS,
+	D3D11_QUERY_OCCLUSION_PREDICATE,
+	D3D11_QUERY_SO_STATISTICS,
+	D3D11_QUERY_SO_OVERFLOW_PREDICATE,
+	D3D11_QUERY_SO_STATISTICS_STREAM0,
+	D3D11_QUERY_SO_OVERFLOW_PREDICATE_STREAM0,
+	D3D11_QUERY_SO_STATISTICS_STREAM1,
+	D3D11_QUERY_SO_OVERFLOW_PREDICATE_STREAM1,
+	D3D11_QUERY_SO_STATISTICS_STREAM2,
+	D3D11_QUERY_SO_OVERFLOW_PREDICATE_STREAM2,
+	D3D11_QUERY_SO_STATISTICS_STREAM3,
+	D3D11_QUERY_SO_OVERFLOW_PREDICATE_STREAM3
+};
+
+enum D3D11_DEVICE_CONTEXT_TYPE : int
+{
+	D3D11_DEVICE_CONTEXT_IMMEDIATE = 0,
+	D3D11_DEVICE_CONTEXT_DEFERRED = 1
+};
+
+enum D3D11_COUNTER : int
+{
+	D3D11_COUNTER_DEVICE_DEPENDENT_0 = 0x40000000
+};
+
+enum D3D11_COUNTER_TYPE : int
+{
+	D3D11_COUNTER_TYPE_FLOAT32 = 0,
+	D3D11_COUNTER_TYPE_UINT16 = 1,
+	D3D11_COUNTER_TYPE_UINT32 = 2,
+	D3D11_COUNTER_TYPE_UINT64 = 3
+};
+
+enum D3D11_FEATURE : int
+{
+	D3D11_FEATURE_THREADING = 0,
+	D3D11_FEATURE_DOUBLES = 1,
+	D3D11_FEATURE_FORMAT_SUPPORT = 2,
+	D3D11_FEATURE_FORMAT_SUPPORT2 = 3,
+	D3D11_FEATURE_D3D10_X_HARDWARE_OPTIONS = 4,
+	D3D11_FEATURE_D3D11_OPTIONS = 5
+};
+
+struct D3D11_FEATURE_DATA_THREADING
+{
+	BOOL DriverConcurrentCreates;
+	BOOL DriverCommandLists;
+};
+
+struct D3D11_FEATURE_DATA_D3D11_OPTIONS
+{
+	BOOL OutputMergerLogicOp;
+	BOOL UAVOnlyRenderingForcedSampleCount;
+	BOOL DiscardAPIsSeenByDriver;
+	BOOL FlagsForUpdateAndCopySeenByDriver;
+	BOOL ClearView;
+	BOOL CopyWithOverlap;
+	BOOL ConstantBufferPartialUpdate;
+	BOOL ConstantBufferOffsetting;
+	BOOL MapNoOverwriteOnDynamicConstantBuffer;
+	BOOL MapNoOverwriteOnDynamicBufferSRV;
+	BOOL MultisampleRTVWithForcedSampleCountOne;
+	BOOL SAD4ShaderInstructions;
+	BOOL ExtendedDoublesShaderInstructions;
+	BOOL ExtendedResourceSharing;
+};
+
+struct D3D11_BOX
+{
+	UINT left;
+	UINT top;
+	UINT front;
+	UINT right;
+	UINT bottom;
+	UINT back;
+};
+
+typedef RECT D3D11_RECT;
+
+struct D3D11_VIEWPORT
+{
+	FLOAT TopLeftX;
+	FLOAT TopLeftY;
+	FLOAT Width;
+	FLOAT Height;
+	FLOAT MinDepth;
+	FLOAT MaxDepth;
+};
+
+struct D3D11_SUBRESOURCE_DATA
+{
+	const void* pSysMem;
+	UINT SysMemPitch;
+	UINT SysMemSlicePitch;
+};
+
+struct D3D11_MAPPED_SUBRESOURCE
+{
+	void* pData;
+	UINT RowPitch;
+	UINT DepthPitch;
+};
+
+struct D3D11_BUFFER_DESC
+{
+	UINT ByteWidth;
+	D3D11_USAGE Usage;
+	UINT BindFlags;
+	UINT CPUAccessFlags;
+	UINT MiscFlags;
+	UINT StructureByteStride;
+};
+
+struct D3D11_TEXTURE1D_DESC
+{
+	UINT Width;
+	UINT MipLevels;
+	UINT ArraySize;
+	DXGI_FORMAT Format;
+	D3D11_USAGE Usage;
+	UINT BindFlags;
+	UINT CPUAccessFlags;
+	UINT MiscFlags;
+};
+
+struct D3D11_TEXTURE2D_DESC
+{
+	UINT Width;
+	UINT Height;
+	UINT MipLevels;
+	UINT ArraySize;
+	DXGI_FORMAT Format;
+	DXGI_SAMPLE_DESC SampleDesc;
+	D3D11_USAGE Usage;
+	UINT BindFlags;
+	UINT CPUAccessFlags;
+	UINT MiscFlags;
+};
+
+struct D3D11_TEXTURE3D_DESC
+{
+	UINT Width;
+	UINT Height;
+	UINT Depth;
+	UINT MipLevels;
+	DXGI_FORMAT Format;
+	D3D11_USAGE Usage;
+	UINT BindFlags;
+	UINT CPUAccessFlags;
+	UINT MiscFlags;
+};
+
+struct D3D11_BUFFER_SRV
+{
+	union { UINT FirstElement; UINT ElementOffset; };
+	union { UINT NumElements; UINT ElementWidth; };
+};
+
+struct D3D11_BUFFEREX_SRV { UINT FirstElement; UINT NumElements; UINT Flags; };
+struct D3D11_TEX1D_SRV { UINT MostDetailedMip; UINT MipLevels; };
+struct D3D11_TEX1D_ARRAY_SRV { UINT MostDetailedMip; UINT MipLevels; UINT FirstArraySlice; UINT ArraySize; };
+struct D3D11_TEX2D_SRV { UINT MostDetailedMip; UINT MipLevels; };
+struct D3D11_TEX2D_ARRAY_SRV { UINT MostDetailedMip; UINT MipLevels; UINT FirstArraySlice; UINT ArraySize; };
+struct D3D11_TEX2DMS_SRV { UINT UnusedField_NothingToDefine; };
+struct D3D11_TEX2DMS_ARRAY_SRV { UINT FirstArraySlice; UINT ArraySize; };
+struct D3D11_TEX3D_SRV { UINT MostDetailedMip; UINT MipLevels; };
+struct D3D11_TEXCUBE_SRV { UINT MostDetailedMip; UINT MipLevels; };
+struct D3D11_TEXCUBE_ARRAY_SRV { UINT MostDetailedMip; UINT MipLevels; UINT First2DArrayFace; UINT NumCubes; };
+
+struct D3D11_SHADER_RESOURCE_VIEW_DESC
+{
+	DXGI_FORMAT Format;
+	D3D11_SRV_DIMENSION ViewDimension;
+	union
+	{
+		D3D11_BUFFER_SRV Buffer;
+		D3D11_TEX1D_SRV Texture1D;
+		D3D11_TEX1D_ARRAY_SRV Texture1DArray;
+		D3D11_TEX2D_SRV Texture2D;
+		D3D11_TEX2D_ARRAY_SRV Texture2DArray;
+		D3D11_TEX2DMS_SRV Texture2DMS;
+		D3D11_TEX2DMS_ARRAY_SRV Texture2DMSArray;
+		D3D11_TEX3D_SRV Texture3D;
+		D3D11_TEXCUBE_SRV TextureCube;
+		D3D11_TEXCUBE_ARRAY_SRV TextureCubeArray;
+		D3D11_BUFFEREX_SRV BufferEx;
+	};
+};
+
+struct D3D11_BUFFER_UAV { UINT FirstElement; UINT NumElements; UINT Flags; };
+struct D3D11_TEX1D_UAV { UINT MipSlice; };
+struct D3D11_TEX1D_ARRAY_UAV { UINT MipSlice; UINT FirstArraySlice; UINT ArraySize; };
+struct D3D11_TEX2D_UAV { UINT MipSlice; };
+struct D3D11_TEX2D_ARRAY_UAV { UINT MipSlice; UINT FirstArraySlice; UINT ArraySize; };
+struct D3D11_TEX3D_UAV { UINT MipSlice; UINT FirstWSlice; UINT WSize; };
+
+struct D3D11_UNORDERED_ACCESS_VIEW_DESC
+{
+	DXGI_FORMAT Format;
+	D3D11_UAV_DIMENSION ViewDimension;
+	union
+	{
+		D3D11_BUFFER_UAV Buffer;
+		D3D11_TEX1D_UAV Texture1D;
+		D3D11_TEX1D_ARRAY_UAV Texture1DArray;
+		D3D11_TEX2D_UAV Texture2D;
+		D3D11_TEX2D_ARRAY_UAV Texture2DArray;
+		D3D11_TEX3D_UAV Texture3D;
+	};
+};
+
+struct D3D11_BUFFER_RTV
+{
+	union { UINT FirstElement; UINT ElementOffset; };
+	union { UINT NumElements; UINT ElementWidth; };
+};
+
+struct D3D11_TEX1D_RTV { UINT MipSlice; };
+struct D3D11_TEX1D_ARRAY_RTV { UINT MipSlice; UINT FirstArraySlice; UINT ArraySize; };
+struct D3D11_TEX2D_RTV { UINT MipSlice; };
+struct D3D11_TEX2D_ARRAY_RTV { UINT MipSlice; UINT FirstArraySlice; UINT ArraySize; };
+struct D3D11_TEX2DMS_RTV { UINT UnusedField_NothingToDefine; };
+struct D3D11_TEX2DMS_ARRAY_RTV { UINT FirstArraySlice; UINT ArraySize; };
+struct D3D11_TEX3D_RTV { UINT MipSlice; UINT FirstWSlice; UINT WSize; };
+
+struct D3D11_RENDER_TARGET_VIEW_DESC
+{
+	DXGI_FORMAT Format;
+	D3D11_RTV_DIMENSION ViewDimension;
+	union
+	{
+		D3D11_BUFFER_RTV Buffer;
+		D3D11_TEX1D_RTV Texture1D;
+		D3D11_TEX1D_ARRAY_RTV Texture1DArray;
+		D3D11_TEX2D_RTV Texture2D;
+		D3D11_TEX2D_ARRAY_RTV Texture2DArray;
+		D3D11_TEX2DMS_RTV Texture2DMS;
+		D3D11_TEX2DMS_ARRAY_RTV Texture2DMSArray;
+		D3D11_TEX3D_RTV Texture3D;
+	};
+};
+
+struct D3D11_TEX1D_DSV { UINT MipSlice; };
+struct D3D11_TEX1D_ARRAY_DSV { UINT MipSlice; UINT FirstArraySlice; UINT ArraySize; };
+struct D3D11_TEX2D_DSV { UINT MipSlice; };
+struct D3D11_TEX2D_ARRAY_DSV { UINT MipSlice; UINT FirstArraySlice; UINT ArraySize; };
+struct D3D11_TEX2DMS_DSV { UINT UnusedField_NothingToDefine; };
+struct D3D11_TEX2DMS_ARRAY_DSV { UINT FirstArraySlice; UINT ArraySize; };
+
+struct D3D11_DEPTH_STENCIL_VIEW_DESC
+{
+	DXGI_FORMAT Format;
+	D3D11_DSV_DIMENSION ViewDimension;
+	UINT Flags;
+	union
+	{
+		D3D11_TEX1D_DSV Texture1D;
+		D3D11_TEX1D_ARRAY_DSV Texture1DArray;
+		D3D11_TEX2D_DSV Texture2D;
+		D3D11_TEX2D_ARRAY_DSV Texture2DArray;
+		D3D11_TEX2DMS_DSV Texture2DMS;
+		D3D11_TEX2DMS_ARRAY_DSV Texture2DMSArray;
+	};
+};
+
+struct D3D11_INPUT_ELEMENT_DESC
+{
+	LPCSTR SemanticName;
+	UINT SemanticIndex;
+	DXGI_FORMAT Format;
+	UINT InputSlot;
+	UINT AlignedByteOffset;
+	D3D11_INPUT_CLASSIFICATION InputSlotClass;
+	UINT InstanceDataStepRate;
+};
+
+struct D3D11_SO_DECLARATION_ENTRY
+{
+	UINT Stream;
+	LPCSTR SemanticName;
+	UINT SemanticIndex;
+	BYTE StartComponent;
+	BYTE ComponentCount;
+	BYTE OutputSlot;
+};
+
+struct D3D11_SAMPLER_DESC
+{
+	D3D11_FILTER Filter;
+	D3D11_TEXTURE_ADDRESS_MODE AddressU;
+	D3D11_TEXTURE_ADDRESS_MODE AddressV;
+	D3D11_TEXTURE_ADDRESS_MODE AddressW;
+	FLOAT MipLODBias;
+	UINT MaxAnisotropy;
+	D3D11_COMPARISON_FUNC ComparisonFunc;
+	FLOAT BorderColor[4];
+	FLOAT MinLOD;
+	FLOAT MaxLOD;
+};
+
+struct D3D11_RENDER_TARGET_BLEND_DESC
+{
+	BOOL BlendEnable;
+	D3D11_BLEND SrcBlend;
+	D3D11_BLEND DestBlend;
+	D3D11_BLEND_OP BlendOp;
+	D3D11_BLEND SrcBlendAlpha;
+	D3D11_BLEND DestBlendAlpha;
+	D3D11_BLEND_OP BlendOpAlpha;
+	UINT8 RenderTargetWriteMask;
+};
+
+struct D3D11_BLEND_DESC
+{
+	BOOL AlphaToCoverageEnable;
+	BOOL IndependentBlendEnable;
+	D3D11_RENDER_TARGET_BLEND_DESC RenderTarget[8];
+};
+
+struct D3D11_DEPTH_STENCILOP_DESC
+{
+	D3D11_STENCIL_OP StencilFailOp;
+	D3D11_STENCIL_OP StencilDepthFailOp;
+	D3D11_STENCIL_OP StencilPassOp;
+	D3D11_COMPARISON_FUNC StencilFunc;
+};
+
+struct D3D11_DEPTH_STENCIL_DESC
+{
+	BOOL DepthEnable;
+	D3D11_DEPTH_WRITE_MASK DepthWriteMask;
+	D3D11_COMPARISON_FUNC DepthFunc;
+	BOOL StencilEnable;
+	UINT8 StencilReadMask;
+	UINT8 StencilWriteMask;
+	D3D11_DEPTH_STENCILOP_DESC FrontFace;
+	D3D11_DEPTH_STENCILOP_DESC BackFace;
+};
+
+struct D3D11_RASTERIZER_DESC
+{
+	D3D11_FILL_MODE FillMode;
+	D3D11_CULL_MODE CullMode;
+	BOOL FrontCounterClockwise;
+	INT DepthBias;
+	FLOAT DepthBiasClamp;
+	FLOAT SlopeScaledDepthBias;
+	BOOL DepthClipEnable;
+	BOOL ScissorEnable;
+	BOOL MultisampleEnable;
+	BOOL AntialiasedLineEnable;
+};
+
+struct D3D11_QUERY_DESC
+{
+	D3D11_QUERY Query;
+	UINT MiscFlags;
+};
+
+struct D3D11_COUNTER_DESC
+{
+	D3D11_COUNTER Counter;
+	UINT MiscFlags;
+};
+
+struct D3D11_COUNTER_INFO
+{
+	D3D11_COUNTER LastDeviceDependentCounter;
+	UINT NumSimultaneousCounters;
+	UINT8 NumDetectableParallelUnits;
+};
+
+struct D3D11_QUERY_DATA_TIMESTAMP_DISJOINT
+{
+	UINT64 Frequency;
+	BOOL Disjoint;
+};
+
+struct D3D11_QUERY_DATA_PIPELINE_STATISTICS
+{
+	UINT64 IAVertices;
+	UINT64 IAPrimitives;
+	UINT64 VSInvocations;
+	UINT64 GSInvocations;
+	UINT64 GSPrimitives;
+	UINT64 CInvocations;
+	UINT64 CPrimitives;
+	UINT64 PSInvocations;
+	UINT64 HSInvocations;
+	UINT64 DSInvocations;
+	UINT64 CSInvocations;
+};
+
+struct D3D11_QUERY_DATA_SO_STATISTICS
+{
+	UINT64 NumPrimitivesWritten;
+	UINT64 PrimitivesStorageNeeded;
+};
+
+struct ID3D11Device;
+
+struct ID3D11DeviceChild : public IUnknown
+{
+	virtual void STDMETHODCALLTYPE GetDevice(ID3D11Device** device) = 0;
+	virtual HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID guid, UINT* dataSize, void* data) = 0;
+	virtual HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID guid, UINT dataSize, const void* data) = 0;
+	virtual HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID guid, const IUnknown* data) = 0;
+};
+
+struct ID3D11Resource : public ID3D11DeviceChild
+{
+	virtual void STDMETHODCALLTYPE GetType(D3D11_RESOURCE_DIMENSION* dimension) = 0;
+	virtual void STDMETHODCALLTYPE SetEvictionPriority(UINT priority) = 0;
+	virtual UINT STDMETHODCALLTYPE GetEvictionPriority() = 0;
+};
+
+struct ID3D11Buffer : public ID3D11Resource
+{
+	virtual void STDMETHODCALLTYPE GetDesc(D3D11_BUFFER_DESC* desc) = 0;
+};
+
+struct ID3D11Texture1D : public ID3D11Resource
+{
+	virtual void STDMETHODCALLTYPE GetDesc(D3D11_TEXTURE1D_DESC* desc) = 0;
+};
+
+struct ID3D11Texture2D : public ID3D11Resource
+{
+	virtual void STDMETHODCALLTYPE GetDesc(D3D11_TEXTURE2D_DESC* desc) = 0;
+};
+
+struct ID3D11Texture3D : public ID3D11Resource
+{
+	virtual void STDMETHODCALLTYPE GetDesc(D3D11_TEXTURE3D_DESC* desc) = 0;
+};
+
+struct ID3D11View : public ID3D11DeviceChild
+{
+	virtual void STDMETHODCALLTYPE GetResource(ID3D11Resource** resource) = 0;
+};
+
+struct ID3D11ShaderResourceView : public ID3D11View
+{
+	virtual void STDMETHODCALLTYPE GetDesc(D3D11_SHADER_RESOURCE_VIEW_DESC* desc) = 0;
+};
+
+struct ID3D11UnorderedAccessView : public ID3D11View
+{
+	virtual void STDMETHODCALLTYPE GetDesc(D3D11_UNORDERED_ACCESS_VIEW_DESC* desc) = 0;
+};
+
+struct ID3D11RenderTargetView : public ID3D11View
+{
+	virtual void STDMETHODCALLTYPE GetDesc(D3D11_RENDER_TARGET_VIEW_DESC* desc) = 0;
+};
+
+struct ID3D11DepthStencilView : public ID3D11View
+{
+	virtual void STDMETHODCALLTYPE GetDesc(D3D11_DEPTH_STENCIL_VIEW_DESC* desc) = 0;
+};
+
+struct ID3D11VertexShader : public ID3D11DeviceChild {};
+struct ID3D11HullShader : public ID3D11DeviceChild {};
+struct ID3D11DomainShader : public ID3D11DeviceChild {};
+struct ID3D11GeometryShader : public ID3D11DeviceChild {};
+struct ID3D11PixelShader : public ID3D11DeviceChild {};
+struct ID3D11ComputeShader : public ID3D11DeviceChild {};
+struct ID3D11InputLayout : public ID3D11DeviceChild {};
+
+// dynamic linkage is never used by sf11, these are only passed through as null
+struct ID3D11ClassInstance : public ID3D11DeviceChild {};
+struct ID3D11ClassLinkage : public ID3D11DeviceChild {};
+struct ID3DDeviceContextState : public ID3D11DeviceChild {};
+
+struct ID3D11SamplerState : public ID3D11DeviceChild
+{
+	virtual void STDMETHODCALLTYPE GetDesc(D3D11_SAMPLER_DESC* desc) = 0;
+};
+
+struct ID3D11BlendState : public ID3D11DeviceChild
+{
+	virtual void STDMETHODCALLTYPE GetDesc(D3D11_BLEND_DESC* desc) = 0;
+};
+
+struct ID3D11DepthStencilState : public ID3D11DeviceChild
+{
+	virtual void STDMETHODCALLTYPE GetDesc(D3D11_DEPTH_STENCIL_DESC* desc) = 0;
+};
+
+struct ID3D11RasterizerState : public ID3D11DeviceChild
+{
+	virtual void STDMETHODCALLTYPE GetDesc(D3D11_RASTERIZER_DESC* desc) = 0;
+};
+
+struct ID3D11Asynchronous : public ID3D11DeviceChild
+{
+	virtual UINT STDMETHODCALLTYPE GetDataSize() = 0;
+};
+
+struct ID3D11Query : public ID3D11Asynchronous
+{
+	virtual void STDMETHODCALLTYPE GetDesc(D3D11_QUERY_DESC* desc) = 0;
+};
+
+struct ID3D11Predicate : public ID3D11Query {};
+
+struct ID3D11Counter : public ID3D11Asynchronous
+{
+	virtual void STDMETHODCALLTYPE GetDesc(D3D11_COUNTER_DESC* desc) = 0;
+};
+
+struct ID3D11CommandList : public ID3D11DeviceChild
+{
+	virtual UINT STDMETHODCALLTYPE GetContextFlags() = 0;
+};
+
+// methods are in sdk order
+struct ID3D11DeviceContext : public ID3D11DeviceChild
+{
+	virtual void STDMETHODCALLTYPE VSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers) = 0;
+	virtual void STDMETHODCALLTYPE PSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* shaderResourceViews) = 0;
+	virtual void STDMETHODCALLTYPE PSSetShader(ID3D11PixelShader* pixelShader, ID3D11ClassInstance* const* classInstances, UINT numClassInstances) = 0;
+	virtual void STDMETHODCALLTYPE PSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplers) = 0;
+	virtual void STDMETHODCALLTYPE VSSetShader(ID3D11VertexShader* vertexShader, ID3D11ClassInstance* const* classInstances, UINT numClassInstances) = 0;
+	virtual void STDMETHODCALLTYPE DrawIndexed(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation) = 0;
+	virtual void STDMETHODCALLTYPE Draw(UINT vertexCount, UINT startVertexLocation) = 0;
+	virtual HRESULT STDMETHODCALLTYPE Map(ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mappedResource) = 0;
+	virtual void STDMETHODCALLTYPE Unmap(ID3D11Resource* resource, UINT subresource) = 0;
+	virtual void STDMETHODCALLTYPE PSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers) = 0;
+	virtual void STDMETHODCALLTYPE IASetInputLayout(ID3D11InputLayout* inputLayout) = 0;
+	virtual void STDMETHODCALLTYPE IASetVertexBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* vertexBuffers, const UINT* strides, const UINT* offsets) = 0;
+	virtual void STDMETHODCALLTYPE IASetIndexBuffer(ID3D11Buffer* indexBuffer, DXGI_FORMAT format, UINT offset) = 0;
+	virtual void STDMETHODCALLTYPE DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation) = 0;
+	virtual void STDMETHODCALLTYPE DrawInstanced(UINT vertexCountPerInstance, UINT instanceCount, UINT startVertexLocation, UINT startInstanceLocation) = 0;
+	virtual void STDMETHODCALLTYPE GSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers) = 0;
+	virtual void STDMETHODCALLTYPE GSSetShader(ID3D11GeometryShader* shader, ID3D11ClassInstance* const* classInstances, UINT numClassInstances) = 0;
+	virtual void STDMETHODCALLTYPE IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology) = 0;
+	virtual void STDMETHODCALLTYPE VSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* shaderResourceViews) = 0;
+	virtual void STDMETHODCALLTYPE VSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplers) = 0;
+	virtual void STDMETHODCALLTYPE Begin(ID3D11Asynchronous* async) = 0;
+	virtual void STDMETHODCALLTYPE End(ID3D11Asynchronous* async) = 0;
+	virtual HRESULT STDMETHODCALLTYPE GetData(ID3D11Asynchronous* async, void* data, UINT dataSize, UINT getDataFlags) = 0;
+	virtual void STDMETHODCALLTYPE SetPredication(ID3D11Predicate* predicate, BOOL predicateValue) = 0;
+	virtual void STDMETHODCALLTYPE GSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* shaderResourceViews) = 0;
+	virtual void STDMETHODCALLTYPE GSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplers) = 0;
+	virtual void STDMETHODCALLTYPE OMSetRenderTargets(UINT numViews, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView) = 0;
+	virtual void STDMETHODCALLTYPE OMSetRenderTargetsAndUnorderedAccessViews(UINT numRTVs, ID3D11RenderTargetView* const* renderTargetViews, ID3D11DepthStencilView* depthStencilView,
+		UINT uavStartSlot, UINT numUAVs, ID3D11UnorderedAccessView* const* unorderedAccessViews, const UINT* uavInitialCounts) = 0;
+	virtual void STDMETHODCALLTYPE OMSetBlendState(ID3D11BlendState* blendState, const FLOAT blendFactor[4], UINT sampleMask) = 0;
+	virtual void STDMETHODCALLTYPE OMSetDepthStencilState(ID3D11DepthStencilState* depthStencilState, UINT stencilRef) = 0;
+	virtual void STDMETHODCALLTYPE SOSetTargets(UINT numBuffers, ID3D11Buffer* const* soTargets, const UINT* offsets) = 0;
+	virtual void STDMETHODCALLTYPE DrawAuto() = 0;
+	virtual void STDMETHODCALLTYPE DrawIndexedInstancedIndirect(ID3D11Buffer* bufferForArgs, UINT alignedByteOffsetForArgs) = 0;
+	virtual void STDMETHODCALLTYPE DrawInstancedIndirect(ID3D11Buffer* bufferForArgs, UINT alignedByteOffsetForArgs) = 0;
+	virtual void STDMETHODCALLTYPE Dispatch(UINT threadGroupCountX, UINT threadGroupCountY, UINT threadGroupCountZ) = 0;
+	virtual void STDMETHODCALLTYPE DispatchIndirect(ID3D11Buffer* bufferForArgs, UINT alignedByteOffsetForArgs) = 0;
+	virtual void STDMETHODCALLTYPE RSSetState(ID3D11RasterizerState* rasterizerState) = 0;
+	virtual void STDMETHODCALLTYPE RSSetViewports(UINT numViewports, const D3D11_VIEWPORT* viewports) = 0;
+	virtual void STDMETHODCALLTYPE RSSetScissorRects(UINT numRects, const D3D11_RECT* rects) = 0;
+	virtual void STDMETHODCALLTYPE CopySubresourceRegion(ID3D11Resource* dstResource, UINT dstSubresource, UINT dstX, UINT dstY, UINT dstZ,
+		ID3D11Resource* srcResource, UINT srcSubresource, const D3D11_BOX* srcBox) = 0;
+	virtual void STDMETHODCALLTYPE CopyResource(ID3D11Resource* dstResource, ID3D11Resource* srcResource) = 0;
+	virtual void STDMETHODCALLTYPE UpdateSubresource(ID3D11Resource* dstResource, UINT dstSubresource, const D3D11_BOX* dstBox,
+		const void* srcData, UINT srcRowPitch, UINT srcDepthPitch) = 0;
+	virtual void STDMETHODCALLTYPE CopyStructureCount(ID3D11Buffer* dstBuffer, UINT dstAlignedByteOffset, ID3D11UnorderedAccessView* srcView) = 0;
+	virtual void STDMETHODCALLTYPE ClearRenderTargetView(ID3D11RenderTargetView* renderTargetView, const FLOAT colorRGBA[4]) = 0;
+	virtual void STDMETHODCALLTYPE ClearUnorderedAccessViewUint(ID3D11UnorderedAccessView* unorderedAccessView, const UINT values[4]) = 0;
+	virtual void STDMETHODCALLTYPE ClearUnorderedAccessViewFloat(ID3D11UnorderedAccessView* unorderedAccessView, const FLOAT values[4]) = 0;
+	virtual void STDMETHODCALLTYPE ClearDepthStencilView(ID3D11DepthStencilView* depthStencilView, UINT clearFlags, FLOAT depth, UINT8 stencil) = 0;
+	virtual void STDMETHODCALLTYPE GenerateMips(ID3D11ShaderResourceView* shaderResourceView) = 0;
+	virtual void STDMETHODCALLTYPE SetResourceMinLOD(ID3D11Resource* resource, FLOAT minLOD) = 0;
+	virtual FLOAT STDMETHODCALLTYPE GetResourceMinLOD(ID3D11Resource* resource) = 0;
+	virtual void STDMETHODCALLTYPE ResolveSubresource(ID3D11Resource* dstResource, UINT dstSubresource, ID3D11Resource* srcResource, UINT srcSubresource, DXGI_FORMAT format) = 0;
+	virtual void STDMETHODCALLTYPE ExecuteCommandList(ID3D11CommandList* commandList, BOOL restoreContextState) = 0;
+	virtual void STDMETHODCALLTYPE HSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* shaderResourceViews) = 0;
+	virtual void STDMETHODCALLTYPE HSSetShader(ID3D11HullShader* hullShader, ID3D11ClassInstance* const* classInstances, UINT numClassInstances) = 0;
+	virtual void STDMETHODCALLTYPE HSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplers) = 0;
+	virtual void STDMETHODCALLTYPE HSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers) = 0;
+	virtual void STDMETHODCALLTYPE DSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* shaderResourceViews) = 0;
+	virtual void STDMETHODCALLTYPE DSSetShader(ID3D11DomainShader* domainShader, ID3D11ClassInstance* const* classInstances, UINT numClassInstances) = 0;
+	virtual void STDMETHODCALLTYPE DSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplers) = 0;
+	virtual void STDMETHODCALLTYPE DSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers) = 0;
+	virtual void STDMETHODCALLTYPE CSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* shaderResourceViews) = 0;
+	virtual void STDMETHODCALLTYPE CSSetUnorderedAccessViews(UINT startSlot, UINT numUAVs, ID3D11UnorderedAccessView* const* unorderedAccessViews, const UINT* uavInitialCounts) = 0;
+	virtual void STDMETHODCALLTYPE CSSetShader(ID3D11ComputeShader* computeShader, ID3D11ClassInstance* const* classInstances, UINT numClassInstances) = 0;
+	virtual void STDMETHODCALLTYPE CSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplers) = 0;
+	virtual void STDMETHODCALLTYPE CSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers) = 0;
+	virtual void STDMETHODCALLTYPE VSGetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer** constantBuffers) = 0;
+	virtual void STDMETHODCALLTYPE PSGetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView** shaderResourceViews) = 0;
+	virtual void STDMETHODCALLTYPE PSGetShader(ID3D11PixelShader** pixelShader, ID3D11ClassInstance** classInstances, UINT* numClassInstances) = 0;
+	virtual void STDMETHODCALLTYPE PSGetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState** samplers) = 0;
+	virtual void STDMETHODCALLTYPE VSGetShader(ID3D11VertexShader** vertexShader, ID3D11ClassInstance** classInstances, UINT* numClassInstances) = 0;
+	virtual void STDMETHODCALLTYPE PSGetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer** constantBuffers) = 0;
+	virtual void STDMETHODCALLTYPE IAGetInputLayout(ID3D11InputLayout** inputLayout) = 0;
+	virtual void STDMETHODCALLTYPE IAGetVertexBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer** vertexBuffers, UINT* strides, UINT* offsets) = 0;
+	virtual void STDMETHODCALLTYPE IAGetIndexBuffer(ID3D11Buffer** indexBuffer, DXGI_FORMAT* format, UINT* offset) = 0;
+	virtual void STDMETHODCALLTYPE GSGetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer** constantBuffers) = 0;
+	virtual void STDMETHODCALLTYPE GSGetShader(ID3D11GeometryShader** geometryShader, ID3D11ClassInstance** classInstances, UINT* numClassInstances) = 0;
+	virtual void STDMETHODCALLTYPE IAGetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY* topology) = 0;
+	virtual void STDMETHODCALLTYPE VSGetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView** shaderResourceViews) = 0;
+	virtual void STDMETHODCALLTYPE VSGetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState** samplers) = 0;
+	virtual void STDMETHODCALLTYPE GetPredication(ID3D11Predicate** predicate, BOOL* predicateValue) = 0;
+	virtual void STDMETHODCALLTYPE GSGetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView** shaderResourceViews) = 0;
+	virtual void STDMETHODCALLTYPE GSGetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState** samplers) = 0;
+	virtual void STDMETHODCALLTYPE OMGetRenderTargets(UINT numViews, ID3D11RenderTargetView** renderTargetViews, ID3D11DepthStencilView** depthStencilView) = 0;
+	virtual void STDMETHODCALLTYPE OMGetRenderTargetsAndUnorderedAccessViews(UINT numRTVs, ID3D11RenderTargetView** renderTargetViews, ID3D11DepthStencilView** depthStencilView,
+		UINT uavStartSlot, UINT numUAVs, ID3D11UnorderedAccessView** unorderedAccessViews) = 0;
+	virtual void STDMETHODCALLTYPE OMGetBlendState(ID3D11BlendState** blendState, FLOAT blendFactor[4], UINT* sampleMask) = 0;
+	virtual void STDMETHODCALLTYPE OMGetDepthStencilState(ID3D11DepthStencilState** depthStencilState, UINT* stencilRef) = 0;
+	virtual void STDMETHODCALLTYPE SOGetTargets(UINT numBuffers, ID3D11Buffer** soTargets) = 0;
+	virtual void STDMETHODCALLTYPE RSGetState(ID3D11RasterizerState** rasterizerState) = 0;
+	virtual void STDMETHODCALLTYPE RSGetViewports(UINT* numViewports, D3D11_VIEWPORT* viewports) = 0;
+	virtual void STDMETHODCALLTYPE RSGetScissorRects(UINT* numRects, D3D11_RECT* rects) = 0;
+	virtual void STDMETHODCALLTYPE HSGetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView** shaderResourceViews) = 0;
+	virtual void STDMETHODCALLTYPE HSGetShader(ID3D11HullShader** hullShader, ID3D11ClassInstance** classInstances, UINT* numClassInstances) = 0;
+	virtual void STDMETHODCALLTYPE HSGetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState** samplers) = 0;
+	virtual void STDMETHODCALLTYPE HSGetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer** constantBuffers) = 0;
+	virtual void STDMETHODCALLTYPE DSGetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView** shaderResourceViews) = 0;
+	virtual void STDMETHODCALLTYPE DSGetShader(ID3D11DomainShader** domainShader, ID3D11ClassInstance** classInstances, UINT* numClassInstances) = 0;
+	virtual void STDMETHODCALLTYPE DSGetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState** samplers) = 0;
+	virtual void STDMETHODCALLTYPE DSGetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer** constantBuffers) = 0;
+	virtual void STDMETHODCALLTYPE CSGetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView** shaderResourceViews) = 0;
+	virtual void STDMETHODCALLTYPE CSGetUnorderedAccessViews(UINT startSlot, UINT numUAVs, ID3D11UnorderedAccessView** unorderedAccessViews) = 0;
+	virtual void STDMETHODCALLTYPE CSGetShader(ID3D11ComputeShader** computeShader, ID3D11ClassInstance** classInstances, UINT* numClassInstances) = 0;
+	virtual void STDMETHODCALLTYPE CSGetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState** samplers) = 0;
+	virtual void STDMETHODCALLTYPE CSGetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer** constantBuffers) = 0;
+	virtual void STDMETHODCALLTYPE ClearState() = 0;
+	virtual void STDMETHODCALLTYPE Flush() = 0;
+	virtual D3D11_DEVICE_CONTEXT_TYPE STDMETHODCALLTYPE GetType() = 0;
+	virtual UINT STDMETHODCALLTYPE GetContextFlags() = 0;
+	virtual HRESULT STDMETHODCALLTYPE FinishCommandList(BOOL restoreDeferredContextState, ID3D11CommandList** commandList) = 0;
+};
+
+struct ID3D11DeviceContext1 : public ID3D11DeviceContext
+{
+	virtual void STDMETHODCALLTYPE CopySubresourceRegion1(ID3D11Resource* dstResource, UINT dstSubresource, UINT dstX, UINT dstY, UINT dstZ,
+		ID3D11Resource* srcResource, UINT srcSubresource, const D3D11_BOX* srcBox, UINT copyFlags) = 0;
+	virtual void STDMETHODCALLTYPE UpdateSubresource1(ID3D11Resource* dstResource, UINT dstSubresource, const D3D11_BOX* dstBox,
+		const void* srcData, UINT srcRowPitch, UINT srcDepthPitch, UINT copyFlags) = 0;
+	virtual void STDMETHODCALLTYPE DiscardResource(ID3D11Resource* resource) = 0;
+	virtual void STDMETHODCALLTYPE DiscardView(ID3D11View* resourceView) = 0;
+	virtual void STDMETHODCALLTYPE VSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers, const UINT* firstConstant, const UINT* numConstants) = 0;
+	virtual void STDMETHODCALLTYPE HSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers, const UINT* firstConstant, const UINT* numConstants) = 0;
+	virtual void STDMETHODCALLTYPE DSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers, const UINT* firstConstant, const UINT* numConstants) = 0;
+	virtual void STDMETHODCALLTYPE GSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers, const UINT* firstConstant, const UINT* numConstants) = 0;
+	virtual void STDMETHODCALLTYPE PSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers, const UINT* firstConstant, const UINT* numConstants) = 0;
+	virtual void STDMETHODCALLTYPE CSSetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* constantBuffers, const UINT* firstConstant, const UINT* numConstants) = 0;
+	virtual void STDMETHODCALLTYPE VSGetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer** constantBuffers, UINT* firstConstant, UINT* numConstants) = 0;
+	virtual void STDMETHODCALLTYPE HSGetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer** constantBuffers, UINT* firstConstant, UINT* numConstants) = 0;
+	virtual void STDMETHODCALLTYPE DSGetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer** constantBuffers, UINT* firstConstant, UINT* numConstants) = 0;
+	virtual void STDMETHODCALLTYPE GSGetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer** constantBuffers, UINT* firstConstant, UINT* numConstants) = 0;
+	virtual void STDMETHODCALLTYPE PSGetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer** constantBuffers, UINT* firstConstant, UINT* numConstants) = 0;
+	virtual void STDMETHODCALLTYPE CSGetConstantBuffers1(UINT startSlot, UINT numBuffers, ID3D11Buffer** constantBuffers, UINT* firstConstant, UINT* numConstants) = 0;
+	virtual void STDMETHODCALLTYPE SwapDeviceContextState(ID3DDeviceContextState* state, ID3DDeviceContextState** previousState) = 0;
+	virtual void STDMETHODCALLTYPE ClearView(ID3D11View* view, const FLOAT color[4], const D3D11_RECT* rects, UINT numRects) = 0;
+	virtual void STDMETHODCALLTYPE DiscardView1(ID3D11View* resourceView, const D3D11_RECT* rects, UINT numRects) = 0;
+};
+
+struct ID3D11Device : public IUnknown
+{
+	virtual HRESULT STDMETHODCALLTYPE CreateBuffer(const D3D11_BUFFER_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Buffer** buffer) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateTexture1D(const D3D11_TEXTURE1D_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture1D** texture1D) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateTexture2D(const D3D11_TEXTURE2D_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture2D** texture2D) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateTexture3D(const D3D11_TEXTURE3D_DESC* desc, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture3D** texture3D) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateShaderResourceView(ID3D11Resource* resource, const D3D11_SHADER_RESOURCE_VIEW_DESC* desc, ID3D11ShaderResourceView** srView) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateUnorderedAccessView(ID3D11Resource* resource, const D3D11_UNORDERED_ACCESS_VIEW_DESC* desc, ID3D11UnorderedAccessView** uaView) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateRenderTargetView(ID3D11Resource* resource, const D3D11_RENDER_TARGET_VIEW_DESC* desc, ID3D11RenderTargetView** rtView) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateDepthStencilView(ID3D11Resource* resource, const D3D11_DEPTH_STENCIL_VIEW_DESC* desc, ID3D11DepthStencilView** depthStencilView) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC* inputElementDescs, UINT numElements,
+		const void* shaderBytecodeWithInputSignature, SIZE_T bytecodeLength, ID3D11InputLayout** inputLayout) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateVertexShader(const void* shaderBytecode, SIZE_T bytecodeLength, ID3D11ClassLinkage* classLinkage, ID3D11VertexShader** vertexShader) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateGeometryShader(const void* shaderBytecode, SIZE_T bytecodeLength, ID3D11ClassLinkage* classLinkage, ID3D11GeometryShader** geometryShader) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateGeometryShaderWithStreamOutput(const void* shaderBytecode, SIZE_T bytecodeLength, const D3D11_SO_DECLARATION_ENTRY* soDeclaration,
+		UINT numEntries, const UINT* bufferStrides, UINT numStrides, UINT rasterizedStream, ID3D11ClassLinkage* classLinkage, ID3D11GeometryShader** geometryShader) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreatePixelShader(const void* shaderBytecode, SIZE_T bytecodeLength, ID3D11ClassLinkage* classLinkage, ID3D11PixelShader** pixelShader) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateHullShader(const void* shaderBytecode, SIZE_T bytecodeLength, ID3D11ClassLinkage* classLinkage, ID3D11HullShader** hullShader) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateDomainShader(const void* shaderBytecode, SIZE_T bytecodeLength, ID3D11ClassLinkage* classLinkage, ID3D11DomainShader** domainShader) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateComputeShader(const void* shaderBytecode, SIZE_T bytecodeLength, ID3D11ClassLinkage* classLinkage, ID3D11ComputeShader** computeShader) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateClassLinkage(ID3D11ClassLinkage** linkage) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateBlendState(const D3D11_BLEND_DESC* blendStateDesc, ID3D11BlendState** blendState) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC* depthStencilDesc, ID3D11DepthStencilState** depthStencilState) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateRasterizerState(const D3D11_RASTERIZER_DESC* rasterizerDesc, ID3D11RasterizerState** rasterizerState) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateSamplerState(const D3D11_SAMPLER_DESC* samplerDesc, ID3D11SamplerState** samplerState) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateQuery(const D3D11_QUERY_DESC* queryDesc, ID3D11Query** query) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreatePredicate(const D3D11_QUERY_DESC* predicateDesc, ID3D11Predicate** predicate) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateCounter(const D3D11_COUNTER_DESC* counterDesc, ID3D11Counter** counter) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CreateDeferredContext(UINT contextFlags, ID3D11DeviceContext** deferredContext) = 0;
+	virtual HRESULT STDMETHODCALLTYPE OpenSharedResource(HANDLE resource, REFIID returnedInterface, void** out) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CheckFormatSupport(DXGI_FORMAT format, UINT* formatSupport) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CheckMultisampleQualityLevels(DXGI_FORMAT format, UINT sampleCount, UINT* numQualityLevels) = 0;
+	virtual void STDMETHODCALLTYPE CheckCounterInfo(D3D11_COUNTER_INFO* counterInfo) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CheckCounter(const D3D11_COUNTER_DESC* desc, D3D11_COUNTER_TYPE* type, UINT* activeCounters,
+		LPSTR name, UINT* nameLength, LPSTR units, UINT* unitsLength, LPSTR description, UINT* descriptionLength) = 0;
+	virtual HRESULT STDMETHODCALLTYPE CheckFeatureSupport(D3D11_FEATURE feature, void* featureSupportData, UINT featureSupportDataSize) = 0;
+	virtual HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID guid, UINT* dataSize, void* data) = 0;
+	virtual HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID guid, UINT dataSize, const void* data) = 0;
+	virtual HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID guid, const IUnknown* data) = 0;
+	virtual D3D_FEATURE_LEVEL STDMETHODCALLTYPE GetFeatureLevel() = 0;
+	virtual UINT STDMETHODCALLTYPE GetCreationFlags() = 0;
+	virtual HRESULT STDMETHODCALLTYPE GetDeviceRemovedReason() = 0;
+	virtual void STDMETHODCALLTYPE GetImmediateContext(ID3D11DeviceContext** immediateContext) = 0;
+	virtual HRESULT STDMETHODCALLTYPE SetExceptionMode(UINT raiseFlags) = 0;
+	virtual UINT STDMETHODCALLTYPE GetExceptionMode() = 0;
+};
@@ -5,20 +5,30 @@
 namespace sf11
 {
 
-SfDepthStencilState::SfDepthStencilState(class SfInstance* instance, const D3D11_DEPTH_STENCIL_DESC& desc):
-	Data(std::make_shared<DepthStencilStateData>(instance, desc))
+D3D11_DEPTH_STENCIL_DESC SfDepthStencilState::CanonicalDesc(const D3D11_DEPTH_STENCIL_DESC& desc)
 {
-	Data->Instance->GetDevice()->CreateDepthStencilState(&Data->Desc, Data->State.GetAddressOf());
+	D3D11_DEPTH_STENCIL_DESC out;
+	memset(&out, 0, sizeof(out));
+	out.DepthEnable = desc.DepthEnable;
+	out.DepthWriteMask = desc.DepthWriteMask;
+	out.DepthFunc = desc.DepthFunc;
+	out.StencilEnable = desc.StencilEnable;
+	out.StencilReadMask = desc.StencilReadMask;
+	out.StencilWriteMask = desc.StencilWriteMask;
+	out.FrontFace = desc.FrontFace;
+	out.BackFace = desc.BackFace;
+	return out;
 }
 
 SfDepthBuffer::SfDepthBuffer(class SfInstance* instance, UINT width, UINT height, bool enableStencil /*= false*/)
 {
 	Data = std::make_shared<SfResource::ResourceData>(instance, false);
-	Data->Texture.Width = width;
-	Data->Texture.Height = height;
+	Data->Texture = std::make_unique<SfResource::TextureData>();
+	Data->Texture->Width = width;
+	Data->Texture->Height = height;
 
-	Data->Texture.Params2D.Height = height;
-	Data->Texture.Params2D.Width = width;
+	Data->Texture->Params.Height = height;
+	Data->Texture->Params.Width = width;
 
 	D3D11_TEXTURE2D_DESC descdepth = {};
 	descdepth.Width = width;
@@ -30,16 +40,16 @@ SfDepthBuffer::SfDepthBuffer(class SfInstance* instance, UINT width, UINT height
 	descdepth.SampleDesc.Quality = 0;
 	descdepth.Usage = D3D11_USAGE_DEFAULT;
 	descdepth.BindFlags = D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE;
-	sfAssertHR(Data->Instance->GetDevice()->CreateTexture2D(&descdepth, nullptr, &Data->Texture.Texture2D),
+	sfAssertHR(Data->Instance->GetDevice()->CreateTexture2D(&descdepth, nullptr, &Data->Texture->Texture2D),
 		"could not create depth stencil texture");
-	Data->Resource = Data->Texture.Texture2D.Get();
+	Data->Resource = Data->Texture->Texture2D.Get();
 
 	D3D11_DEPTH_STENCIL_VIEW_DESC dsvdesc = {};
 	dsvdesc.Flags = 0;
 	dsvdesc.Format = enableStencil ? DXGI_FORMAT_D24_UNORM_S8_UINT : DXGI_FORMAT_D32_FLOAT;
 	dsvdesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
 	dsvdesc.Texture2D.MipSlice = 0;
-	sfAssertHR(Data->Instance->GetDevice()->CreateDepthStencilView(Data->Texture.Texture2D.Get(), &dsvdesc, &Data->Texture.DepthStencilView),
+	sfAssertHR(Data->Instance->GetDevice()->CreateDepthStencilView(Data->Texture->Texture2D.Get(), &dsvdesc, &Data->Texture->DepthStencilView),
 		"could not create depth stencil view");
 
 	D3D11_SHADER_RESOURCE_VIEW_DESC srv = {};
@@ -47,9 +57,9 @@ SfDepthBuffer::SfDepthBuffer(class SfInstance* instance, UINT width, UINT height
 	srv.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
 	srv.Texture2D.MostDetailedMip = 0;
 	srv.Texture2D.MipLevels = 1;
-	sfAssertHR(Data->Instance->GetDevice()->CreateShaderResourceView(Data->Texture.Texture2D.Get(), &srv, &Data->Texture.ShaderResource),
+	sfAssertHR(Data->Instance->GetDevice()->CreateShaderResourceView(Data->Texture->Texture2D.Get(), &srv, &Data->Texture->ShaderResource),
 		"could not create shader resource view from depth texture");
-	Data->ShaderResource = Data->Texture.ShaderResource.Get();
+	Data->ShaderResource = Data->Texture->ShaderResource.Get();
 }
 
 }
@@ -17,6 +17,8 @@ class SfDepthStencilState
 {
 	friend class SfInstance;
 	friend class SfContext;
+	friend class SfPipelineState;
+	friend class SfCommandBuffer;
 
 	struct DepthStencilStateData
 	{
@@ -30,7 +32,8 @@ class SfDepthStencilState
 
 	std::shared_ptr<DepthStencilStateData> Data;
 
-	SfDepthStencilState(class SfInstance* instance, const D3D11_DEPTH_STENCIL_DESC& desc);
+	// copies the desc field by field into a zeroed struct so padding bytes compare equal
+	static D3D11_DEPTH_STENCIL_DESC CanonicalDesc(const D3D11_DEPTH_STENCIL_DESC& desc);
 
 public:
 	D3D11_DEPTH_STENCIL_DESC GetDesc() { return Data->Desc; }
@@ -0,0 +1,145 @@
+#include "frame_arena.h"
+#include "sfassert.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace sf11
+{
+
+namespace
+{
+
+std::atomic<UINT64> HeapAllocations = 0;
+thread_local UINT64 ThreadHeapAllocations = 0;
+
+}
+
+SfFrameArena& SfFrameArena::Get()
+{
+	thread_local SfFrameArena arena;
+	return arena;
+}
+
+void SfFrameArena::AddBlock(size_t minSize)
+{
+	Block block;
+	block.Size = minSize > DefaultBlockSize ? minSize : DefaultBlockSize;
+	block.Memory = std::make_unique<BYTE[]>(block.Size);
+	HeapAllocations++;
+
+	// the block after the current one did not fit, so the new one goes in front of it
+	const size_t index = Blocks.empty() ? 0 : Current + 1;
+	Blocks.insert(Blocks.begin() + index, std::move(block));
+	Current = index;
+	Offset = 0;
+}
+
+void* SfFrameArena::Allocate(size_t size, size_t alignment)
+{
+	sfAssert(alignment > 0 && (alignment & (alignment - 1)) == 0, "arena alignment must be a power of two");
+
+	while (true)
+	{
+		if (Current < Blocks.size())
+		{
+			const Block& block = Blocks[Current];
+			const uintptr_t base = (uintptr_t)block.Memory.get();
+			const size_t aligned = ((base + Offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+			if (aligned + size <= block.Size)
+			{
+				Offset = aligned + size;
+				return block.Memory.get() + aligned;
+			}
+
+			// move on to a block kept from an earlier rewind if the allocation fits it
+			if (Current + 1 < Blocks.size() && size + alignment <= Blocks[Current + 1].Size)
+			{
+				Current++;
+				Offset = 0;
+				continue;
+			}
+		}
+
+		AddBlock(size + alignment);
+	}
+}
+
+void SfFrameArena::Reset()
+{
+	if (Blocks.size() > 1)
+	{
+		const size_t capacity = GetCapacity();
+		Blocks.clear();
+		AddBlock(capacity);
+	}
+
+	Current = 0;
+	Offset = 0;
+}
+
+size_t SfFrameArena::GetBytesUsed() const
+{
+	size_t used = Offset;
+	for (size_t i = 0; i < Current && i < Blocks.size(); i++)
+		used += Blocks[i].Size;
+	return used;
+}
+
+size_t SfFrameArena::GetCapacity() const
+{
+	size_t capacity = 0;
+	for (const Block& block : Blocks)
+		capacity += block.Size;
+	return capacity;
+}
+
+UINT64 GetHeapAllocationCount()
+{
+	return HeapAllocations.load(std::memory_order_relaxed);
+}
+
+UINT64 GetThreadHeapAllocationCount()
+{
+	return ThreadHeapAllocations;
+}
+
+}
+
+#if SF_COUNT_HEAP_ALLOCATIONS
+
+// only the unaligned forms are replaced, the aligned forms keep pairing with their own defaults
+
+void* operator new(size_t size)
+{
+	sf11::HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+	sf11::ThreadHeapAllocations++;
+	if (void* p = malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	sf11::HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+	sf11::ThreadHeapAllocations++;
+	return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+	return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+
+#endif
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "d3d11_include.h"
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <type_traits>
+
+// replaces the global operator new and delete with counting versions when 1, see GetHeapAllocationCount
+// off by default since a library should not own the global allocator
+#ifndef SF_COUNT_HEAP_ALLOCATIONS
+	#define SF_COUNT_HEAP_ALLOCATIONS 0
+#endif
+
+namespace sf11
+{
+
+// bump allocator for memory that only has to live until the end of the frame, every thread has its own
+// nothing is freed on its own, Reset releases everything at once by moving the offset back to the start
+// the immediate context resets the arena of its thread in SfContext::EndFrame, other threads reset their own
+// sf11 takes its scratch memory from here inside an SfArenaScope, which gives it back before returning
+class SfFrameArena
+{
+	struct Block
+	{
+		std::unique_ptr<BYTE[]> Memory;
+		size_t Size = 0;
+	};
+
+	static constexpr size_t DefaultBlockSize = 64 * 1024;
+
+	// blocks past Current are kept for reuse after a rewind
+	std::vector<Block> Blocks;
+	size_t Current = 0;
+	size_t Offset = 0;
+
+	UINT64 HeapAllocations = 0;
+
+	void AddBlock(size_t minSize);
+
+public:
+
+	struct Marker
+	{
+		size_t Block = 0;
+		size_t Offset = 0;
+	};
+
+	SfFrameArena() = default;
+	SfFrameArena(const SfFrameArena&) = delete;
+	SfFrameArena& operator=(const SfFrameArena&) = delete;
+
+	// the arena of the calling thread
+	static SfFrameArena& Get();
+
+	void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	// uninitialized, so only types that need no destructor
+	template <typename T>
+	T* Allocate(size_t count)
+	{
+		static_assert(std::is_trivially_destructible_v<T>, "frame arena memory is never destructed");
+		return (T*)Allocate(sizeof(T) * count, alignof(T));
+	}
+
+	Marker GetMarker() const { return { Current, Offset }; }
+
+	// releases everything allocated since the marker was taken, a reset in between releases everything
+	void Rewind(Marker marker)
+	{
+		if (marker.Block >= Blocks.size()) marker = Marker();
+		Current = marker.Block;
+		Offset = marker.Offset;
+	}
+
+	// releases everything, O(1) unless the frame outgrew the first block
+	// then the blocks are merged into one that fits the whole frame, so a frame of the same size never allocates again
+	void Reset();
+
+	size_t GetBytesUsed() const;
+	size_t GetCapacity() const;
+
+	// blocks this arena took from the heap since it was created
+	UINT64 GetNumHeapAllocations() const { return HeapAllocations; }
+};
+
+// rewinds the arena of the calling thread when it goes out of scope
+class SfArenaScope
+{
+	SfFrameArena& Arena;
+	SfFrameArena::Marker Mark;
+
+public:
+
+	SfArenaScope() : Arena(SfFrameArena::Get()), Mark(Arena.GetMarker()) {}
+	~SfArenaScope() { Arena.Rewind(Mark); }
+
+	SfArenaScope(const SfArenaScope&) = delete;
+	SfArenaScope& operator=(const SfArenaScope&) = delete;
+
+	SfFrameArena& GetArena() const { return Arena; }
+};
+
+// std allocator over a frame arena, deallocation does nothing until the arena is rewound or reset
+template <typename T>
+struct SfArenaAllocator
+{
+	typedef T value_type;
+
+	SfFrameArena* Arena;
+
+	SfArenaAllocator(SfFrameArena& arena = SfFrameArena::Get()) : Arena(&arena) {}
+
+	template <typename U>
+	SfArenaAllocator(const SfArenaAllocator<U>& other) : Arena(other.Arena) {}
+
+	T* allocate(size_t count) { return (T*)Arena->Allocate(sizeof(T) * count, alignof(T)); }
+	void deallocate(T*, size_t) {}
+
+	template <typename U>
+	bool operator==(const SfArenaAllocator<U>& other) const { return Arena == other.Arena; }
+	template <typename U>
+	bool operator!=(const SfArenaAllocator<U>& other) const { return Arena != other.Arena; }
+};
+
+// vector for scratch data, must not outlive the scope or frame it was filled in
+template <typename T>
+using SfArenaVector = std::vector<T, SfArenaAllocator<T>>;
+
+// calls to the global operator new since startup, in the whole process or on the calling thread
+// always 0 unless SF_COUNT_HEAP_ALLOCATIONS is 1
+UINT64 GetHeapAllocationCount();
+UINT64 GetThreadHeapAllocationCount();
+
+}
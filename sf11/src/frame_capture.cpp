@@ -0,0 +1,873 @@
+#include "frame_capture.h"
+#include "instance.h"
+#include "context.h"
+#include "sfassert.h"
+#include <fstream>
+#include <cstdio>
+#include <chrono>
+#include <algorithm>
+
+namespace sf11
+{
+
+namespace
+{
+
+// trace commands store object ids in the pointer slots, so traces only load on builds with the same pointer size
+constexpr char TraceMagic[8] = "SF11TRC";
+constexpr UINT TraceVersion = 1;
+
+struct TraceHeader
+{
+	char Magic[8];
+	UINT Version;
+	UINT PointerSize;
+	UINT NumObjects;
+	UINT NumFrames;
+	UINT NumCommands;
+	UINT Padding;
+	UINT64 StreamSize;
+};
+
+struct TraceObjectHeader
+{
+	UINT Kind;
+	UINT Resource;
+	UINT Usage;
+	UINT Stage;
+	UINT Size;
+};
+
+void Append(std::vector<BYTE>& out, const void* data, size_t size)
+{
+	const BYTE* bytes = (const BYTE*)data;
+	out.insert(out.end(), bytes, bytes + size);
+}
+
+template <typename T>
+void AppendValue(std::vector<BYTE>& out, const T& value)
+{
+	Append(out, &value, sizeof(T));
+}
+
+// reads from a loaded object payload, running past the end fails the whole load
+struct PayloadReader
+{
+	const BYTE* Cursor;
+	const BYTE* End;
+
+	const void* Read(size_t size)
+	{
+		if ((size_t)(End - Cursor) < size) return nullptr;
+		const BYTE* data = Cursor;
+		Cursor += size;
+		return data;
+	}
+
+	template <typename T>
+	bool ReadValue(T& value)
+	{
+		const void* data = Read(sizeof(T));
+		if (data) memcpy(&value, data, sizeof(T));
+		return data != nullptr;
+	}
+};
+
+bool IsBlockCompressed(DXGI_FORMAT format)
+{
+	return (format >= DXGI_FORMAT_BC1_TYPELESS && format <= DXGI_FORMAT_BC5_SNORM) ||
+		(format >= DXGI_FORMAT_BC6H_TYPELESS && format <= DXGI_FORMAT_BC7_UNORM_SRGB);
+}
+
+// everything needed to walk the subresources of a texture of any dimension
+struct TextureLayout
+{
+	UINT Dimensions = 0;
+	UINT Width = 1, Height = 1, Depth = 1;
+	UINT MipLevels = 1, ArraySize = 1;
+	DXGI_FORMAT Format = DXGI_FORMAT_UNKNOWN;
+
+	UINT GetNumSubresources() const { return MipLevels * ArraySize; }
+
+	// number of rows of blocks in one depth slice of a mip
+	UINT GetRows(UINT mip) const
+	{
+		const UINT height = std::max(Height >> mip, 1u);
+		return IsBlockCompressed(Format) ? (height + 3) / 4 : height;
+	}
+
+	UINT GetDepth(UINT mip) const { return std::max(Depth >> mip, 1u); }
+};
+
+}
+
+SfFrameCapture::SfFrameCapture(SfInstance* instance)
+	: Data(std::make_shared<FrameCaptureData>(instance))
+{}
+
+bool SfFrameCapture::EndFrame()
+{
+	Data->Commands.RecordFrameEnd();
+	Data->FramesCaptured++;
+	return Data->FramesLeft == 0 || --Data->FramesLeft > 0;
+}
+
+void SfFrameCapture::RegisterLastCommand(SfContext& context)
+{
+	ID3D11DeviceContext* d3dContext = context.Data->Context.Get();
+	BYTE* command = Data->Commands.GetLastCommand();
+	const SfCommandBuffer::CommandHeader& header = *(const SfCommandBuffer::CommandHeader*)command;
+
+	SfCommandBuffer::VisitObjects(header.Type, command + sizeof(SfCommandBuffer::CommandHeader),
+		[&](void*& object, EObjectKind kind, UINT stage) { Data->StreamIds.push_back(Register(d3dContext, object, kind, stage)); });
+}
+
+UINT SfFrameCapture::Register(ID3D11DeviceContext* context, void* object, EObjectKind kind, UINT stage)
+{
+	if (!object) return 0;
+
+	// buffers share their ids with the resource they are
+	if (kind == EObjectKind::Buffer) return RegisterResource(context, (ID3D11Buffer*)object);
+
+	auto it = Data->ObjectIds.find(object);
+	if (it != Data->ObjectIds.end())
+	{
+		// a freed sf11 resource can hand its address to a new one during the capture, its d3d resource tells them apart
+		// the entry holds that d3d resource, so the address of the old one cannot be reused
+		const CapturedObject& existing = Data->Objects[it->second - 1];
+		if (kind != EObjectKind::Resource || existing.Object.Get() == (IUnknown*)((const SfResource::ResourceData*)object)->Resource)
+			return it->second;
+	}
+
+	// dependencies are registered first so a trace can be loaded front to back
+	CapturedObject captured;
+	captured.Kind = kind;
+	captured.Stage = stage;
+	switch (kind)
+	{
+		case EObjectKind::ShaderResourceView:
+		case EObjectKind::UnorderedAccessView:
+		case EObjectKind::RenderTargetView:
+		case EObjectKind::DepthStencilView:
+		{
+			ComPtr<ID3D11Resource> resource;
+			((ID3D11View*)object)->GetResource(&resource);
+			captured.Resource = RegisterResource(context, resource.Get());
+			captured.Object = (IUnknown*)object;
+			break;
+		}
+		case EObjectKind::Resource:
+		{
+			// sf11 resources are not reference counted objects, the d3d resource keeps the contents alive
+			const SfResource::ResourceData& res = *(const SfResource::ResourceData*)object;
+			captured.Resource = RegisterResource(context, res.Resource);
+			captured.Usage = res.Usage;
+			captured.Object = (IUnknown*)res.Resource;
+			break;
+		}
+		default:
+			captured.Object = (IUnknown*)object;
+			break;
+	}
+
+	Data->Objects.push_back(std::move(captured));
+	const UINT id = (UINT)Data->Objects.size();
+	Data->ObjectIds[object] = id;
+	return id;
+}
+
+UINT SfFrameCapture::RegisterResource(ID3D11DeviceContext* context, ID3D11Resource* resource)
+{
+	if (!resource) return 0;
+
+	auto it = Data->ObjectIds.find(resource);
+	if (it != Data->ObjectIds.end()) return it->second;
+
+	D3D11_RESOURCE_DIMENSION dimension;
+	resource->GetType(&dimension);
+
+	CapturedObject captured;
+	captured.Kind = dimension == D3D11_RESOURCE_DIMENSION_BUFFER ? EObjectKind::Buffer : EObjectKind::Texture;
+	captured.Object = resource;
+
+	// staging copies keep size, format and layout but drop every bind flag
+	ID3D11Device* device = Data->Instance->GetDevice();
+	switch (dimension)
+	{
+		case D3D11_RESOURCE_DIMENSION_BUFFER:
+		{
+			D3D11_BUFFER_DESC desc;
+			((ID3D11Buffer*)resource)->GetDesc(&desc);
+			desc.Usage = D3D11_USAGE_STAGING; desc.BindFlags = 0; desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ; desc.MiscFlags = 0; desc.StructureByteStride = 0;
+
+			ComPtr<ID3D11Buffer> staging;
+			sfAssertHR(device->CreateBuffer(&desc, NULL, &staging), "could not create capture snapshot buffer");
+			captured.Snapshot = staging;
+			break;
+		}
+		case D3D11_RESOURCE_DIMENSION_TEXTURE1D:
+		{
+			D3D11_TEXTURE1D_DESC desc;
+			((ID3D11Texture1D*)resource)->GetDesc(&desc);
+			if (desc.BindFlags & D3D11_BIND_DEPTH_STENCIL) break;
+			desc.Usage = D3D11_USAGE_STAGING; desc.BindFlags = 0; desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ; desc.MiscFlags = 0;
+
+			ComPtr<ID3D11Texture1D> staging;
+			sfAssertHR(device->CreateTexture1D(&desc, NULL, &staging), "could not create capture snapshot texture1D");
+			captured.Snapshot = staging;
+			break;
+		}
+		case D3D11_RESOURCE_DIMENSION_TEXTURE2D:
+		{
+			// depth buffers cannot be created with initial data and multisampled textures cannot be copied to staging
+			D3D11_TEXTURE2D_DESC desc;
+			((ID3D11Texture2D*)resource)->GetDesc(&desc);
+			if ((desc.BindFlags & D3D11_BIND_DEPTH_STENCIL) || desc.SampleDesc.Count > 1) break;
+			desc.Usage = D3D11_USAGE_STAGING; desc.BindFlags = 0; desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ; desc.MiscFlags = 0;
+
+			ComPtr<ID3D11Texture2D> staging;
+			sfAssertHR(device->CreateTexture2D(&desc, NULL, &staging), "could not create capture snapshot texture2D");
+			captured.Snapshot = staging;
+			break;
+		}
+		case D3D11_RESOURCE_DIMENSION_TEXTURE3D:
+		{
+			D3D11_TEXTURE3D_DESC desc;
+			((ID3D11Texture3D*)resource)->GetDesc(&desc);
+			desc.Usage = D3D11_USAGE_STAGING; desc.BindFlags = 0; desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ; desc.MiscFlags = 0;
+
+			ComPtr<ID3D11Texture3D> staging;
+			sfAssertHR(device->CreateTexture3D(&desc, NULL, &staging), "could not create capture snapshot texture3D");
+			captured.Snapshot = staging;
+			break;
+		}
+		default:
+			break;
+	}
+
+	// runs on the capturing context, so the copy sees the contents as of this call
+	if (captured.Snapshot) context->CopyResource(captured.Snapshot.Get(), resource);
+
+	Data->Objects.push_back(std::move(captured));
+	const UINT id = (UINT)Data->Objects.size();
+	Data->ObjectIds[resource] = id;
+	return id;
+}
+
+// reads every subresource of a staging texture, blocking until the gpu is done with it
+static void AppendTextureContents(std::vector<BYTE>& out, ID3D11DeviceContext* context, ID3D11Resource* staging, const TextureLayout& layout)
+{
+	AppendValue(out, staging ? layout.GetNumSubresources() : 0u);
+	if (!staging) return;
+
+	for (UINT slice = 0; slice < layout.ArraySize; slice++)
+	{
+		for (UINT mip = 0; mip < layout.MipLevels; mip++)
+		{
+			D3D11_MAPPED_SUBRESOURCE mapped;
+			sfAssertHR(context->Map(staging, mip + slice * layout.MipLevels, D3D11_MAP_READ, 0, &mapped), "could not map capture snapshot");
+
+			const UINT size = layout.Dimensions == 3 ?
+				mapped.DepthPitch * layout.GetDepth(mip) :
+				mapped.RowPitch * layout.GetRows(mip);
+			AppendValue(out, mapped.RowPitch);
+			AppendValue(out, mapped.DepthPitch);
+			AppendValue(out, size);
+			Append(out, mapped.pData, size);
+			context->Unmap(staging, mip + slice * layout.MipLevels);
+		}
+	}
+}
+
+// bytecode attached to a shader or input layout by sf11, empty for objects created elsewhere
+static bool AppendBytecode(std::vector<BYTE>& out, ID3D11DeviceChild* object)
+{
+	IUnknown* unknown = nullptr;
+	UINT size = sizeof(unknown);
+	if (FAILED(object->GetPrivateData(SF_GUID_SHADER_BYTECODE, &size, &unknown)) || !unknown)
+		return false;
+
+	ComPtr<IUnknown> holder;
+	holder.Attach(unknown);
+	ComPtr<ID3DBlob> blob;
+	if (FAILED(holder.As(&blob))) return false;
+
+	AppendValue(out, (UINT)blob->GetBufferSize());
+	Append(out, blob->GetBufferPointer(), blob->GetBufferSize());
+	return true;
+}
+
+bool SfFrameCapture::Save(const std::string& filePath) const
+{
+	SfContext& immediate = Data->Instance->GetImmediateContext();
+	ID3D11DeviceContext* context = immediate.Data->Context.Get();
+
+	std::ofstream file(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file) return false;
+
+	TraceHeader header = {};
+	memcpy(header.Magic, TraceMagic, sizeof(header.Magic));
+	header.Version = TraceVersion;
+	header.PointerSize = sizeof(void*);
+	header.NumObjects = (UINT)Data->Objects.size();
+	header.NumFrames = Data->FramesCaptured;
+	header.NumCommands = Data->Commands.GetNumCommands();
+	header.StreamSize = Data->Commands.Stream.size();
+	file.write((const char*)&header, sizeof(header));
+
+	std::vector<BYTE> payload;
+	for (const CapturedObject& object : Data->Objects)
+	{
+		payload.clear();
+		switch (object.Kind)
+		{
+			case EObjectKind::Buffer:
+			{
+				ID3D11Buffer* buffer = (ID3D11Buffer*)object.Object.Get();
+				D3D11_BUFFER_DESC desc;
+				buffer->GetDesc(&desc);
+				AppendValue(payload, desc);
+
+				D3D11_MAPPED_SUBRESOURCE mapped;
+				sfAssertHR(context->Map(object.Snapshot.Get(), 0, D3D11_MAP_READ, 0, &mapped), "could not map capture snapshot");
+				Append(payload, mapped.pData, desc.ByteWidth);
+				context->Unmap(object.Snapshot.Get(), 0);
+				break;
+			}
+			case EObjectKind::Texture:
+			{
+				ID3D11Resource* resource = (ID3D11Resource*)object.Object.Get();
+				D3D11_RESOURCE_DIMENSION dimension;
+				resource->GetType(&dimension);
+
+				TextureLayout layout;
+				if (dimension == D3D11_RESOURCE_DIMENSION_TEXTURE1D)
+				{
+					D3D11_TEXTURE1D_DESC desc;
+					((ID3D11Texture1D*)resource)->GetDesc(&desc);
+					AppendValue(payload, 1u);
+					AppendValue(payload, desc);
+					layout = { 1, desc.Width, 1, 1, desc.MipLevels, desc.ArraySize, desc.Format };
+				}
+				else if (dimension == D3D11_RESOURCE_DIMENSION_TEXTURE2D)
+				{
+					D3D11_TEXTURE2D_DESC desc;
+					((ID3D11Texture2D*)resource)->GetDesc(&desc);
+					AppendValue(payload, 2u);
+					AppendValue(payload, desc);
+					layout = { 2, desc.Width, desc.Height, 1, desc.MipLevels, desc.ArraySize, desc.Format };
+				}
+				else
+				{
+					D3D11_TEXTURE3D_DESC desc;
+					((ID3D11Texture3D*)resource)->GetDesc(&desc);
+					AppendValue(payload, 3u);
+					AppendValue(payload, desc);
+					layout = { 3, desc.Width, desc.Height, desc.Depth, desc.MipLevels, 1, desc.Format };
+				}
+				AppendTextureContents(payload, context, object.Snapshot.Get(), layout);
+				break;
+			}
+			case EObjectKind::ShaderResourceView:
+			{
+				D3D11_SHADER_RESOURCE_VIEW_DESC desc;
+				((ID3D11ShaderResourceView*)object.Object.Get())->GetDesc(&desc);
+				AppendValue(payload, desc);
+				break;
+			}
+			case EObjectKind::UnorderedAccessView:
+			{
+				D3D11_UNORDERED_ACCESS_VIEW_DESC desc;
+				((ID3D11UnorderedAccessView*)object.Object.Get())->GetDesc(&desc);
+				AppendValue(payload, desc);
+				break;
+			}
+			case EObjectKind::RenderTargetView:
+			{
+				D3D11_RENDER_TARGET_VIEW_DESC desc;
+				((ID3D11RenderTargetView*)object.Object.Get())->GetDesc(&desc);
+				AppendValue(payload, desc);
+				break;
+			}
+			case EObjectKind::DepthStencilView:
+			{
+				D3D11_DEPTH_STENCIL_VIEW_DESC desc;
+				((ID3D11DepthStencilView*)object.Object.Get())->GetDesc(&desc);
+				AppendValue(payload, desc);
+				break;
+			}
+			case EObjectKind::Sampler:
+			{
+				D3D11_SAMPLER_DESC desc;
+				((ID3D11SamplerState*)object.Object.Get())->GetDesc(&desc);
+				AppendValue(payload, desc);
+				break;
+			}
+			case EObjectKind::BlendState:
+			{
+				D3D11_BLEND_DESC desc;
+				((ID3D11BlendState*)object.Object.Get())->GetDesc(&desc);
+				AppendValue(payload, desc);
+				break;
+			}
+			case EObjectKind::DepthStencilState:
+			{
+				D3D11_DEPTH_STENCIL_DESC desc;
+				((ID3D11DepthStencilState*)object.Object.Get())->GetDesc(&desc);
+				AppendValue(payload, desc);
+				break;
+			}
+			case EObjectKind::Rasterizer:
+			{
+				D3D11_RASTERIZER_DESC desc;
+				((ID3D11RasterizerState*)object.Object.Get())->GetDesc(&desc);
+				AppendValue(payload, desc);
+				break;
+			}
+			case EObjectKind::Shader:
+				sfAssert(AppendBytecode(payload, (ID3D11DeviceChild*)object.Object.Get()), "cannot capture a shader that was not created by sf11");
+				break;
+			case EObjectKind::InputLayout:
+			{
+				ID3D11InputLayout* layout = (ID3D11InputLayout*)object.Object.Get();
+				UINT size = 0;
+				layout->GetPrivateData(SF_GUID_INPUT_ELEMENTS, &size, nullptr);
+				sfAssert(size > 0, "cannot capture an input layout that was not created by sf11");
+
+				std::vector<BYTE> elements(size);
+				layout->GetPrivateData(SF_GUID_INPUT_ELEMENTS, &size, elements.data());
+				AppendValue(payload, size);
+				Append(payload, elements.data(), size);
+				sfAssert(AppendBytecode(payload, layout), "input layout is missing its vertex shader bytecode");
+				break;
+			}
+			case EObjectKind::Resource:
+				break;
+		}
+
+		TraceObjectHeader objectHeader = { (UINT)object.Kind, object.Resource, (UINT)object.Usage.Value, object.Stage, (UINT)payload.size() };
+		file.write((const char*)&objectHeader, sizeof(objectHeader));
+		file.write((const char*)payload.data(), payload.size());
+	}
+
+	// pointers are written as the ids they were registered under when their command was recorded
+	std::vector<BYTE> stream = Data->Commands.Stream;
+	BYTE* cursor = stream.data();
+	BYTE* end = cursor + stream.size();
+	size_t nextId = 0;
+	while (cursor < end)
+	{
+		const SfCommandBuffer::CommandHeader& command = *(const SfCommandBuffer::CommandHeader*)cursor;
+		SfCommandBuffer::VisitObjects(command.Type, cursor + sizeof(SfCommandBuffer::CommandHeader),
+			[&](void*& object, EObjectKind, UINT)
+			{
+				sfAssert(nextId < Data->StreamIds.size(), "captured command references an unregistered object");
+				object = (void*)(size_t)Data->StreamIds[nextId++];
+			});
+		cursor += command.Size;
+	}
+	file.write((const char*)stream.data(), stream.size());
+
+	return (bool)file;
+}
+
+SfTraceReplayer::SfTraceReplayer(SfInstance* instance)
+	: Data(std::make_shared<TraceReplayerData>(instance))
+{}
+
+bool SfTraceReplayer::Load(const std::string& filePath)
+{
+	std::ifstream file(filePath, std::ios::in | std::ios::binary);
+	if (!file) return false;
+
+	TraceHeader header;
+	if (!file.read((char*)&header, sizeof(header))) return false;
+	if (memcmp(header.Magic, TraceMagic, sizeof(header.Magic)) != 0 || header.Version != TraceVersion) return false;
+	if (header.PointerSize != sizeof(void*)) return false;
+
+	ID3D11Device* device = Data->Instance->GetDevice();
+	typedef SfCommandBuffer::EObjectKind EObjectKind;
+
+	// raw pointer each id is replaced with in the command stream, with the kind and shader stage it was saved as
+	std::vector<void*> pointers;
+	std::vector<TraceObjectHeader> objectHeaders;
+	pointers.reserve(header.NumObjects);
+	objectHeaders.reserve(header.NumObjects);
+	Data->Objects.reserve(header.NumObjects);
+
+	// views and sf11 resources may only point at a buffer or texture that was loaded before them
+	auto getResource = [&](UINT id) -> ID3D11Resource*
+	{
+		if (id == 0 || id > Data->Objects.size()) return nullptr;
+		const EObjectKind kind = (EObjectKind)objectHeaders[id - 1].Kind;
+		return kind == EObjectKind::Buffer || kind == EObjectKind::Texture ? (ID3D11Resource*)Data->Objects[id - 1].Get() : nullptr;
+	};
+
+	// captured contents of constant buffers, the stand-ins of static ones seed their cpu copy from these
+	std::unordered_map<UINT, std::vector<BYTE>> constantContents;
+
+	std::vector<BYTE> payload;
+	for (UINT i = 0; i < header.NumObjects; i++)
+	{
+		TraceObjectHeader objectHeader;
+		if (!file.read((char*)&objectHeader, sizeof(objectHeader))) return false;
+		payload.resize(objectHeader.Size);
+		if (objectHeader.Size > 0 && !file.read((char*)payload.data(), objectHeader.Size)) return false;
+
+		PayloadReader reader = { payload.data(), payload.data() + payload.size() };
+		ComPtr<IUnknown> object;
+		void* pointer = nullptr;
+
+		switch ((EObjectKind)objectHeader.Kind)
+		{
+			case EObjectKind::Buffer:
+			{
+				D3D11_BUFFER_DESC desc;
+				if (!reader.ReadValue(desc)) return false;
+				const void* contents = reader.Read(desc.ByteWidth);
+				if (!contents) return false;
+
+				if (desc.BindFlags & D3D11_BIND_CONSTANT_BUFFER)
+					constantContents[i + 1].assign((const BYTE*)contents, (const BYTE*)contents + desc.ByteWidth);
+
+				D3D11_SUBRESOURCE_DATA init = { contents, 0, 0 };
+				ComPtr<ID3D11Buffer> buffer;
+				sfAssertHR(device->CreateBuffer(&desc, &init, &buffer), "could not recreate traced buffer");
+				pointer = buffer.Get();
+				object = buffer;
+				break;
+			}
+			case EObjectKind::Texture:
+			{
+				UINT dimensions;
+				if (!reader.ReadValue(dimensions)) return false;
+
+				D3D11_TEXTURE1D_DESC desc1D;
+				D3D11_TEXTURE2D_DESC desc2D;
+				D3D11_TEXTURE3D_DESC desc3D;
+				if (dimensions == 1 && !reader.ReadValue(desc1D)) return false;
+				if (dimensions == 2 && !reader.ReadValue(desc2D)) return false;
+				if (dimensions == 3 && !reader.ReadValue(desc3D)) return false;
+
+				UINT numSubresources;
+				if (!reader.ReadValue(numSubresources)) return false;
+
+				std::vector<D3D11_SUBRESOURCE_DATA> init(numSubresources);
+				for (D3D11_SUBRESOURCE_DATA& sub : init)
+				{
+					UINT size;
+					if (!reader.ReadValue(sub.SysMemPitch) || !reader.ReadValue(sub.SysMemSlicePitch) || !reader.ReadValue(size)) return false;
+					sub.pSysMem = reader.Read(size);
+					if (!sub.pSysMem) return false;
+				}
+				const D3D11_SUBRESOURCE_DATA* initData = init.empty() ? nullptr : init.data();
+
+				if (dimensions == 1)
+				{
+					ComPtr<ID3D11Texture1D> tex;
+					sfAssertHR(device->CreateTexture1D(&desc1D, initData, &tex), "could not recreate traced texture1D");
+					pointer = tex.Get();
+					object = tex;
+				}
+				else if (dimensions == 2)
+				{
+					ComPtr<ID3D11Texture2D> tex;
+					sfAssertHR(device->CreateTexture2D(&desc2D, initData, &tex), "could not recreate traced texture2D");
+					pointer = tex.Get();
+					object = tex;
+				}
+				else if (dimensions == 3)
+				{
+					ComPtr<ID3D11Texture3D> tex;
+					sfAssertHR(device->CreateTexture3D(&desc3D, initData, &tex), "could not recreate traced texture3D");
+					pointer = tex.Get();
+					object = tex;
+				}
+				else return false;
+				break;
+			}
+			case EObjectKind::ShaderResourceView:
+			{
+				D3D11_SHADER_RESOURCE_VIEW_DESC desc;
+				if (!reader.ReadValue(desc)) return false;
+				ComPtr<ID3D11ShaderResourceView> view;
+				sfAssertHR(device->CreateShaderResourceView(getResource(objectHeader.Resource), &desc, &view), "could not recreate traced shader resource view");
+				pointer = view.Get();
+				object = view;
+				break;
+			}
+			case EObjectKind::UnorderedAccessView:
+			{
+				D3D11_UNORDERED_ACCESS_VIEW_DESC desc;
+				if (!reader.ReadValue(desc)) return false;
+				ComPtr<ID3D11UnorderedAccessView> view;
+				sfAssertHR(device->CreateUnorderedAccessView(getResource(objectHeader.Resource), &desc, &view), "could not recreate traced unordered access view");
+				pointer = view.Get();
+				object = view;
+				break;
+			}
+			case EObjectKind::RenderTargetView:
+			{
+				D3D11_RENDER_TARGET_VIEW_DESC desc;
+				if (!reader.ReadValue(desc)) return false;
+				ComPtr<ID3D11RenderTargetView> view;
+				sfAssertHR(device->CreateRenderTargetView(getResource(objectHeader.Resource), &desc, &view), "could not recreate traced render target view");
+				pointer = view.Get();
+				object = view;
+				break;
+			}
+			case EObjectKind::DepthStencilView:
+			{
+				D3D11_DEPTH_STENCIL_VIEW_DESC desc;
+				if (!reader.ReadValue(desc)) return false;
+				ComPtr<ID3D11DepthStencilView> view;
+				sfAssertHR(device->CreateDepthStencilView(getResource(objectHeader.Resource), &desc, &view), "could not recreate traced depth stencil view");
+				pointer = view.Get();
+				object = view;
+				break;
+			}
+			case EObjectKind::Sampler:
+			{
+				D3D11_SAMPLER_DESC desc;
+				if (!reader.ReadValue(desc)) return false;
+				ComPtr<ID3D11SamplerState> state;
+				sfAssertHR(device->CreateSamplerState(&desc, &state), "could not recreate traced sampler");
+				pointer = state.Get();
+				object = state;
+				break;
+			}
+			case EObjectKind::BlendState:
+			{
+				D3D11_BLEND_DESC desc;
+				if (!reader.ReadValue(desc)) return false;
+				ComPtr<ID3D11BlendState> state;
+				sfAssertHR(device->CreateBlendState(&desc, &state), "could not recreate traced blend state");
+				pointer = state.Get();
+				object = state;
+				break;
+			}
+			case EObjectKind::DepthStencilState:
+			{
+				D3D11_DEPTH_STENCIL_DESC desc;
+				if (!reader.ReadValue(desc)) return false;
+				ComPtr<ID3D11DepthStencilState> state;
+				sfAssertHR(device->CreateDepthStencilState(&desc, &state), "could not recreate traced depth stencil state");
+				pointer = state.Get();
+				object = state;
+				break;
+			}
+			case EObjectKind::Rasterizer:
+			{
+				D3D11_RASTERIZER_DESC desc;
+				if (!reader.ReadValue(desc)) return false;
+				ComPtr<ID3D11RasterizerState> state;
+				sfAssertHR(device->CreateRasterizerState(&desc, &state), "could not recreate traced rasterizer");
+				pointer = state.Get();
+				object = state;
+				break;
+			}
+			case EObjectKind::Shader:
+			{
+				UINT size;
+				if (!reader.ReadValue(size)) return false;
+				const void* code = reader.Read(size);
+				if (!code) return false;
+
+				switch (objectHeader.Stage)
+				{
+					case 0: { ComPtr<ID3D11VertexShader> s; sfAssertHR(device->CreateVertexShader(code, size, NULL, &s), "could not recreate traced shader"); pointer = s.Get(); object = s; break; }
+					case 1: { ComPtr<ID3D11PixelShader> s; sfAssertHR(device->CreatePixelShader(code, size, NULL, &s), "could not recreate traced shader"); pointer = s.Get(); object = s; break; }
+					case 2: { ComPtr<ID3D11HullShader> s; sfAssertHR(device->CreateHullShader(code, size, NULL, &s), "could not recreate traced shader"); pointer = s.Get(); object = s; break; }
+					case 3: { ComPtr<ID3D11DomainShader> s; sfAssertHR(device->CreateDomainShader(code, size, NULL, &s), "could not recreate traced shader"); pointer = s.Get(); object = s; break; }
+					case 4: { ComPtr<ID3D11GeometryShader> s; sfAssertHR(device->CreateGeometryShader(code, size, NULL, &s), "could not recreate traced shader"); pointer = s.Get(); object = s; break; }
+					case 5: { ComPtr<ID3D11ComputeShader> s; sfAssertHR(device->CreateComputeShader(code, size, NULL, &s), "could not recreate traced shader"); pointer = s.Get(); object = s; break; }
+					default: return false;
+				}
+				break;
+			}
+			case EObjectKind::InputLayout:
+			{
+				UINT elementBytes, codeSize;
+				if (!reader.ReadValue(elementBytes)) return false;
+				const SfStoredInputElement* stored = (const SfStoredInputElement*)reader.Read(elementBytes);
+				if (!stored || !reader.ReadValue(codeSize)) return false;
+				const void* code = reader.Read(codeSize);
+				if (!code) return false;
+
+				std::vector<D3D11_INPUT_ELEMENT_DESC> elements(elementBytes / sizeof(SfStoredInputElement));
+				for (size_t e = 0; e < elements.size(); e++)
+				{
+					elements[e].SemanticName = stored[e].SemanticName;
+					elements[e].SemanticIndex = stored[e].SemanticIndex;
+					elements[e].Format = stored[e].Format;
+					elements[e].InputSlot = stored[e].InputSlot;
+					elements[e].AlignedByteOffset = stored[e].AlignedByteOffset;
+					elements[e].InputSlotClass = stored[e].InputSlotClass;
+					elements[e].InstanceDataStepRate = stored[e].InstanceDataStepRate;
+				}
+
+				ComPtr<ID3D11InputLayout> layout;
+				sfAssertHR(device->CreateInputLayout(elements.data(), (UINT)elements.size(), code, codeSize, &layout), "could not recreate traced input layout");
+				pointer = layout.Get();
+				object = layout;
+				break;
+			}
+			case EObjectKind::Resource:
+			{
+				// only what UpdateResourceData and CopyResourceData look at is filled in
+				ID3D11Resource* resource = getResource(objectHeader.Resource);
+				if (!resource) return false;
+
+				SfUsage usage;
+				usage.Value = objectHeader.Usage;
+				std::shared_ptr<SfResource::ResourceData> res = std::make_shared<SfResource::ResourceData>(Data->Instance, usage);
+				res->Resource = resource;
+
+				D3D11_RESOURCE_DIMENSION dimension;
+				resource->GetType(&dimension);
+				switch (dimension)
+				{
+					case D3D11_RESOURCE_DIMENSION_BUFFER:
+						res->Buffer = std::make_unique<SfResource::BufferData>();
+						res->Buffer->Buffer = (ID3D11Buffer*)resource;
+						res->Buffer->Buffer->GetDesc(&res->Buffer->BufferDesc);
+						if (usage.Value == SfUsage::Static && Data->Instance->NeedsWholeConstantUpdates())
+						{
+							// partial updates upload the whole copy, so it has to start out as what was captured
+							auto contents = constantContents.find(objectHeader.Resource);
+							if (contents != constantContents.end())
+							{
+								res->Buffer->Shadow = std::make_unique<BYTE[]>(contents->second.size());
+								memcpy(res->Buffer->Shadow.get(), contents->second.data(), contents->second.size());
+							}
+						}
+						break;
+					case D3D11_RESOURCE_DIMENSION_TEXTURE1D:
+						res->Texture = std::make_unique<SfResource::TextureData>();
+						res->Texture->Dimensions = 1;
+						res->Texture->Texture1D = (ID3D11Texture1D*)resource;
+						res->Texture->Texture1D->GetDesc(&res->Texture->TextureDesc1D);
+						res->Texture->Width = res->Texture->TextureDesc1D.Width;
+						break;
+					case D3D11_RESOURCE_DIMENSION_TEXTURE2D:
+						res->Texture = std::make_unique<SfResource::TextureData>();
+						res->Texture->Dimensions = 2;
+						res->Texture->Texture2D = (ID3D11Texture2D*)resource;
+						res->Texture->Texture2D->GetDesc(&res->Texture->TextureDesc2D);
+						res->Texture->Width = res->Texture->TextureDesc2D.Width;
+						res->Texture->Height = res->Texture->TextureDesc2D.Height;
+						break;
+					default:
+						res->Texture = std::make_unique<SfResource::TextureData>();
+						res->Texture->Dimensions = 3;
+						res->Texture->Texture3D = (ID3D11Texture3D*)resource;
+						res->Texture->Texture3D->GetDesc(&res->Texture->TextureDesc3D);
+						res->Texture->Width = res->Texture->TextureDesc3D.Width;
+						res->Texture->Height = res->Texture->TextureDesc3D.Height;
+						res->Texture->Depth = res->Texture->TextureDesc3D.Depth;
+						break;
+				}
+
+				pointer = res.get();
+				Data->Resources.push_back(std::move(res));
+				break;
+			}
+			default:
+				return false;
+		}
+
+		Data->Objects.push_back(std::move(object));
+		pointers.push_back(pointer);
+		objectHeaders.push_back(objectHeader);
+	}
+
+	std::vector<BYTE>& stream = Data->Commands.Stream;
+	stream.resize((size_t)header.StreamSize);
+	if (header.StreamSize > 0 && !file.read((char*)stream.data(), stream.size())) return false;
+
+	bool valid = true;
+	BYTE* cursor = stream.data();
+	BYTE* end = cursor + stream.size();
+	while (cursor < end && valid)
+	{
+		if ((size_t)(end - cursor) < sizeof(SfCommandBuffer::CommandHeader)) return false;
+		const SfCommandBuffer::CommandHeader& command = *(const SfCommandBuffer::CommandHeader*)cursor;
+		if (command.Size < sizeof(SfCommandBuffer::CommandHeader) || command.Size > (size_t)(end - cursor)) return false;
+		if ((UINT)command.Type >= SF_NUM_COMMAND_TYPES) return false;
+
+		// a damaged count or id must not put an object where replay expects another kind, or read past the command
+		BYTE* commandEnd = cursor + command.Size;
+		SfCommandBuffer::VisitObjects(command.Type, cursor + sizeof(SfCommandBuffer::CommandHeader),
+			[&](void*& object, EObjectKind kind, UINT stage)
+			{
+				if (!valid) return;
+				if ((BYTE*)(&object + 1) > commandEnd) { valid = false; return; }
+
+				const size_t id = (size_t)object;
+				if (id == 0) return;
+				if (id > pointers.size()) { valid = false; return; }
+
+				const TraceObjectHeader& saved = objectHeaders[id - 1];
+				if ((EObjectKind)saved.Kind != kind || (kind == EObjectKind::Shader && saved.Stage != stage)) { valid = false; return; }
+				object = pointers[id - 1];
+			});
+		cursor += command.Size;
+	}
+	if (!valid) return false;
+
+	Data->Commands.NumCommands = header.NumCommands;
+	Data->Frames = header.NumFrames;
+	return true;
+}
+
+SfTraceReport SfTraceReplayer::Replay(SfContext& context) const
+{
+	SfTraceReport report;
+	report.Frames = Data->Frames;
+
+	SfCommandTimings timings;
+	const SfContextStats statsBefore = context.GetStats();
+	auto start = std::chrono::high_resolution_clock::now();
+
+	Data->Commands.Replay(context, &timings);
+
+	report.TotalUs = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+	report.Stats = context.GetStats() - statsBefore;
+
+	for (UINT i = 0; i < SF_NUM_COMMAND_TYPES; i++)
+	{
+		if (timings.Count[i] == 0) continue;
+		report.Calls.push_back({ SfCommandBuffer::GetCommandName(i), timings.Count[i], timings.Microseconds[i] });
+	}
+	std::sort(report.Calls.begin(), report.Calls.end(),
+		[](const SfTraceReport::CallTiming& a, const SfTraceReport::CallTiming& b) { return a.TotalUs > b.TotalUs; });
+
+	return report;
+}
+
+std::string SfTraceReport::ToString() const
+{
+	char line[160];
+	std::string out;
+
+	snprintf(line, sizeof(line), "%u frames, %.1f us total, %.1f us per frame\n",
+		Frames, TotalUs, Frames > 0 ? TotalUs / Frames : TotalUs);
+	out += line;
+
+	snprintf(line, sizeof(line), "%-22s %10s %12s %10s\n", "call", "count", "total us", "avg us");
+	out += line;
+	for (const CallTiming& call : Calls)
+	{
+		snprintf(line, sizeof(line), "%-22s %10llu %12.1f %10.3f\n",
+			call.Name, (unsigned long long)call.Count, call.TotalUs, call.TotalUs / call.Count);
+		out += line;
+	}
+
+	snprintf(line, sizeof(line), "d3d calls: %llu draws, %llu dispatches, %llu binds, %llu state changes\n",
+		(unsigned long long)Stats.Draws, (unsigned long long)Stats.Dispatches,
+		(unsigned long long)Stats.GetTotalBinds(), (unsigned long long)Stats.StateChanges);
+	out += line;
+	return out;
+}
+
+}
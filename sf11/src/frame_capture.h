@@ -0,0 +1,154 @@
+#pragma once
+
+#include "d3d11_include.h"
+#include "command_buffer.h"
+#include "context_stats.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+namespace sf11
+{
+
+// records every call a context sends through sf11 for a number of frames and writes it to a binary trace
+// start it with SfContext::SetFrameCapture, each SfContext::EndFrame closes one captured frame
+// objects are written by description, buffers and textures with their contents from the moment they were first used
+// shader bytecode is only known for shaders created by sf11
+// writes made through MapResource and BindRenderTargetsAndUnorderedAccessViews are not captured
+class SfFrameCapture
+{
+	friend class SfInstance;
+	friend class SfContext;
+
+	typedef SfCommandBuffer::EObjectKind EObjectKind;
+
+	struct CapturedObject
+	{
+		EObjectKind Kind;
+
+		// the d3d resource for sf11 resources, which keys the entry together with the address of the resource
+		ComPtr<IUnknown> Object;
+
+		// id of the d3d resource behind views and sf11 resources, 0 for everything else
+		UINT Resource = 0;
+		SfUsage Usage = SfUsage::Static;
+
+		// bit position in EShaderStage for shaders
+		UINT Stage = 0;
+
+		// staging copy of a buffer or texture, null for multisampled and depth textures
+		ComPtr<ID3D11Resource> Snapshot;
+	};
+
+	struct FrameCaptureData
+	{
+		class SfInstance* Instance = nullptr;
+		SfCommandBuffer Commands;
+
+		// ids are the index in Objects plus one, 0 is null
+		std::vector<CapturedObject> Objects;
+		std::unordered_map<void*, UINT> ObjectIds;
+
+		// the id of every object the stream references, in the order VisitObjects reaches them
+		// taken when the command is recorded, so an address that is reused later in the capture keeps its old id
+		std::vector<UINT> StreamIds;
+
+		UINT FramesLeft = 0;
+		UINT FramesCaptured = 0;
+
+		FrameCaptureData(class SfInstance* instance) : Instance(instance), Commands(*instance) {}
+	};
+
+	std::shared_ptr<FrameCaptureData> Data;
+
+	SfFrameCapture(class SfInstance* instance);
+
+	// records one call, then registers every object it references
+	template <typename F>
+	void Record(class SfContext& context, F record)
+	{
+		// the ids of the stream are taken in order, so a call that recorded nothing must not register again
+		const UINT numCommands = Data->Commands.GetNumCommands();
+		record(Data->Commands);
+		if (Data->Commands.GetNumCommands() != numCommands) RegisterLastCommand(context);
+	}
+
+	void RegisterLastCommand(class SfContext& context);
+	UINT Register(ID3D11DeviceContext* context, void* object, EObjectKind kind, UINT stage);
+	UINT RegisterResource(ID3D11DeviceContext* context, ID3D11Resource* resource);
+
+	// called by SfContext::EndFrame, returns false once the last frame was captured
+	bool EndFrame();
+
+public:
+
+	UINT GetNumFramesCaptured() const { return Data->FramesCaptured; }
+	UINT GetNumCommands() const { return Data->Commands.GetNumCommands(); }
+	UINT GetNumObjects() const { return (UINT)Data->Objects.size(); }
+
+	// writes the trace, resource contents are read back on the immediate context and wait for the gpu
+	bool Save(const std::string& filePath) const;
+
+	SF_DEF_OPERATORS_AND_DEFAULT(SfFrameCapture)
+};
+
+// result of replaying a trace, cpu time spent per call type inside sf11 and d3d
+struct SfTraceReport
+{
+	struct CallTiming
+	{
+		const char* Name = nullptr;
+		UINT64 Count = 0;
+		double TotalUs = 0;
+	};
+
+	// only call types that occurred, slowest first
+	std::vector<CallTiming> Calls;
+
+	UINT Frames = 0;
+	double TotalUs = 0;
+
+	// what actually reached d3d after the state cache, see SfContext::GetStats
+	SfContextStats Stats;
+
+	std::string ToString() const;
+};
+
+// a trace loaded by SfInstance::LoadTrace with every object recreated on the instance device
+// the trace can be replayed any number of times, on hardware, software or null devices
+class SfTraceReplayer
+{
+	friend class SfInstance;
+
+	struct TraceReplayerData
+	{
+		class SfInstance* Instance = nullptr;
+		SfCommandBuffer Commands;
+
+		std::vector<ComPtr<IUnknown>> Objects;
+
+		// stand-ins for the sf11 resources updates and copies referred to
+		std::vector<std::shared_ptr<SfResource::ResourceData>> Resources;
+
+		UINT Frames = 0;
+
+		TraceReplayerData(class SfInstance* instance) : Instance(instance), Commands(*instance) {}
+	};
+
+	std::shared_ptr<TraceReplayerData> Data;
+
+	SfTraceReplayer(class SfInstance* instance);
+	bool Load(const std::string& filePath);
+
+public:
+
+	UINT GetNumFrames() const { return Data->Frames; }
+	UINT GetNumCommands() const { return Data->Commands.GetNumCommands(); }
+
+	// sends the whole trace through the context, timing every call
+	SfTraceReport Replay(class SfContext& context) const;
+
+	SF_DEF_OPERATORS_AND_DEFAULT(SfTraceReplayer)
+};
+
+}
@@ -1,17 +1,28 @@
 #include "gdi.h"
+#include <mutex>
 
 namespace sf11
 {
 
-void sf11::InitGDI()
+bool InitGDI()
 {
-	if (GdiInit) return;
-	Gdiplus::GdiplusStartupInput input;
-	input.GdiplusVersion = 1;
-	input.DebugEventCallback = nullptr;
-	input.SuppressBackgroundThread = false;
-	Gdiplus::GdiplusStartup(&GDIPlusToken, &input, nullptr);
-	GdiInit = true;
+#ifdef _WIN32
+	static std::once_flag once;
+	bool started = false;
+	std::call_once(once, [&]
+	{
+		static ULONG_PTR token;
+		Gdiplus::GdiplusStartupInput input;
+		input.GdiplusVersion = 1;
+		input.DebugEventCallback = nullptr;
+		input.SuppressBackgroundThread = false;
+		Gdiplus::GdiplusStartup(&token, &input, nullptr);
+		started = true;
+	});
+	return started;
+#else
+	return false;
+#endif
 }
 
 }
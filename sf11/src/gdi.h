@@ -1,14 +1,17 @@
 #pragma once
 
 #include "d3d11_include.h"
+#ifdef _WIN32
 #include <gdiplus.h>
 #pragma comment(lib, "gdiplus.lib")
+#endif
 
 namespace sf11
 {
 
-static bool GdiInit = false;
-static ULONG_PTR GDIPlusToken;
-void InitGDI();
+// starts gdi+ for the whole process the first time it is called, safe from any thread
+// called by the functions that load images, nothing else needs it
+// returns true only for the call that started it, always false without windows
+bool InitGDI();
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,129 @@
+#include "geometry_ring.h"
+#include "instance.h"
+#include "context.h"
+#include "sfassert.h"
+
+namespace sf11
+{
+
+static void CreateRingBuffer(ID3D11Device* device, UINT bindFlags, UINT size, ComPtr<ID3D11Buffer>& buffer)
+{
+	D3D11_BUFFER_DESC desc;
+	ZeroMemory(&desc, sizeof(D3D11_BUFFER_DESC));
+	desc.ByteWidth = size;
+	desc.Usage = D3D11_USAGE_DYNAMIC;
+	desc.BindFlags = bindFlags;
+	desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+	sfAssertHR(device->CreateBuffer(&desc, NULL, &buffer), "could not create geometry ring");
+}
+
+SfGeometryRing::SfGeometryRing(SfInstance* instance, UINT vertexBytes, UINT indexBytes)
+	: Data(std::make_shared<GeometryRingData>())
+{
+	Data->Instance = instance;
+
+	Data->Vertex.Size = vertexBytes;
+	CreateRingBuffer(instance->GetDevice(), D3D11_BIND_VERTEX_BUFFER, vertexBytes, Data->Vertex.Buffer);
+
+	if (indexBytes > 0)
+	{
+		Data->Index.Size = indexBytes;
+		CreateRingBuffer(instance->GetDevice(), D3D11_BIND_INDEX_BUFFER, indexBytes, Data->Index.Buffer);
+	}
+}
+
+void* SfGeometryRing::MapRange(ID3D11DeviceContext* context, RingBuffer& ring, UINT size, UINT alignment, UINT& offset)
+{
+	sfAssert(size <= ring.Size, "geometry allocation is larger than the ring");
+
+	offset = (ring.Head + alignment - 1) / alignment * alignment;
+
+	D3D11_MAP type = D3D11_MAP_WRITE_NO_OVERWRITE;
+	if (ring.DiscardNext || offset + size > ring.Size)
+	{
+		type = D3D11_MAP_WRITE_DISCARD;
+		offset = 0;
+		ring.DiscardNext = false;
+		Data->Stats.DiscardMaps++;
+	}
+	else
+	{
+		Data->Stats.NoOverwriteMaps++;
+	}
+
+	D3D11_MAPPED_SUBRESOURCE mapped;
+	sfAssertHR(context->Map(ring.Buffer.Get(), 0, type, 0, &mapped), "could not map geometry ring");
+
+	ring.Mapped = (BYTE*)mapped.pData;
+	ring.MapOffset = offset;
+	ring.MapDiscard = type == D3D11_MAP_WRITE_DISCARD;
+	ring.Head = offset + size;
+	return ring.Mapped + offset;
+}
+
+SfTransientGeometry SfGeometryRing::Allocate(SfContext& context, UINT vertexStride, UINT numVertices, UINT numIndices /*= 0*/, UINT indexSize /*= 2*/)
+{
+	SF_CHECK(vertexStride > 0 && numVertices > 0, "cannot allocate empty transient geometry");
+	SF_CHECK(indexSize == 2 || indexSize == 4, "index size must be 2 or 4 bytes");
+	SF_VALIDATE(numIndices == 0 || Data->Index.Buffer, "geometry ring was created without an index buffer");
+
+	ID3D11DeviceContext* d3dContext = context.Data->Context.Get();
+	// a wrap while earlier writes are still mapped would leave them in the discarded memory
+	SF_VALIDATE(!Data->MappedContext, "geometry ring must be unmapped before the next allocation");
+	Data->MappedContext = d3dContext;
+
+	SfTransientGeometry geometry;
+	geometry.VertexBuffer = Data->Vertex.Buffer.Get();
+	geometry.VertexStride = vertexStride;
+	geometry.NumVertices = numVertices;
+
+	// vertices are placed on a multiple of their stride so the offset is a whole base vertex
+	UINT offset;
+	geometry.Vertices = MapRange(d3dContext, Data->Vertex, vertexStride * numVertices, vertexStride, offset);
+	geometry.BaseVertex = (int)(offset / vertexStride);
+	context.Data->Stats.Maps++;
+
+	if (numIndices > 0)
+	{
+		geometry.IndexBuffer = Data->Index.Buffer.Get();
+		geometry.IndexFormat = indexSize == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+		geometry.NumIndices = numIndices;
+		geometry.Indices = MapRange(d3dContext, Data->Index, indexSize * numIndices, indexSize, offset);
+		geometry.StartIndex = offset / indexSize;
+		context.Data->Stats.Maps++;
+	}
+
+	Data->Stats.Allocations++;
+	return geometry;
+}
+
+void SfGeometryRing::Unmap(SfContext& context)
+{
+	ID3D11DeviceContext* d3dContext = context.Data->Context.Get();
+	SF_VALIDATE(Data->MappedContext == d3dContext, "geometry ring must be unmapped on the context that mapped it");
+
+	for (RingBuffer* ring : { &Data->Vertex, &Data->Index })
+	{
+		if (ring->Mapped)
+		{
+			context.CaptureCall([&](SfCommandBuffer& capture)
+			{
+				capture.RecordWriteBuffer(ring->Buffer.Get(), ring->MapOffset, ring->Mapped + ring->MapOffset, ring->Head - ring->MapOffset, ring->MapDiscard);
+			});
+			d3dContext->Unmap(ring->Buffer.Get(), 0);
+			context.Data->Stats.Unmaps++;
+			ring->Mapped = nullptr;
+		}
+	}
+	Data->MappedContext = nullptr;
+}
+
+void SfGeometryRing::Reset()
+{
+	SF_VALIDATE(!Data->MappedContext, "cannot reset a mapped geometry ring");
+	Data->Vertex.DiscardNext = true;
+	Data->Index.DiscardNext = true;
+}
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "d3d11_include.h"
+
+namespace sf11
+{
+
+// space handed out by SfGeometryRing::Allocate
+// bind with SfContext::BindTransientGeometry then draw with
+// DrawIndexed(NumIndices, StartIndex, BaseVertex) or Draw(NumVertices, BaseVertex)
+struct SfTransientGeometry
+{
+	// write pointers, only valid until SfGeometryRing::Unmap
+	void* Vertices = nullptr;
+	void* Indices = nullptr;
+
+	ID3D11Buffer* VertexBuffer = nullptr;
+	ID3D11Buffer* IndexBuffer = nullptr;
+	UINT VertexStride = 0;
+	DXGI_FORMAT IndexFormat = DXGI_FORMAT_R16_UINT;
+
+	int BaseVertex = 0;
+	UINT StartIndex = 0;
+	UINT NumVertices = 0;
+	UINT NumIndices = 0;
+
+	operator bool() const { return VertexBuffer != nullptr; }
+};
+
+struct SfGeometryRingStats
+{
+	UINT64 Allocations = 0;
+	UINT64 NoOverwriteMaps = 0;
+	UINT64 DiscardMaps = 0;
+};
+
+// large dynamic vertex and index buffers for geometry that is rebuilt every frame (ui, particles, debug lines)
+// allocations are appended with MAP_WRITE_NO_OVERWRITE, only running off the end maps with MAP_WRITE_DISCARD
+// discard gives the ring fresh memory while draws already issued keep reading the old contents
+// a ring may only be used from one context at a time
+// on deferred contexts call Reset after FinishCommandList, a command list has to start with a discard map
+class SfGeometryRing
+{
+	friend class SfInstance;
+	friend class SfContext;
+
+	struct RingBuffer
+	{
+		ComPtr<ID3D11Buffer> Buffer;
+		UINT Size = 0;
+		UINT Head = 0;
+		bool DiscardNext = true;
+		BYTE* Mapped = nullptr;
+
+		// range written by the current map, recorded by frame captures at unmap
+		UINT MapOffset = 0;
+		bool MapDiscard = false;
+	};
+
+	struct GeometryRingData
+	{
+		class SfInstance* Instance = nullptr;
+		RingBuffer Vertex;
+		RingBuffer Index;
+		ID3D11DeviceContext* MappedContext = nullptr;
+		SfGeometryRingStats Stats;
+	};
+
+	std::shared_ptr<GeometryRingData> Data;
+
+	SfGeometryRing(class SfInstance* instance, UINT vertexBytes, UINT indexBytes);
+
+	void* MapRange(ID3D11DeviceContext* context, RingBuffer& ring, UINT size, UINT alignment, UINT& offset);
+
+public:
+
+	// reserves room for the vertices and optional indices and maps it for writing
+	// indexSize is 2 or 4 bytes, the ring stays mapped until Unmap which must come before the next Allocate
+	SfTransientGeometry Allocate(class SfContext& context, UINT vertexStride, UINT numVertices, UINT numIndices = 0, UINT indexSize = 2);
+
+	// must be called after writing and before drawing, no-overwrite maps are cheap enough to do per batch
+	void Unmap(class SfContext& context);
+
+	// forces the next allocation to discard, needed at the start of each deferred command list
+	void Reset();
+
+	const SfGeometryRingStats& GetStats() const { return Data->Stats; }
+
+	SF_DEF_OPERATORS_AND_DEFAULT(SfGeometryRing)
+};
+
+}
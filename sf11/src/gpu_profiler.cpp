@@ -0,0 +1,236 @@
+#include "gpu_profiler.h"
+#include "instance.h"
+#include "context.h"
+#include "sfassert.h"
+#include <fstream>
+#include <algorithm>
+
+namespace sf11
+{
+
+SfGpuProfiler::SfGpuProfiler(SfInstance* instance)
+	: Data(std::make_shared<GpuProfilerData>())
+{
+	Data->Instance = instance;
+
+	D3D11_QUERY_DESC desc = {};
+	desc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+	for (FrameQueries& frame : Data->Frames)
+		sfAssertHR(instance->GetDevice()->CreateQuery(&desc, &frame.Disjoint), "could not create disjoint query");
+}
+
+UINT SfGpuProfiler::AddTimestamp(ID3D11DeviceContext* context)
+{
+	FrameQueries& frame = Data->Frames[Data->CurrentFrame];
+
+	// the query pool of a frame only grows, steady state frames create nothing
+	if (frame.NumTimestamps == frame.Timestamps.size())
+	{
+		D3D11_QUERY_DESC desc = {};
+		desc.Query = D3D11_QUERY_TIMESTAMP;
+		frame.Timestamps.emplace_back();
+		sfAssertHR(Data->Instance->GetDevice()->CreateQuery(&desc, &frame.Timestamps.back()), "could not create timestamp query");
+	}
+
+	context->End(frame.Timestamps[frame.NumTimestamps].Get());
+	return frame.NumTimestamps++;
+}
+
+void SfGpuProfiler::BeginMarker(ID3D11DeviceContext* context, const char* name)
+{
+	if (!Data->Recording) return;
+
+	FrameQueries& frame = Data->Frames[Data->CurrentFrame];
+	Data->OpenMarkers.push_back((UINT)frame.Markers.size());
+	frame.Markers.push_back({ name, (UINT)Data->OpenMarkers.size() - 1, AddTimestamp(context), 0 });
+}
+
+void SfGpuProfiler::EndMarker(ID3D11DeviceContext* context)
+{
+	if (!Data->Recording) return;
+	sfAssert(!Data->OpenMarkers.empty(), "gpu marker ended without being started");
+
+	FrameQueries& frame = Data->Frames[Data->CurrentFrame];
+	frame.Markers[Data->OpenMarkers.back()].EndQuery = AddTimestamp(context);
+	Data->OpenMarkers.pop_back();
+}
+
+void SfGpuProfiler::BeginFrame(SfContext& context)
+{
+	sfAssert(context == Data->Instance->GetImmediateContext(), "gpu profiler frames must run on the immediate context");
+	sfAssert(!Data->Recording, "gpu profiler frame started twice");
+
+	ID3D11DeviceContext* d3dContext = context.Data->Context.Get();
+	FrameQueries& frame = Data->Frames[Data->CurrentFrame];
+
+	// the queries for this slot are still in flight, skip the frame rather than wait for them
+	if (frame.Pending && !Resolve(d3dContext, frame))
+	{
+		Data->SkippedFrames++;
+		Data->FrameCounter++;
+		return;
+	}
+
+	frame.NumTimestamps = 0;
+	frame.Markers.clear();
+	frame.FrameIndex = Data->FrameCounter++;
+	Data->OpenMarkers.clear();
+	Data->Recording = true;
+
+	d3dContext->Begin(frame.Disjoint.Get());
+	AddTimestamp(d3dContext);
+}
+
+void SfGpuProfiler::EndFrame(SfContext& context)
+{
+	ID3D11DeviceContext* d3dContext = context.Data->Context.Get();
+
+	if (Data->Recording)
+	{
+		sfAssert(Data->OpenMarkers.empty(), "gpu markers are still open at the end of the frame");
+
+		FrameQueries& frame = Data->Frames[Data->CurrentFrame];
+		frame.FrameEndQuery = AddTimestamp(d3dContext);
+		d3dContext->End(frame.Disjoint.Get());
+		frame.Pending = true;
+
+		Data->CurrentFrame = (Data->CurrentFrame + 1) % SF_GPU_PROFILER_FRAMES;
+		Data->Recording = false;
+	}
+
+	// oldest first, stop at the first frame the gpu has not finished
+	for (UINT i = 0; i < SF_GPU_PROFILER_FRAMES; i++)
+	{
+		FrameQueries& frame = Data->Frames[(Data->CurrentFrame + i) % SF_GPU_PROFILER_FRAMES];
+		if (frame.Pending && !Resolve(d3dContext, frame))
+			break;
+	}
+}
+
+bool SfGpuProfiler::Resolve(ID3D11DeviceContext* context, FrameQueries& frame)
+{
+	D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+	if (context->GetData(frame.Disjoint.Get(), &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+		return false;
+
+	std::vector<UINT64>& ticks = Data->Ticks;
+	ticks.resize(frame.NumTimestamps);
+	for (UINT i = 0; i < frame.NumTimestamps; i++)
+	{
+		if (context->GetData(frame.Timestamps[i].Get(), &ticks[i], sizeof(UINT64), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+			return false;
+	}
+
+	frame.Pending = false;
+
+	// the gpu clock changed during the frame, its timestamps mean nothing
+	if (disjoint.Disjoint)
+		return true;
+
+	if (!Data->HasBaseTick)
+	{
+		Data->BaseTick = ticks[0];
+		Data->HasBaseTick = true;
+	}
+
+	const double toUs = 1000000.0 / (double)disjoint.Frequency;
+	auto ticksToUs = [&](UINT64 tick) { return ((double)tick - (double)Data->BaseTick) * toUs; };
+
+	SfGpuFrameResult& result = Data->LastResult;
+	result.FrameIndex = frame.FrameIndex;
+	result.StartUs = ticksToUs(ticks[0]);
+	result.DurationUs = ticksToUs(ticks[frame.FrameEndQuery]) - result.StartUs;
+	// LastResult is reused every frame, resize only allocates when a frame has more markers than any before it
+	result.Markers.resize(frame.Markers.size());
+	for (size_t i = 0; i < frame.Markers.size(); i++)
+	{
+		const Marker& marker = frame.Markers[i];
+		SfGpuMarkerResult& out = result.Markers[i];
+		out.Name = marker.Name;
+		out.Depth = marker.Depth;
+		out.StartUs = ticksToUs(ticks[marker.BeginQuery]);
+		out.DurationUs = ticksToUs(ticks[marker.EndQuery]) - out.StartUs;
+	}
+
+	if (Data->MaxHistory > 0)
+	{
+		std::vector<SfGpuFrameResult>& history = Data->History;
+		if (history.size() >= Data->MaxHistory)
+		{
+			// the oldest entry moves to the back and is overwritten, keeping the memory of its markers
+			history.resize(Data->MaxHistory);
+			std::rotate(history.begin(), history.begin() + 1, history.end());
+			history.back() = result;
+		}
+		else
+		{
+			history.push_back(result);
+		}
+	}
+
+	return true;
+}
+
+static void AppendJsonString(std::string& out, const char* text)
+{
+	out += '"';
+	for (const char* c = text ? text : ""; *c; c++)
+	{
+		if (*c == '"' || *c == '\\') out += '\\';
+		if ((unsigned char)*c < 0x20) continue;
+		out += *c;
+	}
+	out += '"';
+}
+
+static void AppendTraceEvent(std::string& out, const char* name, double startUs, double durationUs, bool& first)
+{
+	if (!first) out += ",\n";
+	first = false;
+
+	out += "{\"name\":";
+	AppendJsonString(out, name);
+	out += ",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":";
+	out += std::to_string(startUs);
+	out += ",\"dur\":";
+	out += std::to_string(durationUs);
+	out += "}";
+}
+
+std::string SfGpuProfiler::ExportChromeTrace() const
+{
+	std::string out = "{\"traceEvents\":[\n";
+	bool first = true;
+
+	for (const SfGpuFrameResult& frame : Data->History)
+	{
+		std::string frameName = "frame " + std::to_string(frame.FrameIndex);
+		AppendTraceEvent(out, frameName.c_str(), frame.StartUs, frame.DurationUs, first);
+		for (const SfGpuMarkerResult& marker : frame.Markers)
+			AppendTraceEvent(out, marker.Name, marker.StartUs, marker.DurationUs, first);
+	}
+
+	out += "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return out;
+}
+
+bool SfGpuProfiler::WriteChromeTrace(const std::string& filePath) const
+{
+	std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+	if (!file) return false;
+	file << ExportChromeTrace();
+	return (bool)file;
+}
+
+SfGpuScope::SfGpuScope(SfContext& context, const char* name)
+	: Context(&context)
+{
+	Context->BeginGpuMarker(name);
+}
+
+SfGpuScope::~SfGpuScope()
+{
+	Context->EndGpuMarker();
+}
+
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "d3d11_include.h"
+#include <vector>
+#include <string>
+
+// SF_GPU_SCOPE markers only exist when this is 1, defaults to debug builds only
+#ifndef SF_GPU_PROFILING
+	#ifdef NDEBUG
+		#define SF_GPU_PROFILING 0
+	#else
+		#define SF_GPU_PROFILING 1
+	#endif
+#endif
+
+namespace sf11
+{
+
+// number of frames the profiler can have in flight before it starts skipping frames
+constexpr UINT SF_GPU_PROFILER_FRAMES = 4;
+
+struct SfGpuMarkerResult
+{
+	const char* Name = nullptr;
+	UINT Depth = 0;
+
+	// microseconds since the first frame the profiler resolved
+	double StartUs = 0;
+	double DurationUs = 0;
+};
+
+struct SfGpuFrameResult
+{
+	UINT64 FrameIndex = 0;
+	double StartUs = 0;
+	double DurationUs = 0;
+	std::vector<SfGpuMarkerResult> Markers;
+};
+
+// measures gpu time of nested marker scopes with timestamp queries
+// each frame gets its own set of queries, results are read back SF_GPU_PROFILER_FRAMES - 1 frames later without waiting
+// if the gpu falls further behind than that, frames are skipped instead of stalling
+// attach to a context with SfContext::SetGpuProfiler, then wrap each frame in BeginFrame and EndFrame
+// marker names are stored as pointers and must outlive the profiler, string literals are expected
+class SfGpuProfiler
+{
+	friend class SfInstance;
+	friend class SfContext;
+
+	struct Marker
+	{
+		const char* Name;
+		UINT Depth;
+		UINT BeginQuery;
+		UINT EndQuery;
+	};
+
+	struct FrameQueries
+	{
+		ComPtr<ID3D11Query> Disjoint;
+		std::vector<ComPtr<ID3D11Query>> Timestamps;
+		std::vector<Marker> Markers;
+		UINT NumTimestamps = 0;
+		UINT FrameEndQuery = 0;
+		UINT64 FrameIndex = 0;
+		bool Pending = false;
+	};
+
+	struct GpuProfilerData
+	{
+		class SfInstance* Instance = nullptr;
+		FrameQueries Frames[SF_GPU_PROFILER_FRAMES];
+		UINT CurrentFrame = 0;
+		UINT64 FrameCounter = 0;
+
+		// false while the current frame was skipped because its queries were still in flight
+		bool Recording = false;
+		std::vector<UINT> OpenMarkers;
+
+		UINT64 BaseTick = 0;
+		bool HasBaseTick = false;
+
+		// kept between frames so resolving reuses their memory instead of allocating
+		std::vector<UINT64> Ticks;
+
+		SfGpuFrameResult LastResult;
+		std::vector<SfGpuFrameResult> History;
+		UINT MaxHistory = 0;
+		UINT64 SkippedFrames = 0;
+	};
+
+	std::shared_ptr<GpuProfilerData> Data;
+
+	SfGpuProfiler(class SfInstance* instance);
+
+	UINT AddTimestamp(ID3D11DeviceContext* context);
+	void BeginMarker(ID3D11DeviceContext* context, const char* name);
+	void EndMarker(ID3D11DeviceContext* context);
+	bool Resolve(ID3D11DeviceContext* context, FrameQueries& frame);
+
+public:
+
+	// call on the immediate context around everything that should be measured in a frame
+	// EndFrame also collects every frame whose queries have finished
+	void BeginFrame(class SfContext& context);
+	void EndFrame(class SfContext& context);
+
+	// the most recent frame that finished on the gpu
+	const SfGpuFrameResult& GetLastResult() const { return Data->LastResult; }
+
+	// number of resolved frames kept for trace export, 0 keeps none
+	void SetHistorySize(UINT frames) { Data->MaxHistory = frames; }
+	const std::vector<SfGpuFrameResult>& GetHistory() const { return Data->History; }
+	void ClearHistory() { Data->History.clear(); }
+
+	UINT64 GetSkippedFrames() const { return Data->SkippedFrames; }
+
+	// writes the kept history as chrome trace event json, viewable in chrome://tracing or perfetto
+	std::string ExportChromeTrace() const;
+	bool WriteChromeTrace(const std::string& filePath) const;
+
+	SF_DEF_OPERATORS_AND_DEFAULT(SfGpuProfiler)
+};
+
+// begins a marker on construction and ends it on destruction, use through SF_GPU_SCOPE
+class SfGpuScope
+{
+	class SfContext* Context;
+public:
+	SfGpuScope(class SfContext& context, const char* name);
+	~SfGpuScope();
+	SfGpuScope(const SfGpuScope&) = delete;
+	SfGpuScope& operator=(const SfGpuScope&) = delete;
+};
+
+}
+
+#define SF_GPU_CONCAT_INNER(a, b) a##b
+#define SF_GPU_CONCAT(a, b) SF_GPU_CONCAT_INNER(a, b)
+
+#if SF_GPU_PROFILING
+	#define SF_GPU_SCOPE(context, name) ::sf11::SfGpuScope SF_GPU_CONCAT(sfGpuScope, __LINE__)(context, name)
+#else
+	#define SF_GPU_SCOPE(context, name)
+#endif
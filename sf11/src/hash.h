@@ -0,0 +1,21 @@
+#pragma once
+
+#include "d3d11_include.h"
+
+namespace sf11
+{
+
+// 64 bit fnv-1a, used to key state objects by their contents
+// structs passed in here must be zeroed before filling so padding bytes hash the same
+inline UINT64 SfHashBytes(const void* data, size_t size, UINT64 hash = 0xcbf29ce484222325ull)
+{
+	const BYTE* bytes = (const BYTE*)data;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+}
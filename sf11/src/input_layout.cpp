@@ -2,16 +2,26 @@
 #include "shader.h"
 #include "instance.h"
 #include "sfassert.h"
+#include "frame_arena.h"
 
 namespace sf11
 {
 
+const GUID SF_GUID_SHADER_BYTECODE = { 0x6c1d5a2e, 0x93b4, 0x4f0e, { 0x8a, 0x61, 0x2d, 0x47, 0xe0, 0x15, 0xb9, 0x3c } };
+const GUID SF_GUID_INPUT_ELEMENTS = { 0x0f8e2b71, 0x4c9d, 0x4a36, { 0xb5, 0x02, 0x7e, 0x1a, 0xc3, 0x58, 0x64, 0xd9 } };
+
 void SfInputLayout::LinkWithVertexShader(const SfShader_Vertex& shader) const
 {
+	// scratch vectors come from the frame arena and are released on return
+	SfArenaScope scratch;
+
 	// replace mat4x4 with floats
 	// also make sure instance data is not followed by vertex data
 	bool foundInstance = false;
-	std::vector<SfInputElement> elements;
+	SfArenaVector<const SfInputElement*> elements;
+	SfArenaVector<UINT> semanticIndices;
+	elements.reserve(Elements.size() * 4);
+	semanticIndices.reserve(Elements.size() * 4);
 	for (const SfInputElement& element : Elements)
 	{
 		if (element.SlotType == EInputSlotType::PerVertex && foundInstance)
@@ -22,41 +32,42 @@ void SfInputLayout::LinkWithVertexShader(const SfShader_Vertex& shader) const
 
 		if (element.Format.Type != SfFormat::Mat4x4)
 		{
-			elements.push_back(element);
+			elements.push_back(&element);
+			semanticIndices.push_back(element.SemanticIndex);
 			continue;
 		}
 
-		for (int i = 0; i < 4; i++)
+		// expanded rows point back at the matrix element, the format is replaced below
+		for (UINT i = 0; i < 4; i++)
 		{
-			SfInputElement e;
-			e.SemanticName = element.SemanticName;
-			e.SemanticIndex = i;
-			e.Format.Type = SfFormat::Float;
-			e.Format.Channels = 4;
-			e.SlotType = element.SlotType;
-			elements.push_back(e);
+			elements.push_back(&element);
+			semanticIndices.push_back(i);
 		}
 	}
 
-	std::vector<D3D11_INPUT_ELEMENT_DESC> inputlayout;
+	const SfFormat matrixRow = { SfFormat::Float, 4 };
+
+	SfArenaVector<D3D11_INPUT_ELEMENT_DESC> inputlayout;
+	inputlayout.reserve(elements.size());
 
 	UINT instanceSize = 0;
 
 	for (int i = 0; i < elements.size(); i++)
 	{
-		const SfInputElement& element = elements[i];
+		const SfInputElement& element = *elements[i];
+		const SfFormat& format = element.Format.Type == SfFormat::Mat4x4 ? matrixRow : element.Format;
 		const bool perInstance = element.SlotType == EInputSlotType::PerInstance;
 
 		D3D11_INPUT_ELEMENT_DESC e;
 		e.SemanticName = element.SemanticName.c_str();
-		e.SemanticIndex = element.SemanticIndex;
+		e.SemanticIndex = semanticIndices[i];
 		e.InputSlot = perInstance ? 1 : 0;
 		e.AlignedByteOffset = perInstance ? instanceSize : D3D11_APPEND_ALIGNED_ELEMENT;
 
-		e.Format = element.Format.GetFormat();
+		e.Format = format.GetFormat();
 
 		if (perInstance)
-			instanceSize += element.Format.GetTypeSize() * element.Format.Channels;
+			instanceSize += format.GetTypeSize() * format.Channels;
 
 		e.InputSlotClass = perInstance ?
 			D3D11_INPUT_PER_INSTANCE_DATA :
@@ -74,6 +85,25 @@ void SfInputLayout::LinkWithVertexShader(const SfShader_Vertex& shader) const
 		shader.GetCodeSize(),
 		&(shader.Data->InputLayout)
 	);
+
+	if (!shader.Data->InputLayout) return;
+
+	SfArenaVector<SfStoredInputElement> stored(inputlayout.size());
+	for (size_t i = 0; i < inputlayout.size(); i++)
+	{
+		const D3D11_INPUT_ELEMENT_DESC& e = inputlayout[i];
+		const size_t nameLength = strlen(e.SemanticName);
+		sfAssert(nameLength < sizeof(stored[i].SemanticName), "input element semantic name is too long");
+		memcpy(stored[i].SemanticName, e.SemanticName, nameLength + 1);
+		stored[i].SemanticIndex = e.SemanticIndex;
+		stored[i].Format = e.Format;
+		stored[i].InputSlot = e.InputSlot;
+		stored[i].AlignedByteOffset = e.AlignedByteOffset;
+		stored[i].InputSlotClass = e.InputSlotClass;
+		stored[i].InstanceDataStepRate = e.InstanceDataStepRate;
+	}
+	shader.Data->InputLayout->SetPrivateData(SF_GUID_INPUT_ELEMENTS, UINT(sizeof(SfStoredInputElement) * stored.size()), stored.data());
+	if (shader.Data->Blob) shader.Data->InputLayout->SetPrivateDataInterface(SF_GUID_SHADER_BYTECODE, shader.Data->Blob.Get());
 }
 
 void SfInputLayout::AddElement(const SfInputElement& element)
@@ -9,6 +9,23 @@
 namespace sf11
 {
 
+// private data guids for d3d objects created by sf11, frame captures use them to recreate the objects
+// shaders and input layouts hold their bytecode blob, input layouts also hold their SfStoredInputElement array
+extern const GUID SF_GUID_SHADER_BYTECODE;
+extern const GUID SF_GUID_INPUT_ELEMENTS;
+
+// an input element as passed to d3d, with the semantic name stored inline
+struct SfStoredInputElement
+{
+	char SemanticName[32];
+	UINT SemanticIndex;
+	DXGI_FORMAT Format;
+	UINT InputSlot;
+	UINT AlignedByteOffset;
+	D3D11_INPUT_CLASSIFICATION InputSlotClass;
+	UINT InstanceDataStepRate;
+};
+
 enum class EInputSlotType
 {
 	PerVertex,
@@ -1,20 +1,33 @@
 #include "instance.h"
 #include "adapter.h"
 #include "sfassert.h"
+#ifdef _WIN32
 #include <d3dcompiler.h>
 #include "comdef.h"
+#endif
 #include "shader_program.h"
 #include "depth_buffer.h"
 #include "context.h"
 #include "surface.h"
 #include "gdi.h"
+#include <chrono>
 
 namespace sf11
 {
 
-SfInstance::SfInstance(const InstanceCreationParams& params /*= InstanceCreationParams()*/)
-	: CreationParams(params)
+namespace
+{
+
+typedef std::chrono::high_resolution_clock StartupClock;
+
+double MsSince(StartupClock::time_point start)
 {
+	return std::chrono::duration<double, std::milli>(StartupClock::now() - start).count();
+}
+
+void RegisterRawMouse()
+{
+#ifdef _WIN32
 	static bool rawMouseRegistered = false;
 	if (!rawMouseRegistered)
 	{
@@ -28,17 +41,44 @@ SfInstance::SfInstance(const InstanceCreationParams& params /*= InstanceCreation
 			rawMouseRegistered = true;
 		}
 	}
+#endif
+}
+
+}
+
+SfInstance::SfInstance(const InstanceCreationParams& params /*= InstanceCreationParams()*/)
+	: CreationParams(params)
+{
+	const StartupClock::time_point start = StartupClock::now();
+	StartupClock::time_point phaseStart = start;
 
-	InitGDI();
 	CreateDevice();
-	Window = CreateNewWindow(params.Window);
-	CreateRasterizerStates();
-	
-	InitDepthStates();
-	ImmediateContext->SetDepthBufferState(EDepthState::ReadWrite);
-	ImmediateContext->SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-	ImmediateContext->SetViewport((float)params.Window.Width, (float)params.Window.Height);
-	ImmediateContext->SetCullAndFillMode(ECullMode::CullBack, EFillMode::Solid);
+	AddStartupPhase("device", MsSince(phaseStart));
+
+	if (params.CreateMainWindow && params.DeviceType != EDeviceType::Null)
+	{
+		phaseStart = StartupClock::now();
+		Window = CreateNewWindow(params.Window);
+		AddStartupPhase("window", MsSince(phaseStart));
+	}
+
+	if (params.SetDefaultState)
+	{
+		// the state objects record their own phases
+		InitFixedRasterizers();
+		InitDepthStates();
+
+		phaseStart = StartupClock::now();
+		ImmediateContext->SetDepthBufferState(EDepthState::ReadWrite);
+		ImmediateContext->SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		ImmediateContext->SetViewport((float)params.Window.Width, (float)params.Window.Height);
+		ImmediateContext->SetCullAndFillMode(ECullMode::CullBack, EFillMode::Solid);
+		AddStartupPhase("default state", MsSince(phaseStart));
+	}
+
+	std::lock_guard<std::mutex> lock(StartupMutex);
+	StartupProfile.TotalMs = MsSince(start);
+	Constructed = true;
 }
 
 SfInstance::~SfInstance()
@@ -71,12 +111,52 @@ SfShaderProgram SfInstance::CreateShaderProgram(const ShaderProgramCreateParams&
 	return program;
 }
 
+SfAsync<SfShaderProgram> SfInstance::CreateShaderProgramAsync(const ShaderProgramCreateParams& params, SfResumeQueue* resumeOn /*= nullptr*/)
+{
+	return CreateAsync<SfShaderProgram>([this, params] { return CreateShaderProgram(params); }, resumeOn);
+}
+
+SfPipelineState SfInstance::CreatePipelineState(const PipelineStateCreateParams& params)
+{
+	return SfPipelineState(this, params);
+}
+
+SfConstantRing SfInstance::CreateConstantRing(UINT size)
+{
+	return SfConstantRing(this, size);
+}
+
+SfGeometryRing SfInstance::CreateGeometryRing(UINT vertexBytes, UINT indexBytes)
+{
+	return SfGeometryRing(this, vertexBytes, indexBytes);
+}
+
+SfGpuProfiler SfInstance::CreateGpuProfiler()
+{
+	return SfGpuProfiler(this);
+}
+
+SfFrameCapture SfInstance::CreateFrameCapture()
+{
+	return SfFrameCapture(this);
+}
+
+SfTraceReplayer SfInstance::LoadTrace(const std::string& filePath)
+{
+	SfTraceReplayer replayer(this);
+	if (!replayer.Load(filePath)) return SF_NULL;
+	return replayer;
+}
+
 SfContext_Deferred SfInstance::CreateDeferredContext()
 {
 	SfContext_Deferred context;
 	context.Data = std::make_shared<SfContext::ContextData>();
 	context.Data->Instance = this;
 	Device->CreateDeferredContext(0, &context.Data->Context);
+	context.Data->Context.As(&context.Data->Context1);
+	context.Data->EmulatedCommandList = !Threading.DriverCommandLists;
+	context.Data->Deferred = true;
 	return context;
 }
 
@@ -161,16 +241,29 @@ SfSamplerState SfInstance::CreateSampler_BilinearMirror()
 SfSamplerState SfInstance::CreateSampler(const D3D11_SAMPLER_DESC& desc)
 {
 	SfSamplerState sampler;
-	sampler.Data = std::make_shared<SfSamplerState::SamplerStateData>();
-	sampler.Data->Instance = this;
-	sampler.Data->Desc = desc;
-	Device->CreateSamplerState(&desc, sampler.Data->State.GetAddressOf());
+	sampler.Data = SamplerCache.FindOrCreate(desc, [&]
+	{
+		auto* data = new SfSamplerState::SamplerStateData();
+		data->Instance = this;
+		data->Desc = desc;
+		Device->CreateSamplerState(&desc, data->State.GetAddressOf());
+		return data;
+	});
 	return sampler;
 }
 
 SfDepthStencilState SfInstance::CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC& desc)
 {
-	return SfDepthStencilState(this, desc);
+	const D3D11_DEPTH_STENCIL_DESC key = SfDepthStencilState::CanonicalDesc(desc);
+
+	SfDepthStencilState state;
+	state.Data = DepthStencilCache.FindOrCreate(key, [&]
+	{
+		auto* data = new SfDepthStencilState::DepthStencilStateData(this, key);
+		Device->CreateDepthStencilState(&data->Desc, data->State.GetAddressOf());
+		return data;
+	});
+	return state;
 }
 
 SfDepthBuffer SfInstance::CreateDepthBuffer(const TextureParams2D& params, bool enableStencil /*= false*/)
@@ -180,12 +273,24 @@ SfDepthBuffer SfInstance::CreateDepthBuffer(const TextureParams2D& params, bool
 
 SfBlendState SfInstance::CreateBlendState(const SfBlendData& data)
 {
-	return SfBlendState(this, data);
+	return FindOrCreateBlendState(SfBlendState::MakeDesc(data));
 }
 
 SfBlendState SfInstance::CreateBlendState(SfBlendData* data, UINT count)
 {
-	return SfBlendState(this, data, count);
+	return FindOrCreateBlendState(SfBlendState::MakeDesc(data, count));
+}
+
+SfBlendState SfInstance::FindOrCreateBlendState(const D3D11_BLEND_DESC& desc)
+{
+	SfBlendState state;
+	state.Data = BlendCache.FindOrCreate(desc, [&]
+	{
+		auto* data = new SfBlendState::BlendStateData(this);
+		Device->CreateBlendState(&desc, data->State.GetAddressOf());
+		return data;
+	});
+	return state;
 }
 
 SfTexture2D SfInstance::CreateTexture2DFromSurface(std::unique_ptr<SfSurface2D> surface)
@@ -210,11 +315,31 @@ SfTexture2D SfInstance::LoadTexture2D(const std::string& path)
 
 SfTexture2D SfInstance::LoadTexture2D(const std::string& path, TextureParams2D& params)
 {
+	// gdi+ is shared by the process, it shows up in the profile of the instance that loads the first png
+	const StartupClock::time_point gdiStart = StartupClock::now();
+	if (InitGDI()) AddStartupPhase("gdi+", MsSince(gdiStart));
+
 	auto surface = std::make_unique<SfSurface2D>();
 	surface->LoadPNG(path);	
 	return CreateTexture2DFromSurface(std::move(surface), params);
 }
 
+SfAsync<SfTexture2D> SfInstance::LoadTexture2DAsync(const std::string& path, SfResumeQueue* resumeOn /*= nullptr*/)
+{
+	return CreateAsync<SfTexture2D>([this, path] { return LoadTexture2D(path); }, resumeOn);
+}
+
+std::vector<SfTexture2D> SfInstance::LoadTextures2D(const std::vector<std::string>& paths)
+{
+	std::vector<SfTexture2D> textures(paths.size());
+	GetJobSystem().ParallelFor((UINT)paths.size(), [&](UINT begin, UINT end)
+	{
+		for (UINT i = begin; i < end; i++)
+			textures[i] = LoadTexture2D(paths[i]);
+	}, 1);
+	return textures;
+}
+
 SfTexture1D SfInstance::CreateTexture1D(const TextureParams1D& params, void* data /*= nullptr*/)
 {
 	return SfTexture1D(this, params, data);
@@ -230,6 +355,11 @@ SfTexture3D SfInstance::CreateTexture3D(const TextureParams3D& params, void* dat
 	return SfTexture3D(this, params, data);
 }
 
+SfAsync<SfTexture2D> SfInstance::CreateTexture2DAsync(const TextureParams2D& params, void* data /*= nullptr*/, SfResumeQueue* resumeOn /*= nullptr*/)
+{
+	return CreateAsync<SfTexture2D>([this, params, data] { return CreateTexture2D(params, data); }, resumeOn);
+}
+
 SfBuffer_Vertex SfInstance::CreateVertexBuffer(UINT vertexSize, UINT vertexCount, SfUsage usage/* = SfUsage::Static*/, void* vertices /*= nullptr*/)
 {
 	return SfBuffer_Vertex(this, vertexSize, vertexCount, usage, vertices);
@@ -240,6 +370,16 @@ SfBuffer_Index SfInstance::CreateIndexBuffer(UINT indexSize, UINT indexCount, Sf
 	return SfBuffer_Index(this, indexSize, indexCount, usage, indices);
 }
 
+SfAsync<SfBuffer_Vertex> SfInstance::CreateVertexBufferAsync(UINT vertexSize, UINT vertexCount, SfUsage usage /*= SfUsage::Static*/, void* vertices /*= nullptr*/, SfResumeQueue* resumeOn /*= nullptr*/)
+{
+	return CreateAsync<SfBuffer_Vertex>([=, this] { return CreateVertexBuffer(vertexSize, vertexCount, usage, vertices); }, resumeOn);
+}
+
+SfAsync<SfBuffer_Index> SfInstance::CreateIndexBufferAsync(UINT indexSize, UINT indexCount, SfUsage usage /*= SfUsage::Static*/, void* indices /*= nullptr*/, SfResumeQueue* resumeOn /*= nullptr*/)
+{
+	return CreateAsync<SfBuffer_Index>([=, this] { return CreateIndexBuffer(indexSize, indexCount, usage, indices); }, resumeOn);
+}
+
 SfBuffer_Structured SfInstance::CreateStructuredBuffer(
 	UINT typeSize, 
 	UINT numElements,
@@ -304,119 +444,212 @@ void SfInstance::CreateDevice()
 	ImmediateContext = std::make_unique<SfContext>();
 	ImmediateContext->Data = std::make_shared<SfContext::ContextData>();
 
-	HRESULT hr = D3D11CreateDevice(
-		CreationParams.Adapter ? CreationParams.Adapter->GetDXGI() : nullptr,
-		D3D_DRIVER_TYPE_HARDWARE,
-		NULL,
+	if (CreationParams.DeviceType == EDeviceType::Null)
+	{
+		sfAssertHR(CreateNullDevice(&Device, &ImmediateContext->Data->Context), "could not create null device");
+	}
+	else
+	{
+#ifndef _WIN32
+		sfAssert(false, "only null devices can be created without windows");
+		return;
+#else
+		const bool software = CreationParams.DeviceType == EDeviceType::Software;
+		HRESULT hr = D3D11CreateDevice(
+			CreationParams.Adapter && !software ? CreationParams.Adapter->GetDXGI() : nullptr,
+			software ? D3D_DRIVER_TYPE_WARP : D3D_DRIVER_TYPE_HARDWARE,
+			NULL,
 #if !NDEBUG
-		D3D11_CREATE_DEVICE_DEBUG | D3D11_CREATE_DEVICE_BGRA_SUPPORT,
+			D3D11_CREATE_DEVICE_DEBUG | D3D11_CREATE_DEVICE_BGRA_SUPPORT,
 #else
-		D3D11_CREATE_DEVICE_BGRA_SUPPORT,
+			D3D11_CREATE_DEVICE_BGRA_SUPPORT,
+#endif
+			NULL,
+			NULL,
+			D3D11_SDK_VERSION,
+			&Device,
+			NULL,
+			&ImmediateContext->Data->Context);
 #endif
-		NULL,
-		NULL,
-		D3D11_SDK_VERSION,
-		&Device,
-		NULL,
-		&ImmediateContext->Data->Context);
+	}
 
+	ImmediateContext->Data->Context.As(&ImmediateContext->Data->Context1);
 	ImmediateContext->Data->Instance = this;
+
+	// runtimes without 11.1 fail the options query, which leaves every option off
+	Device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &Options, sizeof(Options));
+	Device->CheckFeatureSupport(D3D11_FEATURE_THREADING, &Threading, sizeof(Threading));
 }
 
-SfContext SfInstance::GetImmediateContext() const
+SfNullDeviceStats SfInstance::GetNullDeviceStats() const
 {
-	return *ImmediateContext.get();
+	SfNullDeviceStats stats;
+	const bool isNull = sf11::GetNullDeviceStats(Device.Get(), stats);
+	sfAssert(isNull, "device stats are only counted by null devices");
+	return stats;
 }
 
-SfWindow SfInstance::CreateNewWindow(const WindowCreationParams& params)
+SfStartupProfile SfInstance::GetStartupProfile() const
 {
-	return SfWindow(params, this);
+	std::lock_guard<std::mutex> lock(StartupMutex);
+	return StartupProfile;
 }
 
-void SfInstance::CreateRasterizerStates()
+void SfInstance::AddStartupPhase(const char* name, double ms)
 {
-	D3D11_RASTERIZER_DESC rast;
+	std::lock_guard<std::mutex> lock(StartupMutex);
+	StartupProfile.Phases.push_back({ name, ms, Constructed });
+}
 
-	ZeroMemory(&rast, sizeof(D3D11_RASTERIZER_DESC));
-	//rast.DepthClipEnable = TRUE;
-	//rast.DepthBias = 100000;
-	rast.DepthBiasClamp = 0;
-	rast.SlopeScaledDepthBias = 1;
+std::string SfStartupProfile::ToString() const
+{
+	char line[128];
+	std::string out;
 
-	rast.FillMode = D3D11_FILL_SOLID;
-	rast.CullMode = D3D11_CULL_NONE;
-	RasterSolidCullNone.Data = std::shared_ptr<SfRasterizer::RasterizerData>(new SfRasterizer::RasterizerData());
-	GetDevice()->CreateRasterizerState(&rast, RasterSolidCullNone.GetPtrAddress());
+	snprintf(line, sizeof(line), "%-20s %10s\n", "phase", "ms");
+	out += line;
+	for (const Phase& phase : Phases)
+	{
+		snprintf(line, sizeof(line), "%-20s %10.3f%s\n", phase.Name, phase.Ms, phase.OnFirstUse ? "  (first use)" : "");
+		out += line;
+	}
+	snprintf(line, sizeof(line), "%-20s %10.3f\n", "constructor", TotalMs);
+	out += line;
+	return out;
+}
 
-	rast.FillMode = D3D11_FILL_SOLID;
-	rast.CullMode = D3D11_CULL_BACK;
-	RasterSolidCullBack.Data = std::shared_ptr<SfRasterizer::RasterizerData>(new SfRasterizer::RasterizerData());
-	GetDevice()->CreateRasterizerState(&rast, RasterSolidCullBack.GetPtrAddress());
+SfJobSystem& SfInstance::GetJobSystem()
+{
+	std::call_once(JobSystemOnce, [this]
+	{
+		const StartupClock::time_point start = StartupClock::now();
+		JobSystem = std::make_unique<SfJobSystem>(CreationParams.NumWorkerThreads);
+		AddStartupPhase("job system", MsSince(start));
+	});
+	return *JobSystem;
+}
 
-	rast.FillMode = D3D11_FILL_SOLID;
-	rast.CullMode = D3D11_CULL_FRONT;
-	RasterSolidCullFront.Data = std::shared_ptr<SfRasterizer::RasterizerData>(new SfRasterizer::RasterizerData());
-	GetDevice()->CreateRasterizerState(&rast, RasterSolidCullFront.GetPtrAddress());
+SfContext& SfInstance::GetImmediateContext() const
+{
+	return *ImmediateContext;
+}
 
-	rast.FillMode = D3D11_FILL_WIREFRAME;
-	rast.CullMode = D3D11_CULL_NONE;
-	RasterWireCullNone.Data = std::shared_ptr<SfRasterizer::RasterizerData>(new SfRasterizer::RasterizerData());
-	GetDevice()->CreateRasterizerState(&rast, RasterWireCullNone.GetPtrAddress());
+SfWindow SfInstance::CreateNewWindow(const WindowCreationParams& params)
+{
+	sfAssert(CreationParams.DeviceType != EDeviceType::Null, "null devices cannot present to a window");
+	if (CreationParams.RegisterRawMouse) RegisterRawMouse();
+	return SfWindow(params, this);
+}
 
-	rast.FillMode = D3D11_FILL_WIREFRAME;
-	rast.CullMode = D3D11_CULL_BACK;
-	RasterWireCullBack.Data = std::shared_ptr<SfRasterizer::RasterizerData>(new SfRasterizer::RasterizerData());
-	GetDevice()->CreateRasterizerState(&rast, RasterWireCullBack.GetPtrAddress());
+void SfInstance::InitFixedRasterizers()
+{
+	std::call_once(FixedRasterizersOnce, [this]
+	{
+		const StartupClock::time_point start = StartupClock::now();
+		for (UINT fill = 0; fill < 2; fill++)
+		{
+			for (UINT cull = 0; cull < 3; cull++)
+			{
+				SfRasterizerDesc desc;
+				desc.FillMode = (EFillMode)fill;
+				desc.CullMode = (ECullMode)cull;
+				FixedRasterizers[fill][cull] = CreateRasterizer(desc);
+			}
+		}
+		AddStartupPhase("rasterizer states", MsSince(start));
+	});
+}
+
+SfRasterizer SfInstance::CreateRasterizer(const SfRasterizerDesc& desc)
+{
+	const D3D11_RASTERIZER_DESC key = SfRasterizer::MakeDesc(desc);
 
-	rast.FillMode = D3D11_FILL_WIREFRAME;
-	rast.CullMode = D3D11_CULL_FRONT;
-	RasterWireCullFront.Data = std::shared_ptr<SfRasterizer::RasterizerData>(new SfRasterizer::RasterizerData());
-	GetDevice()->CreateRasterizerState(&rast, RasterWireCullFront.GetPtrAddress());
+	SfRasterizer rasterizer;
+	rasterizer.Data = RasterizerCache.FindOrCreate(key, [&]
+	{
+		auto* data = new SfRasterizer::RasterizerData();
+		data->Desc = desc;
+		Device->CreateRasterizerState(&key, data->State.GetAddressOf());
+		return data;
+	});
+	return rasterizer;
+}
+
+SfRasterizer& SfInstance::GetRasterizer(ECullMode cull, EFillMode fill)
+{
+	InitFixedRasterizers();
+	return FixedRasterizers[(UINT)fill][(UINT)cull];
+}
+
+ID3D11DepthStencilState* SfInstance::GetDepthState(EDepthState state)
+{
+	InitDepthStates();
+	switch (state)
+	{
+		case EDepthState::ReadOnly: return DepthReadOnly.Get();
+		case EDepthState::WriteOnly: return DepthWriteOnly.Get();
+		case EDepthState::Disabled: return DepthDisabled.Get();
+		default: return DepthReadWrite.Get();
+	}
 }
 
 void SfInstance::InitDepthStates()
 {
-	D3D11_DEPTH_STENCIL_DESC desc = {};
+	std::call_once(DepthStatesOnce, [this]
+	{
+		const StartupClock::time_point start = StartupClock::now();
+
+		D3D11_DEPTH_STENCIL_DESC desc = {};
 
-	desc.DepthEnable = FALSE;
-	desc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
-	desc.DepthFunc = D3D11_COMPARISON_NEVER;
-	Device->CreateDepthStencilState(&desc, DepthDisabled.GetAddressOf());
+		desc.DepthEnable = FALSE;
+		desc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
+		desc.DepthFunc = D3D11_COMPARISON_NEVER;
+		Device->CreateDepthStencilState(&desc, DepthDisabled.GetAddressOf());
 
-	desc.DepthEnable = TRUE;
-	desc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
-	desc.DepthFunc = D3D11_COMPARISON_LESS_EQUAL;
-	Device->CreateDepthStencilState(&desc, DepthReadOnly.GetAddressOf());
+		desc.DepthEnable = TRUE;
+		desc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
+		desc.DepthFunc = D3D11_COMPARISON_LESS_EQUAL;
+		Device->CreateDepthStencilState(&desc, DepthReadOnly.GetAddressOf());
 
-	desc.DepthEnable = TRUE;
-	desc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
-	desc.DepthFunc = D3D11_COMPARISON_LESS_EQUAL;
-	Device->CreateDepthStencilState(&desc, DepthReadWrite.GetAddressOf());
+		desc.DepthEnable = TRUE;
+		desc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
+		desc.DepthFunc = D3D11_COMPARISON_LESS_EQUAL;
+		Device->CreateDepthStencilState(&desc, DepthReadWrite.GetAddressOf());
 
-	desc.DepthEnable = FALSE;
-	desc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
-	desc.DepthFunc = D3D11_COMPARISON_LESS_EQUAL;
-	Device->CreateDepthStencilState(&desc, DepthWriteOnly.GetAddressOf());
+		desc.DepthEnable = FALSE;
+		desc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
+		desc.DepthFunc = D3D11_COMPARISON_LESS_EQUAL;
+		Device->CreateDepthStencilState(&desc, DepthWriteOnly.GetAddressOf());
+
+		AddStartupPhase("depth states", MsSince(start));
+	});
 }
 
 void SfInstance::PumpWindowEvents(const SfWindow& window /*= SF_NULL*/)
 {
 	const SfWindow& win = window ? window : Window;
+	if (!win) return;
+
 	sfAssert(win.Data->Instance == this, "cannot pump events on window that does not belong to this instance");
 
+#ifdef _WIN32
 	MSG msg;
 	while (PeekMessage(&msg, win.GetHandle(), 0, 0, PM_REMOVE))
 	{
 		TranslateMessage(&msg);
 		DispatchMessage(&msg);
 	}
+#endif
 }
 
 void SfInstance::PumpWindowEvents_Blocking(const SfWindow& window /*= SF_NULL*/)
 {
 	const SfWindow& win = window ? window : Window;
+	if (!win) return;
+
 	sfAssert(win.Data->Instance == this, "cannot pump events on window that does not belong to this instance");
 
+#ifdef _WIN32
 	MSG msg;
 	// use GetMessage if an input thread is used
 	while (GetMessage(&msg, win.GetHandle(), 0, 0))
@@ -424,6 +657,7 @@ void SfInstance::PumpWindowEvents_Blocking(const SfWindow& window /*= SF_NULL*/)
 		TranslateMessage(&msg);
 		DispatchMessage(&msg);
 	}
+#endif
 }
 
 // definitions for shader compilation functions
@@ -9,15 +9,40 @@
 #include <vector>
 #include <string>
 #include <unordered_set>
+#include <mutex>
 #include "sampler.h"
 #include "blend_state.h"
 #include "buffer.h"
 #include "surface.h"
 #include "depth_buffer.h"
+#include "pipeline_state.h"
+#include "state_object_cache.h"
+#include "constant_ring.h"
+#include "geometry_ring.h"
+#include "readback.h"
+#include "gpu_profiler.h"
+#include "frame_capture.h"
+#include "null_device.h"
+#include "job_system.h"
+#include "async.h"
 
 namespace sf11
 {
 
+enum class EDeviceType
+{
+	// the adapter in InstanceCreationParams, or the system default
+	Hardware,
+
+	// the WARP software rasterizer, for machines without a gpu
+	Software,
+
+	// nothing is rendered, see CreateNullDevice
+	// runs headless, the instance has no window and no back buffer
+	// the only type available when sf11 is built without windows
+	Null
+};
+
 struct InstanceCreationParams
 {
 	InstanceCreationParams() = default;
@@ -26,29 +51,91 @@ struct InstanceCreationParams
 
 	// the graphics device to use, leave nullptr for system default
 	class SfAdapter* Adapter = nullptr;
+
+	// Adapter is only used for hardware devices
+	EDeviceType DeviceType = EDeviceType::Hardware;
+
+	// creates the instance's own window from Window, ignored for null devices
+	// turn off for compute only tools, windows can still be created later with CreateNewWindow
+	bool CreateMainWindow = true;
+
+	// registers the mouse for raw input when the first window is created
+	bool RegisterRawMouse = true;
+
+	// sets depth read/write, back face culling, a triangle list and a viewport the size of Window on the immediate context
+	// without it the context starts in the d3d11 default state
+	bool SetDefaultState = true;
+
+	// workers in the job system, created on the first GetJobSystem call
+	// 0 uses one per hardware thread minus one for the calling thread
+	UINT NumWorkerThreads = 0;
+};
+
+// wall time of each step of SfInstance creation, see SfInstance::GetStartupProfile
+// state objects, the job system and gdi+ are created on first use, those steps are added when they happen
+// gdi+ is started once per process, so only the instance that loads the first png lists it
+struct SfStartupProfile
+{
+	struct Phase
+	{
+		const char* Name = "";
+		double Ms = 0;
+
+		// ran after the constructor returned, not part of TotalMs
+		bool OnFirstUse = false;
+	};
+
+	std::vector<Phase> Phases;
+
+	// time spent in the constructor
+	double TotalMs = 0;
+
+	std::string ToString() const;
 };
 
 class SfInstance
 {
 	friend class SfContext;
+	friend class SfPipelineState;
+	friend class SfCommandBuffer;
 
 	ComPtr<ID3D11Device> Device;
 	std::unique_ptr<class SfContext> ImmediateContext;
+
+	// driver capabilities, queried once when the device is created
+	D3D11_FEATURE_DATA_D3D11_OPTIONS Options = {};
+	D3D11_FEATURE_DATA_THREADING Threading = {};
 	InstanceCreationParams CreationParams;
 	SfWindow Window;
 	
-	SfRasterizer* CurrentRasterizer = nullptr;
-	SfRasterizer RasterSolidCullNone;
-	SfRasterizer RasterSolidCullFront;
-	SfRasterizer RasterSolidCullBack;
-	SfRasterizer RasterWireCullNone;
-	SfRasterizer RasterWireCullFront;
-	SfRasterizer RasterWireCullBack;
+	// the cull and fill combinations used by SfContext::SetCullAndFillMode, indexed [fill][cull]
+	// these are ordinary cache entries, held here so they never expire
+	// created together the first time one of them is used
+	SfRasterizer FixedRasterizers[2][3];
+	std::once_flag FixedRasterizersOnce;
 
 	ComPtr<ID3D11DepthStencilState> DepthReadWrite;
 	ComPtr<ID3D11DepthStencilState> DepthReadOnly;
 	ComPtr<ID3D11DepthStencilState> DepthWriteOnly;
 	ComPtr<ID3D11DepthStencilState> DepthDisabled;
+	std::once_flag DepthStatesOnce;
+
+	mutable std::mutex StartupMutex;
+	SfStartupProfile StartupProfile;
+	bool Constructed = false;
+
+	// identical descriptions share one d3d object
+	SfStateObjectCache<D3D11_SAMPLER_DESC, SfSamplerState::SamplerStateData> SamplerCache;
+	SfStateObjectCache<D3D11_BLEND_DESC, SfBlendState::BlendStateData> BlendCache;
+	SfStateObjectCache<D3D11_DEPTH_STENCIL_DESC, SfDepthStencilState::DepthStencilStateData> DepthStencilCache;
+	SfStateObjectCache<D3D11_RASTERIZER_DESC, SfRasterizer::RasterizerData> RasterizerCache;
+
+	// staging copies and fences reused by readbacks
+	SfStagingPool StagingPool;
+
+	// declared last so the workers stop before anything their tasks could touch is destroyed
+	std::unique_ptr<SfJobSystem> JobSystem;
+	std::once_flag JobSystemOnce;
 
 public:
 
@@ -59,12 +146,43 @@ public:
 	// this really isnt needed for api usage, only needed internally
 	ID3D11Device* GetDevice() { return Device.Get(); }
 
+	// driver capabilities queried when the device was created
+	const D3D11_FEATURE_DATA_D3D11_OPTIONS& GetOptions() const { return Options; }
+	const D3D11_FEATURE_DATA_THREADING& GetThreadingSupport() const { return Threading; }
+
+	// true when some context cannot update part of a static constant buffer, then those buffers keep a cpu copy to update whole
+	bool NeedsWholeConstantUpdates() const { return !Options.ConstantBufferPartialUpdate || !Threading.DriverCommandLists; }
+
 	// returns the immediate context associated with this instance's device
 	// render commands are issued from this object
-	class SfContext GetImmediateContext() const;
+	class SfContext& GetImmediateContext() const;
+
+	// the task scheduler sf11 uses for its own parallel work, see SfJobSystem
+	// applications should run their tasks here too instead of starting another pool
+	SfJobSystem& GetJobSystem();
+
+	// calls create on the job system and returns a handle to what it returns, the ...Async functions are built on this
+	// create runs on a worker thread, so it may only use the device and sf11 functions that create objects
+	// resumeOn is the queue of the thread that continues a coroutine awaiting the result, nullptr continues on the worker
+	template <typename T, typename CreateFunc>
+	SfAsync<T> CreateAsync(CreateFunc create, SfResumeQueue* resumeOn = nullptr)
+	{
+		SfAsync<T> async;
+		async.Data = std::make_shared<typename SfAsync<T>::AsyncData>();
+		async.Data->Jobs = &GetJobSystem();
+		async.Data->ResumeOn = resumeOn;
+
+		std::shared_ptr<typename SfAsync<T>::AsyncData> data = async.Data;
+		data->Jobs->Run(data->Group, [data, create]
+		{
+			data->Value = create();
+			data->Complete();
+		});
+		return async;
+	}
 
 	// creates a new window
-	// multiple windows can be used with any instance
+	// multiple windows can be used with any instance that does not use a null device
 	SfWindow CreateNewWindow(const WindowCreationParams& params);
 
 	// creates a render target that can be bound via SfContext::BindRenderTarget
@@ -81,6 +199,13 @@ public:
 	// use SfContext::BindShaderProgram to bind all of the shaders in one call
 	SfShaderProgram CreateShaderProgram(const ShaderProgramCreateParams& params);
 
+	// compiles the shaders and creates the input layout on the job system
+	SfAsync<SfShaderProgram> CreateShaderProgramAsync(const ShaderProgramCreateParams& params, SfResumeQueue* resumeOn = nullptr);
+
+	// bakes a shader program and its fixed function state into one object
+	// use SfContext::BindPipelineState to bind all of it in one call
+	SfPipelineState CreatePipelineState(const PipelineStateCreateParams& params);
+
 	// deferred contexts can be used to generate command lists to be executed later on
 	// usage looks identical the instance's immediate context, however there are no commands issued to the GPU
 	// call SfContext_Deferred::FinishCommandList to finalize render commands
@@ -105,6 +230,10 @@ public:
 	// creates a depth/stencil buffer with any desired parameters
 	SfDepthStencilState CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC& desc);
 
+	// creates a rasterizer state with any parameters
+	// the first call with a description creates the d3d object, later calls return the same one
+	SfRasterizer CreateRasterizer(const SfRasterizerDesc& desc);
+
 	// create a blend state from a single blend description
 	SfBlendState CreateBlendState(const SfBlendData& data);
 
@@ -113,9 +242,25 @@ public:
 	SfBlendState CreateBlendState(SfBlendData* data, UINT count);
 	SfBlendState CreateBlendState(std::vector<SfBlendData>& data)
 	{
-		CreateBlendState(data.data(), (UINT)data.size());
+		return CreateBlendState(data.data(), (UINT)data.size());
 	}
 
+	// state creation returns the existing object when the same description was created before
+	// these report how often that happened for each state type
+	SfObjectCacheStats GetSamplerCacheStats() const { return SamplerCache.GetStats(); }
+	SfObjectCacheStats GetBlendCacheStats() const { return BlendCache.GetStats(); }
+	SfObjectCacheStats GetDepthStencilCacheStats() const { return DepthStencilCache.GetStats(); }
+	SfObjectCacheStats GetRasterizerCacheStats() const { return RasterizerCache.GetStats(); }
+
+	// releases the staging resources and fences kept for readbacks that are not in flight
+	void TrimStagingPool() { StagingPool.Trim(); }
+
+	// where the time of creating this instance went, including the subsystems created later on first use
+	SfStartupProfile GetStartupProfile() const;
+
+	// calls the device has received, only available with EDeviceType::Null
+	SfNullDeviceStats GetNullDeviceStats() const;
+
 	// creates a texture2d with data from the specified surface
 	SfTexture2D CreateTexture2DFromSurface(std::unique_ptr<SfSurface2D> surface);
 	// width, height, and format values of params will be replaced
@@ -127,11 +272,21 @@ public:
 	// width, height, and format values of params will be replaced
 	SfTexture2D LoadTexture2D(const std::string& path, TextureParams2D& params);
 
+	// reads, decodes and uploads a png on the job system
+	SfAsync<SfTexture2D> LoadTexture2DAsync(const std::string& path, SfResumeQueue* resumeOn = nullptr);
+
+	// loads many png files at once, decoding and uploading them in parallel on the job system
+	// the textures are returned in the order of paths
+	std::vector<SfTexture2D> LoadTextures2D(const std::vector<std::string>& paths);
+
 	// creates a texture filled with the passed data
 	SfTexture1D CreateTexture1D(const TextureParams1D& params, void* data = nullptr);
 	SfTexture2D CreateTexture2D(const TextureParams2D& params, void* data = nullptr);
 	SfTexture3D CreateTexture3D(const TextureParams3D& params, void* data = nullptr);
 
+	// data must stay valid until the texture is ready
+	SfAsync<SfTexture2D> CreateTexture2DAsync(const TextureParams2D& params, void* data = nullptr, SfResumeQueue* resumeOn = nullptr);
+
 	SfBuffer_Vertex CreateVertexBuffer( 
 		UINT vertexSize, 
 		UINT vertexCount,
@@ -144,6 +299,14 @@ public:
 		return CreateVertexBuffer(sizeof(V), (UINT)vertices.size(), usage, vertices.data());
 	}
 
+	// vertices must stay valid until the buffer is ready
+	SfAsync<SfBuffer_Vertex> CreateVertexBufferAsync(
+		UINT vertexSize,
+		UINT vertexCount,
+		SfUsage usage = SfUsage::Static,
+		void* vertices = nullptr,
+		SfResumeQueue* resumeOn = nullptr);
+
 	SfBuffer_Index CreateIndexBuffer( 
 		UINT indexSize, 
 		UINT indexCount,
@@ -156,6 +319,14 @@ public:
 		return CreateIndexBuffer(sizeof(I), (UINT)indices.size(), usage, indices.data());
 	}
 
+	// indices must stay valid until the buffer is ready
+	SfAsync<SfBuffer_Index> CreateIndexBufferAsync(
+		UINT indexSize,
+		UINT indexCount,
+		SfUsage usage = SfUsage::Static,
+		void* indices = nullptr,
+		SfResumeQueue* resumeOn = nullptr);
+
 	SfBuffer_Structured CreateStructuredBuffer(
 		UINT typeSize,
 		UINT numElements,
@@ -178,6 +349,23 @@ public:
 		SfUsage usage = SfUsage::Static,
 		void* initialData = nullptr);
 
+	// creates a ring of dynamic constant memory for per draw constants, see SfConstantRing
+	SfConstantRing CreateConstantRing(UINT size);
+
+	// creates vertex and index rings for geometry rebuilt every frame, see SfGeometryRing
+	// indexBytes can be 0 for rings that only hold vertices
+	SfGeometryRing CreateGeometryRing(UINT vertexBytes, UINT indexBytes);
+
+	// creates a timestamp profiler, attach it to the immediate context with SfContext::SetGpuProfiler
+	SfGpuProfiler CreateGpuProfiler();
+
+	// creates an empty capture, start it on a context with SfContext::SetFrameCapture
+	SfFrameCapture CreateFrameCapture();
+
+	// loads a trace written by SfFrameCapture::Save and recreates its objects on this device
+	// returns SF_NULL if the file is missing, damaged or was written by a build with another pointer size
+	SfTraceReplayer LoadTrace(const std::string& filePath);
+
 	SfBuffer_Raw CreateRawBuffer(
 		SfFormat format, 
 		UINT numElements,
@@ -190,9 +378,16 @@ public:
 private:
 
 	void CreateDevice();
-	void CreateRasterizerStates();
+	void InitFixedRasterizers();
 	void InitDepthStates();
 
+	// phases added after the constructor returned are marked as first use
+	void AddStartupPhase(const char* name, double ms);
+
+	SfRasterizer& GetRasterizer(ECullMode cull, EFillMode fill);
+	SfBlendState FindOrCreateBlendState(const D3D11_BLEND_DESC& desc);
+	ID3D11DepthStencilState* GetDepthState(EDepthState state);
+
 public:
 	
 	void PumpWindowEvents(const SfWindow& window = SF_NULL);
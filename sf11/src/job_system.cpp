@@ -0,0 +1,198 @@
+#include "job_system.h"
+
+namespace sf11
+{
+
+namespace
+{
+
+// set on worker threads so tasks they start go to their own deque
+thread_local SfJobSystem* CurrentSystem = nullptr;
+thread_local UINT CurrentQueue = 0;
+
+}
+
+SfJobSystem::SfJobSystem(UINT numWorkers /*= 0*/)
+{
+	if (numWorkers == 0)
+	{
+		const UINT hardwareThreads = std::thread::hardware_concurrency();
+		numWorkers = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+
+	for (UINT i = 0; i <= numWorkers; i++)
+		Queues.push_back(std::make_unique<TaskQueue>());
+
+	Workers.reserve(numWorkers);
+	for (UINT i = 0; i < numWorkers; i++)
+		Workers.emplace_back(&SfJobSystem::WorkerLoop, this, i + 1);
+}
+
+SfJobSystem::~SfJobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(SleepMutex);
+		ShuttingDown = true;
+	}
+	WakeUp.notify_all();
+
+	for (std::thread& worker : Workers)
+		worker.join();
+}
+
+UINT SfJobSystem::GetThreadQueue() const
+{
+	return CurrentSystem == this ? CurrentQueue : 0;
+}
+
+void SfJobSystem::WorkerLoop(UINT queueIndex)
+{
+	CurrentSystem = this;
+	CurrentQueue = queueIndex;
+
+	while (true)
+	{
+		if (TryRunOne()) continue;
+
+		std::unique_lock<std::mutex> lock(SleepMutex);
+		NumSleeping++;
+		WakeUp.wait(lock, [&] { return ShuttingDown || NumQueued.load() > 0; });
+		NumSleeping--;
+		if (ShuttingDown && NumQueued.load() == 0) return;
+	}
+}
+
+void SfJobSystem::Push(Task task)
+{
+	// counted first so a worker never sees a task that is not counted yet
+	NumQueued++;
+
+	TaskQueue& queue = *Queues[GetThreadQueue()];
+	{
+		std::lock_guard<std::mutex> lock(queue.Mutex);
+		queue.Tasks.push_back(std::move(task));
+	}
+
+	// a worker that went to sleep has either seen the count above or is waiting on the lock taken here
+	if (NumSleeping.load() > 0)
+	{
+		std::lock_guard<std::mutex> lock(SleepMutex);
+		WakeUp.notify_one();
+	}
+}
+
+bool SfJobSystem::TryRunOne()
+{
+	const UINT own = GetThreadQueue();
+	const UINT numQueues = (UINT)Queues.size();
+
+	Task task;
+	bool found = false;
+
+	// workers take their newest task, which is most likely still in cache
+	if (own != 0)
+	{
+		TaskQueue& queue = *Queues[own];
+		std::lock_guard<std::mutex> lock(queue.Mutex);
+		if (!queue.Tasks.empty())
+		{
+			task = std::move(queue.Tasks.back());
+			queue.Tasks.pop_back();
+			found = true;
+		}
+	}
+
+	// then the shared queue and the other workers, oldest first
+	for (UINT i = 0; i < numQueues && !found; i++)
+	{
+		const UINT index = (own + 1 + i) % numQueues;
+		if (index == own && own != 0) continue;
+
+		TaskQueue& queue = *Queues[index];
+		std::lock_guard<std::mutex> lock(queue.Mutex);
+		if (!queue.Tasks.empty())
+		{
+			task = std::move(queue.Tasks.front());
+			queue.Tasks.pop_front();
+			found = true;
+		}
+	}
+
+	if (!found) return false;
+
+	NumQueued--;
+	task.Func();
+	Finish(task.Group);
+	return true;
+}
+
+void SfJobSystem::Finish(SfTaskGroup* group)
+{
+	std::vector<SfTaskGroup::Continuation> ready;
+	{
+		std::lock_guard<std::mutex> lock(group->ContinuationMutex);
+		if (group->Pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			ready.swap(group->Continuations);
+	}
+
+	// the group can be destroyed from here on, only its continuations are touched
+	for (SfTaskGroup::Continuation& continuation : ready)
+		Push({ std::move(continuation.Task), continuation.Group });
+}
+
+void SfJobSystem::Run(SfTaskGroup& group, std::function<void()> task)
+{
+	group.Pending.fetch_add(1, std::memory_order_relaxed);
+	Push({ std::move(task), &group });
+}
+
+void SfJobSystem::Run(SfTaskGroup& group, std::function<void()> task, SfTaskGroup& dependency)
+{
+	group.Pending.fetch_add(1, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lock(dependency.ContinuationMutex);
+		if (dependency.Pending.load(std::memory_order_acquire) > 0)
+		{
+			dependency.Continuations.push_back({ std::move(task), &group });
+			return;
+		}
+	}
+	Push({ std::move(task), &group });
+}
+
+void SfJobSystem::Wait(SfTaskGroup& group)
+{
+	while (!group.IsFinished())
+	{
+		if (!TryRunOne())
+			std::this_thread::yield();
+	}
+
+	// the task that finished the group may still be releasing the lock
+	std::lock_guard<std::mutex> lock(group.ContinuationMutex);
+}
+
+void SfJobSystem::ParallelFor(UINT count, const std::function<void(UINT begin, UINT end)>& func, UINT grainSize /*= 0*/)
+{
+	if (count == 0) return;
+
+	if (grainSize == 0)
+	{
+		grainSize = count / (GetNumThreads() * 4);
+		if (grainSize == 0) grainSize = 1;
+	}
+
+	SfTaskGroup group;
+
+	// the first range runs on the calling thread after the rest are queued
+	for (UINT begin = grainSize; begin < count; begin += grainSize)
+	{
+		const UINT end = count - begin > grainSize ? begin + grainSize : count;
+		Run(group, [&func, begin, end] { func(begin, end); });
+	}
+	func(0, grainSize < count ? grainSize : count);
+
+	Wait(group);
+}
+
+}
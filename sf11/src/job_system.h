@@ -0,0 +1,108 @@
+#pragma once
+
+#include "d3d11_include.h"
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+
+namespace sf11
+{
+
+// tracks a set of tasks started with SfJobSystem::Run
+// a group is finished when every task in it has returned, tasks can add more tasks to their own group
+// must outlive the tasks in it, so wait on it before it goes out of scope
+class SfTaskGroup
+{
+	friend class SfJobSystem;
+
+	struct Continuation
+	{
+		std::function<void()> Task;
+		SfTaskGroup* Group;
+	};
+
+	std::atomic<UINT> Pending = 0;
+
+	// tasks that were started with this group as their dependency, queued when Pending reaches 0
+	std::mutex ContinuationMutex;
+	std::vector<Continuation> Continuations;
+
+public:
+
+	SfTaskGroup() = default;
+	SfTaskGroup(const SfTaskGroup&) = delete;
+	SfTaskGroup& operator=(const SfTaskGroup&) = delete;
+
+	bool IsFinished() const { return Pending.load(std::memory_order_acquire) == 0; }
+};
+
+// work stealing task scheduler, owned by SfInstance and shared with the application, see SfInstance::GetJobSystem
+// every worker has its own deque, it runs its newest task first and steals the oldest task of another worker when empty
+// tasks started from threads outside the pool go to a shared queue that every worker takes from
+// a thread that waits on a group runs queued tasks until the group is finished instead of blocking
+// tasks must not block on anything but a group wait, or the pool can run out of threads
+class SfJobSystem
+{
+	struct Task
+	{
+		std::function<void()> Func;
+		SfTaskGroup* Group = nullptr;
+	};
+
+	struct TaskQueue
+	{
+		std::mutex Mutex;
+		std::deque<Task> Tasks;
+	};
+
+	// index 0 is the shared queue, workers own 1 to N
+	std::vector<std::unique_ptr<TaskQueue>> Queues;
+	std::vector<std::thread> Workers;
+
+	// tasks sitting in a queue, workers sleep while it is 0
+	std::atomic<UINT> NumQueued = 0;
+	std::atomic<UINT> NumSleeping = 0;
+	std::mutex SleepMutex;
+	std::condition_variable WakeUp;
+	bool ShuttingDown = false;
+
+	void WorkerLoop(UINT queueIndex);
+	void Push(Task task);
+	bool TryRunOne();
+	void Finish(SfTaskGroup* group);
+
+	// the queue owned by the calling thread, 0 for threads outside the pool
+	UINT GetThreadQueue() const;
+
+public:
+
+	// 0 uses one worker per hardware thread, minus one for the thread that creates the instance
+	SfJobSystem(UINT numWorkers = 0);
+	~SfJobSystem();
+
+	SfJobSystem(const SfJobSystem&) = delete;
+	SfJobSystem& operator=(const SfJobSystem&) = delete;
+
+	// workers plus the calling thread, which helps while it waits
+	UINT GetNumThreads() const { return (UINT)Workers.size() + 1; }
+
+	// queues a task as part of group
+	void Run(SfTaskGroup& group, std::function<void()> task);
+
+	// queues a task as part of group once every task in dependency has finished
+	void Run(SfTaskGroup& group, std::function<void()> task, SfTaskGroup& dependency);
+
+	// runs queued tasks on the calling thread until every task in group has finished
+	void Wait(SfTaskGroup& group);
+
+	// calls func on ranges [begin, end) that together cover [0, count) and returns when all of them are done
+	// grainSize is the smallest range handed out, 0 splits the work into a few ranges per thread
+	void ParallelFor(UINT count, const std::function<void(UINT begin, UINT end)>& func, UINT grainSize = 0);
+};
+
+}
@@ -0,0 +1,1300 @@
+#include "null_device.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+namespace sf11
+{
+
+namespace
+{
+
+// private interface ids, QueryInterface returns the internal object behind them without adding a reference
+const GUID SF_GUID_NULL_DEVICE = { 0x3b7c9e14, 0x52a8, 0x4d61, { 0x9f, 0x0e, 0x86, 0x2c, 0x4b, 0xd7, 0x13, 0xa5 } };
+const GUID SF_GUID_NULL_MEMORY = { 0xa41f6d08, 0x7e35, 0x4b92, { 0x8c, 0x57, 0x1d, 0xe9, 0x60, 0x2b, 0xf4, 0x7e } };
+const GUID SF_GUID_NULL_QUERY = { 0x5e02c3b9, 0xd816, 0x47fa, { 0xa3, 0x2d, 0x71, 0x0b, 0x9e, 0x64, 0xc8, 0x25 } };
+
+typedef std::chrono::high_resolution_clock NullClock;
+
+void AddStats(SfNullDeviceStats& to, const SfNullDeviceStats& from)
+{
+	UINT64* a = (UINT64*)&to;
+	const UINT64* b = (const UINT64*)&from;
+	for (size_t i = 0; i < sizeof(SfNullDeviceStats) / sizeof(UINT64); i++)
+		a[i] += b[i];
+}
+
+// bytes per texel, or per 4x4 block for block compressed formats
+// the packed 2x1 formats are given 4 bytes per texel, which only overestimates their size
+UINT GetElementBytes(DXGI_FORMAT format, UINT& blockSize)
+{
+	blockSize = 1;
+	if ((format >= DXGI_FORMAT_BC1_TYPELESS && format <= DXGI_FORMAT_BC5_SNORM) ||
+		(format >= DXGI_FORMAT_BC6H_TYPELESS && format <= DXGI_FORMAT_BC7_UNORM_SRGB))
+	{
+		blockSize = 4;
+		const bool bc1 = format <= DXGI_FORMAT_BC1_UNORM_SRGB;
+		const bool bc4 = format >= DXGI_FORMAT_BC4_TYPELESS && format <= DXGI_FORMAT_BC4_SNORM;
+		return bc1 || bc4 ? 8 : 16;
+	}
+
+	if (format == DXGI_FORMAT_UNKNOWN) return 0;
+	if (format <= DXGI_FORMAT_R32G32B32A32_SINT) return 16;
+	if (format <= DXGI_FORMAT_R32G32B32_SINT) return 12;
+	if (format <= DXGI_FORMAT_X32_TYPELESS_G8X24_UINT) return 8;
+	if (format <= DXGI_FORMAT_X24_TYPELESS_G8_UINT) return 4;
+	if (format <= DXGI_FORMAT_R16_SINT) return 2;
+	if (format <= DXGI_FORMAT_R1_UNORM) return 1;
+	if (format <= DXGI_FORMAT_G8R8_G8B8_UNORM) return 4;
+	if (format <= DXGI_FORMAT_B5G5R5A1_UNORM) return 2;
+	if (format == DXGI_FORMAT_B4G4R4A4_UNORM) return 2;
+	return 4;
+}
+
+UINT CountMips(UINT width, UINT height, UINT depth)
+{
+	UINT size = std::max(width, std::max(height, depth));
+	UINT mips = 1;
+	while (size > 1)
+	{
+		size >>= 1;
+		mips++;
+	}
+	return mips;
+}
+
+// counters and contexts shared by a device and everything it creates
+struct NullDeviceData
+{
+	std::atomic<UINT64> Calls = 0;
+	std::atomic<UINT64> ObjectsCreated = 0;
+	std::atomic<UINT64> ObjectsAlive = 0;
+	std::atomic<UINT64> BytesAllocated = 0;
+
+	// deferred contexts count into their own stats, these are added up when stats are read
+	std::mutex ContextMutex;
+	std::vector<const SfNullDeviceStats*> DeferredStats;
+	SfNullDeviceStats RetiredStats;
+
+	void Count() { Calls.fetch_add(1, std::memory_order_relaxed); }
+};
+
+// private data attached with SetPrivateData and SetPrivateDataInterface
+class PrivateDataStore
+{
+	struct Entry
+	{
+		GUID Guid;
+		std::vector<BYTE> Data;
+		ComPtr<IUnknown> Interface;
+	};
+
+	std::vector<Entry> Entries;
+
+	Entry* Find(REFGUID guid)
+	{
+		for (Entry& entry : Entries)
+			if (entry.Guid == guid) return &entry;
+		return nullptr;
+	}
+
+	void Remove(REFGUID guid)
+	{
+		Entries.erase(std::remove_if(Entries.begin(), Entries.end(),
+			[&](const Entry& entry) { return entry.Guid == guid; }), Entries.end());
+	}
+
+public:
+
+	HRESULT Get(REFGUID guid, UINT* size, void* data)
+	{
+		if (!size) return E_INVALIDARG;
+
+		Entry* entry = Find(guid);
+		if (!entry)
+		{
+			*size = 0;
+			return DXGI_ERROR_NOT_FOUND;
+		}
+
+		const UINT stored = entry->Interface ? (UINT)sizeof(IUnknown*) : (UINT)entry->Data.size();
+		if (!data)
+		{
+			*size = stored;
+			return S_OK;
+		}
+		if (*size < stored)
+		{
+			*size = stored;
+			return DXGI_ERROR_MORE_DATA;
+		}
+
+		*size = stored;
+		if (entry->Interface)
+		{
+			IUnknown* object = entry->Interface.Get();
+			object->AddRef();
+			memcpy(data, &object, sizeof(object));
+		}
+		else if (stored > 0)
+		{
+			memcpy(data, entry->Data.data(), stored);
+		}
+		return S_OK;
+	}
+
+	HRESULT Set(REFGUID guid, UINT size, const void* data)
+	{
+		Remove(guid);
+		if (!data) return S_OK;
+
+		Entry entry;
+		entry.Guid = guid;
+		entry.Data.assign((const BYTE*)data, (const BYTE*)data + size);
+		Entries.push_back(std::move(entry));
+		return S_OK;
+	}
+
+	HRESULT SetInterface(REFGUID guid, const IUnknown* object)
+	{
+		Remove(guid);
+		if (!object) return S_OK;
+
+		Entry entry;
+		entry.Guid = guid;
+		entry.Interface = const_cast<IUnknown*>(object);
+		Entries.push_back(std::move(entry));
+		return S_OK;
+	}
+};
+
+// reference counting, private data and the owning device, shared by every object the device creates
+// Bases are the interfaces between I and ID3D11DeviceChild, QueryInterface answers for all of them
+template <typename I, typename... Bases>
+class NullChild : public I
+{
+	std::atomic<ULONG> References = 1;
+	PrivateDataStore PrivateData;
+
+	// the immediate context belongs to the device and does not keep it alive
+	bool HoldsDevice;
+
+protected:
+
+	ID3D11Device* Device;
+	NullDeviceData* DeviceData;
+
+	// answers the private interface ids
+	virtual void* GetInternal(REFIID) { return nullptr; }
+
+public:
+
+	NullChild(ID3D11Device* device, NullDeviceData* deviceData, bool holdsDevice = true)
+		: HoldsDevice(holdsDevice), Device(device), DeviceData(deviceData)
+	{
+		if (HoldsDevice) Device->AddRef();
+		DeviceData->ObjectsCreated++;
+		DeviceData->ObjectsAlive++;
+	}
+
+	virtual ~NullChild()
+	{
+		DeviceData->ObjectsAlive--;
+		if (HoldsDevice) Device->Release();
+	}
+
+	HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) override
+	{
+		if (!object) return E_POINTER;
+
+		if (riid == __uuidof(IUnknown) || riid == __uuidof(ID3D11DeviceChild) || riid == __uuidof(I) ||
+			((riid == __uuidof(Bases)) || ...))
+		{
+			*object = static_cast<I*>(this);
+			AddRef();
+			return S_OK;
+		}
+
+		*object = GetInternal(riid);
+		return *object ? S_OK : E_NOINTERFACE;
+	}
+
+	ULONG STDMETHODCALLTYPE AddRef() override
+	{
+		return ++References;
+	}
+
+	ULONG STDMETHODCALLTYPE Release() override
+	{
+		const ULONG references = --References;
+		if (references == 0) delete this;
+		return references;
+	}
+
+	void STDMETHODCALLTYPE GetDevice(ID3D11Device** device) override
+	{
+		Device->AddRef();
+		*device = Device;
+	}
+
+	HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID guid, UINT* size, void* data) override
+	{
+		return PrivateData.Get(guid, size, data);
+	}
+
+	HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID guid, UINT size, const void* data) override
+	{
+		return PrivateData.Set(guid, size, data);
+	}
+
+	HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID guid, const IUnknown* object) override
+	{
+		return PrivateData.SetInterface(guid, object);
+	}
+};
+
+struct NullSubresource
+{
+	size_t Offset = 0;
+	UINT Width = 1, Height = 1, Depth = 1;
+	UINT RowPitch = 0;
+	UINT DepthPitch = 0;
+};
+
+// system memory behind a buffer or texture, every subresource in one allocation
+// buffers are one subresource one byte high, so the same copy code serves both
+struct NullMemory
+{
+	D3D11_RESOURCE_DIMENSION Dimension = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+	DXGI_FORMAT Format = DXGI_FORMAT_UNKNOWN;
+	UINT MipLevels = 1;
+	UINT ElementBytes = 1;
+	UINT BlockSize = 1;
+
+	std::vector<BYTE> Bytes;
+	std::vector<NullSubresource> Subresources;
+
+	void InitBuffer(UINT byteWidth)
+	{
+		Dimension = D3D11_RESOURCE_DIMENSION_BUFFER;
+
+		NullSubresource sub;
+		sub.Width = byteWidth;
+		sub.RowPitch = byteWidth;
+		sub.DepthPitch = byteWidth;
+		Subresources.push_back(sub);
+		Bytes.resize(byteWidth);
+	}
+
+	// subresources are ordered by mip inside each array slice, which is how d3d numbers them
+	void InitTexture(D3D11_RESOURCE_DIMENSION dimension, UINT width, UINT height, UINT depth,
+		UINT mips, UINT arraySize, UINT samples, DXGI_FORMAT format)
+	{
+		Dimension = dimension;
+		Format = format;
+		MipLevels = mips;
+		ElementBytes = std::max(GetElementBytes(format, BlockSize), 1u);
+
+		size_t offset = 0;
+		for (UINT slice = 0; slice < arraySize; slice++)
+		{
+			for (UINT mip = 0; mip < mips; mip++)
+			{
+				NullSubresource sub;
+				sub.Offset = offset;
+				sub.Width = std::max(width >> mip, 1u);
+				sub.Height = std::max(height >> mip, 1u);
+				sub.Depth = std::max(depth >> mip, 1u);
+				sub.RowPitch = (sub.Width + BlockSize - 1) / BlockSize * ElementBytes * samples;
+				sub.DepthPitch = sub.RowPitch * ((sub.Height + BlockSize - 1) / BlockSize);
+				offset += (size_t)sub.DepthPitch * sub.Depth;
+				Subresources.push_back(sub);
+			}
+		}
+		Bytes.resize(offset);
+	}
+
+	void InitData(const D3D11_SUBRESOURCE_DATA* data)
+	{
+		if (!data) return;
+		for (UINT i = 0; i < (UINT)Subresources.size(); i++)
+		{
+			const NullSubresource& sub = Subresources[i];
+			UINT x, y, z, rowBytes, rows, depth;
+			GetExtent(i, nullptr, x, y, z, rowBytes, rows, depth);
+			Write(i, 0, 0, 0, (const BYTE*)data[i].pSysMem,
+				data[i].SysMemPitch ? data[i].SysMemPitch : sub.RowPitch,
+				data[i].SysMemSlicePitch ? data[i].SysMemSlicePitch : sub.DepthPitch,
+				rowBytes, rows, depth);
+		}
+	}
+
+	bool IsValid(UINT subresource) const { return subresource < Subresources.size(); }
+
+	BYTE* GetAddress(UINT subresource, UINT x, UINT y, UINT z)
+	{
+		const NullSubresource& sub = Subresources[subresource];
+		return Bytes.data() + sub.Offset + (size_t)z * sub.DepthPitch +
+			(size_t)(y / BlockSize) * sub.RowPitch + (size_t)(x / BlockSize) * ElementBytes;
+	}
+
+	// converts a box of texels to its corner and its size in bytes per row, rows and slices, clamped to the subresource
+	void GetExtent(UINT subresource, const D3D11_BOX* box, UINT& x, UINT& y, UINT& z, UINT& rowBytes, UINT& rows, UINT& depth) const
+	{
+		const NullSubresource& sub = Subresources[subresource];
+		D3D11_BOX b = box ? *box : D3D11_BOX{ 0, 0, 0, sub.Width, sub.Height, sub.Depth };
+		b.right = std::min(b.right, sub.Width);
+		b.bottom = std::min(b.bottom, sub.Height);
+		b.back = std::min(b.back, sub.Depth);
+
+		x = b.left;
+		y = b.top;
+		z = b.front;
+		rowBytes = b.right > b.left ? (b.right - b.left + BlockSize - 1) / BlockSize * ElementBytes : 0;
+		rows = b.bottom > b.top ? (b.bottom - b.top + BlockSize - 1) / BlockSize : 0;
+		depth = b.back > b.front ? b.back - b.front : 0;
+	}
+
+	// writes rows read with the given pitches at a texel position, clamped to the subresource
+	void Write(UINT subresource, UINT x, UINT y, UINT z, const BYTE* src, UINT srcRowPitch, UINT srcDepthPitch,
+		UINT rowBytes, UINT rows, UINT depth)
+	{
+		const NullSubresource& sub = Subresources[subresource];
+		if (!src || x >= sub.Width || y >= sub.Height || z >= sub.Depth) return;
+
+		const UINT blockX = x / BlockSize;
+		const UINT blockY = y / BlockSize;
+		rowBytes = std::min(rowBytes, sub.RowPitch - blockX * ElementBytes);
+		rows = std::min(rows, (sub.Height + BlockSize - 1) / BlockSize - blockY);
+		depth = std::min(depth, sub.Depth - z);
+
+		BYTE* dst = GetAddress(subresource, x, y, z);
+		for (UINT slice = 0; slice < depth; slice++)
+		{
+			for (UINT row = 0; row < rows; row++)
+			{
+				memcpy(dst + (size_t)slice * sub.DepthPitch + (size_t)row * sub.RowPitch,
+					src + (size_t)slice * srcDepthPitch + (size_t)row * srcRowPitch, rowBytes);
+			}
+		}
+	}
+
+	void Copy(UINT dstSubresource, UINT x, UINT y, UINT z, NullMemory& src, UINT srcSubresource, const D3D11_BOX* box)
+	{
+		if (!IsValid(dstSubresource) || !src.IsValid(srcSubresource)) return;
+
+		UINT sx, sy, sz, rowBytes, rows, depth;
+		src.GetExtent(srcSubresource, box, sx, sy, sz, rowBytes, rows, depth);
+		if (rowBytes == 0 || rows == 0 || depth == 0) return;
+
+		const NullSubresource& from = src.Subresources[srcSubresource];
+
+		// same memory is copied through a temporary, d3d leaves overlapping copies undefined
+		if (&src == this)
+		{
+			std::vector<BYTE> temp(Bytes.begin() + from.Offset, Bytes.begin() + from.Offset + (size_t)from.DepthPitch * from.Depth);
+			const size_t start = src.GetAddress(srcSubresource, sx, sy, sz) - (Bytes.data() + from.Offset);
+			Write(dstSubresource, x, y, z, temp.data() + start, from.RowPitch, from.DepthPitch, rowBytes, rows, depth);
+			return;
+		}
+
+		Write(dstSubresource, x, y, z, src.GetAddress(srcSubresource, sx, sy, sz), from.RowPitch, from.DepthPitch, rowBytes, rows, depth);
+	}
+};
+
+NullMemory* GetMemory(ID3D11Resource* resource)
+{
+	NullMemory* memory = nullptr;
+	if (resource) resource->QueryInterface(SF_GUID_NULL_MEMORY, (void**)&memory);
+	return memory;
+}
+
+template <typename I, typename Desc>
+class NullResource : public NullChild<I, ID3D11Resource>
+{
+	UINT EvictionPriority = 0;
+
+protected:
+
+	void* GetInternal(REFIID riid) override
+	{
+		return riid == SF_GUID_NULL_MEMORY ? &Memory : nullptr;
+	}
+
+public:
+
+	Desc ResourceDesc;
+	NullMemory Memory;
+
+	NullResource(ID3D11Device* device, NullDeviceData* deviceData, const Desc& desc)
+		: NullChild<I, ID3D11Resource>(device, deviceData), ResourceDesc(desc)
+	{}
+
+	~NullResource()
+	{
+		this->DeviceData->BytesAllocated -= Memory.Bytes.size();
+	}
+
+	// called once the memory is laid out
+	void Allocated(const D3D11_SUBRESOURCE_DATA* data)
+	{
+		Memory.InitData(data);
+		this->DeviceData->BytesAllocated += Memory.Bytes.size();
+	}
+
+	void STDMETHODCALLTYPE GetType(D3D11_RESOURCE_DIMENSION* dimension) override { *dimension = Memory.Dimension; }
+	void STDMETHODCALLTYPE SetEvictionPriority(UINT priority) override { EvictionPriority = priority; }
+	UINT STDMETHODCALLTYPE GetEvictionPriority() override { return EvictionPriority; }
+	void STDMETHODCALLTYPE GetDesc(Desc* desc) override { *desc = ResourceDesc; }
+};
+
+typedef NullResource<ID3D11Buffer, D3D11_BUFFER_DESC> NullBuffer;
+typedef NullResource<ID3D11Texture1D, D3D11_TEXTURE1D_DESC> NullTexture1D;
+typedef NullResource<ID3D11Texture2D, D3D11_TEXTURE2D_DESC> NullTexture2D;
+typedef NullResource<ID3D11Texture3D, D3D11_TEXTURE3D_DESC> NullTexture3D;
+
+template <typename I, typename Desc>
+class NullView : public NullChild<I, ID3D11View>
+{
+	ComPtr<ID3D11Resource> Resource;
+	Desc ViewDesc;
+
+public:
+
+	NullView(ID3D11Device* device, NullDeviceData* deviceData, ID3D11Resource* resource, const Desc& desc)
+		: NullChild<I, ID3D11View>(device, deviceData), Resource(resource), ViewDesc(desc)
+	{}
+
+	void STDMETHODCALLTYPE GetResource(ID3D11Resource** resource) override
+	{
+		Resource.CopyTo(resource);
+	}
+
+	void STDMETHODCALLTYPE GetDesc(Desc* desc) override { *desc = ViewDesc; }
+};
+
+// views created without a description cover the whole resource in its own format
+// only buffers and plain 1d, 2d and 3d textures are described, arrays are treated as their first slice
+template <typename Desc>
+Desc MakeViewDesc(const NullMemory& memory, UINT bufferDimension, UINT tex1D, UINT tex2D, UINT tex3D)
+{
+	Desc desc = {};
+	desc.Format = memory.Format;
+	switch (memory.Dimension)
+	{
+		case D3D11_RESOURCE_DIMENSION_BUFFER: desc.ViewDimension = (decltype(desc.ViewDimension))bufferDimension; break;
+		case D3D11_RESOURCE_DIMENSION_TEXTURE1D: desc.ViewDimension = (decltype(desc.ViewDimension))tex1D; break;
+		case D3D11_RESOURCE_DIMENSION_TEXTURE3D: desc.ViewDimension = (decltype(desc.ViewDimension))tex3D; break;
+		default: desc.ViewDimension = (decltype(desc.ViewDimension))tex2D; break;
+	}
+	return desc;
+}
+
+template <typename I, typename Desc>
+class NullState : public NullChild<I>
+{
+	Desc StateDesc;
+
+public:
+
+	NullState(ID3D11Device* device, NullDeviceData* deviceData, const Desc& desc)
+		: NullChild<I>(device, deviceData), StateDesc(desc)
+	{}
+
+	void STDMETHODCALLTYPE GetDesc(Desc* desc) override { *desc = StateDesc; }
+};
+
+// shaders and input layouts only need to exist
+template <typename I>
+class NullObject : public NullChild<I>
+{
+public:
+
+	NullObject(ID3D11Device* device, NullDeviceData* deviceData)
+		: NullChild<I>(device, deviceData)
+	{}
+};
+
+struct NullQueryData
+{
+	D3D11_QUERY_DESC Desc;
+
+	// cpu time of the last End, in ticks of NullClock
+	UINT64 Timestamp = 0;
+
+	UINT GetDataSize() const
+	{
+		switch (Desc.Query)
+		{
+			case D3D11_QUERY_EVENT: return sizeof(BOOL);
+			case D3D11_QUERY_OCCLUSION: return sizeof(UINT64);
+			case D3D11_QUERY_TIMESTAMP: return sizeof(UINT64);
+			case D3D11_QUERY_TIMESTAMP_DISJOINT: return sizeof(D3D11_QUERY_DATA_TIMESTAMP_DISJOINT);
+			case D3D11_QUERY_PIPELINE_STATISTICS: return sizeof(D3D11_QUERY_DATA_PIPELINE_STATISTICS);
+			case D3D11_QUERY_SO_STATISTICS:
+			case D3D11_QUERY_SO_STATISTICS_STREAM0:
+			case D3D11_QUERY_SO_STATISTICS_STREAM1:
+			case D3D11_QUERY_SO_STATISTICS_STREAM2:
+			case D3D11_QUERY_SO_STATISTICS_STREAM3: return sizeof(D3D11_QUERY_DATA_SO_STATISTICS);
+			default: return sizeof(BOOL);
+		}
+	}
+};
+
+NullQueryData* GetQueryData(ID3D11Asynchronous* async)
+{
+	NullQueryData* query = nullptr;
+	if (async) async->QueryInterface(SF_GUID_NULL_QUERY, (void**)&query);
+	return query;
+}
+
+template <typename I, typename... Bases>
+class NullQuery : public NullChild<I, Bases...>
+{
+	NullQueryData Query;
+
+protected:
+
+	void* GetInternal(REFIID riid) override
+	{
+		return riid == SF_GUID_NULL_QUERY ? &Query : nullptr;
+	}
+
+public:
+
+	NullQuery(ID3D11Device* device, NullDeviceData* deviceData, const D3D11_QUERY_DESC& desc)
+		: NullChild<I, Bases...>(device, deviceData)
+	{
+		Query.Desc = desc;
+	}
+
+	void STDMETHODCALLTYPE GetDesc(D3D11_QUERY_DESC* desc) override { *desc = Query.Desc; }
+	UINT STDMETHODCALLTYPE GetDataSize() override { return Query.GetDataSize(); }
+};
+
+typedef NullQuery<ID3D11Query, ID3D11Asynchronous> NullQuery_Query;
+typedef NullQuery<ID3D11Predicate, ID3D11Query, ID3D11Asynchronous> NullQuery_Predicate;
+
+class NullCommandList : public NullChild<ID3D11CommandList>
+{
+public:
+
+	NullCommandList(ID3D11Device* device, NullDeviceData* deviceData)
+		: NullChild<ID3D11CommandList>(device, deviceData)
+	{}
+
+	UINT STDMETHODCALLTYPE GetContextFlags() override { return 0; }
+};
+
+template <typename T>
+void ClearOut(T** objects, UINT count)
+{
+	if (objects) memset(objects, 0, sizeof(T*) * count);
+}
+
+// binds and draws are only counted, the null device does not track pipeline state
+// getters report an empty pipeline
+#define SF_NULL_STAGE_METHODS(prefix, ShaderType)                                                                               \
+void STDMETHODCALLTYPE prefix##SetShaderResources(UINT, UINT, ID3D11ShaderResourceView* const*) override                     \
+	{ Count(&SfNullDeviceStats::SlotBinds); }                                                                                   \
+void STDMETHODCALLTYPE prefix##SetShader(ShaderType*, ID3D11ClassInstance* const*, UINT) override                            \
+	{ Count(&SfNullDeviceStats::StateSets); }                                                                                   \
+void STDMETHODCALLTYPE prefix##SetSamplers(UINT, UINT, ID3D11SamplerState* const*) override                                  \
+	{ Count(&SfNullDeviceStats::SlotBinds); }                                                                                   \
+void STDMETHODCALLTYPE prefix##SetConstantBuffers(UINT, UINT, ID3D11Buffer* const*) override                                 \
+	{ Count(&SfNullDeviceStats::SlotBinds); }                                                                                   \
+void STDMETHODCALLTYPE prefix##SetConstantBuffers1(UINT, UINT, ID3D11Buffer* const*, const UINT*, const UINT*) override      \
+	{ Count(&SfNullDeviceStats::SlotBinds); }                                                                                   \
+void STDMETHODCALLTYPE prefix##GetShaderResources(UINT, UINT count, ID3D11ShaderResourceView** views) override               \
+	{ Count(); ClearOut(views, count); }                                                                                        \
+void STDMETHODCALLTYPE prefix##GetShader(ShaderType** shader, ID3D11ClassInstance**, UINT* numInstances) override            \
+	{ Count(); if (shader) *shader = nullptr; if (numInstances) *numInstances = 0; }                                            \
+void STDMETHODCALLTYPE prefix##GetSamplers(UINT, UINT count, ID3D11SamplerState** samplers) override                         \
+	{ Count(); ClearOut(samplers, count); }                                                                                     \
+void STDMETHODCALLTYPE prefix##GetConstantBuffers(UINT, UINT count, ID3D11Buffer** buffers) override                         \
+	{ Count(); ClearOut(buffers, count); }                                                                                      \
+void STDMETHODCALLTYPE prefix##GetConstantBuffers1(UINT, UINT count, ID3D11Buffer** buffers, UINT* firsts, UINT* nums) override \
+	{ Count(); ClearOut(buffers, count); if (firsts) memset(firsts, 0, sizeof(UINT) * count); if (nums) memset(nums, 0, sizeof(UINT) * count); }
+
+class NullContext : public NullChild<ID3D11DeviceContext1, ID3D11DeviceContext>
+{
+	D3D11_DEVICE_CONTEXT_TYPE Type;
+
+	// written only by the thread using this context
+	SfNullDeviceStats Stats;
+
+	void Count(UINT64 SfNullDeviceStats::* counter = nullptr, UINT64 amount = 1)
+	{
+		Stats.Calls++;
+		if (counter) Stats.*counter += amount;
+	}
+
+	void CountCopy(ID3D11Resource* dst, UINT dstSubresource, UINT x, UINT y, UINT z,
+		ID3D11Resource* src, UINT srcSubresource, const D3D11_BOX* box)
+	{
+		Count(&SfNullDeviceStats::Copies);
+		NullMemory* to = GetMemory(dst);
+		NullMemory* from = GetMemory(src);
+		if (to && from) to->Copy(dstSubresource, x, y, z, *from, srcSubresource, box);
+	}
+
+	void CountUpdate(ID3D11Resource* dst, UINT subresource, const D3D11_BOX* box, const void* data, UINT rowPitch, UINT depthPitch)
+	{
+		Count(&SfNullDeviceStats::Updates);
+		NullMemory* memory = GetMemory(dst);
+		if (!memory || !memory->IsValid(subresource)) return;
+
+		UINT x, y, z, rowBytes, rows, depth;
+		memory->GetExtent(subresource, box, x, y, z, rowBytes, rows, depth);
+		const NullSubresource& sub = memory->Subresources[subresource];
+		memory->Write(subresource, x, y, z, (const BYTE*)data, rowPitch ? rowPitch : sub.RowPitch, depthPitch ? depthPitch : sub.DepthPitch,
+			rowBytes, rows, depth);
+	}
+
+public:
+
+	NullContext(ID3D11Device* device, NullDeviceData* deviceData, D3D11_DEVICE_CONTEXT_TYPE type)
+		: NullChild<ID3D11DeviceContext1, ID3D11DeviceContext>(device, deviceData, type == D3D11_DEVICE_CONTEXT_DEFERRED), Type(type)
+	{
+		if (Type != D3D11_DEVICE_CONTEXT_DEFERRED) return;
+		std::lock_guard<std::mutex> lock(DeviceData->ContextMutex);
+		DeviceData->DeferredStats.push_back(&Stats);
+	}
+
+	~NullContext()
+	{
+		if (Type != D3D11_DEVICE_CONTEXT_DEFERRED) return;
+		std::lock_guard<std::mutex> lock(DeviceData->ContextMutex);
+		AddStats(DeviceData->RetiredStats, Stats);
+		auto& stats = DeviceData->DeferredStats;
+		stats.erase(std::find(stats.begin(), stats.end(), &Stats));
+	}
+
+	const SfNullDeviceStats& GetStats() const { return Stats; }
+
+	// the immediate context shares the reference count of its device
+	ULONG STDMETHODCALLTYPE AddRef() override
+	{
+		if (Type == D3D11_DEVICE_CONTEXT_IMMEDIATE) return Device->AddRef();
+		return NullChild::AddRef();
+	}
+
+	ULONG STDMETHODCALLTYPE Release() override
+	{
+		if (Type == D3D11_DEVICE_CONTEXT_IMMEDIATE) return Device->Release();
+		return NullChild::Release();
+	}
+
+	SF_NULL_STAGE_METHODS(VS, ID3D11VertexShader)
+	SF_NULL_STAGE_METHODS(PS, ID3D11PixelShader)
+	SF_NULL_STAGE_METHODS(HS, ID3D11HullShader)
+	SF_NULL_STAGE_METHODS(DS, ID3D11DomainShader)
+	SF_NULL_STAGE_METHODS(GS, ID3D11GeometryShader)
+	SF_NULL_STAGE_METHODS(CS, ID3D11ComputeShader)
+
+	void STDMETHODCALLTYPE Draw(UINT, UINT) override { Count(&SfNullDeviceStats::Draws); }
+	void STDMETHODCALLTYPE DrawIndexed(UINT, UINT, INT) override { Count(&SfNullDeviceStats::Draws); }
+	void STDMETHODCALLTYPE DrawInstanced(UINT, UINT, UINT, UINT) override { Count(&SfNullDeviceStats::Draws); }
+	void STDMETHODCALLTYPE DrawIndexedInstanced(UINT, UINT, UINT, INT, UINT) override { Count(&SfNullDeviceStats::Draws); }
+	void STDMETHODCALLTYPE DrawAuto() override { Count(&SfNullDeviceStats::Draws); }
+	void STDMETHODCALLTYPE DrawIndexedInstancedIndirect(ID3D11Buffer*, UINT) override { Count(&SfNullDeviceStats::Draws); }
+	void STDMETHODCALLTYPE DrawInstancedIndirect(ID3D11Buffer*, UINT) override { Count(&SfNullDeviceStats::Draws); }
+	void STDMETHODCALLTYPE Dispatch(UINT, UINT, UINT) override { Count(&SfNullDeviceStats::Dispatches); }
+	void STDMETHODCALLTYPE DispatchIndirect(ID3D11Buffer*, UINT) override { Count(&SfNullDeviceStats::Dispatches); }
+
+	HRESULT STDMETHODCALLTYPE Map(ID3D11Resource* resource, UINT subresource, D3D11_MAP, UINT, D3D11_MAPPED_SUBRESOURCE* mapped) override
+	{
+		Count(&SfNullDeviceStats::Maps);
+		NullMemory* memory = GetMemory(resource);
+		if (!memory || !memory->IsValid(subresource)) return E_INVALIDARG;
+
+		const NullSubresource& sub = memory->Subresources[subresource];
+		if (mapped)
+		{
+			mapped->pData = memory->Bytes.data() + sub.Offset;
+			mapped->RowPitch = sub.RowPitch;
+			mapped->DepthPitch = sub.DepthPitch;
+		}
+		return S_OK;
+	}
+
+	void STDMETHODCALLTYPE Unmap(ID3D11Resource*, UINT) override { Count(); }
+
+	void STDMETHODCALLTYPE IASetInputLayout(ID3D11InputLayout*) override { Count(&SfNullDeviceStats::StateSets); }
+	void STDMETHODCALLTYPE IASetVertexBuffers(UINT, UINT, ID3D11Buffer* const*, const UINT*, const UINT*) override { Count(&SfNullDeviceStats::SlotBinds); }
+	void STDMETHODCALLTYPE IASetIndexBuffer(ID3D11Buffer*, DXGI_FORMAT, UINT) override { Count(&SfNullDeviceStats::SlotBinds); }
+	void STDMETHODCALLTYPE IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY) override { Count(&SfNullDeviceStats::StateSets); }
+
+	void STDMETHODCALLTYPE Begin(ID3D11Asynchronous*) override { Count(&SfNullDeviceStats::Queries); }
+
+	void STDMETHODCALLTYPE End(ID3D11Asynchronous* async) override
+	{
+		Count(&SfNullDeviceStats::Queries);
+
+		NullQueryData* query = GetQueryData(async);
+		if (query && query->Desc.Query == D3D11_QUERY_TIMESTAMP)
+			query->Timestamp = (UINT64)NullClock::now().time_since_epoch().count();
+	}
+
+	// everything completes as soon as it is submitted
+	HRESULT STDMETHODCALLTYPE GetData(ID3D11Asynchronous* async, void* data, UINT size, UINT) override
+	{
+		Count(&SfNullDeviceStats::Queries);
+		NullQueryData* query = GetQueryData(async);
+		if (!query) return E_INVALIDARG;
+		if (!data || size == 0) return S_OK;
+
+		BYTE result[sizeof(D3D11_QUERY_DATA_PIPELINE_STATISTICS)] = {};
+		switch (query->Desc.Query)
+		{
+			case D3D11_QUERY_EVENT:
+			{
+				const BOOL done = TRUE;
+				memcpy(result, &done, sizeof(done));
+				break;
+			}
+			case D3D11_QUERY_TIMESTAMP:
+			{
+				memcpy(result, &query->Timestamp, sizeof(UINT64));
+				break;
+			}
+			case D3D11_QUERY_TIMESTAMP_DISJOINT:
+			{
+				D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+				disjoint.Frequency = (UINT64)(NullClock::period::den / NullClock::period::num);
+				disjoint.Disjoint = FALSE;
+				memcpy(result, &disjoint, sizeof(disjoint));
+				break;
+			}
+			default:
+				break;
+		}
+
+		memcpy(data, result, std::min(size, query->GetDataSize()));
+		return S_OK;
+	}
+
+	void STDMETHODCALLTYPE SetPredication(ID3D11Predicate*, BOOL) override { Count(&SfNullDeviceStats::StateSets); }
+
+	void STDMETHODCALLTYPE OMSetRenderTargets(UINT, ID3D11RenderTargetView* const*, ID3D11DepthStencilView*) override
+	{
+		Count(&SfNullDeviceStats::SlotBinds);
+	}
+
+	void STDMETHODCALLTYPE OMSetRenderTargetsAndUnorderedAccessViews(UINT, ID3D11RenderTargetView* const*, ID3D11DepthStencilView*,
+		UINT, UINT, ID3D11UnorderedAccessView* const*, const UINT*) override
+	{
+		Count(&SfNullDeviceStats::SlotBinds);
+	}
+
+	void STDMETHODCALLTYPE OMSetBlendState(ID3D11BlendState*, const FLOAT[4], UINT) override { Count(&SfNullDeviceStats::StateSets); }
+	void STDMETHODCALLTYPE OMSetDepthStencilState(ID3D11DepthStencilState*, UINT) override { Count(&SfNullDeviceStats::StateSets); }
+	void STDMETHODCALLTYPE SOSetTargets(UINT, ID3D11Buffer* const*, const UINT*) override { Count(&SfNullDeviceStats::SlotBinds); }
+	void STDMETHODCALLTYPE RSSetState(ID3D11RasterizerState*) override { Count(&SfNullDeviceStats::StateSets); }
+	void STDMETHODCALLTYPE RSSetViewports(UINT, const D3D11_VIEWPORT*) override { Count(&SfNullDeviceStats::StateSets); }
+	void STDMETHODCALLTYPE RSSetScissorRects(UINT, const D3D11_RECT*) override { Count(&SfNullDeviceStats::StateSets); }
+	void STDMETHODCALLTYPE CSSetUnorderedAccessViews(UINT, UINT, ID3D11UnorderedAccessView* const*, const UINT*) override { Count(&SfNullDeviceStats::SlotBinds); }
+
+	void STDMETHODCALLTYPE CopySubresourceRegion(ID3D11Resource* dst, UINT dstSubresource, UINT x, UINT y, UINT z,
+		ID3D11Resource* src, UINT srcSubresource, const D3D11_BOX* box) override
+	{
+		CountCopy(dst, dstSubresource, x, y, z, src, srcSubresource, box);
+	}
+
+	void STDMETHODCALLTYPE CopySubresourceRegion1(ID3D11Resource* dst, UINT dstSubresource, UINT x, UINT y, UINT z,
+		ID3D11Resource* src, UINT srcSubresource, const D3D11_BOX* box, UINT) override
+	{
+		CountCopy(dst, dstSubresource, x, y, z, src, srcSubresource, box);
+	}
+
+	void STDMETHODCALLTYPE CopyResource(ID3D11Resource* dst, ID3D11Resource* src) override
+	{
+		Count(&SfNullDeviceStats::Copies);
+		NullMemory* to = GetMemory(dst);
+		NullMemory* from = GetMemory(src);
+		if (to && from && to != from) memcpy(to->Bytes.data(), from->Bytes.data(), std::min(to->Bytes.size(), from->Bytes.size()));
+	}
+
+	void STDMETHODCALLTYPE UpdateSubresource(ID3D11Resource* dst, UINT subresource, const D3D11_BOX* box,
+		const void* data, UINT rowPitch, UINT depthPitch) override
+	{
+		CountUpdate(dst, subresource, box, data, rowPitch, depthPitch);
+	}
+
+	void STDMETHODCALLTYPE UpdateSubresource1(ID3D11Resource* dst, UINT subresource, const D3D11_BOX* box,
+		const void* data, UINT rowPitch, UINT depthPitch, UINT) override
+	{
+		CountUpdate(dst, subresource, box, data, rowPitch, depthPitch);
+	}
+
+	void STDMETHODCALLTYPE CopyStructureCount(ID3D11Buffer*, UINT, ID3D11UnorderedAccessView*) override { Count(&SfNullDeviceStats::Copies); }
+	void STDMETHODCALLTYPE ClearRenderTargetView(ID3D11RenderTargetView*, const FLOAT[4]) override { Count(&SfNullDeviceStats::Clears); }
+	void STDMETHODCALLTYPE ClearUnorderedAccessViewUint(ID3D11UnorderedAccessView*, const UINT[4]) override { Count(&SfNullDeviceStats::Clears); }
+	void STDMETHODCALLTYPE ClearUnorderedAccessViewFloat(ID3D11UnorderedAccessView*, const FLOAT[4]) override { Count(&SfNullDeviceStats::Clears); }
+	void STDMETHODCALLTYPE ClearDepthStencilView(ID3D11DepthStencilView*, UINT, FLOAT, UINT8) override { Count(&SfNullDeviceStats::Clears); }
+	void STDMETHODCALLTYPE ClearView(ID3D11View*, const FLOAT[4], const D3D11_RECT*, UINT) override { Count(&SfNullDeviceStats::Clears); }
+	void STDMETHODCALLTYPE GenerateMips(ID3D11ShaderResourceView*) override { Count(); }
+	void STDMETHODCALLTYPE SetResourceMinLOD(ID3D11Resource*, FLOAT) override { Count(); }
+	FLOAT STDMETHODCALLTYPE GetResourceMinLOD(ID3D11Resource*) override { Count(); return 0; }
+	void STDMETHODCALLTYPE ResolveSubresource(ID3D11Resource*, UINT, ID3D11Resource*, UINT, DXGI_FORMAT) override { Count(&SfNullDeviceStats::Copies); }
+	void STDMETHODCALLTYPE DiscardResource(ID3D11Resource*) override { Count(); }
+	void STDMETHODCALLTYPE DiscardView(ID3D11View*) override { Count(); }
+	void STDMETHODCALLTYPE DiscardView1(ID3D11View*, const D3D11_RECT*, UINT) override { Count(); }
+
+	void STDMETHODCALLTYPE SwapDeviceContextState(ID3DDeviceContextState*, ID3DDeviceContextState** previous) override
+	{
+		Count();
+		if (previous) *previous = nullptr;
+	}
+
+	void STDMETHODCALLTYPE ExecuteCommandList(ID3D11CommandList*, BOOL) override { Count(&SfNullDeviceStats::CommandLists); }
+
+	HRESULT STDMETHODCALLTYPE FinishCommandList(BOOL, ID3D11CommandList** commandList) override
+	{
+		Count(&SfNullDeviceStats::CommandLists);
+		if (Type != D3D11_DEVICE_CONTEXT_DEFERRED) return DXGI_ERROR_INVALID_CALL;
+		if (commandList) *commandList = new NullCommandList(Device, DeviceData);
+		return S_OK;
+	}
+
+	void STDMETHODCALLTYPE IAGetInputLayout(ID3D11InputLayout** layout) override { Count(); if (layout) *layout = nullptr; }
+
+	void STDMETHODCALLTYPE IAGetVertexBuffers(UINT, UINT count, ID3D11Buffer** buffers, UINT* strides, UINT* offsets) override
+	{
+		Count();
+		ClearOut(buffers, count);
+		if (strides) memset(strides, 0, sizeof(UINT) * count);
+		if (offsets) memset(offsets, 0, sizeof(UINT) * count);
+	}
+
+	void STDMETHODCALLTYPE IAGetIndexBuffer(ID3D11Buffer** buffer, DXGI_FORMAT* format, UINT* offset) override
+	{
+		Count();
+		if (buffer) *buffer = nullptr;
+		if (format) *format = DXGI_FORMAT_UNKNOWN;
+		if (offset) *offset = 0;
+	}
+
+	void STDMETHODCALLTYPE IAGetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY* topology) override
+	{
+		Count();
+		if (topology) *topology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	}
+
+	void STDMETHODCALLTYPE GetPredication(ID3D11Predicate** predicate, BOOL* value) override
+	{
+		Count();
+		if (predicate) *predicate = nullptr;
+		if (value) *value = FALSE;
+	}
+
+	void STDMETHODCALLTYPE OMGetRenderTargets(UINT count, ID3D11RenderTargetView** views, ID3D11DepthStencilView** depth) override
+	{
+		Count();
+		ClearOut(views, count);
+		if (depth) *depth = nullptr;
+	}
+
+	void STDMETHODCALLTYPE OMGetRenderTargetsAndUnorderedAccessViews(UINT count, ID3D11RenderTargetView** views, ID3D11DepthStencilView** depth,
+		UINT, UINT uavCount, ID3D11UnorderedAccessView** uavs) override
+	{
+		Count();
+		ClearOut(views, count);
+		ClearOut(uavs, uavCount);
+		if (depth) *depth = nullptr;
+	}
+
+	void STDMETHODCALLTYPE OMGetBlendState(ID3D11BlendState** state, FLOAT factor[4], UINT* sampleMask) override
+	{
+		Count();
+		if (state) *state = nullptr;
+		if (factor) factor[0] = factor[1] = factor[2] = factor[3] = 1;
+		if (sampleMask) *sampleMask = 0xffffffff;
+	}
+
+	void STDMETHODCALLTYPE OMGetDepthStencilState(ID3D11DepthStencilState** state, UINT* stencilRef) override
+	{
+		Count();
+		if (state) *state = nullptr;
+		if (stencilRef) *stencilRef = 0;
+	}
+
+	void STDMETHODCALLTYPE SOGetTargets(UINT count, ID3D11Buffer** buffers) override { Count(); ClearOut(buffers, count); }
+	void STDMETHODCALLTYPE RSGetState(ID3D11RasterizerState** state) override { Count(); if (state) *state = nullptr; }
+	void STDMETHODCALLTYPE RSGetViewports(UINT* count, D3D11_VIEWPORT*) override { Count(); if (count) *count = 0; }
+	void STDMETHODCALLTYPE RSGetScissorRects(UINT* count, D3D11_RECT*) override { Count(); if (count) *count = 0; }
+	void STDMETHODCALLTYPE CSGetUnorderedAccessViews(UINT, UINT count, ID3D11UnorderedAccessView** views) override { Count(); ClearOut(views, count); }
+
+	void STDMETHODCALLTYPE ClearState() override { Count(&SfNullDeviceStats::StateSets); }
+	void STDMETHODCALLTYPE Flush() override { Count(); }
+	D3D11_DEVICE_CONTEXT_TYPE STDMETHODCALLTYPE GetType() override { return Type; }
+	UINT STDMETHODCALLTYPE GetContextFlags() override { return 0; }
+};
+
+#undef SF_NULL_STAGE_METHODS
+
+class NullDevice : public ID3D11Device
+{
+	std::atomic<ULONG> References = 1;
+	PrivateDataStore PrivateData;
+	NullDeviceData Data;
+	NullContext* ImmediateContext = nullptr;
+	UINT ExceptionMode = 0;
+
+	template <typename T, typename I, typename... Args>
+	HRESULT Create(I** object, Args&&... args)
+	{
+		Data.Count();
+		if (!object) return S_FALSE;
+		*object = new T(this, &Data, std::forward<Args>(args)...);
+		return S_OK;
+	}
+
+	template <typename T, typename Desc>
+	HRESULT CreateView(ID3D11Resource* resource, const Desc* desc, T** view, UINT bufferDimension, UINT tex1D, UINT tex2D, UINT tex3D)
+	{
+		Data.Count();
+		NullMemory* memory = GetMemory(resource);
+		if (!memory) return E_INVALIDARG;
+		if (!view) return S_FALSE;
+
+		*view = new NullView<T, Desc>(this, &Data, resource, desc ? *desc : MakeViewDesc<Desc>(*memory, bufferDimension, tex1D, tex2D, tex3D));
+		return S_OK;
+	}
+
+	template <typename T, typename Desc>
+	HRESULT CreateTexture(const Desc* desc, const D3D11_SUBRESOURCE_DATA* data, T** texture,
+		D3D11_RESOURCE_DIMENSION dimension, UINT height, UINT depth, UINT arraySize, UINT samples)
+	{
+		Data.Count();
+		if (!desc || desc->Width == 0) return E_INVALIDARG;
+		if (!texture) return S_FALSE;
+
+		Desc actual = *desc;
+		if (actual.MipLevels == 0) actual.MipLevels = CountMips(desc->Width, height, depth);
+
+		auto* resource = new NullResource<T, Desc>(this, &Data, actual);
+		resource->Memory.InitTexture(dimension, desc->Width, height, depth, actual.MipLevels, arraySize, samples, desc->Format);
+		resource->Allocated(data);
+		*texture = resource;
+		return S_OK;
+	}
+
+public:
+
+	NullDevice()
+	{
+		ImmediateContext = new NullContext(this, &Data, D3D11_DEVICE_CONTEXT_IMMEDIATE);
+	}
+
+	virtual ~NullDevice()
+	{
+		delete ImmediateContext;
+	}
+
+	SfNullDeviceStats GetStats()
+	{
+		SfNullDeviceStats stats = ImmediateContext->GetStats();
+		{
+			std::lock_guard<std::mutex> lock(Data.ContextMutex);
+			AddStats(stats, Data.RetiredStats);
+			for (const SfNullDeviceStats* deferred : Data.DeferredStats)
+				AddStats(stats, *deferred);
+		}
+
+		stats.Calls += Data.Calls;
+		stats.ObjectsCreated = Data.ObjectsCreated;
+		stats.ObjectsAlive = Data.ObjectsAlive;
+		stats.BytesAllocated = Data.BytesAllocated;
+		return stats;
+	}
+
+	HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) override
+	{
+		if (!object) return E_POINTER;
+
+		if (riid == __uuidof(IUnknown) || riid == __uuidof(ID3D11Device))
+		{
+			*object = static_cast<ID3D11Device*>(this);
+			AddRef();
+			return S_OK;
+		}
+
+		*object = riid == SF_GUID_NULL_DEVICE ? this : nullptr;
+		return *object ? S_OK : E_NOINTERFACE;
+	}
+
+	ULONG STDMETHODCALLTYPE AddRef() override
+	{
+		return ++References;
+	}
+
+	ULONG STDMETHODCALLTYPE Release() override
+	{
+		const ULONG references = --References;
+		if (references == 0) delete this;
+		return references;
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateBuffer(const D3D11_BUFFER_DESC* desc, const D3D11_SUBRESOURCE_DATA* data, ID3D11Buffer** buffer) override
+	{
+		Data.Count();
+		if (!desc || desc->ByteWidth == 0) return E_INVALIDARG;
+		if (!buffer) return S_FALSE;
+
+		NullBuffer* resource = new NullBuffer(this, &Data, *desc);
+		resource->Memory.InitBuffer(desc->ByteWidth);
+		resource->Allocated(data);
+		*buffer = resource;
+		return S_OK;
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateTexture1D(const D3D11_TEXTURE1D_DESC* desc, const D3D11_SUBRESOURCE_DATA* data, ID3D11Texture1D** texture) override
+	{
+		return CreateTexture(desc, data, texture, D3D11_RESOURCE_DIMENSION_TEXTURE1D, 1, 1, desc ? desc->ArraySize : 1, 1);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateTexture2D(const D3D11_TEXTURE2D_DESC* desc, const D3D11_SUBRESOURCE_DATA* data, ID3D11Texture2D** texture) override
+	{
+		if (!desc) return E_INVALIDARG;
+		return CreateTexture(desc, data, texture, D3D11_RESOURCE_DIMENSION_TEXTURE2D, desc->Height, 1, desc->ArraySize, std::max(desc->SampleDesc.Count, 1u));
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateTexture3D(const D3D11_TEXTURE3D_DESC* desc, const D3D11_SUBRESOURCE_DATA* data, ID3D11Texture3D** texture) override
+	{
+		if (!desc) return E_INVALIDARG;
+		return CreateTexture(desc, data, texture, D3D11_RESOURCE_DIMENSION_TEXTURE3D, desc->Height, desc->Depth, 1, 1);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateShaderResourceView(ID3D11Resource* resource, const D3D11_SHADER_RESOURCE_VIEW_DESC* desc, ID3D11ShaderResourceView** view) override
+	{
+		return CreateView(resource, desc, view, D3D11_SRV_DIMENSION_BUFFER, D3D11_SRV_DIMENSION_TEXTURE1D, D3D11_SRV_DIMENSION_TEXTURE2D, D3D11_SRV_DIMENSION_TEXTURE3D);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateUnorderedAccessView(ID3D11Resource* resource, const D3D11_UNORDERED_ACCESS_VIEW_DESC* desc, ID3D11UnorderedAccessView** view) override
+	{
+		return CreateView(resource, desc, view, D3D11_UAV_DIMENSION_BUFFER, D3D11_UAV_DIMENSION_TEXTURE1D, D3D11_UAV_DIMENSION_TEXTURE2D, D3D11_UAV_DIMENSION_TEXTURE3D);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateRenderTargetView(ID3D11Resource* resource, const D3D11_RENDER_TARGET_VIEW_DESC* desc, ID3D11RenderTargetView** view) override
+	{
+		return CreateView(resource, desc, view, D3D11_RTV_DIMENSION_BUFFER, D3D11_RTV_DIMENSION_TEXTURE1D, D3D11_RTV_DIMENSION_TEXTURE2D, D3D11_RTV_DIMENSION_TEXTURE3D);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateDepthStencilView(ID3D11Resource* resource, const D3D11_DEPTH_STENCIL_VIEW_DESC* desc, ID3D11DepthStencilView** view) override
+	{
+		return CreateView(resource, desc, view, D3D11_DSV_DIMENSION_TEXTURE2D, D3D11_DSV_DIMENSION_TEXTURE1D, D3D11_DSV_DIMENSION_TEXTURE2D, D3D11_DSV_DIMENSION_TEXTURE2D);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC*, UINT, const void*, SIZE_T, ID3D11InputLayout** layout) override
+	{
+		return Create<NullObject<ID3D11InputLayout>>(layout);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateVertexShader(const void*, SIZE_T, ID3D11ClassLinkage*, ID3D11VertexShader** shader) override
+	{
+		return Create<NullObject<ID3D11VertexShader>>(shader);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateGeometryShader(const void*, SIZE_T, ID3D11ClassLinkage*, ID3D11GeometryShader** shader) override
+	{
+		return Create<NullObject<ID3D11GeometryShader>>(shader);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateGeometryShaderWithStreamOutput(const void*, SIZE_T, const D3D11_SO_DECLARATION_ENTRY*, UINT,
+		const UINT*, UINT, UINT, ID3D11ClassLinkage*, ID3D11GeometryShader** shader) override
+	{
+		return Create<NullObject<ID3D11GeometryShader>>(shader);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreatePixelShader(const void*, SIZE_T, ID3D11ClassLinkage*, ID3D11PixelShader** shader) override
+	{
+		return Create<NullObject<ID3D11PixelShader>>(shader);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateHullShader(const void*, SIZE_T, ID3D11ClassLinkage*, ID3D11HullShader** shader) override
+	{
+		return Create<NullObject<ID3D11HullShader>>(shader);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateDomainShader(const void*, SIZE_T, ID3D11ClassLinkage*, ID3D11DomainShader** shader) override
+	{
+		return Create<NullObject<ID3D11DomainShader>>(shader);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateComputeShader(const void*, SIZE_T, ID3D11ClassLinkage*, ID3D11ComputeShader** shader) override
+	{
+		return Create<NullObject<ID3D11ComputeShader>>(shader);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateClassLinkage(ID3D11ClassLinkage**) override { Data.Count(); return E_NOTIMPL; }
+
+	HRESULT STDMETHODCALLTYPE CreateBlendState(const D3D11_BLEND_DESC* desc, ID3D11BlendState** state) override
+	{
+		if (!desc) return E_INVALIDARG;
+		return Create<NullState<ID3D11BlendState, D3D11_BLEND_DESC>>(state, *desc);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC* desc, ID3D11DepthStencilState** state) override
+	{
+		if (!desc) return E_INVALIDARG;
+		return Create<NullState<ID3D11DepthStencilState, D3D11_DEPTH_STENCIL_DESC>>(state, *desc);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateRasterizerState(const D3D11_RASTERIZER_DESC* desc, ID3D11RasterizerState** state) override
+	{
+		if (!desc) return E_INVALIDARG;
+		return Create<NullState<ID3D11RasterizerState, D3D11_RASTERIZER_DESC>>(state, *desc);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateSamplerState(const D3D11_SAMPLER_DESC* desc, ID3D11SamplerState** state) override
+	{
+		if (!desc) return E_INVALIDARG;
+		return Create<NullState<ID3D11SamplerState, D3D11_SAMPLER_DESC>>(state, *desc);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateQuery(const D3D11_QUERY_DESC* desc, ID3D11Query** query) override
+	{
+		if (!desc) return E_INVALIDARG;
+		return Create<NullQuery_Query>(query, *desc);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreatePredicate(const D3D11_QUERY_DESC* desc, ID3D11Predicate** predicate) override
+	{
+		if (!desc) return E_INVALIDARG;
+		return Create<NullQuery_Predicate>(predicate, *desc);
+	}
+
+	HRESULT STDMETHODCALLTYPE CreateCounter(const D3D11_COUNTER_DESC*, ID3D11Counter**) override { Data.Count(); return E_NOTIMPL; }
+
+	HRESULT STDMETHODCALLTYPE CreateDeferredContext(UINT, ID3D11DeviceContext** context) override
+	{
+		return Create<NullContext>(context, D3D11_DEVICE_CONTEXT_DEFERRED);
+	}
+
+	HRESULT STDMETHODCALLTYPE OpenSharedResource(HANDLE, REFIID, void** resource) override
+	{
+		Data.Count();
+		if (resource) *resource = nullptr;
+		return E_NOTIMPL;
+	}
+
+	HRESULT STDMETHODCALLTYPE CheckFormatSupport(DXGI_FORMAT format, UINT* support) override
+	{
+		Data.Count();
+		UINT blockSize;
+		const bool known = GetElementBytes(format, blockSize) > 0;
+		if (support) *support = known ? 0xffffffff : 0;
+		return known ? S_OK : E_FAIL;
+	}
+
+	HRESULT STDMETHODCALLTYPE CheckMultisampleQualityLevels(DXGI_FORMAT, UINT sampleCount, UINT* levels) override
+	{
+		Data.Count();
+		if (levels) *levels = sampleCount > 0 && sampleCount <= 8 && (sampleCount & (sampleCount - 1)) == 0 ? 1 : 0;
+		return S_OK;
+	}
+
+	void STDMETHODCALLTYPE CheckCounterInfo(D3D11_COUNTER_INFO* info) override
+	{
+		Data.Count();
+		if (info) memset(info, 0, sizeof(*info));
+	}
+
+	HRESULT STDMETHODCALLTYPE CheckCounter(const D3D11_COUNTER_DESC*, D3D11_COUNTER_TYPE*, UINT*, LPSTR, UINT*, LPSTR, UINT*, LPSTR, UINT*) override
+	{
+		Data.Count();
+		return E_NOTIMPL;
+	}
+
+	// threading and 11.1 constant buffer offsets are reported as supported, every other feature reads as zero
+	HRESULT STDMETHODCALLTYPE CheckFeatureSupport(D3D11_FEATURE feature, void* data, UINT size) override
+	{
+		Data.Count();
+		if (!data) return E_INVALIDARG;
+		memset(data, 0, size);
+
+		switch (feature)
+		{
+			case D3D11_FEATURE_THREADING:
+			{
+				if (size != sizeof(D3D11_FEATURE_DATA_THREADING)) return E_INVALIDARG;
+				D3D11_FEATURE_DATA_THREADING* threading = (D3D11_FEATURE_DATA_THREADING*)data;
+				threading->DriverConcurrentCreates = TRUE;
+				threading->DriverCommandLists = TRUE;
+				break;
+			}
+			case D3D11_FEATURE_D3D11_OPTIONS:
+			{
+				if (size != sizeof(D3D11_FEATURE_DATA_D3D11_OPTIONS)) return E_INVALIDARG;
+				D3D11_FEATURE_DATA_D3D11_OPTIONS* options = (D3D11_FEATURE_DATA_D3D11_OPTIONS*)data;
+				options->ConstantBufferOffsetting = TRUE;
+				options->ConstantBufferPartialUpdate = TRUE;
+				options->MapNoOverwriteOnDynamicConstantBuffer = TRUE;
+				options->MapNoOverwriteOnDynamicBufferSRV = TRUE;
+				break;
+			}
+			default:
+				break;
+		}
+		return S_OK;
+	}
+
+	HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID guid, UINT* size, void* data) override
+	{
+		return PrivateData.Get(guid, size, data);
+	}
+
+	HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID guid, UINT size, const void* data) override
+	{
+		return PrivateData.Set(guid, size, data);
+	}
+
+	HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID guid, const IUnknown* object) override
+	{
+		return PrivateData.SetInterface(guid, object);
+	}
+
+	D3D_FEATURE_LEVEL STDMETHODCALLTYPE GetFeatureLevel() override { return D3D_FEATURE_LEVEL_11_1; }
+	UINT STDMETHODCALLTYPE GetCreationFlags() override { return 0; }
+	HRESULT STDMETHODCALLTYPE GetDeviceRemovedReason() override { return S_OK; }
+
+	void STDMETHODCALLTYPE GetImmediateContext(ID3D11DeviceContext** context) override
+	{
+		ImmediateContext->AddRef();
+		*context = ImmediateContext;
+	}
+
+	HRESULT STDMETHODCALLTYPE SetExceptionMode(UINT flags) override
+	{
+		ExceptionMode = flags;
+		return S_OK;
+	}
+
+	UINT STDMETHODCALLTYPE GetExceptionMode() override { return ExceptionMode; }
+};
+
+}
+
+HRESULT CreateNullDevice(ID3D11Device** device, ID3D11DeviceContext** immediateContext)
+{
+	if (!device) return E_INVALIDARG;
+
+	NullDevice* nullDevice = new NullDevice();
+	if (immediateContext) nullDevice->GetImmediateContext(immediateContext);
+	*device = nullDevice;
+	return S_OK;
+}
+
+bool GetNullDeviceStats(ID3D11Device* device, SfNullDeviceStats& stats)
+{
+	NullDevice* nullDevice = nullptr;
+	if (!device || FAILED(device->QueryInterface(SF_GUID_NULL_DEVICE, (void**)&nullDevice))) return false;
+
+	stats = nullDevice->GetStats();
+	return true;
+}
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "d3d11_include.h"
+
+namespace sf11
+{
+
+// calls received by a null device, see EDeviceType::Null
+// every field is a UINT64 counter so snapshots can be subtracted field by field
+struct SfNullDeviceStats
+{
+	// every device and context method, including the ones counted below
+	UINT64 Calls = 0;
+
+	UINT64 Draws = 0;
+	UINT64 Dispatches = 0;
+
+	// shaders, input layout, topology and fixed function state
+	UINT64 StateSets = 0;
+
+	// slot ranges of views, samplers, constant buffers, vertex buffers and render targets
+	UINT64 SlotBinds = 0;
+
+	UINT64 Maps = 0;
+	UINT64 Updates = 0;
+	UINT64 Copies = 0;
+	UINT64 Clears = 0;
+
+	// begin, end and get data
+	UINT64 Queries = 0;
+
+	// finished and executed command lists
+	UINT64 CommandLists = 0;
+
+	UINT64 ObjectsCreated = 0;
+	UINT64 ObjectsAlive = 0;
+
+	// system memory held by buffers and textures
+	UINT64 BytesAllocated = 0;
+
+	SfNullDeviceStats operator-(const SfNullDeviceStats& other) const
+	{
+		SfNullDeviceStats out;
+		const UINT64* a = (const UINT64*)this;
+		const UINT64* b = (const UINT64*)&other;
+		UINT64* o = (UINT64*)&out;
+		for (size_t i = 0; i < sizeof(SfNullDeviceStats) / sizeof(UINT64); i++)
+			o[i] = a[i] - b[i];
+		return out;
+	}
+};
+
+// creates a device that implements d3d11 without a gpu
+// resources live in system memory, so updates, copies, maps and readbacks behave like the real thing
+// nothing is drawn, queries complete immediately and timestamps are taken from the cpu clock
+// windows and swap chains are not supported, render into render targets instead
+// device contexts support the 11.1 constant buffer offsets, nothing else from 11.1
+HRESULT CreateNullDevice(ID3D11Device** device, ID3D11DeviceContext** immediateContext);
+
+// fills stats with the calls a device from CreateNullDevice has received
+// deferred contexts count their own calls, stats should not be read while one is recording on another thread
+// returns false if the device is not a null device
+bool GetNullDeviceStats(ID3D11Device* device, SfNullDeviceStats& stats);
+
+}
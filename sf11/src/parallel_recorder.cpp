@@ -0,0 +1,87 @@
+#include "parallel_recorder.h"
+#include "instance.h"
+#include "sfassert.h"
+#include <chrono>
+
+namespace sf11
+{
+
+static double MillisecondsSince(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+SfParallelRecorder::SfParallelRecorder(SfInstance& instance, UINT numThreads /*= 0*/)
+	: Instance(&instance)
+{
+	SetNumThreads(numThreads);
+}
+
+void SfParallelRecorder::SetNumThreads(UINT numThreads)
+{
+	const UINT available = Instance->GetJobSystem().GetNumThreads();
+	NumThreads = numThreads == 0 || numThreads > available ? available : numThreads;
+}
+
+void SfParallelRecorder::RunJobs()
+{
+	const UINT numJobs = (UINT)Jobs.size();
+	UINT index;
+	while ((index = NextJob.fetch_add(1, std::memory_order_relaxed)) < numJobs)
+	{
+		SfContext_Deferred& context = ContextPool[index];
+		JobDraws[index] = Jobs[index](context, index);
+		context.FinishCommandList();
+	}
+}
+
+void SfParallelRecorder::AddJob(RecordJob job)
+{
+	Jobs.push_back(std::move(job));
+}
+
+void SfParallelRecorder::Execute(bool restoreState /*= false*/)
+{
+	const UINT numJobs = (UINT)Jobs.size();
+
+	Stats = SfRecorderStats();
+	Stats.NumJobs = numJobs;
+	Stats.NumThreads = GetNumThreads();
+	if (numJobs == 0) return;
+
+	// contexts are created on this thread, the device is free threaded but this keeps creation out of the timings
+	while (ContextPool.size() < numJobs)
+		ContextPool.push_back(Instance->CreateDeferredContext());
+	JobDraws.assign(numJobs, 0);
+
+	auto recordStart = std::chrono::high_resolution_clock::now();
+
+	NextJob.store(0, std::memory_order_relaxed);
+
+	// every task pulls jobs until none are left, so the number of tasks is the number of threads recording
+	SfJobSystem& jobs = Instance->GetJobSystem();
+	SfTaskGroup group;
+	const UINT numTasks = NumThreads < numJobs ? NumThreads : numJobs;
+	for (UINT i = 1; i < numTasks; i++)
+		jobs.Run(group, [this] { RunJobs(); });
+
+	// the calling thread records too instead of sitting idle
+	RunJobs();
+	jobs.Wait(group);
+
+	Stats.RecordTime = MillisecondsSince(recordStart);
+	for (UINT draws : JobDraws)
+		Stats.DrawCalls += draws;
+
+	auto executeStart = std::chrono::high_resolution_clock::now();
+
+	SfContext& immediate = Instance->GetImmediateContext();
+	for (UINT i = 0; i < numJobs; i++)
+		immediate.ExecuteDeferredCommands(&ContextPool[i], !restoreState);
+
+	Stats.ExecuteTime = MillisecondsSince(executeStart);
+
+	Jobs.clear();
+}
+
+}
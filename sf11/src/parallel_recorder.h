@@ -0,0 +1,80 @@
+#pragma once
+
+#include "d3d11_include.h"
+#include "context.h"
+#include <vector>
+#include <functional>
+#include <atomic>
+
+namespace sf11
+{
+
+// timings from the last SfParallelRecorder::Execute call, all times in milliseconds
+// record time is the wall time from fan out until every command list is finished
+// execute time covers the ExecuteDeferredCommands calls on the immediate context
+struct SfRecorderStats
+{
+	UINT NumJobs = 0;
+	UINT NumThreads = 0;
+	double RecordTime = 0;
+	double ExecuteTime = 0;
+	UINT64 DrawCalls = 0;
+
+	// draws per second across the record phase, this is the number to compare between thread counts
+	double GetDrawsPerSecond() const { return RecordTime > 0 ? DrawCalls / (RecordTime / 1000.0) : 0; }
+};
+
+// records a list of jobs on the instance's job system and plays the results back on the immediate context
+// each job gets its own deferred context from a pool owned by the recorder, contexts are reused between calls
+// command lists are always executed in the order the jobs were added, regardless of which thread recorded them
+// jobs start with cleared context state, the whole pipeline needs to be set up inside each job
+class SfParallelRecorder
+{
+public:
+
+	// the job receives its deferred context and its index in the job list
+	// the return value is the number of draws it recorded, used only for stats
+	using RecordJob = std::function<UINT(SfContext&, UINT)>;
+
+private:
+
+	class SfInstance* Instance = nullptr;
+
+	std::vector<SfContext_Deferred> ContextPool;
+	std::vector<RecordJob> Jobs;
+	std::vector<UINT> JobDraws;
+
+	UINT NumThreads = 1;
+	std::atomic<UINT> NextJob = 0;
+
+	SfRecorderStats Stats;
+
+	void RunJobs();
+
+public:
+
+	// numThreads counts the calling thread, 0 uses every thread of the job system
+	SfParallelRecorder(class SfInstance& instance, UINT numThreads = 0);
+
+	SfParallelRecorder(const SfParallelRecorder&) = delete;
+	SfParallelRecorder& operator=(const SfParallelRecorder&) = delete;
+
+	// changes how many threads record, used to measure scaling between 1 and N threads
+	// capped at the number of threads in the job system
+	void SetNumThreads(UINT numThreads);
+	UINT GetNumThreads() const { return NumThreads; }
+
+	// queues a job for the next Execute
+	void AddJob(RecordJob job);
+
+	// records every queued job in parallel then executes the command lists on the immediate context
+	// restoreState keeps the immediate context state intact across the command lists
+	void Execute(bool restoreState = false);
+
+	// drops queued jobs without recording them
+	void Clear() { Jobs.clear(); }
+
+	const SfRecorderStats& GetStats() const { return Stats; }
+};
+
+}
@@ -0,0 +1,49 @@
+#include "pipeline_state.h"
+#include "instance.h"
+#include "sfassert.h"
+#include "hash.h"
+
+namespace sf11
+{
+
+SfPipelineState::SfPipelineState(SfInstance* instance, const PipelineStateCreateParams& params)
+	: Data(std::make_shared<PipelineStateData>())
+{
+	sfAssert(params.Program, "pipeline state requires a shader program");
+	sfAssert(!params.BlendState || params.BlendState.Data->Instance == instance, "cannot use blend state from another instance");
+	sfAssert(!params.DepthStencilState || params.DepthStencilState.Data->Instance == instance, "cannot use depth stencil state from another instance");
+
+	Data->Instance = instance;
+	Data->Params = params;
+
+	const SfShaderProgram& program = params.Program;
+	EShaderStage shaders = program.GetActiveShaders();
+
+	PipelineKey& key = Data->Key;
+	memset(&key, 0, sizeof(PipelineKey));
+
+	key.VertexShader = program.GetVertexShader().GetShader();
+	key.InputLayout = program.GetVertexShader().GetInputLayout();
+	if (shaders & EShaderStage::Hull) key.HullShader = program.GetHullShader().GetShader();
+	if (shaders & EShaderStage::Domain) key.DomainShader = program.GetDomainShader().GetShader();
+	if (shaders & EShaderStage::Geometry) key.GeometryShader = program.GetGeometryShader().GetShader();
+	key.PixelShader = program.GetPixelShader().GetShader();
+
+	key.BlendState = params.BlendState ? params.BlendState.Data->State.Get() : nullptr;
+	memcpy(key.BlendFactor, params.BlendFactor, sizeof(key.BlendFactor));
+	key.SampleMask = params.SampleMask;
+
+	key.DepthStencilState = params.DepthStencilState ?
+		params.DepthStencilState.Data->State.Get() :
+		instance->GetDepthState(params.DepthState);
+	key.StencilRef = params.StencilRef;
+
+	key.RasterizerState = params.Rasterizer ?
+		params.Rasterizer.GetState() :
+		instance->GetRasterizer(params.CullMode, params.FillMode).GetState();
+	key.Topology = params.Topology;
+
+	Data->Hash = SfHashBytes(&key, sizeof(PipelineKey));
+}
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "d3d11_include.h"
+#include "shader_program.h"
+#include "blend_state.h"
+#include "depth_buffer.h"
+#include "rasterizer.h"
+
+namespace sf11
+{
+
+struct PipelineStateCreateParams
+{
+	SfShaderProgram Program;
+
+	// leave null for no blending
+	SfBlendState BlendState;
+	float BlendFactor[4] = { 1, 1, 1, 1 };
+	UINT SampleMask = 0xFFFFFFFF;
+
+	// Rasterizer is used instead of CullMode and FillMode when set
+	ECullMode CullMode = ECullMode::CullBack;
+	EFillMode FillMode = EFillMode::Solid;
+	SfRasterizer Rasterizer;
+
+	// DepthStencilState is used instead of DepthState when set
+	EDepthState DepthState = EDepthState::ReadWrite;
+	SfDepthStencilState DepthStencilState;
+	UINT StencilRef = 0;
+
+	D3D11_PRIMITIVE_TOPOLOGY Topology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+};
+
+// immutable bundle of the shaders, input layout, blend, rasterizer, depth stencil and topology state for a pass
+// bind with SfContext::BindPipelineState, only the parts that differ from the bound pipeline are sent to d3d
+// stages the program does not use are unbound, unlike SfContext::BindShaderProgram
+class SfPipelineState
+{
+	friend class SfInstance;
+	friend class SfContext;
+	friend class SfCommandBuffer;
+
+	// the resolved d3d objects, compared and hashed as raw bytes
+	struct PipelineKey
+	{
+		ID3D11VertexShader* VertexShader;
+		ID3D11HullShader* HullShader;
+		ID3D11DomainShader* DomainShader;
+		ID3D11GeometryShader* GeometryShader;
+		ID3D11PixelShader* PixelShader;
+		ID3D11InputLayout* InputLayout;
+		ID3D11BlendState* BlendState;
+		ID3D11DepthStencilState* DepthStencilState;
+		ID3D11RasterizerState* RasterizerState;
+		FLOAT BlendFactor[4];
+		UINT SampleMask;
+		UINT StencilRef;
+		D3D11_PRIMITIVE_TOPOLOGY Topology;
+	};
+
+	struct PipelineStateData
+	{
+		class SfInstance* Instance = nullptr;
+
+		// holds references to the objects the key points into
+		PipelineStateCreateParams Params;
+		PipelineKey Key;
+		UINT64 Hash = 0;
+	};
+
+	std::shared_ptr<PipelineStateData> Data;
+
+	SfPipelineState(class SfInstance* instance, const PipelineStateCreateParams& params);
+
+public:
+
+	const PipelineStateCreateParams& GetParams() const { return Data->Params; }
+	UINT64 GetHash() const { return Data->Hash; }
+
+	// true if both pipelines resolve to the same d3d state, even when they were created separately
+	bool IsEquivalent(const SfPipelineState& other) const
+	{
+		return Data->Hash == other.Data->Hash && memcmp(&Data->Key, &other.Data->Key, sizeof(PipelineKey)) == 0;
+	}
+
+	SF_DEF_OPERATORS_AND_DEFAULT(SfPipelineState)
+};
+
+}
@@ -0,0 +1,30 @@
+#include "rasterizer.h"
+
+namespace sf11
+{
+
+D3D11_RASTERIZER_DESC SfRasterizer::MakeDesc(const SfRasterizerDesc& desc)
+{
+	D3D11_RASTERIZER_DESC rast;
+	ZeroMemory(&rast, sizeof(D3D11_RASTERIZER_DESC));
+
+	rast.FillMode = desc.FillMode == EFillMode::Wireframe ? D3D11_FILL_WIREFRAME : D3D11_FILL_SOLID;
+	switch (desc.CullMode)
+	{
+		case ECullMode::CullBack: rast.CullMode = D3D11_CULL_BACK; break;
+		case ECullMode::CullFront: rast.CullMode = D3D11_CULL_FRONT; break;
+		case ECullMode::CullNone: rast.CullMode = D3D11_CULL_NONE; break;
+	}
+	rast.FrontCounterClockwise = desc.FrontCounterClockwise;
+	rast.DepthBias = desc.DepthBias;
+	rast.DepthBiasClamp = desc.DepthBiasClamp;
+	rast.SlopeScaledDepthBias = desc.SlopeScaledDepthBias;
+	rast.DepthClipEnable = desc.DepthClipEnable;
+	rast.ScissorEnable = desc.ScissorEnable;
+	rast.MultisampleEnable = desc.MultisampleEnable;
+	rast.AntialiasedLineEnable = desc.AntialiasedLineEnable;
+
+	return rast;
+}
+
+}
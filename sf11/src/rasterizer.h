@@ -20,29 +20,54 @@ enum class ECullMode
 	CullNone
 };
 
+// full rasterizer description, the defaults match the states used by SfContext::SetCullAndFillMode
+struct SfRasterizerDesc
+{
+	EFillMode FillMode = EFillMode::Solid;
+	ECullMode CullMode = ECullMode::CullBack;
+	bool FrontCounterClockwise = false;
+
+	// depth = depth + DepthBias * r + SlopeScaledDepthBias * max slope, clamped to DepthBiasClamp
+	int DepthBias = 0;
+	float DepthBiasClamp = 0;
+	float SlopeScaledDepthBias = 1;
+
+	bool DepthClipEnable = false;
+
+	// set the rect with SfContext::SetScissorRect
+	bool ScissorEnable = false;
+
+	bool MultisampleEnable = false;
+	bool AntialiasedLineEnable = false;
+};
+
 class SfRasterizer
 {
 	friend class SfInstance;
 	friend class SfContext;
+	friend class SfPipelineState;
+	friend class SfCommandBuffer;
 
 	struct RasterizerData
 	{
-		EFillMode FillMode;
-		ECullMode CullMode;
+		SfRasterizerDesc Desc;
 		ComPtr<ID3D11RasterizerState> State;
 	};
 
 	std::shared_ptr<RasterizerData> Data;
 
+	// zeroed d3d desc, used as the cache key
+	static D3D11_RASTERIZER_DESC MakeDesc(const SfRasterizerDesc& desc);
+
 public:
-	EFillMode GetFillMode() const { return Data->FillMode; }
-	ECullMode GetCullMode() const { return Data->CullMode; }
+	const SfRasterizerDesc& GetDesc() const { return Data->Desc; }
+	EFillMode GetFillMode() const { return Data->Desc.FillMode; }
+	ECullMode GetCullMode() const { return Data->Desc.CullMode; }
 
 	SF_DEF_OPERATORS_AND_DEFAULT(SfRasterizer)
 
 private:
-	ID3D11RasterizerState* GetState() { return Data->State.Get(); }
-	ID3D11RasterizerState** GetPtrAddress() { return &Data->State; }
+	ID3D11RasterizerState* GetState() const { return Data->State.Get(); }
 };
 
 }
\ No newline at end of file
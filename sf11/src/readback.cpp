@@ -0,0 +1,145 @@
+#include "readback.h"
+#include "hash.h"
+#include "sfassert.h"
+
+namespace sf11
+{
+
+UINT64 SfStagingPool::HashDesc(const StagingDesc& desc)
+{
+	return SfHashBytes(&desc, sizeof(desc));
+}
+
+ComPtr<ID3D11Resource> SfStagingPool::FindFree(const StagingDesc& desc)
+{
+	std::lock_guard<std::mutex> lock(Core->Mutex);
+
+	// a hash match alone is not enough, a collision would hand out a resource of the wrong size or format
+	auto range = Core->FreeResources.equal_range(HashDesc(desc));
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (memcmp(&it->second.Desc, &desc, sizeof(StagingDesc)) != 0) continue;
+		ComPtr<ID3D11Resource> resource = std::move(it->second.Resource);
+		Core->FreeResources.erase(it);
+		return resource;
+	}
+	return nullptr;
+}
+
+ComPtr<ID3D11Resource> SfStagingPool::AcquireBuffer(ID3D11Device* device, UINT size, StagingDesc& desc)
+{
+	memset(&desc, 0, sizeof(desc));
+	desc.ByteWidth = size;
+
+	if (ComPtr<ID3D11Resource> resource = FindFree(desc))
+		return resource;
+
+	D3D11_BUFFER_DESC bufferDesc;
+	ZeroMemory(&bufferDesc, sizeof(D3D11_BUFFER_DESC));
+	bufferDesc.ByteWidth = size;
+	bufferDesc.Usage = D3D11_USAGE_STAGING;
+	bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+
+	ComPtr<ID3D11Buffer> buffer;
+	sfAssertHR(device->CreateBuffer(&bufferDesc, NULL, &buffer), "could not create staging buffer");
+	return buffer;
+}
+
+ComPtr<ID3D11Resource> SfStagingPool::AcquireTexture(ID3D11Device* device, UINT dimensions, const void* textureDesc, StagingDesc& desc)
+{
+	// staging copies keep size, format, layout and cube flag but drop every bind flag
+	memset(&desc, 0, sizeof(desc));
+	desc.Dimensions = dimensions;
+	switch (dimensions)
+	{
+		case 1:
+			desc.Desc1D = *(const D3D11_TEXTURE1D_DESC*)textureDesc;
+			desc.Desc1D.Usage = D3D11_USAGE_STAGING; desc.Desc1D.BindFlags = 0; desc.Desc1D.CPUAccessFlags = D3D11_CPU_ACCESS_READ; desc.Desc1D.MiscFlags = 0;
+			break;
+		case 2:
+			desc.Desc2D = *(const D3D11_TEXTURE2D_DESC*)textureDesc;
+			desc.Desc2D.Usage = D3D11_USAGE_STAGING; desc.Desc2D.BindFlags = 0; desc.Desc2D.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+			desc.Desc2D.MiscFlags &= D3D11_RESOURCE_MISC_TEXTURECUBE;
+			break;
+		case 3:
+			desc.Desc3D = *(const D3D11_TEXTURE3D_DESC*)textureDesc;
+			desc.Desc3D.Usage = D3D11_USAGE_STAGING; desc.Desc3D.BindFlags = 0; desc.Desc3D.CPUAccessFlags = D3D11_CPU_ACCESS_READ; desc.Desc3D.MiscFlags = 0;
+			break;
+		default:
+			sfAssert(false, "cannot read back texture with unknown dimensions");
+			return nullptr;
+	}
+
+	if (ComPtr<ID3D11Resource> resource = FindFree(desc))
+		return resource;
+
+	ComPtr<ID3D11Resource> resource;
+	switch (dimensions)
+	{
+		case 1:
+		{
+			ComPtr<ID3D11Texture1D> tex;
+			sfAssertHR(device->CreateTexture1D(&desc.Desc1D, NULL, &tex), "could not create staging texture1D");
+			resource = tex;
+			break;
+		}
+		case 2:
+		{
+			ComPtr<ID3D11Texture2D> tex;
+			sfAssertHR(device->CreateTexture2D(&desc.Desc2D, NULL, &tex), "could not create staging texture2D");
+			resource = tex;
+			break;
+		}
+		case 3:
+		{
+			ComPtr<ID3D11Texture3D> tex;
+			sfAssertHR(device->CreateTexture3D(&desc.Desc3D, NULL, &tex), "could not create staging texture3D");
+			resource = tex;
+			break;
+		}
+	}
+	return resource;
+}
+
+ComPtr<ID3D11Query> SfStagingPool::AcquireQuery(ID3D11Device* device)
+{
+	{
+		std::lock_guard<std::mutex> lock(Core->Mutex);
+		if (!Core->FreeQueries.empty())
+		{
+			ComPtr<ID3D11Query> query = Core->FreeQueries.back();
+			Core->FreeQueries.pop_back();
+			return query;
+		}
+	}
+
+	D3D11_QUERY_DESC desc = {};
+	desc.Query = D3D11_QUERY_EVENT;
+
+	ComPtr<ID3D11Query> query;
+	sfAssertHR(device->CreateQuery(&desc, &query), "could not create event query");
+	return query;
+}
+
+void SfStagingPool::Trim()
+{
+	std::lock_guard<std::mutex> lock(Core->Mutex);
+	Core->FreeResources.clear();
+	Core->FreeQueries.clear();
+}
+
+SfReadback::ReadbackData::~ReadbackData()
+{
+	sfAssert(!IsMapped, "readback destroyed while mapped");
+
+	std::shared_ptr<SfStagingPool::PoolCore> pool = Pool.lock();
+	if (!pool) return;
+
+	std::lock_guard<std::mutex> lock(pool->Mutex);
+	if (Staging) pool->FreeResources.insert({ SfStagingPool::HashDesc(PoolDesc), { PoolDesc, std::move(Staging) } });
+
+	// a fence that never signaled may still be pending on the gpu, ending it again on reuse is fine
+	if (Fence) pool->FreeQueries.push_back(std::move(Fence));
+}
+
+}
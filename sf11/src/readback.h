@@ -0,0 +1,105 @@
+#pragma once
+
+#include "d3d11_include.h"
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace sf11
+{
+
+// staging resources and event queries kept by the instance for reuse between readbacks
+// a staging resource is matched by its full description, buffers by their byte size
+class SfStagingPool
+{
+	friend class SfReadback;
+
+public:
+
+	// what a staging resource is matched on, zeroed before filling since it is hashed and compared as raw bytes
+	struct StagingDesc
+	{
+		// 0 for buffers
+		UINT Dimensions;
+		union
+		{
+			UINT ByteWidth;
+			D3D11_TEXTURE1D_DESC Desc1D;
+			D3D11_TEXTURE2D_DESC Desc2D;
+			D3D11_TEXTURE3D_DESC Desc3D;
+		};
+	};
+
+private:
+
+	struct FreeResource
+	{
+		StagingDesc Desc;
+		ComPtr<ID3D11Resource> Resource;
+	};
+
+	struct PoolCore
+	{
+		std::mutex Mutex;
+
+		// keyed by the hash of the desc, entries are compared on the whole desc like SfStateObjectCache
+		std::unordered_multimap<UINT64, FreeResource> FreeResources;
+		std::vector<ComPtr<ID3D11Query>> FreeQueries;
+	};
+
+	static UINT64 HashDesc(const StagingDesc& desc);
+	ComPtr<ID3D11Resource> FindFree(const StagingDesc& desc);
+
+	std::shared_ptr<PoolCore> Core = std::make_shared<PoolCore>();
+
+public:
+
+	// desc is filled with the description the resource must be returned under
+	ComPtr<ID3D11Resource> AcquireBuffer(ID3D11Device* device, UINT size, StagingDesc& desc);
+	ComPtr<ID3D11Resource> AcquireTexture(ID3D11Device* device, UINT dimensions, const void* textureDesc, StagingDesc& desc);
+	ComPtr<ID3D11Query> AcquireQuery(ID3D11Device* device);
+
+	std::weak_ptr<PoolCore> GetCore() const { return Core; }
+
+	// releases every pooled object that is not in use
+	void Trim();
+};
+
+// a copy of gpu data on its way to the cpu
+// created by SfContext::ReadbackResource and polled with SfContext::TryMapReadback or TryReadReadback
+// the staging resource and fence go back to the instance pool when the last handle is destroyed
+class SfReadback
+{
+	friend class SfContext;
+
+	struct ReadbackData
+	{
+		std::weak_ptr<SfStagingPool::PoolCore> Pool;
+		class SfInstance* Instance = nullptr;
+
+		ComPtr<ID3D11Resource> Staging;
+		ComPtr<ID3D11Query> Fence;
+		SfStagingPool::StagingDesc PoolDesc = {};
+
+		// byte size for buffers, 0 for textures
+		UINT Size = 0;
+
+		bool Signaled = false;
+		bool IsMapped = false;
+
+		~ReadbackData();
+	};
+
+	std::shared_ptr<ReadbackData> Data;
+
+public:
+
+	// true once the fence has been seen, does not query the gpu
+	bool IsSignaled() const { return Data->Signaled; }
+
+	UINT GetSize() const { return Data->Size; }
+
+	SF_DEF_OPERATORS_AND_DEFAULT(SfReadback)
+};
+
+}
@@ -0,0 +1,208 @@
+#include "render_queue.h"
+#include "context.h"
+#include "blend_state.h"
+#include "shader_program.h"
+#include "sfassert.h"
+
+namespace sf11
+{
+
+// mixes a pointer down to the requested number of bits
+// equal pointers always land on equal bits, collisions only cost some sorting quality
+static UINT64 HashBits(UINT64 value, UINT bits)
+{
+	value ^= value >> 33;
+	value *= 0xff51afd7ed558ccdull;
+	value ^= value >> 33;
+	return value & ((1ull << bits) - 1);
+}
+
+static UINT64 QuantizeDepth(float depth, UINT bits)
+{
+	depth = depth > 1 ? 1 : (depth < 0 ? 0 : depth);
+	return (UINT64)(depth * (float)((1u << bits) - 1));
+}
+
+UINT64 SfRenderQueue::MakeSortKey(const SfDrawItem& item)
+{
+	UINT64 program = (UINT64)(item.Program ? item.Program->Data.get() : nullptr);
+
+	UINT64 state = (UINT64)(item.BlendState ? item.BlendState->Data.get() : nullptr);
+	state ^= ((UINT64)item.DepthState << 0) | ((UINT64)item.CullMode << 4) | ((UINT64)item.FillMode << 8) | ((UINT64)item.Topology << 12);
+
+	UINT64 resources = (UINT64)(item.VertexBuffer ? item.VertexBuffer->Data.get() : nullptr);
+	for (UINT i = 0; i < item.NumShaderResources; i++)
+		resources = resources * 31 + (UINT64)(item.ShaderResources[i] ? item.ShaderResources[i]->Data.get() : nullptr);
+
+	if (!item.Transparent)
+	{
+		// | 0 | program 15 | state 12 | resources 16 | depth 20 |
+		return
+			(HashBits(program, 15) << 48) |
+			(HashBits(state, 12) << 36) |
+			(HashBits(resources, 16) << 20) |
+			QuantizeDepth(item.Depth, 20);
+	}
+
+	// | 1 | inverted depth 24 | program 15 | state 12 | resources 12 |
+	return
+		(1ull << 63) |
+		(((1ull << 24) - 1 - QuantizeDepth(item.Depth, 24)) << 39) |
+		(HashBits(program, 15) << 24) |
+		(HashBits(state, 12) << 12) |
+		HashBits(resources, 12);
+}
+
+void SfRenderQueue::Submit(const SfDrawItem& item)
+{
+	SF_CHECK(item.Program, "cannot submit a draw item without a shader program");
+	SF_CHECK(item.NumShaderResources <= SF_DRAW_ITEM_MAX_RESOURCES, "too many shader resources for draw item");
+	SF_CHECK(item.NumConstantBuffers <= SF_DRAW_ITEM_MAX_CONSTANT_BUFFERS, "too many constant buffers for draw item");
+	SF_CHECK(!item.Constants || item.ConstantsSlot >= item.NumConstantBuffers, "constant allocation slot overlaps the draw item constant buffers");
+
+	Keys.push_back({ MakeSortKey(item), (UINT)Items.size() });
+	Items.push_back(item);
+}
+
+void SfRenderQueue::Reserve(UINT count)
+{
+	Items.reserve(count);
+	Keys.reserve(count);
+	SortScratch.reserve(count);
+}
+
+void SfRenderQueue::SortKeys()
+{
+	const UINT count = (UINT)Keys.size();
+	SortScratch.resize(count);
+
+	SortEntry* src = Keys.data();
+	SortEntry* dst = SortScratch.data();
+
+	// least significant byte first, 8 stable counting passes
+	for (UINT shift = 0; shift < 64; shift += 8)
+	{
+		UINT offsets[256] = {};
+		for (UINT i = 0; i < count; i++)
+			offsets[(src[i].Key >> shift) & 0xFF]++;
+
+		// every key shares this byte, the pass would not move anything
+		if (offsets[(src[0].Key >> shift) & 0xFF] == count)
+			continue;
+
+		UINT total = 0;
+		for (UINT b = 0; b < 256; b++)
+		{
+			UINT c = offsets[b];
+			offsets[b] = total;
+			total += c;
+		}
+
+		for (UINT i = 0; i < count; i++)
+			dst[offsets[(src[i].Key >> shift) & 0xFF]++] = src[i];
+
+		std::swap(src, dst);
+	}
+
+	if (src != Keys.data())
+		memcpy(Keys.data(), src, sizeof(SortEntry) * count);
+}
+
+void SfRenderQueue::Replay(SfContext& context)
+{
+	const SfDrawItem* last = nullptr;
+
+	for (const SortEntry& entry : Keys)
+	{
+		const SfDrawItem& item = Items[entry.Index];
+
+		if (!last || *last->Program != *item.Program)
+			context.BindShaderProgram(*item.Program);
+
+		const bool blendChanged = !last ||
+			(last->BlendState ? last->BlendState->Data.get() : nullptr) !=
+			(item.BlendState ? item.BlendState->Data.get() : nullptr);
+		if (blendChanged)
+		{
+			if (item.BlendState) context.BindBlendState(*item.BlendState);
+			else context.ClearBlendState();
+		}
+
+		if (!last || last->DepthState != item.DepthState)
+			context.SetDepthBufferState(item.DepthState);
+
+		if (!last || last->CullMode != item.CullMode || last->FillMode != item.FillMode)
+			context.SetCullAndFillMode(item.CullMode, item.FillMode);
+
+		if (!last || last->Topology != item.Topology)
+			context.SetPrimitiveTopology(item.Topology);
+
+		if (item.VertexBuffer)
+		{
+			const bool buffersChanged = !last ||
+				!last->VertexBuffer || *last->VertexBuffer != *item.VertexBuffer ||
+				(last->InstanceBuffer ? last->InstanceBuffer->Data.get() : nullptr) !=
+				(item.InstanceBuffer ? item.InstanceBuffer->Data.get() : nullptr);
+			if (buffersChanged)
+			{
+				if (item.InstanceBuffer) context.BindVertexBuffer(*item.VertexBuffer, *item.InstanceBuffer);
+				else context.BindVertexBuffer(*item.VertexBuffer);
+			}
+		}
+
+		if (item.NumShaderResources > 0)
+		{
+			bool resourcesChanged = !last ||
+				last->NumShaderResources != item.NumShaderResources ||
+				last->ResourceStages.Index != item.ResourceStages.Index;
+			for (UINT i = 0; i < item.NumShaderResources && !resourcesChanged; i++)
+				resourcesChanged =
+					(last->ShaderResources[i] ? last->ShaderResources[i]->Data.get() : nullptr) !=
+					(item.ShaderResources[i] ? item.ShaderResources[i]->Data.get() : nullptr);
+			if (resourcesChanged)
+				context.BindShaderResources((const SfResource**)item.ShaderResources, item.NumShaderResources, 0, item.ResourceStages);
+		}
+
+		// one slot at a time, the state cache drops the ones that are already bound, null slots bind null
+		for (UINT i = 0; i < item.NumConstantBuffers; i++)
+			context.BindConstantBuffers(item.ConstantBuffers[i], 1, i, item.ConstantBufferStages);
+
+		if (item.Constants)
+			context.BindConstantAllocation(item.Constants, item.ConstantsSlot, item.ConstantBufferStages);
+
+		switch (item.DrawType)
+		{
+			case EDrawType::Draw:
+				context.Draw(item.Count, item.Start);
+				break;
+			case EDrawType::DrawIndexed:
+				context.DrawIndexed(item.Count, item.Start, item.BaseVertex);
+				break;
+			case EDrawType::DrawInstanced:
+				context.DrawInstanced(item.Count, item.InstanceCount, item.Start, item.StartInstance);
+				break;
+			case EDrawType::DrawIndexedInstanced:
+				context.DrawIndexedInstanced(item.Count, item.InstanceCount, item.Start, item.BaseVertex, item.StartInstance);
+				break;
+		}
+
+		last = &item;
+	}
+}
+
+void SfRenderQueue::Flush(SfContext& context)
+{
+	if (Items.empty()) return;
+
+	SortKeys();
+	Replay(context);
+	Clear();
+}
+
+void SfRenderQueue::Clear()
+{
+	Items.clear();
+	Keys.clear();
+}
+
+}
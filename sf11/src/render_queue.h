@@ -0,0 +1,114 @@
+#pragma once
+
+#include "d3d11_include.h"
+#include "rasterizer.h"
+#include "depth_buffer.h"
+#include "buffer.h"
+#include "constant_ring.h"
+#include <vector>
+
+namespace sf11
+{
+
+enum class EDrawType
+{
+	Draw,
+	DrawIndexed,
+	DrawInstanced,
+	DrawIndexedInstanced
+};
+
+// maximum number of shader resources and constant buffers a single draw item can carry
+constexpr UINT SF_DRAW_ITEM_MAX_RESOURCES = 8;
+constexpr UINT SF_DRAW_ITEM_MAX_CONSTANT_BUFFERS = 4;
+
+// everything needed to issue one draw call
+// handles are referenced rather than copied, they must stay alive until the queue is flushed
+struct SfDrawItem
+{
+	const class SfShaderProgram* Program = nullptr;
+
+	// null clears the blend state
+	const class SfBlendState* BlendState = nullptr;
+
+	EDepthState DepthState = EDepthState::ReadWrite;
+	ECullMode CullMode = ECullMode::CullBack;
+	EFillMode FillMode = EFillMode::Solid;
+	D3D11_PRIMITIVE_TOPOLOGY Topology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+
+	// the linked index buffer of the vertex buffer is bound with it
+	// leave null for draws that generate their vertices in the shader
+	const SfBuffer_Vertex* VertexBuffer = nullptr;
+	const SfBuffer_Instance* InstanceBuffer = nullptr;
+
+	// bound to slots 0 - NumShaderResources for ResourceStages
+	const class SfResource* ShaderResources[SF_DRAW_ITEM_MAX_RESOURCES] = {};
+	UINT NumShaderResources = 0;
+	EShaderStage ResourceStages = EShaderStage::Pixel;
+
+	// bound to slots 0 - NumConstantBuffers for ConstantBufferStages
+	const SfBuffer_Constant* ConstantBuffers[SF_DRAW_ITEM_MAX_CONSTANT_BUFFERS] = {};
+	UINT NumConstantBuffers = 0;
+	EShaderStage ConstantBufferStages = EShaderStage::Pixel | EShaderStage::Vertex;
+
+	// per draw constants pushed to an SfConstantRing, bound to ConstantsSlot for ConstantBufferStages when not empty
+	// the ring has to be unmapped before the queue is flushed
+	SfConstantAllocation Constants;
+	UINT ConstantsSlot = SF_DRAW_ITEM_MAX_CONSTANT_BUFFERS;
+
+	EDrawType DrawType = EDrawType::DrawIndexed;
+	UINT Count = 0;         // vertex or index count, per instance for instanced draws
+	UINT InstanceCount = 1;
+	UINT Start = 0;         // start vertex or start index
+	int BaseVertex = 0;
+	UINT StartInstance = 0;
+
+	// normalized view depth from 0 (near) to 1 (far)
+	// opaque items are drawn front to back within the same state, transparent items back to front
+	float Depth = 0;
+	bool Transparent = false;
+};
+
+// collects draw items and replays them through a context in an order that minimizes state changes
+// opaque items are grouped by program, then state, then resources, and come before all transparent items
+// transparent items are sorted by depth first so blending stays correct
+// a queue is not thread safe, use one per recording thread
+class SfRenderQueue
+{
+	struct SortEntry
+	{
+		UINT64 Key;
+		UINT Index;
+	};
+
+	std::vector<SfDrawItem> Items;
+
+	// kept between flushes so steady state frames do not allocate
+	std::vector<SortEntry> Keys;
+	std::vector<SortEntry> SortScratch;
+
+	static UINT64 MakeSortKey(const SfDrawItem& item);
+	void SortKeys();
+	void Replay(class SfContext& context);
+
+public:
+
+	SfRenderQueue() = default;
+
+	// adds a draw to the queue, nothing is sent to the context until Flush
+	void Submit(const SfDrawItem& item);
+
+	// preallocate room for the expected number of draws per flush
+	void Reserve(UINT count);
+
+	UINT GetNumItems() const { return (UINT)Items.size(); }
+
+	// sorts the queued items, issues them on the given context and empties the queue
+	// works on the immediate context as well as deferred contexts
+	void Flush(class SfContext& context);
+
+	// drops every queued item without drawing
+	void Clear();
+};
+
+}
@@ -1 +1,18 @@
 #include "resource.h"
+
+namespace sf11
+{
+
+SfSlotPool<SfResource::ResourceData*, SfResource>& SfResource::GetRegistry()
+{
+	// never freed, resources held in globals may be released after static destruction
+	static SfSlotPool<ResourceData*, SfResource>* registry = new SfSlotPool<ResourceData*, SfResource>();
+	return *registry;
+}
+
+SfResource::ResourceData* SfResource::Resolve(SfResourceHandle handle)
+{
+	return GetRegistry().Get(handle);
+}
+
+}
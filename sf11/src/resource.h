@@ -5,19 +5,29 @@
 #include "shader.h"
 #include <memory>
 #include "usage.h"
+#include "slot_pool.h"
 
 namespace sf11
 {
 
+// non owning 32 bit handle to a texture or buffer, see SfResource::GetHandle
+typedef SfHandle<class SfResource> SfResourceHandle;
+
 // base resource class for textures and buffers
 class SfResource
 {
 	friend class SfInstance;
 	friend class SfContext;
 	friend class SfWindow;
+	friend class SfRenderQueue;
+	friend class SfCommandBuffer;
+	friend class SfFrameCapture;
+	friend class SfTraceReplayer;
 	
 protected:
 
+	// the hot part is what binds read and fits in one cache line
+	// buffer and texture data is cold and allocated separately, only the one matching the resource exists
 	struct ResourceData
 	{
 		struct BufferData
@@ -30,13 +40,18 @@ protected:
 
 			D3D11_BUFFER_DESC BufferDesc;
 			DXGI_FORMAT IndexFormat;
+			D3D11_SHADER_RESOURCE_VIEW_DESC SrvDesc;
+			D3D11_UNORDERED_ACCESS_VIEW_DESC UavDesc;
 
 			// associated index or vertex buffer to be bound at the same time as this
 			std::weak_ptr<ResourceData> LinkedBuffer;
 
+			// cpu copy of a static constant buffer, only kept when SfInstance::NeedsWholeConstantUpdates
+			// partial updates write here and upload the whole buffer on contexts that cannot update part of it
+			std::unique_ptr<BYTE[]> Shadow;
+
 			BufferData() = default;
-			BufferData(UINT typeSize, UINT numElements, 
-				UINT defaultSlot, EShaderStage stage) : 
+			BufferData(UINT typeSize, UINT numElements) : 
 				TypeSize(typeSize),
 				NumElements(numElements)
 			{}
@@ -67,40 +82,44 @@ protected:
 				D3D11_TEXTURE3D_DESC TextureDesc3D;
 			};
 
-			//union
-			//{
-				TextureParams1D Params1D;
-				TextureParams2D Params2D;
-				TextureParams3D Params3D;
-			//};
+			// 1d and 2d textures only fill their part
+			TextureParams3D Params;
 
 			TextureData() = default;
 			~TextureData() {}
 		};
 
-		class SfInstance* Instance = nullptr;
-
 		ID3D11ShaderResourceView* ShaderResource = nullptr;
 		ID3D11UnorderedAccessView* UnorderedAccess = nullptr;
 		ID3D11Resource* Resource = nullptr;
-		D3D11_SHADER_RESOURCE_VIEW_DESC SrvDesc;
-		D3D11_UNORDERED_ACCESS_VIEW_DESC UavDesc;
+		class SfInstance* Instance = nullptr;
 		SfUsage Usage = SfUsage::Static;
-		EShaderStage DefaultStage = EShaderStage::None;
 		UINT DefaultSlot = 0;
+		EShaderStage DefaultStage = EShaderStage::None;
 		bool IsMapped = false;
-		
-	//	union
-	//	{
-			BufferData Buffer;
-			TextureData Texture;
-	//	};
+
+		// slot in the resource registry, released with the data
+		SfResourceHandle Handle;
+
+		// null unless this is a buffer or a texture, render targets, depth buffers and back buffers are textures
+		std::unique_ptr<BufferData> Buffer;
+		std::unique_ptr<TextureData> Texture;
 
 		ResourceData(SfInstance* instance, SfUsage usage = SfUsage::Static, UINT defaultSlot = -1, EShaderStage defaultStage = EShaderStage::Pixel) 
-			: Instance(instance), Usage(usage), DefaultSlot(defaultSlot), DefaultStage(defaultStage) {}
-		~ResourceData() {}
+			: Instance(instance), Usage(usage), DefaultSlot(defaultSlot), DefaultStage(defaultStage) { Handle = GetRegistry().Add(this); }
+		~ResourceData() { GetRegistry().Remove(Handle); }
+
+		ResourceData(const ResourceData&) = delete;
+		ResourceData& operator=(const ResourceData&) = delete;
 	};
 
+	// every live ResourceData is in one process wide registry, adds, removals and lookups are lock free
+	static SfSlotPool<ResourceData*, SfResource>& GetRegistry();
+
+	// null if the resource behind the handle was released
+	// the caller keeps the resource alive while it uses what this returns
+	static ResourceData* Resolve(SfResourceHandle handle);
+
 	std::shared_ptr<ResourceData> Data;
 	SfResource() = default;
 	SfResource(SfInstance* instance, SfUsage usage = SfUsage::Static, UINT defaultSlot = -1, EShaderStage defaultStage = EShaderStage::Pixel) 
@@ -128,6 +147,16 @@ protected:
 
 	ID3D11Resource* GetResource() const { return Data->Resource; }
 
+public:
+
+	// 4 byte handle that can be copied and stored without touching the reference count
+	// it does not keep the resource alive, a released resource leaves it stale rather than dangling
+	SfResourceHandle GetHandle() const { return Data ? Data->Handle : SfResourceHandle(); }
+	// only a snapshot, the resource can be released on another thread right after it returns
+	static bool IsHandleValid(SfResourceHandle handle) { return GetRegistry().IsValid(handle); }
+
+protected:
+
 	typedef ResourceData::TextureData TextureData;
 	typedef ResourceData::BufferData BufferData;
 };
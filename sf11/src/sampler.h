@@ -9,6 +9,7 @@ class SfSamplerState
 {
 	friend class SfInstance;
 	friend class SfContext;
+	friend class SfCommandBuffer;
 
 	struct SamplerStateData
 	{
@@ -13,6 +13,7 @@ std::unique_ptr<SfInstance> CreateInstance(const InstanceCreationParams& params)
 std::vector<SfAdapter> EnumerateAdapters()
 {
 	std::vector<SfAdapter> adapters;
+#ifdef _WIN32
 	IDXGIFactory* factory = NULL;
 	if (FAILED(CreateDXGIFactory(__uuidof(IDXGIFactory), (void**)&factory))) return adapters;
 
@@ -24,6 +25,7 @@ std::vector<SfAdapter> EnumerateAdapters()
 	}
 
 	if (factory) factory->Release();
+#endif
 
 	return std::move(adapters);
 }
@@ -1,28 +1,173 @@
 #include "sfassert.h"
 #include "d3d11_include.h"
-#include "comdef.h"
-#include <string>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#ifndef _WIN32
+#include <functional>
+#include <thread>
+#endif
 
-void sf11::sfAssert(bool condition, const char* message)
+namespace sf11
 {
-	if (!condition)
+
+namespace
+{
+
+constexpr UINT ErrorRingSize = 64;
+
+// a slot is readable while Sequence matches what the reader expects, writers clear it first and set it last
+struct ErrorSlot
+{
+	std::atomic<UINT64> Sequence = 0;
+	SfError Error;
+};
+
+ErrorSlot ErrorRing[ErrorRingSize];
+std::atomic<UINT64> LastSequence = 0;
+std::atomic<SfErrorCallback> ErrorCallback = nullptr;
+
+void CopyString(char* dst, size_t dstSize, const char* src)
+{
+	if (!src) src = "";
+	size_t i = 0;
+	for (; i + 1 < dstSize && src[i]; i++)
+		dst[i] = src[i];
+	dst[i] = 0;
+}
+
+DWORD GetThreadId()
+{
+#ifdef _WIN32
+	return GetCurrentThreadId();
+#else
+	// only used to tell errors apart, it does not match any os id
+	return (DWORD)std::hash<std::thread::id>()(std::this_thread::get_id());
+#endif
+}
+
+void DescribeResult(HRESULT hr, char* out, size_t outSize)
+{
+	char system[128] = {};
+#ifdef _WIN32
+	const DWORD length = FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+		NULL, (DWORD)hr, 0, system, sizeof(system), NULL);
+
+	// system messages end in a line break
+	for (DWORD i = length; i > 0 && (system[i - 1] == '\r' || system[i - 1] == '\n'); i--)
+		system[i - 1] = 0;
+#endif
+
+	snprintf(out, outSize, "%s (0x%08lX)%s%s", GetResultName(hr), (unsigned long)hr, system[0] ? ": " : "", system);
+}
+
+void Fail(HRESULT hr, const char* message)
+{
+	const UINT64 sequence = LastSequence.fetch_add(1, std::memory_order_relaxed) + 1;
+	ErrorSlot& slot = ErrorRing[sequence % ErrorRingSize];
+
+	SfError error;
+	error.Sequence = sequence;
+	error.Result = hr;
+	error.ThreadId = GetThreadId();
+	CopyString(error.Message, sizeof(error.Message), message ? message : "assertion failed");
+	if (hr != S_OK) DescribeResult(hr, error.Description, sizeof(error.Description));
+
+	slot.Sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.Error = error;
+	slot.Sequence.store(sequence, std::memory_order_release);
+
+	SfErrorCallback callback = ErrorCallback.load(std::memory_order_acquire);
+	if (callback && callback(error) == EErrorAction::Continue)
+		return;
+
+	char line[512];
+	snprintf(line, sizeof(line), "sf11: %s%s%s\n", error.Message, error.Description[0] ? "\n  " : "", error.Description);
+#ifdef _WIN32
+	OutputDebugStringA(line);
+#endif
+	fputs(line, stderr);
+
+#ifdef _WIN32
+	if (IsDebuggerPresent()) __debugbreak();
+#endif
+	abort();
+}
+
+}
+
+void sfAssert(bool condition, const char* message)
+{
+	if (!condition) Fail(S_OK, message);
+}
+
+void sfAssertHR(HRESULT hr, const char* message)
+{
+	if (FAILED(hr)) Fail(hr, message);
+}
+
+void SetErrorCallback(SfErrorCallback callback)
+{
+	ErrorCallback.store(callback, std::memory_order_release);
+}
+
+UINT GetRecentErrors(SfError* errors, UINT maxErrors)
+{
+	const UINT64 last = LastSequence.load(std::memory_order_acquire);
+	const UINT64 count = last < ErrorRingSize ? last : ErrorRingSize;
+	const UINT64 first = last - (count < maxErrors ? count : maxErrors) + 1;
+
+	UINT copied = 0;
+	for (UINT64 sequence = first; sequence <= last; sequence++)
 	{
-		MessageBox(NULL, message, "Assertion Failed", 0);
-		throw;
-		exit(1);
+		const ErrorSlot& slot = ErrorRing[sequence % ErrorRingSize];
+		if (slot.Sequence.load(std::memory_order_acquire) != sequence) continue;
+
+		SfError error = slot.Error;
+
+		// skip the slot if a writer started on it while it was copied
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.Sequence.load(std::memory_order_relaxed) != sequence) continue;
+
+		errors[copied++] = error;
 	}
+	return copied;
 }
- 
-void sf11::sfAssertHR(HRESULT hr, const char* message)
+
+UINT64 GetErrorCount()
+{
+	return LastSequence.load(std::memory_order_relaxed);
+}
+
+const char* GetResultName(HRESULT hr)
 {
-	if (!SUCCEEDED(hr))
+	switch (hr)
 	{
-		_com_error err(hr);
-		LPCTSTR hrMsg = err.ErrorMessage();
-		std::string str1(message);
-		std::string str2(hrMsg);
-		MessageBoxA(NULL, std::string(str1 + "\n" + str2).c_str(), "Assertion Failed", MB_OK);
-		throw;
-		exit(1);
+		case S_OK: return "S_OK";
+		case S_FALSE: return "S_FALSE";
+		case E_FAIL: return "E_FAIL";
+		case E_INVALIDARG: return "E_INVALIDARG";
+		case E_OUTOFMEMORY: return "E_OUTOFMEMORY";
+		case E_NOTIMPL: return "E_NOTIMPL";
+		case E_NOINTERFACE: return "E_NOINTERFACE";
+		case E_POINTER: return "E_POINTER";
+		case D3D11_ERROR_FILE_NOT_FOUND: return "D3D11_ERROR_FILE_NOT_FOUND";
+		case D3D11_ERROR_TOO_MANY_UNIQUE_STATE_OBJECTS: return "D3D11_ERROR_TOO_MANY_UNIQUE_STATE_OBJECTS";
+		case D3D11_ERROR_TOO_MANY_UNIQUE_VIEW_OBJECTS: return "D3D11_ERROR_TOO_MANY_UNIQUE_VIEW_OBJECTS";
+		case D3D11_ERROR_DEFERRED_CONTEXT_MAP_WITHOUT_INITIAL_DISCARD: return "D3D11_ERROR_DEFERRED_CONTEXT_MAP_WITHOUT_INITIAL_DISCARD";
+		case DXGI_ERROR_INVALID_CALL: return "DXGI_ERROR_INVALID_CALL";
+		case DXGI_ERROR_NOT_FOUND: return "DXGI_ERROR_NOT_FOUND";
+		case DXGI_ERROR_MORE_DATA: return "DXGI_ERROR_MORE_DATA";
+		case DXGI_ERROR_UNSUPPORTED: return "DXGI_ERROR_UNSUPPORTED";
+		case DXGI_ERROR_DEVICE_REMOVED: return "DXGI_ERROR_DEVICE_REMOVED";
+		case DXGI_ERROR_DEVICE_HUNG: return "DXGI_ERROR_DEVICE_HUNG";
+		case DXGI_ERROR_DEVICE_RESET: return "DXGI_ERROR_DEVICE_RESET";
+		case DXGI_ERROR_WAS_STILL_DRAWING: return "DXGI_ERROR_WAS_STILL_DRAWING";
+		case DXGI_ERROR_DRIVER_INTERNAL_ERROR: return "DXGI_ERROR_DRIVER_INTERNAL_ERROR";
+		case DXGI_ERROR_SDK_COMPONENT_MISSING: return "DXGI_ERROR_SDK_COMPONENT_MISSING";
+		default: return "unknown";
 	}
 }
+
+}
@@ -2,8 +2,72 @@
 
 #include "d3d11_include.h"
 
+// how much sf11 checks the arguments of binds, updates and draws
+// 0 compiles the checks out, 1 keeps cheap argument checks like slot ranges and null objects
+// 2 adds checks that look at other objects, like instance ownership, usage and mapped state
+// defaults to 2 in debug builds and 0 in release, sfAssert itself is never compiled out
+#ifndef SF_VALIDATION
+	#ifdef NDEBUG
+		#define SF_VALIDATION 0
+	#else
+		#define SF_VALIDATION 2
+	#endif
+#endif
+
+#if SF_VALIDATION >= 1
+	#define SF_CHECK(condition, message) ::sf11::sfAssert(condition, message)
+#else
+	#define SF_CHECK(condition, message) ((void)0)
+#endif
+
+#if SF_VALIDATION >= 2
+	#define SF_VALIDATE(condition, message) ::sf11::sfAssert(condition, message)
+#else
+	#define SF_VALIDATE(condition, message) ((void)0)
+#endif
+
 namespace sf11
 {
+	// failed checks are recorded in a lock free ring of the most recent errors, then passed to the error callback
 	void sfAssert(bool condition, const char* message = nullptr);
 	void sfAssertHR(HRESULT hr, const char* message = nullptr);
+
+	struct SfError
+	{
+		// counts up from 1 across the whole process
+		UINT64 Sequence = 0;
+
+		// S_OK for failed conditions
+		HRESULT Result = S_OK;
+
+		// the os thread id on windows, only an identifier elsewhere
+		DWORD ThreadId = 0;
+
+		// truncated to fit
+		char Message[256] = {};
+
+		// name and system text of Result, empty for S_OK
+		char Description[192] = {};
+	};
+
+	enum class EErrorAction
+	{
+		Abort,
+		Continue
+	};
+
+	// called on the failing thread after the error is recorded
+	// Continue returns from the failed check and carries on, which can crash later
+	// without a callback the error is written to the debug output and stderr, then the process aborts
+	typedef EErrorAction (*SfErrorCallback)(const SfError& error);
+	void SetErrorCallback(SfErrorCallback callback);
+
+	// copies up to maxErrors of the most recent errors, oldest first, returns how many were copied
+	UINT GetRecentErrors(SfError* errors, UINT maxErrors);
+
+	// errors recorded since startup, including the ones that have left the ring
+	UINT64 GetErrorCount();
+
+	// symbolic name of d3d, dxgi and common com results, "unknown" for anything else
+	const char* GetResultName(HRESULT hr);
 };
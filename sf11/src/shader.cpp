@@ -1,7 +1,10 @@
 #include "shader.h"
 #include "sfassert.h"
 #include "instance.h"
+#include "frame_arena.h"
+#ifdef _WIN32
 #include <d3dcompiler.h>
+#endif
 #include <map>
 
 // ugly macro but prevents all shaders from copy pasting this
@@ -10,7 +13,7 @@ sfAssertHR(Data->Instance->GetDevice()->Create##type##Shader( \
 	blob->GetBufferPointer(),                                 \
 	blob->GetBufferSize(),                                    \
 	NULL,                                                     \
-	&Data->##type##Shader),                                   \
+	&Data->type##Shader),                                     \
 	"could not create shader");
 
 namespace sf11
@@ -69,6 +72,16 @@ void SfShader::InitFromBlob(ID3DBlob* blob)
 			sfAssert(false, "");
 			break;
 	}
+
+	// keeps the bytecode reachable from the d3d shader for frame captures
+	ID3D11DeviceChild* shader =
+		Data->VertexShader ? (ID3D11DeviceChild*)Data->VertexShader.Get() :
+		Data->PixelShader ? (ID3D11DeviceChild*)Data->PixelShader.Get() :
+		Data->HullShader ? (ID3D11DeviceChild*)Data->HullShader.Get() :
+		Data->DomainShader ? (ID3D11DeviceChild*)Data->DomainShader.Get() :
+		Data->GeometryShader ? (ID3D11DeviceChild*)Data->GeometryShader.Get() :
+		(ID3D11DeviceChild*)Data->ComputeShader.Get();
+	if (shader) shader->SetPrivateDataInterface(SF_GUID_SHADER_BYTECODE, blob);
 }
 
 void SfShader::CompileText(EShaderStage stage, const std::string& fileOrString, const std::string& entryPoint, bool isFile)
@@ -78,6 +91,9 @@ void SfShader::CompileText(EShaderStage stage, const std::string& fileOrString,
 	std::string profile = Profiles[stage];
 	profile += "5_0";
 
+#ifndef _WIN32
+	sfAssert(false, (std::string("cannot compile shader ") + fileOrString + ", hlsl compilation needs d3dcompiler which is only available on windows").c_str());
+#else
 	UINT flags = D3DCOMPILE_ENABLE_STRICTNESS;
 #if !NDEBUG
 	flags |= D3DCOMPILE_DEBUG;
@@ -89,8 +105,15 @@ void SfShader::CompileText(EShaderStage stage, const std::string& fileOrString,
 	HRESULT hr = 0;
 	if (isFile)
 	{
+		// the wide path only lives for the call, so it comes from the frame arena
+		SfArenaScope scratch;
+		wchar_t* path = scratch.GetArena().Allocate<wchar_t>(fileOrString.size() + 1);
+		for (size_t i = 0; i < fileOrString.size(); i++)
+			path[i] = (wchar_t)(unsigned char)fileOrString[i];
+		path[fileOrString.size()] = 0;
+
 		HRESULT hr = D3DCompileFromFile(
-			std::wstring(fileOrString.begin(), fileOrString.end()).c_str(),
+			path,
 			NULL,
 			D3D_COMPILE_STANDARD_FILE_INCLUDE,
 			entryPoint.c_str(),
@@ -103,8 +126,9 @@ void SfShader::CompileText(EShaderStage stage, const std::string& fileOrString,
 	}
 	else
 	{
+		// source text is passed as is, d3dcompiler reads it as bytes
 		HRESULT hr = D3DCompile(
-			std::wstring(fileOrString.begin(), fileOrString.end()).c_str(),
+			fileOrString.data(),
 			fileOrString.size(),
 			NULL,
 			NULL,
@@ -140,6 +164,7 @@ void SfShader::CompileText(EShaderStage stage, const std::string& fileOrString,
 
 	sfAssert(Data->Blob, "blob was null after compiling shader");
 	InitFromBlob(Data->Blob.Get());
+#endif
 }
 
 void SfShader_Vertex::LinkInputLayout(const class SfInputLayout& layout)
@@ -33,6 +33,7 @@ struct EShaderStage
 	EShaderStage(BYTE index) : Index(index) {}
 	EShaderStage(int index) : Index(index) {}
 	EShaderStage(const EShaderStage& stage) : Index(stage.Index) {}
+	EShaderStage& operator=(const EShaderStage& stage) = default;
 };
 
 class SfShader
@@ -44,6 +44,7 @@ class SfShaderProgram
 {
 	friend class SfInstance;
 	friend class SfContext;
+	friend class SfRenderQueue;
 
 	struct ShaderProgramData
 	{
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "d3d11_include.h"
+#include "sfassert.h"
+#include <atomic>
+#include <memory>
+
+namespace sf11
+{
+
+// 32 bit handle into an SfSlotPool, low bits are the slot index and high bits the generation of the slot
+// copies are plain integer copies, a handle to a removed object is detected by its generation
+// 0 is the null handle, generations start at 1 so no live handle is 0
+template <typename Tag>
+struct SfHandle
+{
+	static constexpr UINT IndexBits = 20;
+	static constexpr UINT IndexMask = (1u << IndexBits) - 1;
+	static constexpr UINT GenerationMask = (1u << (32 - IndexBits)) - 1;
+
+	UINT Value = 0;
+
+	SfHandle() = default;
+	SfHandle(decltype(nullptr)) {}
+	SfHandle(UINT index, UINT generation) : Value(((generation & GenerationMask) << IndexBits) | index) {}
+
+	UINT GetIndex() const { return Value & IndexMask; }
+	UINT GetGeneration() const { return Value >> IndexBits; }
+
+	bool operator==(const SfHandle& other) const { return Value == other.Value; }
+	bool operator!=(const SfHandle& other) const { return Value != other.Value; }
+	operator bool() const { return Value != 0; }
+};
+
+// slot map, objects are stored in fixed pages that never move, so pointers to them stay valid until removal
+// freed slots are reused with the next generation
+// adds, removals and lookups are lock free and can run on any thread, T has to be a trivially copyable type such as a pointer
+// a lookup racing with the removal of the same object may still return it, the caller keeps objects alive while it uses them
+// Tag picks the handle type, so pools of pointers can hand out handles named after the object type
+template <typename T, typename Tag = T, UINT PageSize = 1024>
+class SfSlotPool
+{
+	typedef SfHandle<Tag> Handle;
+
+	static constexpr UINT MaxSlots = Handle::IndexMask + 1;
+	static constexpr UINT MaxPages = MaxSlots / PageSize;
+	static constexpr UINT NoSlot = ~0u;
+
+	struct Slot
+	{
+		std::atomic<T> Value = T();
+		std::atomic<UINT> Generation = 1;
+		std::atomic<UINT> NextFree = NoSlot;
+		std::atomic<bool> Alive = false;
+	};
+
+	std::atomic<Slot*> Pages[MaxPages] = {};
+	std::atomic<UINT> NumSlots = 0;
+	std::atomic<UINT> NumAlive = 0;
+
+	// index of the first free slot in the low half, the high half counts pops and pushes so a stale head never matches
+	std::atomic<UINT64> FreeHead = NoSlot;
+
+	Slot& GetSlot(UINT index) const { return Pages[index / PageSize].load(std::memory_order_acquire)[index % PageSize]; }
+
+	UINT PopFree()
+	{
+		UINT64 head = FreeHead.load(std::memory_order_acquire);
+		while ((UINT)head != NoSlot)
+		{
+			const UINT64 next = (((head >> 32) + 1) << 32) | GetSlot((UINT)head).NextFree.load(std::memory_order_relaxed);
+			if (FreeHead.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire)) return (UINT)head;
+		}
+		return NoSlot;
+	}
+
+	void PushFree(UINT index)
+	{
+		UINT64 head = FreeHead.load(std::memory_order_relaxed);
+		do GetSlot(index).NextFree.store((UINT)head, std::memory_order_relaxed);
+		while (!FreeHead.compare_exchange_weak(head, (((head >> 32) + 1) << 32) | index, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+public:
+
+	SfSlotPool() = default;
+	SfSlotPool(const SfSlotPool&) = delete;
+	SfSlotPool& operator=(const SfSlotPool&) = delete;
+	~SfSlotPool()
+	{
+		for (std::atomic<Slot*>& page : Pages) delete[] page.load();
+	}
+
+	Handle Add(const T& value)
+	{
+		UINT index = PopFree();
+		if (index == NoSlot)
+		{
+			index = NumSlots.fetch_add(1, std::memory_order_relaxed);
+			sfAssert(index < MaxSlots, "slot pool is full");
+
+			// threads that start the same page race to install it, the loser frees its copy
+			std::atomic<Slot*>& page = Pages[index / PageSize];
+			if (!page.load(std::memory_order_acquire))
+			{
+				Slot* fresh = new Slot[PageSize];
+				Slot* expected = nullptr;
+				if (!page.compare_exchange_strong(expected, fresh, std::memory_order_acq_rel)) delete[] fresh;
+			}
+		}
+
+		Slot& slot = GetSlot(index);
+		slot.Value.store(value, std::memory_order_relaxed);
+		slot.Alive.store(true, std::memory_order_release);
+		NumAlive.fetch_add(1, std::memory_order_relaxed);
+		return Handle(index, slot.Generation.load(std::memory_order_relaxed));
+	}
+
+	// returns false if the handle was already removed
+	bool Remove(Handle handle)
+	{
+		if (!IsValid(handle)) return false;
+
+		const UINT index = handle.GetIndex();
+		Slot& slot = GetSlot(index);
+		slot.Alive.store(false, std::memory_order_release);
+		slot.Value.store(T(), std::memory_order_relaxed);
+
+		// skip 0 when the generation wraps so the handle never becomes null
+		UINT generation = (slot.Generation.load(std::memory_order_relaxed) + 1) & Handle::GenerationMask;
+		if (generation == 0) generation = 1;
+		slot.Generation.store(generation, std::memory_order_release);
+
+		PushFree(index);
+		NumAlive.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	bool IsValid(Handle handle) const
+	{
+		const UINT index = handle.GetIndex();
+		if (!handle || !Pages[index / PageSize].load(std::memory_order_acquire)) return false;
+		const Slot& slot = GetSlot(index);
+		return slot.Alive.load(std::memory_order_acquire) && (slot.Generation.load(std::memory_order_acquire) & Handle::GenerationMask) == handle.GetGeneration();
+	}
+
+	// default value if the handle is stale
+	T Get(Handle handle) const
+	{
+		return IsValid(handle) ? GetSlot(handle.GetIndex()).Value.load(std::memory_order_acquire) : T();
+	}
+
+	UINT GetNumAlive() const { return NumAlive.load(std::memory_order_relaxed); }
+};
+
+}
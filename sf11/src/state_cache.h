@@ -0,0 +1,136 @@
+#pragma once
+
+#include "d3d11_include.h"
+
+namespace sf11
+{
+
+// number of shader stages that own bind slots
+// per-stage arrays are indexed by the bit position of the stage in EShaderStage
+constexpr UINT SF_NUM_SHADER_STAGES = 6;
+
+// how many d3d calls a context has sent to the driver and how many were dropped as redundant
+struct SfStateCacheStats
+{
+	UINT64 CallsIssued = 0;
+	UINT64 CallsSkipped = 0;
+};
+
+// mirror of the state currently set on a d3d context
+// every field starts out unknown (all bits set) so the first bind always reaches the driver
+// this struct must stay trivially copyable since it is invalidated with memset
+struct SfStateCache
+{
+	ID3D11VertexShader* VertexShader;
+	ID3D11HullShader* HullShader;
+	ID3D11DomainShader* DomainShader;
+	ID3D11GeometryShader* GeometryShader;
+	ID3D11PixelShader* PixelShader;
+	ID3D11ComputeShader* ComputeShader;
+	ID3D11InputLayout* InputLayout;
+
+	// inputs, these are evicted by the runtime when the same resource is bound for output
+	ID3D11ShaderResourceView* SRVs[SF_NUM_SHADER_STAGES][D3D11_COMMONSHADER_INPUT_RESOURCE_REGISTER_COUNT];
+	ID3D11Buffer* CBs[SF_NUM_SHADER_STAGES][D3D11_COMMONSHADER_CONSTANT_BUFFER_HW_SLOT_COUNT];
+	UINT CBFirstConstants[SF_NUM_SHADER_STAGES][D3D11_COMMONSHADER_CONSTANT_BUFFER_HW_SLOT_COUNT];
+	UINT CBNumConstants[SF_NUM_SHADER_STAGES][D3D11_COMMONSHADER_CONSTANT_BUFFER_HW_SLOT_COUNT];
+	ID3D11Buffer* VertexBuffers[2];
+	UINT VertexStrides[2];
+	UINT VertexOffsets[2];
+	ID3D11Buffer* IndexBuffer;
+	DXGI_FORMAT IndexFormat;
+	UINT IndexOffset;
+
+	// outputs
+	ID3D11RenderTargetView* RTVs[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT];
+	ID3D11DepthStencilView* DSV;
+	ID3D11UnorderedAccessView* ComputeUAVs[D3D11_PS_CS_UAV_REGISTER_COUNT];
+
+	ID3D11SamplerState* Samplers[SF_NUM_SHADER_STAGES][D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];
+	ID3D11BlendState* BlendState;
+	FLOAT BlendFactor[4];
+	UINT SampleMask;
+	ID3D11DepthStencilState* DepthStencilState;
+	UINT StencilRef;
+	ID3D11RasterizerState* RasterizerState;
+	D3D11_PRIMITIVE_TOPOLOGY Topology;
+	D3D11_VIEWPORT Viewport;
+	D3D11_RECT ScissorRect;
+
+	SfStateCache() { Invalidate(); }
+
+	// forget everything, used when the context state changes outside of sf11 (ClearState, command lists)
+	void Invalidate() { memset(this, 0xFF, sizeof(SfStateCache)); }
+
+	// binding a resource for output silently unbinds it from every input slot
+	// we do not track resources per slot, so any output change forgets all inputs
+	void InvalidateInputs()
+	{
+		memset(SRVs, 0xFF, sizeof(SRVs));
+		memset(CBs, 0xFF, sizeof(CBs));
+		memset(VertexBuffers, 0xFF, sizeof(VertexBuffers));
+		IndexBuffer = (ID3D11Buffer*)~(size_t)0;
+	}
+
+	// compute UAVs and render targets evict each other
+	void InvalidateOutputs()
+	{
+		memset(RTVs, 0xFF, sizeof(RTVs));
+		DSV = (ID3D11DepthStencilView*)~(size_t)0;
+		memset(ComputeUAVs, 0xFF, sizeof(ComputeUAVs));
+	}
+};
+
+// slot binds staged by commit at draw mode, flushed with one call per stage at the next draw or dispatch
+// the arrays always mirror the slots sf11 has been asked to bind, the ranges mark what has not reached d3d yet
+struct SfPendingBinds
+{
+	struct SlotRange
+	{
+		UINT Min = ~0u;
+		UINT Max = 0;
+
+		bool IsDirty() const { return Min <= Max; }
+		void Reset() { Min = ~0u; Max = 0; }
+		void Add(UINT startSlot, UINT count)
+		{
+			if (startSlot < Min) Min = startSlot;
+			if (startSlot + count - 1 > Max) Max = startSlot + count - 1;
+		}
+	};
+
+	ID3D11ShaderResourceView* SRVs[SF_NUM_SHADER_STAGES][D3D11_COMMONSHADER_INPUT_RESOURCE_REGISTER_COUNT];
+	ID3D11SamplerState* Samplers[SF_NUM_SHADER_STAGES][D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];
+	ID3D11Buffer* CBs[SF_NUM_SHADER_STAGES][D3D11_COMMONSHADER_CONSTANT_BUFFER_HW_SLOT_COUNT];
+
+	// constant buffer windows in 16 byte constants, a count of 0 binds the whole buffer
+	UINT CBFirstConstants[SF_NUM_SHADER_STAGES][D3D11_COMMONSHADER_CONSTANT_BUFFER_HW_SLOT_COUNT];
+	UINT CBNumConstants[SF_NUM_SHADER_STAGES][D3D11_COMMONSHADER_CONSTANT_BUFFER_HW_SLOT_COUNT];
+
+	SlotRange SRVRange[SF_NUM_SHADER_STAGES];
+	SlotRange SamplerRange[SF_NUM_SHADER_STAGES];
+	SlotRange CBRange[SF_NUM_SHADER_STAGES];
+
+	bool AnyDirty = false;
+
+	SfPendingBinds() { Reset(); }
+
+	// matches the state of a freshly created or cleared context
+	void Reset()
+	{
+		memset(SRVs, 0, sizeof(SRVs));
+		memset(Samplers, 0, sizeof(Samplers));
+		memset(CBs, 0, sizeof(CBs));
+		memset(CBFirstConstants, 0, sizeof(CBFirstConstants));
+		memset(CBNumConstants, 0, sizeof(CBNumConstants));
+		for (UINT i = 0; i < SF_NUM_SHADER_STAGES; i++)
+		{
+			SRVRange[i].Reset();
+			SamplerRange[i].Reset();
+			CBRange[i].Reset();
+		}
+		AnyDirty = false;
+	}
+};
+
+}
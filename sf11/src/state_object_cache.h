@@ -0,0 +1,111 @@
+#pragma once
+
+#include "d3d11_include.h"
+#include "hash.h"
+#include <mutex>
+#include <unordered_map>
+
+namespace sf11
+{
+
+// lookups into one of the instance's state object caches
+struct SfObjectCacheStats
+{
+	UINT64 Hits = 0;
+	UINT64 Misses = 0;
+	UINT LiveObjects = 0;
+
+	double GetHitRate() const { return Hits + Misses > 0 ? (double)Hits / (double)(Hits + Misses) : 0; }
+};
+
+// shares state objects between every handle created from the same description
+// d3d11 only allows 4096 unique objects of each state type, so identical descriptions must not create new ones
+// entries do not keep their objects alive, an entry is removed when the last handle to it is destroyed
+// lookups are locked so handles can be created from any thread
+template <typename DescType, typename DataType>
+class SfStateObjectCache
+{
+	struct Entry
+	{
+		DescType Desc;
+		std::weak_ptr<DataType> Object;
+		DataType* Raw;
+	};
+
+	struct CacheCore
+	{
+		std::mutex Mutex;
+		std::unordered_multimap<UINT64, Entry> Entries;
+		SfObjectCacheStats Stats;
+	};
+
+	// handles reach the core through a weak pointer so they can outlive the instance
+	std::shared_ptr<CacheCore> Core = std::make_shared<CacheCore>();
+
+public:
+
+	// returns the existing object for this description or stores the one returned by create
+	// desc must be fully zeroed before filling, it is hashed and compared as raw bytes
+	// create returns a new DataType* and is called with the lock held
+	template <typename CreateFunc>
+	std::shared_ptr<DataType> FindOrCreate(const DescType& desc, CreateFunc create)
+	{
+		const UINT64 hash = SfHashBytes(&desc, sizeof(DescType));
+
+		std::lock_guard<std::mutex> lock(Core->Mutex);
+
+		auto range = Core->Entries.equal_range(hash);
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (memcmp(&it->second.Desc, &desc, sizeof(DescType)) != 0) continue;
+
+			// an expired entry belongs to a handle that is being destroyed right now, its deleter removes it
+			if (std::shared_ptr<DataType> existing = it->second.Object.lock())
+			{
+				Core->Stats.Hits++;
+				return existing;
+			}
+		}
+
+		Core->Stats.Misses++;
+		Core->Stats.LiveObjects++;
+
+		std::weak_ptr<CacheCore> weakCore = Core;
+		std::shared_ptr<DataType> object(create(), [weakCore, hash](DataType* data)
+		{
+			if (std::shared_ptr<CacheCore> core = weakCore.lock())
+			{
+				std::lock_guard<std::mutex> lock(core->Mutex);
+				auto range = core->Entries.equal_range(hash);
+				for (auto it = range.first; it != range.second; ++it)
+				{
+					if (it->second.Raw == data)
+					{
+						core->Entries.erase(it);
+						core->Stats.LiveObjects--;
+						break;
+					}
+				}
+			}
+			delete data;
+		});
+
+		Core->Entries.insert({ hash, Entry{ desc, object, object.get() } });
+		return object;
+	}
+
+	SfObjectCacheStats GetStats() const
+	{
+		std::lock_guard<std::mutex> lock(Core->Mutex);
+		return Core->Stats;
+	}
+
+	void ResetStats()
+	{
+		std::lock_guard<std::mutex> lock(Core->Mutex);
+		Core->Stats.Hits = 0;
+		Core->Stats.Misses = 0;
+	}
+};
+
+}
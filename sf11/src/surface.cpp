@@ -13,6 +13,8 @@ void SfSurface2D::LoadPNG(const std::string& name, ESurfacePadMethod pad)
 {
 	PadMethod = pad;
 
+#ifdef _WIN32
+	InitGDI();
 	Gdiplus::Bitmap bitmap(std::wstring(name.begin(), name.end()).c_str());
 	Gdiplus::Status s = bitmap.GetLastStatus();
 	sfAssert(s == Gdiplus::Status::Ok, ("could not load texture \'" + name + "\' with gdiplus - error " + std::to_string(s)).c_str());
@@ -32,6 +34,10 @@ void SfSurface2D::LoadPNG(const std::string& name, ESurfacePadMethod pad)
 			if (c.GetAlpha() < 255) bHasTransparency = true;
 		}
 	}
+#else
+	sfAssert(false, ("could not load texture \'" + name + "\', png loading needs gdi+ which is only available on windows").c_str());
+	return;
+#endif
 
 	if (PadMethod != ESurfacePadMethod::NoPadding)
 	{
@@ -74,15 +80,16 @@ SfColor8* SfSurface2D::GetPixelPointer(unsigned int x, unsigned int y) const
 
 SfSurface2D::SfSurface2D(unsigned int w, unsigned int h, ESurfacePadMethod pad)
 {
-	Width = w;
-	Height = h;
+	PadMethod = pad;
 
 	if (pad != ESurfacePadMethod::NoPadding)
 	{
-		w += h;
+		w += 2;
 		h += 2;
 	}
 
+	Width = w;
+	Height = h;
 	Data = std::make_unique<SfColor8[]>(w * h);
 }
 
@@ -154,43 +161,45 @@ void SfSurface2D::SetPixel(unsigned int x, unsigned int y, SfColor8 color)
 
 	if (x == 1 || x == Width - 2 || y == 1 || y == Height - 2)
 	{
-		std::vector<SfColor8*> pixels;
+		// eight covers every mirror below at once, which only happens on 1x1 content
+		SfColor8* pixels[8];
+		UINT numPixels = 0;
 		switch (PadMethod)
 		{
 		case ESurfacePadMethod::Repeat:
 		{
-			if (x == 1)			pixels.push_back(GetPixelPointer(Width - 1, y));
-			if (x == Width - 2) pixels.push_back(GetPixelPointer(0, y));
+			if (x == 1)			pixels[numPixels++] = GetPixelPointer(Width - 1, y);
+			if (x == Width - 2) pixels[numPixels++] = GetPixelPointer(0, y);
 
-			if (y == 1)			 pixels.push_back(GetPixelPointer(x, Height - 1));
-			if (y == Height - 2) pixels.push_back(GetPixelPointer(x, 0));
+			if (y == 1)			 pixels[numPixels++] = GetPixelPointer(x, Height - 1);
+			if (y == Height - 2) pixels[numPixels++] = GetPixelPointer(x, 0);
 
-			if (x == 1 && y == 1)				   pixels.push_back(GetPixelPointer(Width - 1, Height - 1));
-			if (x == Width - 2 && y == Height - 2) pixels.push_back(GetPixelPointer(0, 0));
-			if (x == Width - 2 && y == 1)		   pixels.push_back(GetPixelPointer(0, Height - 1));
-			if (x == 1 && y == Height - 2)		   pixels.push_back(GetPixelPointer(Width - 1, 0));
+			if (x == 1 && y == 1)				   pixels[numPixels++] = GetPixelPointer(Width - 1, Height - 1);
+			if (x == Width - 2 && y == Height - 2) pixels[numPixels++] = GetPixelPointer(0, 0);
+			if (x == Width - 2 && y == 1)		   pixels[numPixels++] = GetPixelPointer(0, Height - 1);
+			if (x == 1 && y == Height - 2)		   pixels[numPixels++] = GetPixelPointer(Width - 1, 0);
 
 			break;
 		}
 		case ESurfacePadMethod::Clamp:
 		{
-			if (x == 1)			pixels.push_back(GetPixelPointer(0, y));
-			if (x == Width - 2) pixels.push_back(GetPixelPointer(Width - 1, y));
+			if (x == 1)			pixels[numPixels++] = GetPixelPointer(0, y);
+			if (x == Width - 2) pixels[numPixels++] = GetPixelPointer(Width - 1, y);
 
-			if (y == 1)			 pixels.push_back(GetPixelPointer(x, 0));
-			if (y == Height - 2) pixels.push_back(GetPixelPointer(x, Height - 1));
+			if (y == 1)			 pixels[numPixels++] = GetPixelPointer(x, 0);
+			if (y == Height - 2) pixels[numPixels++] = GetPixelPointer(x, Height - 1);
 
-			if (x == 1 && y == 1) pixels.push_back(GetPixelPointer(0, 0));
-			if (x == Width - 2 && y == Height - 2) pixels.push_back(GetPixelPointer(Width - 1, Height - 1));
-			if (x == Width - 2 && y == 1)  pixels.push_back(GetPixelPointer(Width - 1, 0));
-			if (x == 1 && y == Height - 2) pixels.push_back(GetPixelPointer(0, Height - 1));
+			if (x == 1 && y == 1) pixels[numPixels++] = GetPixelPointer(0, 0);
+			if (x == Width - 2 && y == Height - 2) pixels[numPixels++] = GetPixelPointer(Width - 1, Height - 1);
+			if (x == Width - 2 && y == 1)  pixels[numPixels++] = GetPixelPointer(Width - 1, 0);
+			if (x == 1 && y == Height - 2) pixels[numPixels++] = GetPixelPointer(0, Height - 1);
 
 			break;
 		}
 		}
-		for (SfColor8* p : pixels)
+		for (UINT i = 0; i < numPixels; i++)
 		{
-			*p = color;
+			*pixels[i] = color;
 		}
 	}
 }
@@ -108,44 +108,42 @@ void CreateTexDesc(TEXDESC& desc, const PARAMS& params, bool renderTarget = fals
 SfTexture::SfTexture(SfInstance* instance)
 	: SfResource(instance)
 {
-
+	Data->Texture = std::make_unique<TextureData>();
 }
 
 SfTexture1D::SfTexture1D(SfInstance* instance, const TextureParams1D& params, void* data)
 	: SfTexture(instance)
 {
-	Data->Texture.Width = params.Width;
-	Data->Texture.Dimensions = 1;
-	CreateTexDesc<1>(Data->Texture.TextureDesc1D, params);
+	Data->Texture->Width = params.Width;
+	Data->Texture->Dimensions = 1;
+	CreateTexDesc<1>(Data->Texture->TextureDesc1D, params);
 
-	Data->Texture.Params1D = params;
+	static_cast<TextureParams1D&>(Data->Texture->Params) = params;
 	Data->Usage = params.Usage;
 
-	UINT size = params.TextureFormat.GetTypeSize();
 	D3D11_SUBRESOURCE_DATA d = {};
 	if (data) d.pSysMem = data;
 
-	sfAssertHR(Data->Instance->GetDevice()->CreateTexture1D(&Data->Texture.TextureDesc1D, data ? &d : NULL, &Data->Texture.Texture1D),
+	sfAssertHR(Data->Instance->GetDevice()->CreateTexture1D(&Data->Texture->TextureDesc1D, data ? &d : NULL, &Data->Texture->Texture1D),
 		"could not create texture1D");
-	Data->Resource = Data->Texture.Texture1D.Get();
+	Data->Resource = Data->Texture->Texture1D.Get();
 
-	CreateViews<1>(Data->Instance, params, Data->Texture.ShaderResource, Data->Texture.UnorderedAccessView, Data->Texture.Texture1D);
-	Data->ShaderResource = Data->Texture.ShaderResource.Get();
-	Data->UnorderedAccess = Data->Texture.UnorderedAccessView.Get();
+	CreateViews<1>(Data->Instance, params, Data->Texture->ShaderResource, Data->Texture->UnorderedAccessView, Data->Texture->Texture1D);
+	Data->ShaderResource = Data->Texture->ShaderResource.Get();
+	Data->UnorderedAccess = Data->Texture->UnorderedAccessView.Get();
 }
 
 SfTexture2D::SfTexture2D(SfInstance* instance, const TextureParams2D& params, bool renderTarget, std::unique_ptr<SfSurface2D> surface)
 	: SfTexture(instance)
 {
-	Data->Texture.Width = params.Width;
-	Data->Texture.Height = params.Height;
-	Data->Texture.Dimensions = 2;
-	CreateTexDesc<2>(Data->Texture.TextureDesc2D, params, renderTarget);
+	Data->Texture->Width = params.Width;
+	Data->Texture->Height = params.Height;
+	Data->Texture->Dimensions = 2;
+	CreateTexDesc<2>(Data->Texture->TextureDesc2D, params, renderTarget);
 
-	Data->Texture.Params2D = params;
+	static_cast<TextureParams2D&>(Data->Texture->Params) = params;
 	Data->Usage = params.Usage;
 
-	UINT size = params.TextureFormat.GetTypeSize();
 	D3D11_SUBRESOURCE_DATA d = {};
 	if (surface.get())
 	{
@@ -153,24 +151,24 @@ SfTexture2D::SfTexture2D(SfInstance* instance, const TextureParams2D& params, bo
 		d.SysMemPitch = surface->GetPaddedWidth() * 4;
 	}
 
-	sfAssertHR(Data->Instance->GetDevice()->CreateTexture2D(&Data->Texture.TextureDesc2D, d.pSysMem ? &d : NULL, &Data->Texture.Texture2D),
+	sfAssertHR(Data->Instance->GetDevice()->CreateTexture2D(&Data->Texture->TextureDesc2D, d.pSysMem ? &d : NULL, &Data->Texture->Texture2D),
 		"could not create texture2D");
-	Data->Resource = Data->Texture.Texture2D.Get();
+	Data->Resource = Data->Texture->Texture2D.Get();
 
-	CreateViews<2>(Data->Instance, params, Data->Texture.ShaderResource, Data->Texture.UnorderedAccessView, Data->Texture.Texture2D);
-	Data->ShaderResource = Data->Texture.ShaderResource.Get();
-	Data->UnorderedAccess = Data->Texture.UnorderedAccessView.Get();
+	CreateViews<2>(Data->Instance, params, Data->Texture->ShaderResource, Data->Texture->UnorderedAccessView, Data->Texture->Texture2D);
+	Data->ShaderResource = Data->Texture->ShaderResource.Get();
+	Data->UnorderedAccess = Data->Texture->UnorderedAccessView.Get();
 }
 
 SfTexture2D::SfTexture2D(SfInstance* instance, const TextureParams2D& params, void* data /*= nullptr*/)
 	: SfTexture(instance)
 {
-	Data->Texture.Width = params.Width;
-	Data->Texture.Height = params.Height;
-	Data->Texture.Dimensions = 2;
-	CreateTexDesc<2>(Data->Texture.TextureDesc2D, params);
+	Data->Texture->Width = params.Width;
+	Data->Texture->Height = params.Height;
+	Data->Texture->Dimensions = 2;
+	CreateTexDesc<2>(Data->Texture->TextureDesc2D, params);
 
-	Data->Texture.Params2D = params;
+	static_cast<TextureParams2D&>(Data->Texture->Params) = params;
 	Data->Usage = params.Usage;
 
 	D3D11_SUBRESOURCE_DATA d = {};
@@ -180,25 +178,25 @@ SfTexture2D::SfTexture2D(SfInstance* instance, const TextureParams2D& params, vo
 		d.SysMemPitch = params.Width * params.TextureFormat.GetTypeSize() * params.TextureFormat.Channels;
 	}
 
-	sfAssertHR(Data->Instance->GetDevice()->CreateTexture2D(&Data->Texture.TextureDesc2D, d.pSysMem ? &d : NULL, &Data->Texture.Texture2D),
+	sfAssertHR(Data->Instance->GetDevice()->CreateTexture2D(&Data->Texture->TextureDesc2D, d.pSysMem ? &d : NULL, &Data->Texture->Texture2D),
 		"could not create texture2D");
-	Data->Resource = Data->Texture.Texture2D.Get();
+	Data->Resource = Data->Texture->Texture2D.Get();
 
-	CreateViews<2>(Data->Instance, params, Data->Texture.ShaderResource, Data->Texture.UnorderedAccessView, Data->Texture.Texture2D);
-	Data->ShaderResource = Data->Texture.ShaderResource.Get();
-	Data->UnorderedAccess = Data->Texture.UnorderedAccessView.Get();
+	CreateViews<2>(Data->Instance, params, Data->Texture->ShaderResource, Data->Texture->UnorderedAccessView, Data->Texture->Texture2D);
+	Data->ShaderResource = Data->Texture->ShaderResource.Get();
+	Data->UnorderedAccess = Data->Texture->UnorderedAccessView.Get();
 }
 
 SfTexture3D::SfTexture3D(SfInstance* instance, const TextureParams3D& params, void* data)
 	: SfTexture(instance)
 {
-	Data->Texture.Width = params.Width;
-	Data->Texture.Height = params.Height;
-	Data->Texture.Depth = params.Depth;
-	Data->Texture.Dimensions = 3;
-	CreateTexDesc<3>(Data->Texture.TextureDesc3D, params);
+	Data->Texture->Width = params.Width;
+	Data->Texture->Height = params.Height;
+	Data->Texture->Depth = params.Depth;
+	Data->Texture->Dimensions = 3;
+	CreateTexDesc<3>(Data->Texture->TextureDesc3D, params);
 
-	Data->Texture.Params3D = params;
+	Data->Texture->Params = params;
 	Data->Usage = params.Usage;
 
 	UINT size = params.TextureFormat.GetTypeSize();
@@ -210,13 +208,13 @@ SfTexture3D::SfTexture3D(SfInstance* instance, const TextureParams3D& params, vo
 		d.SysMemSlicePitch = params.Height * params.Width * size;
 	}
 
-	sfAssertHR(Data->Instance->GetDevice()->CreateTexture3D(&Data->Texture.TextureDesc3D, data ? &d : NULL, &Data->Texture.Texture3D),
+	sfAssertHR(Data->Instance->GetDevice()->CreateTexture3D(&Data->Texture->TextureDesc3D, data ? &d : NULL, &Data->Texture->Texture3D),
 		"could not create texture3D");
-	Data->Resource = Data->Texture.Texture3D.Get();
+	Data->Resource = Data->Texture->Texture3D.Get();
 
-	CreateViews<3>(Data->Instance, params, Data->Texture.ShaderResource, Data->Texture.UnorderedAccessView, Data->Texture.Texture3D);
-	Data->ShaderResource = Data->Texture.ShaderResource.Get();
-	Data->UnorderedAccess = Data->Texture.UnorderedAccessView.Get();
+	CreateViews<3>(Data->Instance, params, Data->Texture->ShaderResource, Data->Texture->UnorderedAccessView, Data->Texture->Texture3D);
+	Data->ShaderResource = Data->Texture->ShaderResource.Get();
+	Data->UnorderedAccess = Data->Texture->UnorderedAccessView.Get();
 }
 
 }
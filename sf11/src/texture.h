@@ -27,7 +27,7 @@ class SfTexture1D : public SfTexture
 
 public:
 
-	UINT GetWidth() const { return Data->Texture.Width; }
+	UINT GetWidth() const { return Data->Texture->Width; }
 
 	SF_DEF_OPERATORS_AND_DEFAULT(SfTexture1D)
 };
@@ -42,8 +42,8 @@ protected:
 	SfTexture2D(SfInstance* instance, const TextureParams2D& params, bool renderTarget, std::unique_ptr<SfSurface2D> surface);
 public:
 
-	UINT GetWidth() const { return Data->Texture.Width; }
-	UINT GetHeight() const { return Data->Texture.Height; }
+	UINT GetWidth() const { return Data->Texture->Width; }
+	UINT GetHeight() const { return Data->Texture->Height; }
 	SF_DEF_OPERATORS_AND_DEFAULT(SfTexture2D)
 };
 
@@ -56,9 +56,9 @@ class SfTexture3D : public SfTexture
 
 public:
 
-	UINT GetWidth() const { return Data->Texture.Width; }
-	UINT GetHeight() const { return Data->Texture.Height; }
-	UINT GetDepth() const { return Data->Texture.Depth; }
+	UINT GetWidth() const { return Data->Texture->Width; }
+	UINT GetHeight() const { return Data->Texture->Height; }
+	UINT GetDepth() const { return Data->Texture->Depth; }
 	SF_DEF_OPERATORS_AND_DEFAULT(SfTexture3D)
 };
 
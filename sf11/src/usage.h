@@ -22,5 +22,13 @@ struct SfUsage
 
 	D3D11_USAGE GetUsage() const;
 };
+
+// how an update to part of a dynamic resource treats the bytes it does not write
+enum class EUpdateMode
+{
+	Discard,      // the rest of the resource becomes undefined, safe while the gpu is still reading it
+	NoOverwrite   // the rest is kept, the caller guarantees the gpu is not using the written range
+	              // constant buffers need MapNoOverwriteOnDynamicConstantBuffer unless the update covers them whole
+};
 	
 }
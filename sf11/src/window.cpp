@@ -7,6 +7,8 @@
 namespace sf11
 {
 
+#ifdef _WIN32
+
 SfWindow::SfWindow(const WindowCreationParams& params, SfInstance* instance)
 	: Data(std::make_shared<WindowData>())
 {
@@ -37,10 +39,7 @@ SfWindow::SfWindow(const WindowCreationParams& params, SfInstance* instance)
 	wc.lpszClassName = className.c_str();
 	wc.hIconSm = nullptr;
 	if (!RegisterClassEx(&wc))
-	{
-		MessageBox(NULL, "RegisterClassEx failed", "sf11", NULL);
-		exit(1);
-	}
+		sfAssert(false, "RegisterClassEx failed");
 
 	int monX = GetSystemMetrics(SM_CXSCREEN);
 	int monY = GetSystemMetrics(SM_CYSCREEN);
@@ -111,10 +110,8 @@ UINT SfWindow::GetHeight() const
 void SfWindow::LockCursor()
 {
 	if (CursorClippingWindow.lock())
-	{
 		UnlockCursor();
-		CursorClippingWindow = Data;
-	}
+	CursorClippingWindow = Data;
 
 	RECT rect;
 	GetClientRect(GetHandle(), &rect);
@@ -202,6 +199,7 @@ void SfWindow::WindowData::CreateSwapChainRenderTarget()
 {
 	BackBuffer.Data = std::make_shared<SfResource::ResourceData>(Instance);
 	BackBuffer.Data->Instance = Instance;
+	BackBuffer.Data->Texture = std::make_unique<SfResource::TextureData>();
 
 	// get the address of the swap chain's back buffer 
 	ID3D11Texture2D* backBuffer = nullptr;
@@ -209,13 +207,13 @@ void SfWindow::WindowData::CreateSwapChainRenderTarget()
 	sfAssert(backBuffer, "cannot fill swap chain render target texture");
 
 	// assign the render target view of our new back buffer object to the swap chain's buffer
-	Instance->GetDevice()->CreateRenderTargetView(backBuffer, NULL, &BackBuffer.Data->Texture.RenderTargetView);
+	Instance->GetDevice()->CreateRenderTargetView(backBuffer, NULL, &BackBuffer.Data->Texture->RenderTargetView);
 
 	D3D11_TEXTURE2D_DESC td;
 	backBuffer->GetDesc(&td);
 
-	BackBuffer.Data->Texture.Width = td.Width;
-	BackBuffer.Data->Texture.Height = td.Height;
+	BackBuffer.Data->Texture->Width = td.Width;
+	BackBuffer.Data->Texture->Height = td.Height;
 
 	backBuffer->Release();
 }
@@ -240,6 +238,12 @@ LRESULT CALLBACK SfWindow::WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lP
 
 LRESULT CALLBACK SfWindow::WindowData::DoWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
+	// handle passed to callbacks, locked once per message so callbacks can keep it or lock the cursor to it
+	// messages sent while the data is being destroyed have no owner left and only get the default handling
+	SfWindow win;
+	win.Data = weak_from_this().lock();
+	if (!win.Data) return DefWindowProc(hWnd, msg, wParam, lParam);
+
 	switch (msg)
 	{
 		case WM_SIZE:
@@ -270,8 +274,6 @@ LRESULT CALLBACK SfWindow::WindowData::DoWndProc(HWND hWnd, UINT msg, WPARAM wPa
 				{
 					if (raw->data.mouse.lLastX != NULL || raw->data.mouse.lLastY != NULL)
 					{
-						SfWindow win;
-						win.Data = shared_from_this();
 						RawMouseCallback(win, raw->data.mouse.lLastX, raw->data.mouse.lLastY);
 					}
 				}
@@ -282,8 +284,6 @@ LRESULT CALLBACK SfWindow::WindowData::DoWndProc(HWND hWnd, UINT msg, WPARAM wPa
 		{
 			if (MouseScrollCallback)
 			{
-				SfWindow win;
-				win.Data = shared_from_this();
 				MouseScrollCallback(win, GET_WHEEL_DELTA_WPARAM(wParam));
 			}
 			return 0;
@@ -296,8 +296,6 @@ LRESULT CALLBACK SfWindow::WindowData::DoWndProc(HWND hWnd, UINT msg, WPARAM wPa
 				if (wParam == VK_RETURN || wParam == VK_BACK || wParam == 10 || wParam == 127)
 					return 0;
 
-				SfWindow win;
-				win.Data = shared_from_this();
 				CharCallback(win, (UINT)wParam);
 			}
 			return 0;
@@ -307,8 +305,6 @@ LRESULT CALLBACK SfWindow::WindowData::DoWndProc(HWND hWnd, UINT msg, WPARAM wPa
 		{
 			if (KeyCallback)
 			{
-				SfWindow win;
-				win.Data = shared_from_this();
 				KeyCallback(win, (UINT)wParam, false);
 			}
 			return 0;
@@ -318,8 +314,6 @@ LRESULT CALLBACK SfWindow::WindowData::DoWndProc(HWND hWnd, UINT msg, WPARAM wPa
 		{
 			if (KeyCallback)
 			{
-				SfWindow win;
-				win.Data = shared_from_this();
 				KeyCallback(win, (UINT)wParam, true);
 			}
 			return 0;
@@ -330,8 +324,6 @@ LRESULT CALLBACK SfWindow::WindowData::DoWndProc(HWND hWnd, UINT msg, WPARAM wPa
 		{
 			if (MouseButtonCallback)
 			{
-				SfWindow win;
-				win.Data = shared_from_this();
 				MouseButtonCallback(win, (UINT)wParam, false);
 			}
 			return 0;
@@ -342,8 +334,6 @@ LRESULT CALLBACK SfWindow::WindowData::DoWndProc(HWND hWnd, UINT msg, WPARAM wPa
 		{
 			if (MouseButtonCallback)
 			{
-				SfWindow win;
-				win.Data = shared_from_this();
 				MouseButtonCallback(win, (UINT)wParam, true);
 			}
 			return 0;
@@ -358,4 +348,33 @@ SfWindow::WindowData::~WindowData()
 	DestroyWindow(Handle);
 }
 
+#else
+
+// windows need win32, so without it no SfWindow is ever created and these only let the rest of sf11 link
+
+SfWindow::SfWindow(const WindowCreationParams&, SfInstance*)
+{
+	sfAssert(false, "windows can only be created on windows");
+}
+
+void SfWindow::Present(UINT, UINT) {}
+UINT SfWindow::GetWidth() const { return 0; }
+UINT SfWindow::GetHeight() const { return 0; }
+void SfWindow::LockCursor() {}
+void SfWindow::UnlockCursor() {}
+void SfWindow::HideCursor() {}
+void SfWindow::ShowCursor() {}
+bool SfWindow::KeyIsPressed(unsigned short) { return false; }
+
+void SfWindow::WindowData::CreateSwapChain() {}
+void SfWindow::WindowData::CreateSwapChainRenderTarget() {}
+void SfWindow::WindowData::OnResize(UINT, UINT) {}
+
+LRESULT CALLBACK SfWindow::WndProc(HWND, UINT, WPARAM, LPARAM) { return 0; }
+LRESULT CALLBACK SfWindow::WindowData::DoWndProc(HWND, UINT, WPARAM, LPARAM) { return 0; }
+
+SfWindow::WindowData::~WindowData() {}
+
+#endif
+
 }
@@ -0,0 +1,104 @@
+#include "sf11.h"
+#include <cstdio>
+
+// built against the library with SF_COUNT_HEAP_ALLOCATIONS=1
+// runs a frame loop through the per frame paths and fails if a steady state frame allocates
+
+using namespace sf11;
+
+namespace
+{
+
+constexpr UINT WarmUpFrames = 4;
+constexpr UINT MeasuredFrames = 64;
+constexpr UINT DrawsPerFrame = 32;
+
+struct Vertex { float X, Y, Z; };
+struct DrawConstants { float Transform[16]; };
+
+}
+
+int main()
+{
+	// the counter has to be live, otherwise every frame trivially reads 0
+	// new expressions may be elided by the optimizer, a direct call to operator new may not
+	const UINT64 before = GetThreadHeapAllocationCount();
+	::operator delete(::operator new(sizeof(int)));
+	if (GetThreadHeapAllocationCount() == before)
+	{
+		fprintf(stderr, "failed: heap allocations are not counted, build with SF_COUNT_HEAP_ALLOCATIONS=1\n");
+		return 1;
+	}
+
+	InstanceCreationParams params;
+	params.DeviceType = EDeviceType::Null;
+	SfInstance instance(params);
+	SfContext& context = instance.GetImmediateContext();
+
+	TextureParams2D textureParams;
+	textureParams.Width = 64;
+	textureParams.Height = 64;
+	SfTexture2D textures[2] = { instance.CreateTexture2D(textureParams), instance.CreateTexture2D(textureParams) };
+	const SfResourceHandle handles[2] = { textures[0].GetHandle(), textures[1].GetHandle() };
+	SfRenderTarget target = instance.CreateRenderTarget(textureParams);
+
+	float frameConstants[4] = {};
+	SfBuffer_Constant frameBuffer = instance.CreateConstantBuffer(sizeof(frameConstants), SfUsage::Dynamic);
+	SfConstantRing constants = instance.CreateConstantRing(1024 * 1024);
+	SfGeometryRing geometry = instance.CreateGeometryRing(1024 * 1024, 256 * 1024);
+
+	UINT64 frameStart = 0;
+	for (UINT frame = 0; frame < WarmUpFrames + MeasuredFrames; frame++)
+	{
+		if (frame >= WarmUpFrames) frameStart = GetThreadHeapAllocationCount();
+
+		context.BeginFrame();
+		context.BindRenderTarget(target);
+		context.SetCullAndFillMode(ECullMode::CullBack, EFillMode::Solid);
+		context.SetDepthBufferState(EDepthState::ReadWrite);
+
+		frameConstants[0] = (float)frame;
+		context.UpdateConstantBuffer(frameBuffer, frameConstants);
+		context.BindConstantBuffer(frameBuffer, 0, EShaderStage::Vertex | EShaderStage::Pixel);
+
+		SfConstantAllocation draws[DrawsPerFrame];
+		constants.Map(context);
+		for (UINT i = 0; i < DrawsPerFrame; i++)
+		{
+			DrawConstants c = {};
+			c.Transform[0] = (float)i;
+			draws[i] = constants.Push(c);
+		}
+		constants.Unmap(context);
+
+		for (UINT i = 0; i < DrawsPerFrame; i++)
+		{
+			SfTransientGeometry quad = geometry.Allocate(context, sizeof(Vertex), 4, 6);
+			Vertex* v = (Vertex*)quad.Vertices;
+			for (UINT k = 0; k < 4; k++)
+				v[k] = { (float)(k & 1), (float)(k >> 1), 0 };
+			const UINT16 indices[6] = { 0, 1, 2, 2, 1, 3 };
+			memcpy(quad.Indices, indices, sizeof(indices));
+			geometry.Unmap(context);
+
+			context.BindTransientGeometry(quad);
+			context.BindConstantAllocation(draws[i], 1, EShaderStage::Vertex);
+			context.BindShaderResources(handles + (i & 1), 1, 0, EShaderStage::Pixel);
+			context.DrawIndexed(quad.NumIndices, quad.StartIndex, quad.BaseVertex);
+		}
+
+		constants.NextFrame();
+		context.EndFrame();
+
+		if (frame < WarmUpFrames) continue;
+
+		const UINT64 allocations = GetThreadHeapAllocationCount() - frameStart;
+		if (allocations)
+		{
+			fprintf(stderr, "failed: frame %u made %llu heap allocations\n", frame, (unsigned long long)allocations);
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,159 @@
+#include "sf11.h"
+#include "src/surface.h"
+#include "src/shader.h"
+#include <atomic>
+#include <cstdio>
+
+using namespace sf11;
+
+namespace
+{
+
+int Failures = 0;
+
+void Check(bool condition, const char* what)
+{
+	if (condition) return;
+	fprintf(stderr, "failed: %s\n", what);
+	Failures++;
+}
+
+// bytecode holder for shaders that are never compiled, the null device accepts any bytes
+struct TestBlob final : public ID3DBlob
+{
+	std::atomic<ULONG> Refs = 1;
+	BYTE Code[16] = {};
+
+	HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) override
+	{
+		if (riid != __uuidof(IUnknown) && riid != __uuidof(ID3DBlob)) { *object = nullptr; return E_NOINTERFACE; }
+		AddRef();
+		*object = this;
+		return S_OK;
+	}
+	ULONG STDMETHODCALLTYPE AddRef() override { return ++Refs; }
+	ULONG STDMETHODCALLTYPE Release() override { const ULONG refs = --Refs; if (!refs) delete this; return refs; }
+	LPVOID STDMETHODCALLTYPE GetBufferPointer() override { return Code; }
+	SIZE_T STDMETHODCALLTYPE GetBufferSize() override { return sizeof(Code); }
+};
+
+// a vertex shader made from placeholder bytecode, stands in for one from CompileShaderFromFile
+struct TestVertexShader : public SfShader_Vertex
+{
+	TestVertexShader(SfInstance& instance)
+	{
+		ComPtr<ID3DBlob> blob;
+		blob.Attach(new TestBlob());
+		Data = std::make_shared<ShaderData>();
+		Data->Instance = &instance;
+		Data->Stage = EShaderStage::Vertex;
+		Data->Blob = blob;
+		InitFromBlob(blob.Get());
+	}
+};
+
+void TestFormats()
+{
+	Check(SfFormat(SfFormat::Float, 4).GetFormat() == DXGI_FORMAT_R32G32B32A32_FLOAT, "float4 format");
+	Check(SfFormat(SfFormat::UNorm8BGRA, 4).GetFormat() == DXGI_FORMAT_B8G8R8A8_UNORM, "bgra format");
+	Check(SfFormat(SfFormat::UInt16, 1).GetFormat() == DXGI_FORMAT_R16_UINT, "uint16 format");
+	Check(SfFormat(SfFormat::Float, 4).GetTypeSize() == 4, "float size");
+	Check(SfFormat(SfFormat::HalfFloat, 2).GetTypeSize() == 2, "half size");
+}
+
+void TestColors()
+{
+	const SfColor8 c(10, 20, 30, 40);
+	Check(c.GetR() == 10 && c.GetG() == 20 && c.GetB() == 30 && c.GetA() == 40, "color channels");
+	Check(c.Inverse().GetR() == 245 && c.Inverse().GetA() == 215, "color inverse");
+	Check(c.Lerp(SfColor8(110, 20, 30, 40), 0.5f).GetR() == 60, "color lerp");
+}
+
+void TestSurfaces()
+{
+	SfSurface2D surface(4, 4);
+	for (UINT y = 0; y < 4; y++)
+		for (UINT x = 0; x < 4; x++)
+			surface.SetPixel(x, y, SfColor8((BYTE)x, (BYTE)y, 0, 255));
+	Check(surface.GetPixel(3, 2).GetR() == 3 && surface.GetPixel(3, 2).GetG() == 2, "surface pixels");
+
+	std::unique_ptr<SfSurface2D> copy = surface.CopySurface();
+	Check(copy->GetPixel(1, 3).Color == surface.GetPixel(1, 3).Color, "surface copy");
+}
+
+void TestNullDevice()
+{
+	InstanceCreationParams params;
+	params.DeviceType = EDeviceType::Null;
+	SfInstance instance(params);
+	SfContext& context = instance.GetImmediateContext();
+
+	// null contexts report the 11.1 constant buffer offsets
+	Check(instance.GetOptions().ConstantBufferOffsetting, "11.1 context found through QueryInterface");
+
+	const SfNullDeviceStats start = instance.GetNullDeviceStats();
+
+	auto surface = std::make_unique<SfSurface2D>(8, 8);
+	surface->SetPixel(0, 0, SfColor8(255, 0, 0, 255));
+	SfTexture2D texture = instance.CreateTexture2DFromSurface(std::move(surface));
+	Check(texture && texture.GetWidth() == 8, "texture from surface");
+
+	TextureParams2D targetParams;
+	targetParams.Width = 16;
+	targetParams.Height = 16;
+	SfRenderTarget target = instance.CreateRenderTarget(targetParams);
+
+	TestVertexShader shader(instance);
+	SfInputLayout layout = { { "POSITION", { SfFormat::Float, 3 } }, { "WORLD", SfFormat::Mat4x4, EInputSlotType::PerInstance } };
+	shader.LinkInputLayout(layout);
+	Check(shader.GetInputLayout(), "input layout linked");
+
+	// the matrix is expanded to one element per row
+	UINT elementsSize = 0;
+	if (shader.GetInputLayout()) shader.GetInputLayout()->GetPrivateData(SF_GUID_INPUT_ELEMENTS, &elementsSize, nullptr);
+	Check(elementsSize == 5 * sizeof(SfStoredInputElement), "input layout elements");
+
+	struct Vertex { float X, Y, Z; };
+	std::vector<Vertex> vertices = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } };
+	std::vector<UINT16> indices = { 0, 1, 2 };
+	SfBuffer_Vertex vb = instance.CreateVertexBuffer(vertices);
+	SfBuffer_Index ib = instance.CreateIndexBuffer(indices);
+	float constants[4] = { 1, 2, 3, 4 };
+	SfBuffer_Constant cb = instance.CreateConstantBuffer(sizeof(constants), SfUsage::Dynamic);
+
+	context.BindRenderTarget(target);
+	context.BindVertexShader(shader);
+	context.BindVertexBuffer(vb);
+	context.BindIndexBuffer(ib);
+	context.BindTexture2D(texture, 0);
+	context.BindConstantBuffer(cb, 0, EShaderStage::Vertex);
+	context.BindConstantBuffers(nullptr, 1, 1, EShaderStage::Vertex);
+	const SfBuffer_Constant none;
+	context.BindConstantBuffers(&none, 1, 2, EShaderStage::Vertex);
+	context.UpdateConstantBuffer(cb, constants);
+	context.DrawIndexed(3, 0, 0);
+
+	// the state cache drops binds of what is already bound
+	context.BindTexture2D(texture, 0);
+	context.BindVertexBuffer(vb);
+	context.DrawIndexed(3, 0, 0);
+
+	const SfNullDeviceStats calls = instance.GetNullDeviceStats() - start;
+	Check(calls.Draws == 2, "draws reached the device");
+	Check(calls.Maps == 1, "dynamic constant update mapped once");
+	Check(calls.ObjectsAlive > 0 && calls.BytesAllocated > 0, "resources live in system memory");
+	Check(context.GetStats().Draws == 2, "context counted the draws");
+}
+
+}
+
+int main()
+{
+	TestFormats();
+	TestColors();
+	TestSurfaces();
+	TestNullDevice();
+
+	if (Failures) fprintf(stderr, "%d checks failed\n", Failures);
+	return Failures ? 1 : 0;
+}
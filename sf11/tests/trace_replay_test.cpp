@@ -0,0 +1,108 @@
+#include "sf11.h"
+#include <cstdio>
+#include <filesystem>
+
+// captures a few frames on a null device, saves and loads the trace, then checks that replay sends the same calls to d3d
+
+using namespace sf11;
+
+namespace
+{
+
+int Failures = 0;
+
+void Check(bool condition, const char* what)
+{
+	if (condition) return;
+	fprintf(stderr, "failed: %s\n", what);
+	Failures++;
+}
+
+constexpr UINT CapturedFrames = 3;
+constexpr UINT DrawsPerFrame = 8;
+
+struct Vertex { float X, Y, Z; };
+
+}
+
+int main()
+{
+	InstanceCreationParams params;
+	params.DeviceType = EDeviceType::Null;
+	SfInstance instance(params);
+	SfContext& context = instance.GetImmediateContext();
+
+	TextureParams2D textureParams;
+	textureParams.Width = 16;
+	textureParams.Height = 16;
+	SfTexture2D textures[2] = { instance.CreateTexture2D(textureParams), instance.CreateTexture2D(textureParams) };
+	SfRenderTarget target = instance.CreateRenderTarget(textureParams);
+
+	std::vector<Vertex> vertices = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 1, 1, 0 } };
+	std::vector<UINT16> indices = { 0, 1, 2, 2, 1, 3 };
+	SfBuffer_Vertex vb = instance.CreateVertexBuffer(vertices);
+	SfBuffer_Index ib = instance.CreateIndexBuffer(indices);
+
+	float constants[4] = {};
+	SfBuffer_Constant frameBuffer = instance.CreateConstantBuffer(sizeof(constants), SfUsage::Static);
+	SfBuffer_Constant drawBuffer = instance.CreateConstantBuffer(sizeof(constants), SfUsage::Dynamic);
+
+	SfFrameCapture capture = instance.CreateFrameCapture();
+	context.ClearState();
+	context.SetFrameCapture(capture, CapturedFrames);
+
+	const SfContextStats start = context.GetStats();
+	for (UINT frame = 0; frame < CapturedFrames; frame++)
+	{
+		context.BeginFrame();
+		context.BindRenderTarget(target);
+		context.SetCullAndFillMode(ECullMode::CullBack, EFillMode::Solid);
+
+		constants[0] = (float)frame;
+		context.UpdateConstantBuffer(frameBuffer, constants);
+		context.BindConstantBuffer(frameBuffer, 0, EShaderStage::Vertex | EShaderStage::Pixel);
+		context.BindVertexBuffer(vb);
+		context.BindIndexBuffer(ib);
+
+		for (UINT i = 0; i < DrawsPerFrame; i++)
+		{
+			constants[1] = (float)i;
+			context.UpdateConstantBuffer(drawBuffer, constants);
+			context.BindConstantBuffer(drawBuffer, 1, EShaderStage::Vertex);
+			context.BindTexture2D(textures[i & 1], 0);
+			context.DrawIndexed(6, 0, 0);
+		}
+		context.EndFrame();
+	}
+	const SfContextStats captured = context.GetStats() - start;
+
+	Check(capture.GetNumFramesCaptured() == CapturedFrames, "every frame captured");
+	Check(!context.GetFrameCapture(), "capture detached after its last frame");
+	Check(captured.Draws == CapturedFrames * DrawsPerFrame, "draws reached the device while capturing");
+	Check(captured.GetTotalBinds() > 0, "binds reached the device while capturing");
+
+	const std::string path = (std::filesystem::temp_directory_path() / "sf11_trace_replay_test.sftrace").string();
+	Check(capture.Save(path), "trace saved");
+
+	SfTraceReplayer replayer = instance.LoadTrace(path);
+	Check(replayer, "trace loaded");
+	if (replayer)
+	{
+		Check(replayer.GetNumFrames() == CapturedFrames, "loaded frame count");
+		Check(replayer.GetNumCommands() == capture.GetNumCommands(), "loaded command count");
+
+		// replay starts from the same cleared state the capture started from
+		context.ClearState();
+		const SfTraceReport report = replayer.Replay(context);
+		Check(report.Frames == CapturedFrames, "replayed frame count");
+		Check(report.Stats.Draws == captured.Draws, "replay draws match the capture");
+		Check(report.Stats.GetTotalBinds() == captured.GetTotalBinds(), "replay binds match the capture");
+		Check(report.Stats.StateChanges == captured.StateChanges, "replay state changes match the capture");
+	}
+
+	std::error_code error;
+	std::filesystem::remove(path, error);
+
+	if (Failures) fprintf(stderr, "%d checks failed\n", Failures);
+	return Failures ? 1 : 0;
+}